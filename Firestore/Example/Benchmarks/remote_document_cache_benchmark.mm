@@ -176,6 +176,38 @@ BENCHMARK(BM_QueryMatching)
     ->Args({100, 1000})
     ->Args({1000, 1000});
 
+// Measures full collection scans of large collections with a selective filter.
+// Only matching documents are handed back by the RemoteDocumentCache, so the
+// cost should scale with the number of matches rather than the collection size.
+void BM_QuerySelectivity(benchmark::State& state) {
+  int64_t selectivity_percent = state.range(0);
+  int64_t total_docs = state.range(1);
+  int64_t matching_docs = total_docs * selectivity_percent / 100;
+
+  FIRFirestore* db = OpenFirestore();
+  auto collection = [db collectionWithPath:MakeNSString("docs-" + CreateAutoId())];
+  WriteDocs(collection, matching_docs, /*match=*/true);
+  WriteDocs(collection, total_docs - matching_docs, /*match=*/false);
+
+  FIRQuery* query = [collection queryWhereField:@"match" isEqualTo:@YES];
+  for (auto _ : state) {
+    auto docs = GetDocumentsFromCache(query);
+    HARD_ASSERT(static_cast<int64_t>(docs.count) == matching_docs, "Expected %s matches",
+                matching_docs);
+  }
+  state.counters["matches"] = static_cast<double>(matching_docs);
+
+  Shutdown(db);
+}
+BENCHMARK(BM_QuerySelectivity)
+    ->Unit(benchmark::kMillisecond)
+    ->Args({1, 10000})
+    ->Args({10, 10000})
+    ->Args({100, 10000})
+    ->Args({1, 50000})
+    ->Args({10, 50000})
+    ->Args({100, 50000});
+
 void BM_QueryAll(benchmark::State& state) {
   int64_t total_docs = state.range(0);
 
@@ -54,7 +54,6 @@
 #include "Firestore/core/test/unit/testutil/testutil.h"
 #include "absl/memory/memory.h"
 
-using firebase::Timestamp;
 using firebase::firestore::core::DatabaseInfo;
 using firebase::firestore::credentials::EmptyAppCheckCredentialsProvider;
 using firebase::firestore::credentials::EmptyAuthCredentialsProvider;
@@ -67,7 +66,6 @@ using firebase::firestore::local::QueryEngine;
 using firebase::firestore::model::BatchId;
 using firebase::firestore::model::DatabaseId;
 using firebase::firestore::model::DocumentKeySet;
-using firebase::firestore::model::MutationBatch;
 using firebase::firestore::model::MutationBatchResult;
 using firebase::firestore::model::OnlineState;
 using firebase::firestore::model::TargetId;
@@ -293,11 +291,9 @@ class RemoteStoreEventCapture : public RemoteStoreCallback {
   _remoteStore->set_sync_engine(&capture);
 
   auto mutation = SetMutation("rooms/eros", Map("name", "Eros"));
-  MutationBatch batch = MutationBatch(23, Timestamp::Now(), {}, {mutation});
   _testWorkerQueue->Enqueue([=] {
-    _remoteStore->AddToWritePipeline(batch);
-    // The added batch won't be written immediately because write stream wasn't yet open --
-    // trigger its opening.
+    _localStore->WriteLocally({mutation});
+    // The stored batch won't be written until the write stream opens -- trigger its opening.
     _remoteStore->FillWritePipeline();
   });
 
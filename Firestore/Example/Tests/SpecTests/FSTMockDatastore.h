@@ -42,7 +42,8 @@ class MockDatastore : public Datastore {
                 std::shared_ptr<credentials::AuthCredentialsProvider> auth_credentials,
                 std::shared_ptr<credentials::AppCheckCredentialsProvider> app_check_credentials,
                 ConnectivityMonitor* connectivity_monitor,
-                FirebaseMetadataProvider* firebase_metadata_provider);
+                FirebaseMetadataProvider* firebase_metadata_provider,
+                bool resume_write_streams = false);
 
   std::shared_ptr<WatchStream> CreateWatchStream(WatchStreamCallback* callback) override;
   std::shared_ptr<WriteStream> CreateWriteStream(WriteStreamCallback* callback) override;
@@ -62,6 +63,14 @@ class MockDatastore : public Datastore {
     return write_stream_request_count_;
   }
 
+  /**
+   * Whether a new write stream resumes the previous one if the client sends its ID, or always
+   * starts over, as if the backend had released the previous stream.
+   */
+  bool resume_write_streams() const {
+    return resume_write_streams_;
+  }
+
   void IncrementWatchStreamRequests() {
     ++watch_stream_request_count_;
   }
@@ -92,6 +101,9 @@ class MockDatastore : public Datastore {
   /** Injects a stream failure as though it had come from the backend. */
   void FailWrite(const util::Status& error);
 
+  /** Drops the last `count` writes that were sent, as though they never reached the backend. */
+  void LoseWrites(int count);
+
  private:
   // These are all passed to the base class; however, making `MockDatastore` store the pointers
   // reduces the number of test-only methods in `Datastore`.
@@ -103,6 +115,8 @@ class MockDatastore : public Datastore {
   std::shared_ptr<MockWatchStream> watch_stream_;
   std::shared_ptr<MockWriteStream> write_stream_;
 
+  bool resume_write_streams_ = false;
+
   int watch_stream_request_count_ = 0;
   int write_stream_request_count_ = 0;
 };
@@ -16,9 +16,9 @@
 
 #import "Firestore/Example/Tests/SpecTests/FSTMockDatastore.h"
 
+#include <deque>
 #include <map>
 #include <memory>
-#include <queue>
 #include <utility>
 
 #include "Firestore/core/src/core/database_info.h"
@@ -27,6 +27,7 @@
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/remote/connectivity_monitor.h"
 #include "Firestore/core/src/remote/datastore.h"
 #include "Firestore/core/src/remote/firebase_metadata_provider.h"
@@ -36,6 +37,7 @@
 #include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/string_apple.h"
+#include "Firestore/core/src/util/string_format.h"
 #include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
 #include "absl/memory/memory.h"
 #include "grpcpp/completion_queue.h"
@@ -52,6 +54,7 @@ using firebase::firestore::model::Mutation;
 using firebase::firestore::model::MutationResult;
 using firebase::firestore::model::SnapshotVersion;
 using firebase::firestore::model::TargetId;
+using firebase::firestore::nanopb::ByteString;
 using firebase::firestore::remote::ConnectivityMonitor;
 using firebase::firestore::remote::FirebaseMetadataProvider;
 using firebase::firestore::remote::GrpcConnection;
@@ -61,6 +64,7 @@ using firebase::firestore::remote::WatchTargetChange;
 using firebase::firestore::remote::WriteStream;
 using firebase::firestore::util::AsyncQueue;
 using firebase::firestore::util::Status;
+using firebase::firestore::util::StringFormat;
 
 namespace firebase {
 namespace firestore {
@@ -185,7 +189,6 @@ class MockWriteStream : public WriteStream {
   void Start() override {
     HARD_ASSERT(!open_, "Trying to start already started write stream");
     open_ = true;
-    sent_mutations_ = {};
     callback_->OnWriteStreamOpen();
   }
 
@@ -207,13 +210,30 @@ class MockWriteStream : public WriteStream {
 
   void WriteHandshake() override {
     datastore_->IncrementWriteStreamRequests();
+
+    // Like the backend, resumes the previous stream if its ID is known. The writes sent on a
+    // resumed stream are still going to be acknowledged, so they are kept.
+    bool resumed = datastore_->resume_write_streams() && !stream_id().empty();
+    if (!resumed) {
+      set_stream_id(ByteString{StringFormat("stream-%s", ++stream_count_)});
+      sent_mutations_ = {};
+    }
     SetHandshakeComplete();
+    SetHandshakeResumed(resumed);
     callback_->OnWriteStreamHandshakeComplete();
   }
 
   void WriteMutations(const std::vector<Mutation>& mutations) override {
     datastore_->IncrementWriteStreamRequests();
-    sent_mutations_.push(mutations);
+    sent_mutations_.push_back(mutations);
+  }
+
+  /** Drops the last `count` writes that were sent, as though they never reached the backend. */
+  void LoseWrites(int count) {
+    HARD_ASSERT(count <= sent_mutations_count(), "Can't lose more writes than were sent");
+    for (int i = 0; i != count; ++i) {
+      sent_mutations_.pop_back();
+    }
   }
 
   /** Injects a write ack as though it had come from the backend in response to a write. */
@@ -234,7 +254,7 @@ class MockWriteStream : public WriteStream {
     HARD_ASSERT(!sent_mutations_.empty(),
                 "Writes need to happen before you can call NextSentWrite.");
     std::vector<Mutation> result = std::move(sent_mutations_.front());
-    sent_mutations_.pop();
+    sent_mutations_.pop_front();
     return result;
   }
 
@@ -248,7 +268,8 @@ class MockWriteStream : public WriteStream {
 
  private:
   bool open_ = false;
-  std::queue<std::vector<Mutation>> sent_mutations_;
+  int stream_count_ = 0;
+  std::deque<std::vector<Mutation>> sent_mutations_;
   MockDatastore* datastore_ = nullptr;
   WriteStreamCallback* callback_ = nullptr;
 };
@@ -259,13 +280,15 @@ MockDatastore::MockDatastore(
     std::shared_ptr<credentials::AuthCredentialsProvider> auth_credentials,
     std::shared_ptr<credentials::AppCheckCredentialsProvider> app_check_credentials,
     ConnectivityMonitor* connectivity_monitor,
-    FirebaseMetadataProvider* firebase_metadata_provider)
+    FirebaseMetadataProvider* firebase_metadata_provider,
+    bool resume_write_streams)
     : Datastore{database_info,         worker_queue,         auth_credentials,
                 app_check_credentials, connectivity_monitor, firebase_metadata_provider},
       database_info_{&database_info},
       worker_queue_{worker_queue},
       app_check_credentials_{app_check_credentials},
-      auth_credentials_{auth_credentials} {
+      auth_credentials_{auth_credentials},
+      resume_write_streams_{resume_write_streams} {
 }
 
 std::shared_ptr<WatchStream> MockDatastore::CreateWatchStream(WatchStreamCallback* callback) {
@@ -316,6 +339,10 @@ void MockDatastore::FailWrite(const Status& error) {
   write_stream_->FailStream(error);
 }
 
+void MockDatastore::LoseWrites(int count) {
+  write_stream_->LoseWrites(count);
+}
+
 }  // namespace remote
 }  // namespace firestore
 }  // namespace firebase
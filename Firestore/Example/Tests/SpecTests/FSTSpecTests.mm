@@ -41,6 +41,7 @@
 #include "Firestore/core/src/bundle/bundle_reader.h"
 #include "Firestore/core/src/bundle/bundle_serializer.h"
 #include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/persistence.h"
 #include "Firestore/core/src/local/target_data.h"
@@ -80,8 +81,8 @@ using firebase::firestore::bundle::BundleReader;
 using firebase::firestore::bundle::BundleSerializer;
 using firebase::firestore::core::DocumentViewChange;
 using firebase::firestore::core::Query;
+using firebase::firestore::core::Target;
 using firebase::firestore::credentials::User;
-using firebase::firestore::google_firestore_v1_ArrayValue;
 using firebase::firestore::google_firestore_v1_Value;
 using firebase::firestore::local::Persistence;
 using firebase::firestore::local::QueryPurpose;
@@ -91,7 +92,6 @@ using firebase::firestore::model::Document;
 using firebase::firestore::model::DocumentKey;
 using firebase::firestore::model::DocumentKeySet;
 using firebase::firestore::model::MutableDocument;
-using firebase::firestore::model::MutationResult;
 using firebase::firestore::model::ObjectValue;
 using firebase::firestore::model::ResourcePath;
 using firebase::firestore::model::SnapshotVersion;
@@ -207,6 +207,11 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
 @implementation FSTSpecTests {
   BOOL _gcEnabled;
   size_t _maxConcurrentLimboResolutions;
+  size_t _limboResolutionBatchSize;
+  BOOL _resumeWriteStreams;
+  size_t _writeCoalescingMaxMutations;
+  size_t _writeCoalescingMaxBytes;
+  int _watchCoalescingWindowMs;
   BOOL _networkEnabled;
   FSTUserDataReader *_reader;
   std::shared_ptr<Executor> user_executor_;
@@ -245,6 +250,14 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
   _maxConcurrentLimboResolutions = (maxConcurrentLimboResolutions == nil)
                                        ? std::numeric_limits<size_t>::max()
                                        : maxConcurrentLimboResolutions.unsignedIntValue;
+  _limboResolutionBatchSize = [config[@"limboResolutionBatchSize"] unsignedIntValue];
+  _resumeWriteStreams = [config[@"resumeWriteStreams"] boolValue];
+  _writeCoalescingMaxMutations = [config[@"writeCoalescingMaxMutations"] unsignedIntValue];
+  NSNumber *writeCoalescingMaxBytes = config[@"writeCoalescingMaxBytes"];
+  _writeCoalescingMaxBytes = (writeCoalescingMaxBytes == nil)
+                                 ? std::numeric_limits<size_t>::max()
+                                 : writeCoalescingMaxBytes.unsignedIntValue;
+  _watchCoalescingWindowMs = [config[@"watchCoalescingWindowMs"] intValue];
   NSNumber *numClients = config[@"numClients"];
   if (numClients) {
     XCTAssertEqualObjects(numClients, @1, @"The iOS client does not support multi-client tests");
@@ -254,7 +267,12 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
       [[FSTSyncEngineTestDriver alloc] initWithPersistence:std::move(persistence)
                                                initialUser:User::Unauthenticated()
                                          outstandingWrites:{}
-                             maxConcurrentLimboResolutions:_maxConcurrentLimboResolutions];
+                             maxConcurrentLimboResolutions:_maxConcurrentLimboResolutions
+                                  limboResolutionBatchSize:_limboResolutionBatchSize
+                                        resumeWriteStreams:_resumeWriteStreams
+                               writeCoalescingMaxMutations:_writeCoalescingMaxMutations
+                                   writeCoalescingMaxBytes:_writeCoalescingMaxBytes
+                                   watchCoalescingWindowMs:_watchCoalescingWindowMs];
   [self.driver start];
 }
 
@@ -510,10 +528,7 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
                 @"'keepInQueue=true' is not supported on iOS and should only be set in "
                 @"multi-client tests");
 
-  MutationResult mutationResult(version, Message<google_firestore_v1_ArrayValue>{});
-  std::vector<MutationResult> mutationResults;
-  mutationResults.emplace_back(std::move(mutationResult));
-  [self.driver receiveWriteAckWithVersion:version mutationResults:std::move(mutationResults)];
+  [self.driver receiveWriteAckWithVersion:version];
 }
 
 - (void)doFailWrite:(NSDictionary *)spec {
@@ -524,6 +539,15 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
   [self.driver receiveWriteError:code userInfo:errorSpec keepInQueue:keepInQueue.boolValue];
 }
 
+- (void)doWriteStreamClose:(NSDictionary *)closeSpec {
+  NSDictionary *errorSpec = closeSpec[@"error"];
+  int code = ((NSNumber *)(errorSpec[@"code"])).intValue;
+
+  int lostWrites = ((NSNumber *)(closeSpec[@"lostWrites"])).intValue;
+
+  [self.driver receiveWriteStreamError:code userInfo:errorSpec lostWrites:lostWrites];
+}
+
 - (void)doDrainQueue {
   [self.driver drainQueue];
 }
@@ -542,6 +566,10 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
     timerID = TimerId::WriteStreamConnectionBackoff;
   } else if ([timer isEqualToString:@"online_state_timeout"]) {
     timerID = TimerId::OnlineStateTimeout;
+  } else if ([timer isEqualToString:@"watch_snapshot_coalescing"]) {
+    timerID = TimerId::WatchSnapshotCoalescing;
+  } else if ([timer isEqualToString:@"write_stream_resume_timeout"]) {
+    timerID = TimerId::WriteStreamResumeTimeout;
   } else {
     HARD_FAIL("runTimer spec step specified unknown timer: %s", timer);
   }
@@ -579,7 +607,12 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
       [[FSTSyncEngineTestDriver alloc] initWithPersistence:std::move(persistence)
                                                initialUser:currentUser
                                          outstandingWrites:outstandingWrites
-                             maxConcurrentLimboResolutions:_maxConcurrentLimboResolutions];
+                             maxConcurrentLimboResolutions:_maxConcurrentLimboResolutions
+                                  limboResolutionBatchSize:_limboResolutionBatchSize
+                                        resumeWriteStreams:_resumeWriteStreams
+                               writeCoalescingMaxMutations:_writeCoalescingMaxMutations
+                                   writeCoalescingMaxBytes:_writeCoalescingMaxBytes
+                                   watchCoalescingWindowMs:_watchCoalescingWindowMs];
   [self.driver start];
 }
 
@@ -628,6 +661,8 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
     [self doWriteAck:step[@"writeAck"]];
   } else if (step[@"failWrite"]) {
     [self doFailWrite:step[@"failWrite"]];
+  } else if (step[@"writeStreamClose"]) {
+    [self doWriteStreamClose:step[@"writeStreamClose"]];
   } else if (step[@"waitForPendingWrites"]) {
     [self doWaitForPendingWrites];
   } else if (step[@"runTimer"]) {
@@ -766,14 +801,24 @@ NSString *ToTargetIdListString(const ActiveTargetMap &map) {
           enumerateKeysAndObjectsUsingBlock:^(NSString *targetIDString, NSDictionary *queryData,
                                               BOOL *) {
             TargetId targetID = [targetIDString intValue];
-            NSArray *queriesJson = queryData[@"queries"];
+            std::vector<Target> targets;
+            if (queryData[@"documents"]) {
+              // A limbo target that resolves several documents at once.
+              std::vector<DocumentKey> keys;
+              for (NSString *name in queryData[@"documents"]) {
+                keys.push_back(FSTTestDocKey(name));
+              }
+              targets.push_back(Target::ForDocuments(std::move(keys)));
+            }
+            for (id queryJson in queryData[@"queries"]) {
+              targets.push_back([self parseQuery:queryJson].ToTarget());
+            }
             std::vector<TargetData> queries;
-            for (id queryJson in queriesJson) {
-              Query query = [self parseQuery:queryJson];
+            for (const Target &target : targets) {
               // TODO(mcg): populate the purpose of the target once it's possible to encode that in
               // the spec tests. For now, hard-code that it's a listen despite the fact that it's
               // not always the right value.
-              TargetData target_data(query.ToTarget(), targetID, 0, QueryPurpose::Listen);
+              TargetData target_data(target, targetID, 0, QueryPurpose::Listen);
               if ([queryData objectForKey:@"resumeToken"] != nil) {
                 target_data = target_data.WithResumeToken(
                     MakeResumeToken(queryData[@"resumeToken"]), SnapshotVersion::None());
@@ -120,12 +120,20 @@ typedef std::
 /**
  * Initializes the underlying FSTSyncEngine with the given local persistence implementation and
  * a set of existing outstandingWrites (useful when your Persistence object has persisted
- * mutation queues).
+ * mutation queues). limboResolutionBatchSize is passed to the SyncEngine. If resumeWriteStreams
+ * is set, the mock backend resumes a failed write stream when the client asks it to.
+ * writeCoalescingMaxMutations, writeCoalescingMaxBytes and watchCoalescingWindowMs are passed to
+ * the RemoteStore.
  */
 - (instancetype)initWithPersistence:(std::unique_ptr<local::Persistence>)persistence
                         initialUser:(const credentials::User &)initialUser
                   outstandingWrites:(const FSTOutstandingWriteQueues &)outstandingWrites
-      maxConcurrentLimboResolutions:(size_t)maxConcurrentLimboResolutions NS_DESIGNATED_INITIALIZER;
+      maxConcurrentLimboResolutions:(size_t)maxConcurrentLimboResolutions
+           limboResolutionBatchSize:(size_t)limboResolutionBatchSize
+                 resumeWriteStreams:(BOOL)resumeWriteStreams
+        writeCoalescingMaxMutations:(size_t)writeCoalescingMaxMutations
+            writeCoalescingMaxBytes:(size_t)writeCoalescingMaxBytes
+            watchCoalescingWindowMs:(int)watchCoalescingWindowMs NS_DESIGNATED_INITIALIZER;
 
 - (instancetype)init NS_UNAVAILABLE;
 
@@ -193,6 +201,21 @@ typedef std::
  */
 - (void)receiveWatchStreamError:(int)errorCode userInfo:(NSDictionary<NSString *, id> *)userInfo;
 
+/**
+ * Delivers a write stream error that isn't caused by any of the writes, such as a dropped
+ * connection. The writes that were sent are not acknowledged or rejected, and are sent again
+ * unless the next write stream resumes the failed one.
+ *
+ * @param errorCode A FIRFirestoreErrorCode value, from FIRFirestoreErrors.h
+ * @param userInfo Any additional details that the server might have sent along with the error.
+ *     For the moment this is effectively unused, but is logged.
+ * @param lostWrites How many of the last writes that were sent never reached the backend. A
+ *     resumed stream doesn't respond to them.
+ */
+- (void)receiveWriteStreamError:(int)errorCode
+                       userInfo:(NSDictionary<NSString *, id> *)userInfo
+                     lostWrites:(int)lostWrites;
+
 /**
  * Performs a mutation against the FSTSyncEngine as if the user had written the mutation through
  * the API.
@@ -222,20 +245,19 @@ typedef std::
                                keepInQueue:(BOOL)keepInQueue;
 
 /**
- * Delivers a write acknowledgement as if the Streaming Write backend has acknowledged a write with
- * the snapshot version at which the write was committed.
+ * Delivers a write acknowledgement as if the Streaming Write backend has acknowledged a request
+ * with the snapshot version at which its writes were committed. If the request coalesced several
+ * writes, all of them are acknowledged.
  *
  * @param commitVersion The snapshot version at which the simulated server has committed
- *     the mutation. Snapshot versions must be monotonically increasing.
- * @param mutationResults The mutation results for the write that is being acked.
+ *     the mutations. Snapshot versions must be monotonically increasing.
  */
-- (FSTOutstandingWrite *)receiveWriteAckWithVersion:(const model::SnapshotVersion &)commitVersion
-                                    mutationResults:
-                                        (std::vector<model::MutationResult>)mutationResults;
+- (void)receiveWriteAckWithVersion:(const model::SnapshotVersion &)commitVersion;
 
 /**
  * A count of the mutations written to the write stream by the FSTSyncEngine, but not yet
- * acknowledged via receiveWriteError: or receiveWriteAckWithVersion:mutationResults.
+ * acknowledged via receiveWriteError: or receiveWriteAckWithVersion:. A request that coalesced
+ * several writes counts once.
  */
 @property(nonatomic, readonly) int sentWritesCount;
 
@@ -43,6 +43,8 @@
 #include "Firestore/core/src/local/query_engine.h"
 #include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/remote/firebase_metadata_provider.h"
 #include "Firestore/core/src/remote/firebase_metadata_provider_noop.h"
 #include "Firestore/core/src/remote/remote_store.h"
@@ -61,6 +63,7 @@
 #include "absl/memory/memory.h"
 
 using firebase::firestore::api::LoadBundleTask;
+using firebase::firestore::google_firestore_v1_ArrayValue;
 using firebase::firestore::Error;
 using firebase::firestore::bundle::BundleReader;
 using firebase::firestore::core::DatabaseInfo;
@@ -87,6 +90,7 @@ using firebase::firestore::model::MutationResult;
 using firebase::firestore::model::OnlineState;
 using firebase::firestore::model::SnapshotVersion;
 using firebase::firestore::model::TargetId;
+using firebase::firestore::nanopb::Message;
 using firebase::firestore::remote::CreateFirebaseMetadataProviderNoOp;
 using firebase::firestore::remote::CreateNoOpConnectivityMonitor;
 using firebase::firestore::remote::ConnectivityMonitor;
@@ -211,7 +215,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (instancetype)initWithPersistence:(std::unique_ptr<Persistence>)persistence
                         initialUser:(const User &)initialUser
                   outstandingWrites:(const FSTOutstandingWriteQueues &)outstandingWrites
-      maxConcurrentLimboResolutions:(size_t)maxConcurrentLimboResolutions {
+      maxConcurrentLimboResolutions:(size_t)maxConcurrentLimboResolutions
+           limboResolutionBatchSize:(size_t)limboResolutionBatchSize
+                 resumeWriteStreams:(BOOL)resumeWriteStreams
+        writeCoalescingMaxMutations:(size_t)writeCoalescingMaxMutations
+            writeCoalescingMaxBytes:(size_t)writeCoalescingMaxBytes
+            watchCoalescingWindowMs:(int)watchCoalescingWindowMs {
   if (self = [super init]) {
     _maxConcurrentLimboResolutions = maxConcurrentLimboResolutions;
 
@@ -234,14 +243,17 @@ NS_ASSUME_NONNULL_BEGIN
     _datastore = std::make_shared<MockDatastore>(
         _databaseInfo, _workerQueue, std::make_shared<EmptyAuthCredentialsProvider>(),
         std::make_shared<EmptyAppCheckCredentialsProvider>(), _connectivityMonitor.get(),
-        _firebaseMetadataProvider.get());
+        _firebaseMetadataProvider.get(), resumeWriteStreams);
     _remoteStore = absl::make_unique<RemoteStore>(
         _localStore.get(), _datastore, _workerQueue, _connectivityMonitor.get(),
         [self](OnlineState onlineState) { _syncEngine->HandleOnlineStateChange(onlineState); });
-    ;
+    _remoteStore->set_write_coalescing_max_mutations(writeCoalescingMaxMutations);
+    _remoteStore->set_write_coalescing_max_bytes(writeCoalescingMaxBytes);
+    _remoteStore->set_watch_coalescing_window(AsyncQueue::Milliseconds(watchCoalescingWindowMs));
 
     _syncEngine = absl::make_unique<SyncEngine>(_localStore.get(), _remoteStore.get(), initialUser,
                                                 _maxConcurrentLimboResolutions);
+    _syncEngine->set_limbo_resolution_batch_size(limboResolutionBatchSize);
     _remoteStore->set_sync_engine(_syncEngine.get());
     _eventManager.Init(_syncEngine.get());
 
@@ -358,15 +370,23 @@ NS_ASSUME_NONNULL_BEGIN
   });
 }
 
-- (void)validateNextWriteSent:(const Mutation &)expectedWrite {
+- (NSUInteger)validateNextWriteSent {
   std::vector<Mutation> request = _datastore->NextSentWrite();
-  // Make sure the write went through the pipe like we expected it to.
-  HARD_ASSERT(request.size() == 1, "Only single mutation requests are supported at the moment");
-  const Mutation &actualWrite = request[0];
-  HARD_ASSERT(actualWrite == expectedWrite,
-              "Mock datastore received write %s but first outstanding mutation was %s",
-              actualWrite.ToString(), expectedWrite.ToString());
-  LOG_DEBUG("A write was sent: %s", actualWrite.ToString());
+  NSMutableArray<FSTOutstandingWrite *> *writes = [self currentOutstandingWrites];
+  // Make sure the writes went through the pipe like we expected them to. A request can coalesce
+  // several writes, each of which has a single mutation.
+  HARD_ASSERT(request.size() <= writes.count,
+              "Mock datastore received %s mutations but only %s writes are outstanding",
+              request.size(), writes.count);
+  for (NSUInteger i = 0; i != request.size(); ++i) {
+    const Mutation &actualWrite = request[i];
+    const Mutation &expectedWrite = writes[i].write;
+    HARD_ASSERT(actualWrite == expectedWrite,
+                "Mock datastore received write %s but outstanding mutation was %s",
+                actualWrite.ToString(), expectedWrite.ToString());
+    LOG_DEBUG("A write was sent: %s", actualWrite.ToString());
+  }
+  return request.size();
 }
 
 - (int)sentWritesCount {
@@ -403,16 +423,16 @@ NS_ASSUME_NONNULL_BEGIN
   _workerQueue->EnqueueBlocking([&] { _syncEngine->HandleCredentialChange(user); });
 }
 
-- (FSTOutstandingWrite *)receiveWriteAckWithVersion:(const SnapshotVersion &)commitVersion
-                                    mutationResults:(std::vector<MutationResult>)mutationResults {
-  FSTOutstandingWrite *write = [self currentOutstandingWrites].firstObject;
-  [[self currentOutstandingWrites] removeObjectAtIndex:0];
-  [self validateNextWriteSent:write.write];
+- (void)receiveWriteAckWithVersion:(const SnapshotVersion &)commitVersion {
+  NSUInteger writeCount = [self validateNextWriteSent];
+  [[self currentOutstandingWrites] removeObjectsInRange:NSMakeRange(0, writeCount)];
 
+  std::vector<MutationResult> mutationResults;
+  for (NSUInteger i = 0; i != writeCount; ++i) {
+    mutationResults.emplace_back(commitVersion, Message<google_firestore_v1_ArrayValue>{});
+  }
   _workerQueue->EnqueueBlocking(
       [&] { _datastore->AckWrite(commitVersion, std::move(mutationResults)); });
-
-  return write;
 }
 
 - (FSTOutstandingWrite *)receiveWriteError:(int)errorCode
@@ -421,11 +441,13 @@ NS_ASSUME_NONNULL_BEGIN
   Status error{static_cast<Error>(errorCode), MakeString([userInfo description])};
 
   FSTOutstandingWrite *write = [self currentOutstandingWrites].firstObject;
-  [self validateNextWriteSent:write.write];
+  NSUInteger writeCount = [self validateNextWriteSent];
 
   // If this is a permanent error, the mutation is not expected to be sent again so we remove it
-  // from currentOutstandingWrites.
+  // from currentOutstandingWrites. Coalesced writes are retried one at a time instead.
   if (!keepInQueue) {
+    HARD_ASSERT(writeCount == 1, "A request with %s coalesced writes can't be rejected",
+                writeCount);
     [[self currentOutstandingWrites] removeObjectAtIndex:0];
   }
 
@@ -529,6 +551,18 @@ NS_ASSUME_NONNULL_BEGIN
   });
 }
 
+- (void)receiveWriteStreamError:(int)errorCode
+                       userInfo:(NSDictionary<NSString *, id> *)userInfo
+                     lostWrites:(int)lostWrites {
+  Status error{static_cast<Error>(errorCode), MakeString([userInfo description])};
+
+  LOG_DEBUG("Failing the write stream.");
+  _workerQueue->EnqueueBlocking([&] {
+    _datastore->LoseWrites(lostWrites);
+    _datastore->FailWrite(error);
+  });
+}
+
 - (std::map<DocumentKey, TargetId>)activeLimboDocumentResolutions {
   return _syncEngine->GetActiveLimboDocumentResolutions();
 }
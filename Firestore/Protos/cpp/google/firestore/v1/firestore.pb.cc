@@ -35,11 +35,12 @@ extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fwrite_2eproto ::PROTOB
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fwrite_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_DocumentDelete_google_2ffirestore_2fv1_2fwrite_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fcommon_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<0> scc_info_DocumentMask_google_2ffirestore_2fv1_2fcommon_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fwrite_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_DocumentRemove_google_2ffirestore_2fv1_2fwrite_2eproto;
-extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fwrite_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<0> scc_info_ExistenceFilter_google_2ffirestore_2fv1_2fwrite_2eproto;
+extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fwrite_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_ExistenceFilter_google_2ffirestore_2fv1_2fwrite_2eproto;
+extern PROTOBUF_INTERNAL_EXPORT_google_2fprotobuf_2fwrappers_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<0> scc_info_Int32Value_google_2fprotobuf_2fwrappers_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2ffirestore_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<0> scc_info_ListenRequest_LabelsEntry_DoNotUse_google_2ffirestore_2fv1_2ffirestore_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fcommon_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_Precondition_google_2ffirestore_2fv1_2fcommon_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2fquery_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<6> scc_info_StructuredQuery_google_2ffirestore_2fv1_2fquery_2eproto;
-extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2ffirestore_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<3> scc_info_Target_google_2ffirestore_2fv1_2ffirestore_2eproto;
+extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2ffirestore_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<4> scc_info_Target_google_2ffirestore_2fv1_2ffirestore_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2ffirestore_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<0> scc_info_Target_DocumentsTarget_google_2ffirestore_2fv1_2ffirestore_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2ffirestore_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<1> scc_info_Target_QueryTarget_google_2ffirestore_2fv1_2ffirestore_2eproto;
 extern PROTOBUF_INTERNAL_EXPORT_google_2ffirestore_2fv1_2ffirestore_2eproto ::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<2> scc_info_TargetChange_google_2ffirestore_2fv1_2ffirestore_2eproto;
@@ -493,11 +494,12 @@ static void InitDefaultsscc_info_Target_google_2ffirestore_2fv1_2ffirestore_2epr
   ::google::firestore::v1::Target::InitAsDefaultInstance();
 }
 
-::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<3> scc_info_Target_google_2ffirestore_2fv1_2ffirestore_2eproto =
-    {{ATOMIC_VAR_INIT(::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase::kUninitialized), 3, 0, InitDefaultsscc_info_Target_google_2ffirestore_2fv1_2ffirestore_2eproto}, {
+::PROTOBUF_NAMESPACE_ID::internal::SCCInfo<4> scc_info_Target_google_2ffirestore_2fv1_2ffirestore_2eproto =
+    {{ATOMIC_VAR_INIT(::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase::kUninitialized), 4, 0, InitDefaultsscc_info_Target_google_2ffirestore_2fv1_2ffirestore_2eproto}, {
       &scc_info_Target_QueryTarget_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
       &scc_info_Target_DocumentsTarget_google_2ffirestore_2fv1_2ffirestore_2eproto.base,
-      &scc_info_Timestamp_google_2fprotobuf_2ftimestamp_2eproto.base,}};
+      &scc_info_Timestamp_google_2fprotobuf_2ftimestamp_2eproto.base,
+      &scc_info_Int32Value_google_2fprotobuf_2fwrappers_2eproto.base,}};
 
 static void InitDefaultsscc_info_Target_DocumentsTarget_google_2ffirestore_2fv1_2ffirestore_2eproto() {
   GOOGLE_PROTOBUF_VERIFY_VERSION;
@@ -830,6 +832,7 @@ const ::PROTOBUF_NAMESPACE_ID::uint32 TableStruct_google_2ffirestore_2fv1_2ffire
   offsetof(::google::firestore::v1::TargetDefaultTypeInternal, read_time_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::Target, target_id_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::Target, once_),
+  PROTOBUF_FIELD_OFFSET(::google::firestore::v1::Target, expected_count_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::Target, target_type_),
   PROTOBUF_FIELD_OFFSET(::google::firestore::v1::Target, resume_type_),
   ~0u,  // no _has_bits_
@@ -883,9 +886,9 @@ static const ::PROTOBUF_NAMESPACE_ID::internal::MigrationSchema schemas[] PROTOB
   { 194, -1, sizeof(::google::firestore::v1::Target_DocumentsTarget)},
   { 200, -1, sizeof(::google::firestore::v1::Target_QueryTarget)},
   { 208, -1, sizeof(::google::firestore::v1::Target)},
-  { 221, -1, sizeof(::google::firestore::v1::TargetChange)},
-  { 231, -1, sizeof(::google::firestore::v1::ListCollectionIdsRequest)},
-  { 239, -1, sizeof(::google::firestore::v1::ListCollectionIdsResponse)},
+  { 222, -1, sizeof(::google::firestore::v1::TargetChange)},
+  { 232, -1, sizeof(::google::firestore::v1::ListCollectionIdsRequest)},
+  { 240, -1, sizeof(::google::firestore::v1::ListCollectionIdsResponse)},
 };
 
 static ::PROTOBUF_NAMESPACE_ID::Message const * const file_default_instances[] = {
@@ -926,179 +929,181 @@ const char descriptor_table_protodef_google_2ffirestore_2fv1_2ffirestore_2eproto
   "google/firestore/v1/query.proto\032\037google/"
   "firestore/v1/write.proto\032\033google/protobu"
   "f/empty.proto\032\037google/protobuf/timestamp"
-  ".proto\032\027google/rpc/status.proto\"\263\001\n\022GetD"
-  "ocumentRequest\022\014\n\004name\030\001 \001(\t\022/\n\004mask\030\002 \001"
-  "(\0132!.google.firestore.v1.DocumentMask\022\025\n"
-  "\013transaction\030\003 \001(\014H\000\022/\n\tread_time\030\005 \001(\0132"
-  "\032.google.protobuf.TimestampH\000B\026\n\024consist"
-  "ency_selector\"\235\002\n\024ListDocumentsRequest\022\016"
-  "\n\006parent\030\001 \001(\t\022\025\n\rcollection_id\030\002 \001(\t\022\021\n"
-  "\tpage_size\030\003 \001(\005\022\022\n\npage_token\030\004 \001(\t\022\020\n\010"
-  "order_by\030\006 \001(\t\022/\n\004mask\030\007 \001(\0132!.google.fi"
-  "restore.v1.DocumentMask\022\025\n\013transaction\030\010"
-  " \001(\014H\000\022/\n\tread_time\030\n \001(\0132\032.google.proto"
-  "buf.TimestampH\000\022\024\n\014show_missing\030\014 \001(\010B\026\n"
-  "\024consistency_selector\"b\n\025ListDocumentsRe"
-  "sponse\0220\n\tdocuments\030\001 \003(\0132\035.google.fires"
-  "tore.v1.Document\022\027\n\017next_page_token\030\002 \001("
-  "\t\"\265\001\n\025CreateDocumentRequest\022\016\n\006parent\030\001 "
-  "\001(\t\022\025\n\rcollection_id\030\002 \001(\t\022\023\n\013document_i"
-  "d\030\003 \001(\t\022/\n\010document\030\004 \001(\0132\035.google.fires"
-  "tore.v1.Document\022/\n\004mask\030\005 \001(\0132!.google."
-  "firestore.v1.DocumentMask\"\356\001\n\025UpdateDocu"
-  "mentRequest\022/\n\010document\030\001 \001(\0132\035.google.f"
-  "irestore.v1.Document\0226\n\013update_mask\030\002 \001("
-  "\0132!.google.firestore.v1.DocumentMask\022/\n\004"
-  "mask\030\003 \001(\0132!.google.firestore.v1.Documen"
-  "tMask\022;\n\020current_document\030\004 \001(\0132!.google"
-  ".firestore.v1.Precondition\"b\n\025DeleteDocu"
-  "mentRequest\022\014\n\004name\030\001 \001(\t\022;\n\020current_doc"
-  "ument\030\002 \001(\0132!.google.firestore.v1.Precon"
-  "dition\"\224\002\n\030BatchGetDocumentsRequest\022\020\n\010d"
-  "atabase\030\001 \001(\t\022\021\n\tdocuments\030\002 \003(\t\022/\n\004mask"
-  "\030\003 \001(\0132!.google.firestore.v1.DocumentMas"
-  "k\022\025\n\013transaction\030\004 \001(\014H\000\022B\n\017new_transact"
-  "ion\030\005 \001(\0132\'.google.firestore.v1.Transact"
-  "ionOptionsH\000\022/\n\tread_time\030\007 \001(\0132\032.google"
+  ".proto\032\036google/protobuf/wrappers.proto\032\027"
+  "google/rpc/status.proto\"\263\001\n\022GetDocumentR"
+  "equest\022\014\n\004name\030\001 \001(\t\022/\n\004mask\030\002 \001(\0132!.goo"
+  "gle.firestore.v1.DocumentMask\022\025\n\013transac"
+  "tion\030\003 \001(\014H\000\022/\n\tread_time\030\005 \001(\0132\032.google"
   ".protobuf.TimestampH\000B\026\n\024consistency_sel"
-  "ector\"\254\001\n\031BatchGetDocumentsResponse\022.\n\005f"
-  "ound\030\001 \001(\0132\035.google.firestore.v1.Documen"
-  "tH\000\022\021\n\007missing\030\002 \001(\tH\000\022\023\n\013transaction\030\003 "
-  "\001(\014\022-\n\tread_time\030\004 \001(\0132\032.google.protobuf"
-  ".TimestampB\010\n\006result\"e\n\027BeginTransaction"
-  "Request\022\020\n\010database\030\001 \001(\t\0228\n\007options\030\002 \001"
-  "(\0132\'.google.firestore.v1.TransactionOpti"
-  "ons\"/\n\030BeginTransactionResponse\022\023\n\013trans"
-  "action\030\001 \001(\014\"b\n\rCommitRequest\022\020\n\010databas"
-  "e\030\001 \001(\t\022*\n\006writes\030\002 \003(\0132\032.google.firesto"
-  "re.v1.Write\022\023\n\013transaction\030\003 \001(\014\"z\n\016Comm"
-  "itResponse\0227\n\rwrite_results\030\001 \003(\0132 .goog"
-  "le.firestore.v1.WriteResult\022/\n\013commit_ti"
-  "me\030\002 \001(\0132\032.google.protobuf.Timestamp\"8\n\017"
-  "RollbackRequest\022\020\n\010database\030\001 \001(\t\022\023\n\013tra"
-  "nsaction\030\002 \001(\014\"\225\002\n\017RunQueryRequest\022\016\n\006pa"
-  "rent\030\001 \001(\t\022@\n\020structured_query\030\002 \001(\0132$.g"
-  "oogle.firestore.v1.StructuredQueryH\000\022\025\n\013"
-  "transaction\030\005 \001(\014H\001\022B\n\017new_transaction\030\006"
-  " \001(\0132\'.google.firestore.v1.TransactionOp"
-  "tionsH\001\022/\n\tread_time\030\007 \001(\0132\032.google.prot"
-  "obuf.TimestampH\001B\014\n\nquery_typeB\026\n\024consis"
-  "tency_selector\"\240\001\n\020RunQueryResponse\022\023\n\013t"
-  "ransaction\030\002 \001(\014\022/\n\010document\030\001 \001(\0132\035.goo"
-  "gle.firestore.v1.Document\022-\n\tread_time\030\003"
-  " \001(\0132\032.google.protobuf.Timestamp\022\027\n\017skip"
-  "ped_results\030\004 \001(\005\"\343\001\n\014WriteRequest\022\020\n\010da"
-  "tabase\030\001 \001(\t\022\021\n\tstream_id\030\002 \001(\t\022*\n\006write"
-  "s\030\003 \003(\0132\032.google.firestore.v1.Write\022\024\n\014s"
-  "tream_token\030\004 \001(\014\022=\n\006labels\030\005 \003(\0132-.goog"
-  "le.firestore.v1.WriteRequest.LabelsEntry"
-  "\032-\n\013LabelsEntry\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 "
-  "\001(\t:\0028\001\"\242\001\n\rWriteResponse\022\021\n\tstream_id\030\001"
-  " \001(\t\022\024\n\014stream_token\030\002 \001(\014\0227\n\rwrite_resu"
-  "lts\030\003 \003(\0132 .google.firestore.v1.WriteRes"
-  "ult\022/\n\013commit_time\030\004 \001(\0132\032.google.protob"
-  "uf.Timestamp\"\355\001\n\rListenRequest\022\020\n\010databa"
-  "se\030\001 \001(\t\0221\n\nadd_target\030\002 \001(\0132\033.google.fi"
-  "restore.v1.TargetH\000\022\027\n\rremove_target\030\003 \001"
-  "(\005H\000\022>\n\006labels\030\004 \003(\0132..google.firestore."
-  "v1.ListenRequest.LabelsEntry\032-\n\013LabelsEn"
-  "try\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 \001(\t:\0028\001B\017\n\rt"
-  "arget_change\"\325\002\n\016ListenResponse\022:\n\rtarge"
-  "t_change\030\002 \001(\0132!.google.firestore.v1.Tar"
-  "getChangeH\000\022>\n\017document_change\030\003 \001(\0132#.g"
-  "oogle.firestore.v1.DocumentChangeH\000\022>\n\017d"
-  "ocument_delete\030\004 \001(\0132#.google.firestore."
-  "v1.DocumentDeleteH\000\022>\n\017document_remove\030\006"
-  " \001(\0132#.google.firestore.v1.DocumentRemov"
-  "eH\000\0226\n\006filter\030\005 \001(\0132$.google.firestore.v"
-  "1.ExistenceFilterH\000B\017\n\rresponse_type\"\241\003\n"
-  "\006Target\0228\n\005query\030\002 \001(\0132\'.google.firestor"
-  "e.v1.Target.QueryTargetH\000\022@\n\tdocuments\030\003"
-  " \001(\0132+.google.firestore.v1.Target.Docume"
-  "ntsTargetH\000\022\026\n\014resume_token\030\004 \001(\014H\001\022/\n\tr"
-  "ead_time\030\013 \001(\0132\032.google.protobuf.Timesta"
-  "mpH\001\022\021\n\ttarget_id\030\005 \001(\005\022\014\n\004once\030\006 \001(\010\032$\n"
-  "\017DocumentsTarget\022\021\n\tdocuments\030\002 \003(\t\032m\n\013Q"
-  "ueryTarget\022\016\n\006parent\030\001 \001(\t\022@\n\020structured"
-  "_query\030\002 \001(\0132$.google.firestore.v1.Struc"
-  "turedQueryH\000B\014\n\nquery_typeB\r\n\013target_typ"
-  "eB\r\n\013resume_type\"\252\002\n\014TargetChange\022N\n\022tar"
-  "get_change_type\030\001 \001(\01622.google.firestore"
-  ".v1.TargetChange.TargetChangeType\022\022\n\ntar"
-  "get_ids\030\002 \003(\005\022!\n\005cause\030\003 \001(\0132\022.google.rp"
-  "c.Status\022\024\n\014resume_token\030\004 \001(\014\022-\n\tread_t"
-  "ime\030\006 \001(\0132\032.google.protobuf.Timestamp\"N\n"
-  "\020TargetChangeType\022\r\n\tNO_CHANGE\020\000\022\007\n\003ADD\020"
-  "\001\022\n\n\006REMOVE\020\002\022\013\n\007CURRENT\020\003\022\t\n\005RESET\020\004\"Q\n"
-  "\030ListCollectionIdsRequest\022\016\n\006parent\030\001 \001("
-  "\t\022\021\n\tpage_size\030\002 \001(\005\022\022\n\npage_token\030\003 \001(\t"
-  "\"L\n\031ListCollectionIdsResponse\022\026\n\016collect"
-  "ion_ids\030\001 \003(\t\022\027\n\017next_page_token\030\002 \001(\t2\204"
-  "\022\n\tFirestore\022\217\001\n\013GetDocument\022\'.google.fi"
-  "restore.v1.GetDocumentRequest\032\035.google.f"
-  "irestore.v1.Document\"8\202\323\344\223\0022\0220/v1/{name="
-  "projects/*/databases/*/documents/*/**}\022\262"
-  "\001\n\rListDocuments\022).google.firestore.v1.L"
-  "istDocumentsRequest\032*.google.firestore.v"
-  "1.ListDocumentsResponse\"J\202\323\344\223\002D\022B/v1/{pa"
-  "rent=projects/*/databases/*/documents/*/"
-  "**}/{collection_id}\022\257\001\n\016CreateDocument\022*"
-  ".google.firestore.v1.CreateDocumentReque"
-  "st\032\035.google.firestore.v1.Document\"R\202\323\344\223\002"
-  "L\"@/v1/{parent=projects/*/databases/*/do"
-  "cuments/**}/{collection_id}:\010document\022\250\001"
-  "\n\016UpdateDocument\022*.google.firestore.v1.U"
-  "pdateDocumentRequest\032\035.google.firestore."
-  "v1.Document\"K\202\323\344\223\002E29/v1/{document.name="
-  "projects/*/databases/*/documents/*/**}:\010"
-  "document\022\216\001\n\016DeleteDocument\022*.google.fir"
-  "estore.v1.DeleteDocumentRequest\032\026.google"
-  ".protobuf.Empty\"8\202\323\344\223\0022*0/v1/{name=proje"
-  "cts/*/databases/*/documents/*/**}\022\271\001\n\021Ba"
-  "tchGetDocuments\022-.google.firestore.v1.Ba"
-  "tchGetDocumentsRequest\032..google.firestor"
-  "e.v1.BatchGetDocumentsResponse\"C\202\323\344\223\002=\"8"
-  "/v1/{database=projects/*/databases/*}/do"
-  "cuments:batchGet:\001*0\001\022\274\001\n\020BeginTransacti"
-  "on\022,.google.firestore.v1.BeginTransactio"
-  "nRequest\032-.google.firestore.v1.BeginTran"
-  "sactionResponse\"K\202\323\344\223\002E\"@/v1/{database=p"
-  "rojects/*/databases/*}/documents:beginTr"
-  "ansaction:\001*\022\224\001\n\006Commit\022\".google.firesto"
-  "re.v1.CommitRequest\032#.google.firestore.v"
-  "1.CommitResponse\"A\202\323\344\223\002;\"6/v1/{database="
-  "projects/*/databases/*}/documents:commit"
-  ":\001*\022\215\001\n\010Rollback\022$.google.firestore.v1.R"
-  "ollbackRequest\032\026.google.protobuf.Empty\"C"
-  "\202\323\344\223\002=\"8/v1/{database=projects/*/databas"
-  "es/*}/documents:rollback:\001*\022\337\001\n\010RunQuery"
-  "\022$.google.firestore.v1.RunQueryRequest\032%"
-  ".google.firestore.v1.RunQueryResponse\"\203\001"
-  "\202\323\344\223\002}\"6/v1/{parent=projects/*/databases"
-  "/*/documents}:runQuery:\001*Z@\";/v1/{parent"
-  "=projects/*/databases/*/documents/*/**}:"
-  "runQuery:\001*0\001\022\224\001\n\005Write\022!.google.firesto"
-  "re.v1.WriteRequest\032\".google.firestore.v1"
-  ".WriteResponse\"@\202\323\344\223\002:\"5/v1/{database=pr"
-  "ojects/*/databases/*}/documents:write:\001*"
-  "(\0010\001\022\230\001\n\006Listen\022\".google.firestore.v1.Li"
-  "stenRequest\032#.google.firestore.v1.Listen"
-  "Response\"A\202\323\344\223\002;\"6/v1/{database=projects"
-  "/*/databases/*}/documents:listen:\001*(\0010\001\022"
-  "\213\002\n\021ListCollectionIds\022-.google.firestore"
-  ".v1.ListCollectionIdsRequest\032..google.fi"
-  "restore.v1.ListCollectionIdsResponse\"\226\001\202"
-  "\323\344\223\002\217\001\"\?/v1/{parent=projects/*/databases"
-  "/*/documents}:listCollectionIds:\001*ZI\"D/v"
+  "ector\"\235\002\n\024ListDocumentsRequest\022\016\n\006parent"
+  "\030\001 \001(\t\022\025\n\rcollection_id\030\002 \001(\t\022\021\n\tpage_si"
+  "ze\030\003 \001(\005\022\022\n\npage_token\030\004 \001(\t\022\020\n\010order_by"
+  "\030\006 \001(\t\022/\n\004mask\030\007 \001(\0132!.google.firestore."
+  "v1.DocumentMask\022\025\n\013transaction\030\010 \001(\014H\000\022/"
+  "\n\tread_time\030\n \001(\0132\032.google.protobuf.Time"
+  "stampH\000\022\024\n\014show_missing\030\014 \001(\010B\026\n\024consist"
+  "ency_selector\"b\n\025ListDocumentsResponse\0220"
+  "\n\tdocuments\030\001 \003(\0132\035.google.firestore.v1."
+  "Document\022\027\n\017next_page_token\030\002 \001(\t\"\265\001\n\025Cr"
+  "eateDocumentRequest\022\016\n\006parent\030\001 \001(\t\022\025\n\rc"
+  "ollection_id\030\002 \001(\t\022\023\n\013document_id\030\003 \001(\t\022"
+  "/\n\010document\030\004 \001(\0132\035.google.firestore.v1."
+  "Document\022/\n\004mask\030\005 \001(\0132!.google.firestor"
+  "e.v1.DocumentMask\"\356\001\n\025UpdateDocumentRequ"
+  "est\022/\n\010document\030\001 \001(\0132\035.google.firestore"
+  ".v1.Document\0226\n\013update_mask\030\002 \001(\0132!.goog"
+  "le.firestore.v1.DocumentMask\022/\n\004mask\030\003 \001"
+  "(\0132!.google.firestore.v1.DocumentMask\022;\n"
+  "\020current_document\030\004 \001(\0132!.google.firesto"
+  "re.v1.Precondition\"b\n\025DeleteDocumentRequ"
+  "est\022\014\n\004name\030\001 \001(\t\022;\n\020current_document\030\002 "
+  "\001(\0132!.google.firestore.v1.Precondition\"\224"
+  "\002\n\030BatchGetDocumentsRequest\022\020\n\010database\030"
+  "\001 \001(\t\022\021\n\tdocuments\030\002 \003(\t\022/\n\004mask\030\003 \001(\0132!"
+  ".google.firestore.v1.DocumentMask\022\025\n\013tra"
+  "nsaction\030\004 \001(\014H\000\022B\n\017new_transaction\030\005 \001("
+  "\0132\'.google.firestore.v1.TransactionOptio"
+  "nsH\000\022/\n\tread_time\030\007 \001(\0132\032.google.protobu"
+  "f.TimestampH\000B\026\n\024consistency_selector\"\254\001"
+  "\n\031BatchGetDocumentsResponse\022.\n\005found\030\001 \001"
+  "(\0132\035.google.firestore.v1.DocumentH\000\022\021\n\007m"
+  "issing\030\002 \001(\tH\000\022\023\n\013transaction\030\003 \001(\014\022-\n\tr"
+  "ead_time\030\004 \001(\0132\032.google.protobuf.Timesta"
+  "mpB\010\n\006result\"e\n\027BeginTransactionRequest\022"
+  "\020\n\010database\030\001 \001(\t\0228\n\007options\030\002 \001(\0132\'.goo"
+  "gle.firestore.v1.TransactionOptions\"/\n\030B"
+  "eginTransactionResponse\022\023\n\013transaction\030\001"
+  " \001(\014\"b\n\rCommitRequest\022\020\n\010database\030\001 \001(\t\022"
+  "*\n\006writes\030\002 \003(\0132\032.google.firestore.v1.Wr"
+  "ite\022\023\n\013transaction\030\003 \001(\014\"z\n\016CommitRespon"
+  "se\0227\n\rwrite_results\030\001 \003(\0132 .google.fires"
+  "tore.v1.WriteResult\022/\n\013commit_time\030\002 \001(\013"
+  "2\032.google.protobuf.Timestamp\"8\n\017Rollback"
+  "Request\022\020\n\010database\030\001 \001(\t\022\023\n\013transaction"
+  "\030\002 \001(\014\"\225\002\n\017RunQueryRequest\022\016\n\006parent\030\001 \001"
+  "(\t\022@\n\020structured_query\030\002 \001(\0132$.google.fi"
+  "restore.v1.StructuredQueryH\000\022\025\n\013transact"
+  "ion\030\005 \001(\014H\001\022B\n\017new_transaction\030\006 \001(\0132\'.g"
+  "oogle.firestore.v1.TransactionOptionsH\001\022"
+  "/\n\tread_time\030\007 \001(\0132\032.google.protobuf.Tim"
+  "estampH\001B\014\n\nquery_typeB\026\n\024consistency_se"
+  "lector\"\240\001\n\020RunQueryResponse\022\023\n\013transacti"
+  "on\030\002 \001(\014\022/\n\010document\030\001 \001(\0132\035.google.fire"
+  "store.v1.Document\022-\n\tread_time\030\003 \001(\0132\032.g"
+  "oogle.protobuf.Timestamp\022\027\n\017skipped_resu"
+  "lts\030\004 \001(\005\"\343\001\n\014WriteRequest\022\020\n\010database\030\001"
+  " \001(\t\022\021\n\tstream_id\030\002 \001(\t\022*\n\006writes\030\003 \003(\0132"
+  "\032.google.firestore.v1.Write\022\024\n\014stream_to"
+  "ken\030\004 \001(\014\022=\n\006labels\030\005 \003(\0132-.google.fires"
+  "tore.v1.WriteRequest.LabelsEntry\032-\n\013Labe"
+  "lsEntry\022\013\n\003key\030\001 \001(\t\022\r\n\005value\030\002 \001(\t:\0028\001\""
+  "\242\001\n\rWriteResponse\022\021\n\tstream_id\030\001 \001(\t\022\024\n\014"
+  "stream_token\030\002 \001(\014\0227\n\rwrite_results\030\003 \003("
+  "\0132 .google.firestore.v1.WriteResult\022/\n\013c"
+  "ommit_time\030\004 \001(\0132\032.google.protobuf.Times"
+  "tamp\"\355\001\n\rListenRequest\022\020\n\010database\030\001 \001(\t"
+  "\0221\n\nadd_target\030\002 \001(\0132\033.google.firestore."
+  "v1.TargetH\000\022\027\n\rremove_target\030\003 \001(\005H\000\022>\n\006"
+  "labels\030\004 \003(\0132..google.firestore.v1.Liste"
+  "nRequest.LabelsEntry\032-\n\013LabelsEntry\022\013\n\003k"
+  "ey\030\001 \001(\t\022\r\n\005value\030\002 \001(\t:\0028\001B\017\n\rtarget_ch"
+  "ange\"\325\002\n\016ListenResponse\022:\n\rtarget_change"
+  "\030\002 \001(\0132!.google.firestore.v1.TargetChang"
+  "eH\000\022>\n\017document_change\030\003 \001(\0132#.google.fi"
+  "restore.v1.DocumentChangeH\000\022>\n\017document_"
+  "delete\030\004 \001(\0132#.google.firestore.v1.Docum"
+  "entDeleteH\000\022>\n\017document_remove\030\006 \001(\0132#.g"
+  "oogle.firestore.v1.DocumentRemoveH\000\0226\n\006f"
+  "ilter\030\005 \001(\0132$.google.firestore.v1.Existe"
+  "nceFilterH\000B\017\n\rresponse_type\"\326\003\n\006Target\022"
+  "8\n\005query\030\002 \001(\0132\'.google.firestore.v1.Tar"
+  "get.QueryTargetH\000\022@\n\tdocuments\030\003 \001(\0132+.g"
+  "oogle.firestore.v1.Target.DocumentsTarge"
+  "tH\000\022\026\n\014resume_token\030\004 \001(\014H\001\022/\n\tread_time"
+  "\030\013 \001(\0132\032.google.protobuf.TimestampH\001\022\021\n\t"
+  "target_id\030\005 \001(\005\022\014\n\004once\030\006 \001(\010\0223\n\016expecte"
+  "d_count\030\014 \001(\0132\033.google.protobuf.Int32Val"
+  "ue\032$\n\017DocumentsTarget\022\021\n\tdocuments\030\002 \003(\t"
+  "\032m\n\013QueryTarget\022\016\n\006parent\030\001 \001(\t\022@\n\020struc"
+  "tured_query\030\002 \001(\0132$.google.firestore.v1."
+  "StructuredQueryH\000B\014\n\nquery_typeB\r\n\013targe"
+  "t_typeB\r\n\013resume_type\"\252\002\n\014TargetChange\022N"
+  "\n\022target_change_type\030\001 \001(\01622.google.fire"
+  "store.v1.TargetChange.TargetChangeType\022\022"
+  "\n\ntarget_ids\030\002 \003(\005\022!\n\005cause\030\003 \001(\0132\022.goog"
+  "le.rpc.Status\022\024\n\014resume_token\030\004 \001(\014\022-\n\tr"
+  "ead_time\030\006 \001(\0132\032.google.protobuf.Timesta"
+  "mp\"N\n\020TargetChangeType\022\r\n\tNO_CHANGE\020\000\022\007\n"
+  "\003ADD\020\001\022\n\n\006REMOVE\020\002\022\013\n\007CURRENT\020\003\022\t\n\005RESET"
+  "\020\004\"Q\n\030ListCollectionIdsRequest\022\016\n\006parent"
+  "\030\001 \001(\t\022\021\n\tpage_size\030\002 \001(\005\022\022\n\npage_token\030"
+  "\003 \001(\t\"L\n\031ListCollectionIdsResponse\022\026\n\016co"
+  "llection_ids\030\001 \003(\t\022\027\n\017next_page_token\030\002 "
+  "\001(\t2\204\022\n\tFirestore\022\217\001\n\013GetDocument\022\'.goog"
+  "le.firestore.v1.GetDocumentRequest\032\035.goo"
+  "gle.firestore.v1.Document\"8\202\323\344\223\0022\0220/v1/{"
+  "name=projects/*/databases/*/documents/*/"
+  "**}\022\262\001\n\rListDocuments\022).google.firestore"
+  ".v1.ListDocumentsRequest\032*.google.firest"
+  "ore.v1.ListDocumentsResponse\"J\202\323\344\223\002D\022B/v"
   "1/{parent=projects/*/databases/*/documen"
-  "ts/*/**}:listCollectionIds:\001*B\262\001\n\027com.go"
-  "ogle.firestore.v1B\016FirestoreProtoP\001Z<goo"
-  "gle.golang.org/genproto/googleapis/fires"
-  "tore/v1;firestore\242\002\004GCFS\252\002\036Google.Cloud."
-  "Firestore.V1Beta1\312\002\036Google\\Cloud\\Firesto"
-  "re\\V1beta1b\006proto3"
+  "ts/*/**}/{collection_id}\022\257\001\n\016CreateDocum"
+  "ent\022*.google.firestore.v1.CreateDocument"
+  "Request\032\035.google.firestore.v1.Document\"R"
+  "\202\323\344\223\002L\"@/v1/{parent=projects/*/databases"
+  "/*/documents/**}/{collection_id}:\010docume"
+  "nt\022\250\001\n\016UpdateDocument\022*.google.firestore"
+  ".v1.UpdateDocumentRequest\032\035.google.fires"
+  "tore.v1.Document\"K\202\323\344\223\002E29/v1/{document."
+  "name=projects/*/databases/*/documents/*/"
+  "**}:\010document\022\216\001\n\016DeleteDocument\022*.googl"
+  "e.firestore.v1.DeleteDocumentRequest\032\026.g"
+  "oogle.protobuf.Empty\"8\202\323\344\223\0022*0/v1/{name="
+  "projects/*/databases/*/documents/*/**}\022\271"
+  "\001\n\021BatchGetDocuments\022-.google.firestore."
+  "v1.BatchGetDocumentsRequest\032..google.fir"
+  "estore.v1.BatchGetDocumentsResponse\"C\202\323\344"
+  "\223\002=\"8/v1/{database=projects/*/databases/"
+  "*}/documents:batchGet:\001*0\001\022\274\001\n\020BeginTran"
+  "saction\022,.google.firestore.v1.BeginTrans"
+  "actionRequest\032-.google.firestore.v1.Begi"
+  "nTransactionResponse\"K\202\323\344\223\002E\"@/v1/{datab"
+  "ase=projects/*/databases/*}/documents:be"
+  "ginTransaction:\001*\022\224\001\n\006Commit\022\".google.fi"
+  "restore.v1.CommitRequest\032#.google.firest"
+  "ore.v1.CommitResponse\"A\202\323\344\223\002;\"6/v1/{data"
+  "base=projects/*/databases/*}/documents:c"
+  "ommit:\001*\022\215\001\n\010Rollback\022$.google.firestore"
+  ".v1.RollbackRequest\032\026.google.protobuf.Em"
+  "pty\"C\202\323\344\223\002=\"8/v1/{database=projects/*/da"
+  "tabases/*}/documents:rollback:\001*\022\337\001\n\010Run"
+  "Query\022$.google.firestore.v1.RunQueryRequ"
+  "est\032%.google.firestore.v1.RunQueryRespon"
+  "se\"\203\001\202\323\344\223\002}\"6/v1/{parent=projects/*/data"
+  "bases/*/documents}:runQuery:\001*Z@\";/v1/{p"
+  "arent=projects/*/databases/*/documents/*"
+  "/**}:runQuery:\001*0\001\022\224\001\n\005Write\022!.google.fi"
+  "restore.v1.WriteRequest\032\".google.firesto"
+  "re.v1.WriteResponse\"@\202\323\344\223\002:\"5/v1/{databa"
+  "se=projects/*/databases/*}/documents:wri"
+  "te:\001*(\0010\001\022\230\001\n\006Listen\022\".google.firestore."
+  "v1.ListenRequest\032#.google.firestore.v1.L"
+  "istenResponse\"A\202\323\344\223\002;\"6/v1/{database=pro"
+  "jects/*/databases/*}/documents:listen:\001*"
+  "(\0010\001\022\213\002\n\021ListCollectionIds\022-.google.fire"
+  "store.v1.ListCollectionIdsRequest\032..goog"
+  "le.firestore.v1.ListCollectionIdsRespons"
+  "e\"\226\001\202\323\344\223\002\217\001\"\?/v1/{parent=projects/*/data"
+  "bases/*/documents}:listCollectionIds:\001*Z"
+  "I\"D/v1/{parent=projects/*/databases/*/do"
+  "cuments/*/**}:listCollectionIds:\001*B\262\001\n\027c"
+  "om.google.firestore.v1B\016FirestoreProtoP\001"
+  "Z<google.golang.org/genproto/googleapis/"
+  "firestore/v1;firestore\242\002\004GCFS\252\002\036Google.C"
+  "loud.Firestore.V1Beta1\312\002\036Google\\Cloud\\Fi"
+  "restore\\V1beta1b\006proto3"
   ;
-static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_deps[8] = {
+static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_deps[9] = {
   &::descriptor_table_google_2fapi_2fannotations_2eproto,
   &::descriptor_table_google_2ffirestore_2fv1_2fcommon_2eproto,
   &::descriptor_table_google_2ffirestore_2fv1_2fdocument_2eproto,
@@ -1106,6 +1111,7 @@ static const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable*const descriptor
   &::descriptor_table_google_2ffirestore_2fv1_2fwrite_2eproto,
   &::descriptor_table_google_2fprotobuf_2fempty_2eproto,
   &::descriptor_table_google_2fprotobuf_2ftimestamp_2eproto,
+  &::descriptor_table_google_2fprotobuf_2fwrappers_2eproto,
   &::descriptor_table_google_2frpc_2fstatus_2eproto,
 };
 static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_sccs[27] = {
@@ -1140,8 +1146,8 @@ static ::PROTOBUF_NAMESPACE_ID::internal::SCCInfoBase*const descriptor_table_goo
 static ::PROTOBUF_NAMESPACE_ID::internal::once_flag descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_once;
 static bool descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_initialized = false;
 const ::PROTOBUF_NAMESPACE_ID::internal::DescriptorTable descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto = {
-  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_initialized, descriptor_table_protodef_google_2ffirestore_2fv1_2ffirestore_2eproto, "google/firestore/v1/firestore.proto", 7098,
-  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_once, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_sccs, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_deps, 27, 8,
+  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_initialized, descriptor_table_protodef_google_2ffirestore_2fv1_2ffirestore_2eproto, "google/firestore/v1/firestore.proto", 7183,
+  &descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_once, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_sccs, descriptor_table_google_2ffirestore_2fv1_2ffirestore_2eproto_deps, 27, 9,
   schemas, file_default_instances, TableStruct_google_2ffirestore_2fv1_2ffirestore_2eproto::offsets,
   file_level_metadata_google_2ffirestore_2fv1_2ffirestore_2eproto, 27, file_level_enum_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto, file_level_service_descriptors_google_2ffirestore_2fv1_2ffirestore_2eproto,
 };
@@ -8290,12 +8296,15 @@ void Target::InitAsDefaultInstance() {
       &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
   ::google::firestore::v1::_Target_default_instance_.read_time_ = const_cast< PROTOBUF_NAMESPACE_ID::Timestamp*>(
       PROTOBUF_NAMESPACE_ID::Timestamp::internal_default_instance());
+  ::google::firestore::v1::_Target_default_instance_._instance.get_mutable()->expected_count_ = const_cast< PROTOBUF_NAMESPACE_ID::Int32Value*>(
+      PROTOBUF_NAMESPACE_ID::Int32Value::internal_default_instance());
 }
 class Target::_Internal {
  public:
   static const ::google::firestore::v1::Target_QueryTarget& query(const Target* msg);
   static const ::google::firestore::v1::Target_DocumentsTarget& documents(const Target* msg);
   static const PROTOBUF_NAMESPACE_ID::Timestamp& read_time(const Target* msg);
+  static const PROTOBUF_NAMESPACE_ID::Int32Value& expected_count(const Target* msg);
 };
 
 const ::google::firestore::v1::Target_QueryTarget&
@@ -8310,6 +8319,10 @@ const PROTOBUF_NAMESPACE_ID::Timestamp&
 Target::_Internal::read_time(const Target* msg) {
   return *msg->resume_type_.read_time_;
 }
+const PROTOBUF_NAMESPACE_ID::Int32Value&
+Target::_Internal::expected_count(const Target* msg) {
+  return *msg->expected_count_;
+}
 void Target::set_allocated_query(::google::firestore::v1::Target_QueryTarget* query) {
   ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaNoVirtual();
   clear_target_type();
@@ -8359,6 +8372,12 @@ void Target::clear_read_time() {
     clear_has_resume_type();
   }
 }
+void Target::clear_expected_count() {
+  if (GetArenaNoVirtual() == nullptr && expected_count_ != nullptr) {
+    delete expected_count_;
+  }
+  expected_count_ = nullptr;
+}
 Target::Target()
   : ::PROTOBUF_NAMESPACE_ID::Message(), _internal_metadata_(nullptr) {
   SharedCtor();
@@ -8368,6 +8387,11 @@ Target::Target(const Target& from)
   : ::PROTOBUF_NAMESPACE_ID::Message(),
       _internal_metadata_(nullptr) {
   _internal_metadata_.MergeFrom(from._internal_metadata_);
+  if (from._internal_has_expected_count()) {
+    expected_count_ = new PROTOBUF_NAMESPACE_ID::Int32Value(*from.expected_count_);
+  } else {
+    expected_count_ = nullptr;
+  }
   ::memcpy(&target_id_, &from.target_id_,
     static_cast<size_t>(reinterpret_cast<char*>(&once_) -
     reinterpret_cast<char*>(&target_id_)) + sizeof(once_));
@@ -8404,9 +8428,9 @@ Target::Target(const Target& from)
 
 void Target::SharedCtor() {
   ::PROTOBUF_NAMESPACE_ID::internal::InitSCC(&scc_info_Target_google_2ffirestore_2fv1_2ffirestore_2eproto.base);
-  ::memset(&target_id_, 0, static_cast<size_t>(
+  ::memset(&expected_count_, 0, static_cast<size_t>(
       reinterpret_cast<char*>(&once_) -
-      reinterpret_cast<char*>(&target_id_)) + sizeof(once_));
+      reinterpret_cast<char*>(&expected_count_)) + sizeof(once_));
   clear_has_target_type();
   clear_has_resume_type();
 }
@@ -8417,6 +8441,7 @@ Target::~Target() {
 }
 
 void Target::SharedDtor() {
+  if (this != internal_default_instance()) delete expected_count_;
   if (has_target_type()) {
     clear_target_type();
   }
@@ -8477,6 +8502,10 @@ void Target::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  if (GetArenaNoVirtual() == nullptr && expected_count_ != nullptr) {
+    delete expected_count_;
+  }
+  expected_count_ = nullptr;
   ::memset(&target_id_, 0, static_cast<size_t>(
       reinterpret_cast<char*>(&once_) -
       reinterpret_cast<char*>(&target_id_)) + sizeof(once_));
@@ -8535,6 +8564,13 @@ const char* Target::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::int
           CHK_(ptr);
         } else goto handle_unusual;
         continue;
+      // .google.protobuf.Int32Value expected_count = 12;
+      case 12:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<::PROTOBUF_NAMESPACE_ID::uint8>(tag) == 98)) {
+          ptr = ctx->ParseMessage(_internal_mutable_expected_count(), ptr);
+          CHK_(ptr);
+        } else goto handle_unusual;
+        continue;
       default: {
       handle_unusual:
         if ((tag & 7) == 4 || tag == 0) {
@@ -8603,6 +8639,14 @@ failure:
         11, _Internal::read_time(this), target, stream);
   }
 
+  // .google.protobuf.Int32Value expected_count = 12;
+  if (this->has_expected_count()) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        12, _Internal::expected_count(this), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormat::InternalSerializeUnknownFieldsToArray(
         _internal_metadata_.unknown_fields(), target, stream);
@@ -8619,6 +8663,13 @@ size_t Target::ByteSizeLong() const {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  // .google.protobuf.Int32Value expected_count = 12;
+  if (this->has_expected_count()) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+        *expected_count_);
+  }
+
   // int32 target_id = 5;
   if (this->target_id() != 0) {
     total_size += 1 +
@@ -8700,6 +8751,9 @@ void Target::MergeFrom(const Target& from) {
   ::PROTOBUF_NAMESPACE_ID::uint32 cached_has_bits = 0;
   (void) cached_has_bits;
 
+  if (from.has_expected_count()) {
+    _internal_mutable_expected_count()->PROTOBUF_NAMESPACE_ID::Int32Value::MergeFrom(from._internal_expected_count());
+  }
   if (from.target_id() != 0) {
     _internal_set_target_id(from._internal_target_id());
   }
@@ -8755,6 +8809,7 @@ bool Target::IsInitialized() const {
 void Target::InternalSwap(Target* other) {
   using std::swap;
   _internal_metadata_.Swap(&other->_internal_metadata_);
+  swap(expected_count_, other->expected_count_);
   swap(target_id_, other->target_id_);
   swap(once_, other->once_);
   swap(target_type_, other->target_type_);
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/* Automatically generated nanopb header */
+/* Generated by nanopb-0.3.9.8 */
+
+#ifndef PB_GOOGLE_FIRESTORE_V1_BLOOM_FILTER_NANOPB_H_INCLUDED
+#define PB_GOOGLE_FIRESTORE_V1_BLOOM_FILTER_NANOPB_H_INCLUDED
+#include <pb.h>
+
+#include <string>
+
+namespace firebase {
+namespace firestore {
+
+/* @@protoc_insertion_point(includes) */
+#if PB_PROTO_HEADER_VERSION != 30
+#error Regenerate this file with the current version of nanopb generator.
+#endif
+
+
+/* Struct definitions */
+typedef struct _google_firestore_v1_BitSequence {
+    pb_bytes_array_t *bitmap;
+    int32_t padding;
+
+    std::string ToString(int indent = 0) const;
+/* @@protoc_insertion_point(struct:google_firestore_v1_BitSequence) */
+} google_firestore_v1_BitSequence;
+
+typedef struct _google_firestore_v1_BloomFilter {
+    google_firestore_v1_BitSequence bits;
+    int32_t hash_count;
+
+    std::string ToString(int indent = 0) const;
+/* @@protoc_insertion_point(struct:google_firestore_v1_BloomFilter) */
+} google_firestore_v1_BloomFilter;
+
+/* Default values for struct fields */
+
+/* Initializer values for message structs */
+#define google_firestore_v1_BitSequence_init_default {NULL, 0}
+#define google_firestore_v1_BloomFilter_init_default {google_firestore_v1_BitSequence_init_default, 0}
+#define google_firestore_v1_BitSequence_init_zero {NULL, 0}
+#define google_firestore_v1_BloomFilter_init_zero {google_firestore_v1_BitSequence_init_zero, 0}
+
+/* Field tags (for use in manual encoding/decoding) */
+#define google_firestore_v1_BitSequence_bitmap_tag 1
+#define google_firestore_v1_BitSequence_padding_tag 2
+#define google_firestore_v1_BloomFilter_bits_tag 1
+#define google_firestore_v1_BloomFilter_hash_count_tag 2
+
+/* Struct field encoding specification for nanopb */
+extern const pb_field_t google_firestore_v1_BitSequence_fields[3];
+extern const pb_field_t google_firestore_v1_BloomFilter_fields[3];
+
+/* Maximum encoded size of messages (where known) */
+/* google_firestore_v1_BitSequence_size depends on runtime parameters */
+/* google_firestore_v1_BloomFilter_size depends on runtime parameters */
+
+/* Message IDs (where set with "msgid" option) */
+#ifdef PB_MSGID
+
+#define BLOOM_FILTER_MESSAGES \
+
+
+#endif
+
+}  // namespace firestore
+}  // namespace firebase
+
+/* @@protoc_insertion_point(eof) */
+
+#endif
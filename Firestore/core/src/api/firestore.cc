@@ -180,25 +180,26 @@ void Firestore::WaitForPendingWrites(util::StatusCallback callback) {
 }
 
 void Firestore::ClearPersistence(util::StatusCallback callback) {
-  worker_queue()->EnqueueEvenWhileRestricted([this, callback] {
-    auto MaybeCallback = [=](Status status) {
-      if (callback) {
-        user_executor_->Execute([=] { callback(status); });
-      }
-    };
-
-    {
-      std::lock_guard<std::mutex> lock{mutex_};
-      if (client_ && !client_->is_terminated()) {
-        MaybeCallback(util::Status(
-            Error::kErrorFailedPrecondition,
-            "Persistence cannot be cleared while the client is running."));
-        return;
-      }
-    }
-
-    MaybeCallback(LevelDbPersistence::ClearPersistence(MakeDatabaseInfo()));
-  });
+  worker_queue()->EnqueueEvenWhileRestricted(
+      "Firestore::ClearPersistence", [this, callback] {
+        auto MaybeCallback = [=](Status status) {
+          if (callback) {
+            user_executor_->Execute([=] { callback(status); });
+          }
+        };
+
+        {
+          std::lock_guard<std::mutex> lock{mutex_};
+          if (client_ && !client_->is_terminated()) {
+            MaybeCallback(util::Status(
+                Error::kErrorFailedPrecondition,
+                "Persistence cannot be cleared while the client is running."));
+            return;
+          }
+        }
+
+        MaybeCallback(LevelDbPersistence::ClearPersistence(MakeDatabaseInfo()));
+      });
 }
 
 void Firestore::EnableNetwork(util::StatusCallback callback) {
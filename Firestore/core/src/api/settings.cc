@@ -27,16 +27,53 @@ constexpr bool Settings::DefaultSslEnabled;
 constexpr bool Settings::DefaultPersistenceEnabled;
 constexpr int64_t Settings::DefaultCacheSizeBytes;
 constexpr int64_t Settings::MinimumCacheSizeBytes;
+constexpr uint32_t Settings::BundleChunkSizeUnlimited;
+constexpr int64_t Settings::WatchCoalescingDisabled;
+constexpr int64_t Settings::DefaultLevelDbBlockCacheSizeBytes;
+constexpr int Settings::DefaultLevelDbBloomFilterBitsPerKey;
+constexpr int64_t Settings::DefaultLevelDbWriteBufferSizeBytes;
+constexpr int64_t Settings::DefaultLevelDbMaxFileSizeBytes;
+constexpr bool Settings::DefaultLevelDbCompressionEnabled;
+constexpr int Settings::DefaultMaxPendingWrites;
+constexpr int Settings::WriteCoalescingDisabled;
+constexpr int Settings::DefaultLimboResolutionBatchSize;
+constexpr int Settings::DefaultIndexBackfillMaxDocuments;
 
 size_t Settings::Hash() const {
   return util::Hash(host_, ssl_enabled_, persistence_enabled_,
-                    cache_size_bytes_);
+                    cache_size_bytes_, bundle_chunk_size_,
+                    watch_coalescing_window_ms_,
+                    leveldb_block_cache_size_bytes_,
+                    leveldb_bloom_filter_bits_per_key_,
+                    leveldb_write_buffer_size_bytes_,
+                    leveldb_max_file_size_bytes_, leveldb_compression_enabled_,
+                    max_pending_writes_, write_coalescing_max_mutations_,
+                    limbo_resolution_batch_size_,
+                    index_backfill_max_documents_);
 }
 
 bool operator==(const Settings& lhs, const Settings& rhs) {
   return lhs.host_ == rhs.host_ && lhs.ssl_enabled_ == rhs.ssl_enabled_ &&
          lhs.persistence_enabled_ == rhs.persistence_enabled_ &&
-         lhs.cache_size_bytes_ == rhs.cache_size_bytes_;
+         lhs.cache_size_bytes_ == rhs.cache_size_bytes_ &&
+         lhs.bundle_chunk_size_ == rhs.bundle_chunk_size_ &&
+         lhs.watch_coalescing_window_ms_ == rhs.watch_coalescing_window_ms_ &&
+         lhs.leveldb_block_cache_size_bytes_ ==
+             rhs.leveldb_block_cache_size_bytes_ &&
+         lhs.leveldb_bloom_filter_bits_per_key_ ==
+             rhs.leveldb_bloom_filter_bits_per_key_ &&
+         lhs.leveldb_write_buffer_size_bytes_ ==
+             rhs.leveldb_write_buffer_size_bytes_ &&
+         lhs.leveldb_max_file_size_bytes_ ==
+             rhs.leveldb_max_file_size_bytes_ &&
+         lhs.leveldb_compression_enabled_ == rhs.leveldb_compression_enabled_ &&
+         lhs.max_pending_writes_ == rhs.max_pending_writes_ &&
+         lhs.write_coalescing_max_mutations_ ==
+             rhs.write_coalescing_max_mutations_ &&
+         lhs.limbo_resolution_batch_size_ ==
+             rhs.limbo_resolution_batch_size_ &&
+         lhs.index_backfill_max_documents_ ==
+             rhs.index_backfill_max_documents_;
 }
 
 }  // namespace api
@@ -40,6 +40,17 @@ class Settings {
   static constexpr int64_t DefaultCacheSizeBytes = 100 * 1024 * 1024;
   static constexpr int64_t MinimumCacheSizeBytes = 1 * 1024 * 1024;
   static constexpr int64_t CacheSizeUnlimited = -1;
+  static constexpr uint32_t BundleChunkSizeUnlimited = 0;
+  static constexpr int64_t WatchCoalescingDisabled = 0;
+  static constexpr int64_t DefaultLevelDbBlockCacheSizeBytes = 8 * 1024 * 1024;
+  static constexpr int DefaultLevelDbBloomFilterBitsPerKey = 10;
+  static constexpr int64_t DefaultLevelDbWriteBufferSizeBytes = 4 * 1024 * 1024;
+  static constexpr int64_t DefaultLevelDbMaxFileSizeBytes = 2 * 1024 * 1024;
+  static constexpr bool DefaultLevelDbCompressionEnabled = true;
+  static constexpr int DefaultMaxPendingWrites = 10;
+  static constexpr int WriteCoalescingDisabled = 0;
+  static constexpr int DefaultLimboResolutionBatchSize = 1;
+  static constexpr int DefaultIndexBackfillMaxDocuments = 50;
 
   Settings() = default;
 
@@ -74,6 +85,133 @@ class Settings {
     return cache_size_bytes_ != CacheSizeUnlimited;
   }
 
+  /**
+   * Sets the number of documents that are committed per transaction when
+   * loading a bundle. Loads that commit documents in chunks keep less of the
+   * bundle in memory and can resume after being interrupted.
+   * `BundleChunkSizeUnlimited` commits all documents of a bundle at once.
+   */
+  void set_bundle_chunk_size(uint32_t value) {
+    bundle_chunk_size_ = value;
+  }
+  uint32_t bundle_chunk_size() const {
+    return bundle_chunk_size_;
+  }
+
+  /**
+   * Sets how long, in milliseconds, consistent watch snapshots may be held
+   * back so that they can be applied to the local store together. This bounds
+   * the latency added to each snapshot. `WatchCoalescingDisabled` applies
+   * every snapshot as soon as it arrives.
+   */
+  void set_watch_coalescing_window_ms(int64_t value) {
+    watch_coalescing_window_ms_ = value;
+  }
+  int64_t watch_coalescing_window_ms() const {
+    return watch_coalescing_window_ms_;
+  }
+
+  /**
+   * Sets the size of LevelDB's cache of uncompressed blocks. Databases that
+   * are larger than the cache read most blocks from disk.
+   */
+  void set_leveldb_block_cache_size_bytes(int64_t value) {
+    leveldb_block_cache_size_bytes_ = value;
+  }
+  int64_t leveldb_block_cache_size_bytes() const {
+    return leveldb_block_cache_size_bytes_;
+  }
+
+  /**
+   * Sets the number of bits per key of the bloom filters that LevelDB keeps
+   * for each table, which let point lookups skip tables that do not contain
+   * the key. Zero disables the filters. Tables only get filters once they are
+   * rewritten after the setting changes.
+   */
+  void set_leveldb_bloom_filter_bits_per_key(int value) {
+    leveldb_bloom_filter_bits_per_key_ = value;
+  }
+  int leveldb_bloom_filter_bits_per_key() const {
+    return leveldb_bloom_filter_bits_per_key_;
+  }
+
+  /**
+   * Sets how many bytes of writes LevelDB buffers in memory before it writes
+   * them to a sorted table on disk.
+   */
+  void set_leveldb_write_buffer_size_bytes(int64_t value) {
+    leveldb_write_buffer_size_bytes_ = value;
+  }
+  int64_t leveldb_write_buffer_size_bytes() const {
+    return leveldb_write_buffer_size_bytes_;
+  }
+
+  /** Sets the size at which LevelDB starts a new sorted table file. */
+  void set_leveldb_max_file_size_bytes(int64_t value) {
+    leveldb_max_file_size_bytes_ = value;
+  }
+  int64_t leveldb_max_file_size_bytes() const {
+    return leveldb_max_file_size_bytes_;
+  }
+
+  /** Sets whether LevelDB compresses its blocks with Snappy. */
+  void set_leveldb_compression_enabled(bool value) {
+    leveldb_compression_enabled_ = value;
+  }
+  bool leveldb_compression_enabled() const {
+    return leveldb_compression_enabled_;
+  }
+
+  /**
+   * Sets how many writes may be sent to the backend before the first of them
+   * is acknowledged. Up to `DefaultMaxPendingWrites` writes are always kept in
+   * flight; a larger limit is only reached while the backend acknowledges
+   * writes as fast as they are sent. Values below 1 are treated as 1.
+   */
+  void set_max_pending_writes(int value) {
+    max_pending_writes_ = value;
+  }
+  int max_pending_writes() const {
+    return max_pending_writes_;
+  }
+
+  /**
+   * Sets how many mutations adjacent pending batches may add up to when they
+   * are sent to the backend in one request. Batches sent together are
+   * committed together. `WriteCoalescingDisabled` sends each batch on its
+   * own.
+   */
+  void set_write_coalescing_max_mutations(int value) {
+    write_coalescing_max_mutations_ = value;
+  }
+  int write_coalescing_max_mutations() const {
+    return write_coalescing_max_mutations_;
+  }
+
+  /**
+   * Sets how many documents in limbo may be resolved by a single listen.
+   * Larger batches resolve many documents with few targets, for example after
+   * a query's results were reset because they didn't match the backend's.
+   */
+  void set_limbo_resolution_batch_size(int value) {
+    limbo_resolution_batch_size_ = value;
+  }
+  int limbo_resolution_batch_size() const {
+    return limbo_resolution_batch_size_;
+  }
+
+  /**
+   * Sets how many documents each periodic index backfill run may index. Runs
+   * with larger budgets catch up with new indexes sooner, but block the worker
+   * queue for longer. Values below 1 are treated as 1.
+   */
+  void set_index_backfill_max_documents(int value) {
+    index_backfill_max_documents_ = value;
+  }
+  int index_backfill_max_documents() const {
+    return index_backfill_max_documents_;
+  }
+
   friend bool operator==(const Settings& lhs, const Settings& rhs);
 
   size_t Hash() const;
@@ -83,6 +221,17 @@ class Settings {
   bool ssl_enabled_ = DefaultSslEnabled;
   bool persistence_enabled_ = DefaultPersistenceEnabled;
   int64_t cache_size_bytes_ = DefaultCacheSizeBytes;
+  uint32_t bundle_chunk_size_ = BundleChunkSizeUnlimited;
+  int64_t watch_coalescing_window_ms_ = WatchCoalescingDisabled;
+  int64_t leveldb_block_cache_size_bytes_ = DefaultLevelDbBlockCacheSizeBytes;
+  int leveldb_bloom_filter_bits_per_key_ = DefaultLevelDbBloomFilterBitsPerKey;
+  int64_t leveldb_write_buffer_size_bytes_ = DefaultLevelDbWriteBufferSizeBytes;
+  int64_t leveldb_max_file_size_bytes_ = DefaultLevelDbMaxFileSizeBytes;
+  bool leveldb_compression_enabled_ = DefaultLevelDbCompressionEnabled;
+  int max_pending_writes_ = DefaultMaxPendingWrites;
+  int write_coalescing_max_mutations_ = WriteCoalescingDisabled;
+  int limbo_resolution_batch_size_ = DefaultLimboResolutionBatchSize;
+  int index_backfill_max_documents_ = DefaultIndexBackfillMaxDocuments;
 };
 
 }  // namespace api
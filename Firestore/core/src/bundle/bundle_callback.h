@@ -18,6 +18,7 @@
 
 #include <string>
 
+#include "Firestore/core/src/bundle/bundle_load_checkpoint.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/named_query.h"
 
@@ -44,11 +45,26 @@ class BundleCallback {
       const model::MutableDocumentMap& documents,
       const std::string& bundle_id) = 0;
 
+  /**
+   * Applies a chunk of the documents from a bundle to the "ground-state"
+   * (remote) documents and saves `checkpoint` in the same transaction, such
+   * that an interrupted load can resume after the chunk.
+   *
+   * Unlike `ApplyBundledDocuments`, documents applied by earlier chunks of the
+   * same bundle load remain associated with the bundle.
+   */
+  virtual model::DocumentMap ApplyBundledDocumentChunk(
+      const model::MutableDocumentMap& documents,
+      const BundleLoadCheckpoint& checkpoint) = 0;
+
   /** Saves the given NamedQuery to local persistence. */
   virtual void SaveNamedQuery(const NamedQuery& query,
                               const model::DocumentKeySet& keys) = 0;
 
-  /** Saves the given BundleMetadata to local persistence. */
+  /**
+   * Saves the given BundleMetadata to local persistence, completing any
+   * chunked load of the bundle.
+   */
   virtual void SaveBundle(const BundleMetadata& metadata) = 0;
 };
 
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_BUNDLE_BUNDLE_LOAD_CHECKPOINT_H_
+#define FIRESTORE_CORE_SRC_BUNDLE_BUNDLE_LOAD_CHECKPOINT_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "Firestore/core/src/bundle/bundle_metadata.h"
+#include "Firestore/core/src/model/snapshot_version.h"
+
+namespace firebase {
+namespace firestore {
+namespace bundle {
+
+/**
+ * Records how much of a bundle has been committed to local storage by a
+ * bundle load that applies documents in chunks. It is saved together with
+ * every chunk, such that an interrupted load can skip the documents that have
+ * already been committed.
+ */
+class BundleLoadCheckpoint {
+ public:
+  BundleLoadCheckpoint() = default;
+
+  BundleLoadCheckpoint(std::string bundle_id,
+                       model::SnapshotVersion create_time,
+                       uint32_t documents_loaded,
+                       uint64_t bytes_loaded)
+      : bundle_id_(std::move(bundle_id)),
+        create_time_(create_time),
+        documents_loaded_(documents_loaded),
+        bytes_loaded_(bytes_loaded) {
+  }
+
+  /** @return The ID of the bundle that is being loaded. */
+  const std::string& bundle_id() const {
+    return bundle_id_;
+  }
+
+  /** @return The create time of the bundle that is being loaded. */
+  model::SnapshotVersion create_time() const {
+    return create_time_;
+  }
+
+  /** @return The number of documents that have been committed. */
+  uint32_t documents_loaded() const {
+    return documents_loaded_;
+  }
+
+  /**
+   * @return The number of bytes of the bundle that had been read when the
+   * last chunk was committed.
+   */
+  uint64_t bytes_loaded() const {
+    return bytes_loaded_;
+  }
+
+  /** @return Whether this checkpoint was saved while loading `metadata`. */
+  bool IsFor(const BundleMetadata& metadata) const {
+    return bundle_id_ == metadata.bundle_id() &&
+           create_time_ == metadata.create_time();
+  }
+
+ private:
+  std::string bundle_id_;
+  model::SnapshotVersion create_time_;
+  uint32_t documents_loaded_ = 0;
+  uint64_t bytes_loaded_ = 0;
+};
+
+inline bool operator==(const BundleLoadCheckpoint& lhs,
+                       const BundleLoadCheckpoint& rhs) {
+  return lhs.bundle_id() == rhs.bundle_id() &&
+         lhs.create_time() == rhs.create_time() &&
+         lhs.documents_loaded() == rhs.documents_loaded() &&
+         lhs.bytes_loaded() == rhs.bytes_loaded();
+}
+
+inline bool operator!=(const BundleLoadCheckpoint& lhs,
+                       const BundleLoadCheckpoint& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace bundle
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_BUNDLE_BUNDLE_LOAD_CHECKPOINT_H_
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <unordered_map>
+#include <utility>
 
 #include "Firestore/core/include/firebase/firestore/firestore_errors.h"
 #include "Firestore/core/src/api/load_bundle_task.h"
@@ -27,6 +28,7 @@
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/util/hard_assert.h"
 
 namespace firebase {
 namespace firestore {
@@ -38,9 +40,27 @@ using firestore::api::LoadBundleTaskState;
 using model::DocumentKeySet;
 using model::DocumentMap;
 using model::MutableDocument;
+using model::MutableDocumentMap;
 using util::Status;
 using util::StatusOr;
 
+BundleLoader::BundleLoader(BundleCallback* callback,
+                           BundleMetadata metadata,
+                           uint32_t documents_per_chunk,
+                           absl::optional<BundleLoadCheckpoint> checkpoint)
+    : callback_(callback),
+      metadata_(std::move(metadata)),
+      documents_per_chunk_(documents_per_chunk) {
+  if (checkpoint.has_value()) {
+    HARD_ASSERT(loads_in_chunks(),
+                "Only bundles loaded in chunks can resume from a checkpoint.");
+    HARD_ASSERT(checkpoint->IsFor(metadata_),
+                "Checkpoint of bundle %s does not match the loaded bundle.",
+                checkpoint->bundle_id());
+    documents_to_skip_ = checkpoint->documents_loaded();
+  }
+}
+
 Status BundleLoader::AddElementInternal(const BundleElement& element) {
   HARD_ASSERT(element.element_type() != BundleElement::Type::Metadata,
               "Unexpected bundle metadata element.");
@@ -54,14 +74,22 @@ Status BundleLoader::AddElementInternal(const BundleElement& element) {
     case BundleElement::Type::DocumentMetadata: {
       const auto& document_metadata =
           static_cast<const BundledDocumentMetadata&>(element);
-      current_document_ = document_metadata.key();
-      documents_metadata_.emplace(document_metadata.key(), document_metadata);
+      for (const auto& query : document_metadata.queries()) {
+        auto inserted = query_documents_[query].insert(document_metadata.key());
+        query_documents_[query] = std::move(inserted);
+      }
+
+      if (documents_loaded_ < documents_to_skip_) {
+        // The document was committed before the load was interrupted, and the
+        // reader skips its contents (see `BundleReader::SkipDocumentsUntil`).
+        ++documents_loaded_;
+        break;
+      }
 
+      current_document_ = document_metadata.key();
       if (!document_metadata.exists()) {
-        documents_ = documents_.insert(
-            document_metadata.key(),
-            MutableDocument::NoDocument(document_metadata.key(),
-                                        document_metadata.read_time()));
+        AddDocument(MutableDocument::NoDocument(document_metadata.key(),
+                                                document_metadata.read_time()));
         current_document_ = absl::nullopt;
       }
       break;
@@ -76,7 +104,7 @@ Status BundleLoader::AddElementInternal(const BundleElement& element) {
             "The document being added does not match the stored metadata.")};
       }
 
-      documents_ = documents_.insert(document.key(), document.document());
+      AddDocument(document.document());
       current_document_ = absl::nullopt;
       break;
     }
@@ -90,12 +118,17 @@ Status BundleLoader::AddElementInternal(const BundleElement& element) {
   return Status::OK();
 }
 
+void BundleLoader::AddDocument(MutableDocument document) {
+  ++documents_loaded_;
+  documents_ = documents_.insert(document.key(), std::move(document));
+}
+
 StatusOr<absl::optional<LoadBundleTaskProgress>> BundleLoader::AddElement(
     std::unique_ptr<BundleElement> element_ptr, uint64_t byte_size) {
   HARD_ASSERT(element_ptr->element_type() != BundleElement::Type::Metadata,
               "Unexpected bundle metadata element.");
 
-  auto before_count = documents_.size();
+  auto before_count = documents_loaded_;
 
   auto result = AddElementInternal(*element_ptr);
   if (!result.ok()) {
@@ -105,16 +138,42 @@ StatusOr<absl::optional<LoadBundleTaskProgress>> BundleLoader::AddElement(
   bytes_loaded_ += byte_size;
 
   // Document has only been partially loaded, no progress to report.
-  if (before_count == documents_.size()) {
+  if (before_count == documents_loaded_) {
     return {absl::nullopt};
   }
 
+  if (loads_in_chunks()) {
+    // Progress is reported once the documents have been committed.
+    if (documents_.size() < documents_per_chunk_) {
+      return {absl::nullopt};
+    }
+    CommitChunk();
+  }
+
   LoadBundleTaskProgress progress{
-      documents_.size(), metadata_.total_documents(), bytes_loaded_,
+      documents_loaded_, metadata_.total_documents(), bytes_loaded_,
       metadata_.total_bytes(), LoadBundleTaskState::kInProgress};
   return {absl::make_optional(std::move(progress))};
 }
 
+void BundleLoader::CommitChunk() {
+  BundleLoadCheckpoint checkpoint(metadata_.bundle_id(),
+                                  metadata_.create_time(), documents_loaded_,
+                                  bytes_loaded_);
+  DocumentMap changes =
+      callback_->ApplyBundledDocumentChunk(documents_, checkpoint);
+  for (const auto& kv : changes) {
+    committed_changes_ = committed_changes_.insert(kv.first, kv.second);
+  }
+  documents_ = MutableDocumentMap{};
+}
+
+DocumentMap BundleLoader::TakeCommittedChanges() {
+  DocumentMap changes = std::move(committed_changes_);
+  committed_changes_ = DocumentMap{};
+  return changes;
+}
+
 StatusOr<DocumentMap> BundleLoader::ApplyChanges() {
   if (current_document_ != absl::nullopt) {
     return StatusOr<DocumentMap>(
@@ -122,14 +181,23 @@ StatusOr<DocumentMap> BundleLoader::ApplyChanges() {
                "Bundled documents end with a document metadata "
                "element instead of a document."));
   }
-  if (metadata_.total_documents() != documents_.size()) {
+  if (metadata_.total_documents() != documents_loaded_) {
     return StatusOr<DocumentMap>(
         Status(Error::kErrorInvalidArgument,
                "Loaded documents count is not the same as in metadata."));
   }
 
-  auto changes =
-      callback_->ApplyBundledDocuments(documents_, metadata_.bundle_id());
+  DocumentMap changes;
+  if (loads_in_chunks()) {
+    if (!documents_.empty()) {
+      CommitChunk();
+    }
+    changes = TakeCommittedChanges();
+  } else {
+    changes =
+        callback_->ApplyBundledDocuments(documents_, metadata_.bundle_id());
+  }
+
   auto query_document_map = GetQueryDocumentMapping();
   for (const auto& named_query : queries_) {
     const auto& matching_keys = query_document_map[named_query.query_name()];
@@ -145,17 +213,9 @@ std::unordered_map<std::string, DocumentKeySet>
 BundleLoader::GetQueryDocumentMapping() {
   std::unordered_map<std::string, DocumentKeySet> result;
   for (const auto& named_query : queries_) {
-    result.emplace(named_query.query_name(), DocumentKeySet{});
-  }
-
-  for (const auto& doc_metadata : documents_metadata_) {
-    const auto& metadata = doc_metadata.second;
-    for (const auto& query : doc_metadata.second.queries()) {
-      auto inserted = result[query].insert(metadata.key());
-      result[query] = std::move(inserted);
-    }
+    result.emplace(named_query.query_name(),
+                   query_documents_[named_query.query_name()]);
   }
-
   return result;
 }
 
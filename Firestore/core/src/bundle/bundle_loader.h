@@ -26,10 +26,13 @@
 #include "Firestore/core/src/api/load_bundle_task.h"
 #include "Firestore/core/src/bundle/bundle_callback.h"
 #include "Firestore/core/src/bundle/bundle_element.h"
+#include "Firestore/core/src/bundle/bundle_load_checkpoint.h"
 #include "Firestore/core/src/bundle/bundled_document_metadata.h"
 #include "Firestore/core/src/immutable/sorted_map.h"
+#include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "absl/types/optional.h"
 
@@ -50,6 +53,19 @@ inline api::LoadBundleTaskProgress InitialProgress(
           api::LoadBundleTaskState::kInProgress};
 }
 
+/**
+ * Loads the elements of a bundle into local storage.
+ *
+ * By default, the documents of a bundle are kept in memory until
+ * `ApplyChanges()` writes all of them in a single transaction. If
+ * `documents_per_chunk` is not zero, the loader instead commits a chunk of
+ * documents whenever `documents_per_chunk` documents have been added, along
+ * with a `BundleLoadCheckpoint`. A load that is interrupted can then resume
+ * from the checkpoint: the reader skips the documents that were committed
+ * before the checkpoint (see `BundleReader::SkipDocumentsUntil`), while their
+ * metadata elements are still added to build the document keys of the
+ * bundle's named queries.
+ */
 class BundleLoader {
  public:
   using AddElementResult =
@@ -59,19 +75,38 @@ class BundleLoader {
       : callback_(callback), metadata_(std::move(metadata)) {
   }
 
+  /**
+   * Creates a loader that commits the documents of the bundle in chunks of
+   * `documents_per_chunk` documents, resuming after `checkpoint` if it is set.
+   */
+  BundleLoader(BundleCallback* callback,
+               BundleMetadata metadata,
+               uint32_t documents_per_chunk,
+               absl::optional<BundleLoadCheckpoint> checkpoint);
+
   /**
    * Adds an element from the bundle to the loader.
    *
    * @return a new progress if adding the element leads to a new progress,
    * otherwise returns `nullopt`. If an error occurred, returns a not `ok()`
-   * status.
+   * status. When loading in chunks, progress is only reported when a chunk
+   * has been committed.
    */
   AddElementResult AddElement(std::unique_ptr<BundleElement> element,
                               uint64_t byte_size);
 
+  /**
+   * Returns the document view changes of the chunks that have been committed
+   * since the last call, so that they can be raised before the bundle has
+   * been loaded completely.
+   */
+  model::DocumentMap TakeCommittedChanges();
+
   /**
    * Applies the loaded documents and queries to local store. Returns the
-   * document view changes. If an error occurred, returns a not `ok()` status.
+   * document view changes that have not been returned by
+   * `TakeCommittedChanges()`. If an error occurred, returns a not `ok()`
+   * status.
    */
   util::StatusOr<model::DocumentMap> ApplyChanges();
 
@@ -89,15 +124,34 @@ class BundleLoader {
    */
   util::Status AddElementInternal(const BundleElement& element);
 
+  /** Adds a document that has been read completely. */
+  void AddDocument(model::MutableDocument document);
+
+  /** Commits the buffered documents as one chunk. */
+  void CommitChunk();
+
+  bool loads_in_chunks() const {
+    return documents_per_chunk_ > 0;
+  }
+
   BundleCallback* callback_ = nullptr;
   BundleMetadata metadata_;
   std::vector<NamedQuery> queries_;
-  std::unordered_map<model::DocumentKey,
-                     BundledDocumentMetadata,
-                     model::DocumentKeyHash>
-      documents_metadata_;
+  std::unordered_map<std::string, model::DocumentKeySet> query_documents_;
   model::MutableDocumentMap documents_;
 
+  /** The number of documents per chunk, or 0 to apply all at once. */
+  uint32_t documents_per_chunk_ = 0;
+
+  /** The number of documents committed by an earlier, interrupted load. */
+  uint32_t documents_to_skip_ = 0;
+
+  /** The number of documents that have been read completely. */
+  uint32_t documents_loaded_ = 0;
+
+  /** The changes of committed chunks that have not been taken yet. */
+  model::DocumentMap committed_changes_;
+
   uint64_t bytes_loaded_ = 0;
   absl::optional<model::DocumentKey> current_document_;
 };
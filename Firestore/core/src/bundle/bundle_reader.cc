@@ -17,8 +17,11 @@
 #include "Firestore/core/src/bundle/bundle_reader.h"
 
 #include <algorithm>
+#include <string>
 
+#include "Firestore/core/src/bundle/json_pull_parser.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/match.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
 
@@ -37,6 +40,20 @@ json Parse(absl::string_view s) {
                      /*allow_exceptions=*/false);
 }
 
+/**
+ * Whether `element` is a `{"document": ...}` element, judging from its first
+ * member name.
+ */
+bool IsDocumentElement(absl::string_view element) {
+  auto start = element.find_first_not_of(" \t\n\r");
+  if (start == absl::string_view::npos || element[start] != '{') {
+    return false;
+  }
+  start = element.find_first_not_of(" \t\n\r", start + 1);
+  return start != absl::string_view::npos &&
+         absl::StartsWith(element.substr(start), "\"document\"");
+}
+
 }  // namespace
 
 BundleReader::BundleReader(BundleSerializer serializer,
@@ -68,32 +85,37 @@ std::unique_ptr<BundleElement> BundleReader::GetNextElement() {
 }
 
 std::unique_ptr<BundleElement> BundleReader::ReadNextElement() {
-  auto length_prefix = ReadLengthPrefix();
-  if (!length_prefix.has_value()) {
-    return nullptr;
-  }
+  while (true) {
+    auto length_prefix = ReadLengthPrefix();
+    if (!length_prefix.has_value()) {
+      return nullptr;
+    }
 
-  size_t prefix_value = 0;
-  auto ok = absl::SimpleAtoi<size_t>(length_prefix.value(), &prefix_value);
-  if (!ok) {
-    Fail("Prefix string is not a valid number");
-    return nullptr;
-  }
+    size_t prefix_value = 0;
+    auto ok = absl::SimpleAtoi<size_t>(length_prefix.value(), &prefix_value);
+    if (!ok) {
+      Fail("Prefix string is not a valid number");
+      return nullptr;
+    }
 
-  buffer_.clear();
-  ReadJsonToBuffer(prefix_value);
-  if (!reader_status_.ok()) {
-    return nullptr;
-  }
+    buffer_.clear();
+    ReadJsonToBuffer(prefix_value);
+    if (!reader_status_.ok()) {
+      return nullptr;
+    }
 
-  // metadata's size does not count in `bytes_read_`.
-  if (metadata_loaded_) {
-    bytes_read_ += length_prefix.value().size() + buffer_.size();
-  }
-  auto result = DecodeBundleElementFromBuffer();
-  reader_status_.Update(json_reader_.status());
+    // metadata's size does not count in `bytes_read_`.
+    if (metadata_loaded_) {
+      bytes_read_ += length_prefix.value().size() + buffer_.size();
+      if (bytes_read_ <= skip_documents_until_ && IsDocumentElement(buffer_)) {
+        continue;
+      }
+    }
+    auto result = DecodeBundleElementFromBuffer();
+    reader_status_.Update(json_reader_.status());
 
-  return result;
+    return result;
+  }
 }
 
 absl::optional<std::string> BundleReader::ReadLengthPrefix() {
@@ -140,6 +162,12 @@ void BundleReader::ReadJsonToBuffer(size_t required_size) {
 }
 
 std::unique_ptr<BundleElement> BundleReader::DecodeBundleElementFromBuffer() {
+  // Documents make up most of a bundle, so they are decoded straight from the
+  // buffer instead of going through a JSON tree.
+  if (IsDocumentElement(buffer_)) {
+    return DecodeDocumentFromBuffer();
+  }
+
   auto json_object = Parse(buffer_);
   if (json_object.is_discarded()) {
     Fail("Failed to parse string into json");
@@ -166,6 +194,20 @@ std::unique_ptr<BundleElement> BundleReader::DecodeBundleElementFromBuffer() {
   }
 }
 
+std::unique_ptr<BundleElement> BundleReader::DecodeDocumentFromBuffer() {
+  JsonPullParser parser(buffer_, &json_reader_);
+  std::string name;
+  parser.ReadBeginObject();
+  parser.ReadMemberName(&name);
+  auto document = absl::make_unique<BundleDocument>(
+      serializer_.DecodeDocument(parser));
+  if (parser.ReadMemberName(&name)) {
+    parser.Fail("Unrecognized BundleElement");
+  }
+  parser.ReadEnd();
+  return document;
+}
+
 }  // namespace bundle
 }  // namespace firestore
 }  // namespace firebase
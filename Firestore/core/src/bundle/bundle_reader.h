@@ -59,6 +59,20 @@ class BundleReader {
    */
   std::unique_ptr<BundleElement> GetNextElement();
 
+  /**
+   * Makes `GetNextElement()` pass over the document elements that end within
+   * the first `offset` bytes of the bundle (as counted by `bytes_read()`),
+   * without decoding them. All other elements are still returned, since the
+   * document metadata elements are needed to rebuild the results of the
+   * bundle's named queries.
+   *
+   * Used to resume a load from a `BundleLoadCheckpoint`, whose documents have
+   * already been committed.
+   */
+  void SkipDocumentsUntil(int64_t offset) {
+    skip_documents_until_ = offset;
+  }
+
   /** Returns whether this instance is in good state. */
   const util::Status& reader_status() const {
     return reader_status_;
@@ -110,6 +124,12 @@ class BundleReader {
    */
   std::unique_ptr<BundleElement> DecodeBundleElementFromBuffer();
 
+  /**
+   * Decodes internal `buffer_`, which holds a `document` element, without
+   * building a JSON tree of it.
+   */
+  std::unique_ptr<BundleElement> DecodeDocumentFromBuffer();
+
   BundleSerializer serializer_;
   JsonReader json_reader_;
 
@@ -125,6 +145,7 @@ class BundleReader {
 
   util::Status reader_status_;
   int64_t bytes_read_ = 0;
+  int64_t skip_documents_until_ = 0;
 };
 
 }  // namespace bundle
@@ -89,25 +89,8 @@ const std::vector<T>& EmptyVector() {
   return *empty;
 }
 
-Timestamp DecodeTimestamp(JsonReader& reader, const json& version) {
-  StatusOr<Timestamp> decoded;
-  if (version.is_string()) {
-    Time time;
-    std::string err;
-    bool ok = absl::ParseTime(
-        absl::RFC3339_full, version.get_ref<const std::string&>(), &time, &err);
-    if (ok) {
-      decoded = TimestampInternal::FromUntrustedTime(time);
-    } else {
-      reader.Fail("Parsing timestamp failed with error: " + err);
-      return {};
-    }
-  } else {
-    decoded = TimestampInternal::FromUntrustedSecondsAndNanos(
-        reader.OptionalInt<int64_t>("seconds", version, 0),
-        reader.OptionalInt<int32_t>("nanos", version, 0));
-  }
-
+Timestamp CheckedTimestamp(util::ReadContext& reader,
+                           StatusOr<Timestamp> decoded) {
   if (!decoded.ok()) {
     reader.Fail(
         "Failed to decode json into valid protobuf Timestamp with error '%s'",
@@ -117,6 +100,29 @@ Timestamp DecodeTimestamp(JsonReader& reader, const json& version) {
   return decoded.ConsumeValueOrDie();
 }
 
+Timestamp DecodeTimestampString(util::ReadContext& reader,
+                                const std::string& version) {
+  Time time;
+  std::string err;
+  bool ok = absl::ParseTime(absl::RFC3339_full, version, &time, &err);
+  if (!ok) {
+    reader.Fail("Parsing timestamp failed with error: " + err);
+    return {};
+  }
+  return CheckedTimestamp(reader, TimestampInternal::FromUntrustedTime(time));
+}
+
+Timestamp DecodeTimestamp(JsonReader& reader, const json& version) {
+  if (version.is_string()) {
+    return DecodeTimestampString(reader,
+                                 version.get_ref<const std::string&>());
+  }
+  return CheckedTimestamp(
+      reader, TimestampInternal::FromUntrustedSecondsAndNanos(
+                  reader.OptionalInt<int64_t>("seconds", version, 0),
+                  reader.OptionalInt<int32_t>("nanos", version, 0)));
+}
+
 SnapshotVersion DecodeSnapshotVersion(JsonReader& reader, const json& version) {
   return SnapshotVersion(DecodeTimestamp(reader, version));
 }
@@ -314,7 +320,7 @@ google_type_LatLng DecodeGeoPointValue(JsonReader& reader,
   return result;
 }
 
-pb_bytes_array_t* DecodeBytesValue(JsonReader& reader,
+pb_bytes_array_t* DecodeBytesValue(util::ReadContext& reader,
                                    const std::string& bytes_string) {
   std::string decoded;
   if (!absl::Base64Unescape(bytes_string, &decoded)) {
@@ -324,6 +330,133 @@ pb_bytes_array_t* DecodeBytesValue(JsonReader& reader,
   return nanopb::MakeBytesArray(decoded);
 }
 
+// Mark: Pull decoding helpers
+
+template <typename IntType>
+IntType ReadInt(JsonPullParser& parser) {
+  IntType result = 0;
+  std::string s;
+  absl::string_view literal;
+  switch (parser.PeekType()) {
+    case JsonPullParser::Type::Number:
+      if (!parser.ReadNumber(&literal)) {
+        return 0;
+      }
+      break;
+    case JsonPullParser::Type::String:
+      if (!parser.ReadString(&s)) {
+        return 0;
+      }
+      literal = s;
+      break;
+    default:
+      parser.Fail("Only integer and string can be parsed into int type");
+      return 0;
+  }
+
+  if (!absl::SimpleAtoi<IntType>(literal, &result)) {
+    parser.Fail("Failed to parse into integer: " + std::string(literal));
+    return 0;
+  }
+  return result;
+}
+
+double ReadDouble(JsonPullParser& parser) {
+  double result = 0;
+  std::string s;
+  absl::string_view literal;
+  switch (parser.PeekType()) {
+    case JsonPullParser::Type::Number:
+      if (!parser.ReadNumber(&literal)) {
+        return 0;
+      }
+      break;
+    case JsonPullParser::Type::String:
+      if (!parser.ReadString(&s)) {
+        return 0;
+      }
+      literal = s;
+      break;
+    default:
+      // Matches `JsonReader::DecodeDouble`, which ignores other types.
+      parser.SkipValue();
+      return 0;
+  }
+
+  if (!absl::SimpleAtod(literal, &result)) {
+    parser.Fail("Failed to parse into double: " + std::string(literal));
+    return 0;
+  }
+  return result;
+}
+
+Timestamp DecodeTimestamp(JsonPullParser& parser) {
+  if (parser.PeekType() == JsonPullParser::Type::String) {
+    std::string version;
+    if (!parser.ReadString(&version)) {
+      return {};
+    }
+    return DecodeTimestampString(parser.context(), version);
+  }
+
+  int64_t seconds = 0;
+  int32_t nanos = 0;
+  if (parser.PeekType() == JsonPullParser::Type::Object) {
+    parser.ReadBeginObject();
+    std::string name;
+    while (parser.ReadMemberName(&name)) {
+      if (name == "seconds") {
+        seconds = ReadInt<int64_t>(parser);
+      } else if (name == "nanos") {
+        nanos = ReadInt<int32_t>(parser);
+      } else {
+        parser.SkipValue();
+      }
+    }
+  } else {
+    parser.SkipValue();
+  }
+
+  if (!parser.ok()) {
+    return {};
+  }
+  return CheckedTimestamp(
+      parser.context(),
+      TimestampInternal::FromUntrustedSecondsAndNanos(seconds, nanos));
+}
+
+google_type_LatLng DecodeGeoPointValue(JsonPullParser& parser) {
+  google_type_LatLng result{};
+  if (parser.PeekType() != JsonPullParser::Type::Object) {
+    parser.SkipValue();
+    return result;
+  }
+
+  parser.ReadBeginObject();
+  std::string name;
+  while (parser.ReadMemberName(&name)) {
+    if (name == "latitude") {
+      result.latitude = ReadDouble(parser);
+    } else if (name == "longitude") {
+      result.longitude = ReadDouble(parser);
+    } else {
+      parser.SkipValue();
+    }
+  }
+  return result;
+}
+
+/** Reads a string member, failing with the message `JsonReader` uses. */
+bool ReadStringMember(JsonPullParser& parser,
+                      const char* name,
+                      std::string* value) {
+  if (parser.PeekType() != JsonPullParser::Type::String) {
+    parser.Fail(StringFormat("'%s' is missing or is not a string", name));
+    return false;
+  }
+  return parser.ReadString(value);
+}
+
 }  // namespace
 
 // Mark: JsonReader
@@ -570,8 +703,13 @@ ResourcePath BundleSerializer::DecodeName(JsonReader& reader,
     reader.Fail("Document name is not a string.");
     return {};
   }
-  auto path =
-      ResourcePath::FromString(document_name.get_ref<const std::string&>());
+  return DecodeResourceName(reader,
+                            document_name.get_ref<const std::string&>());
+}
+
+ResourcePath BundleSerializer::DecodeResourceName(
+    util::ReadContext& reader, const std::string& name) const {
+  auto path = ResourcePath::FromString(name);
   if (!rpc_serializer_.IsLocalResourceName(path)) {
     reader.Fail("Resource name is not valid for current instance: " +
                 path.CanonicalString());
@@ -797,7 +935,7 @@ Message<google_firestore_v1_ArrayValue> BundleSerializer::DecodeArrayValue(
 }
 
 pb_bytes_array_t* BundleSerializer::DecodeReferenceValue(
-    JsonReader& reader, const std::string& ref_string) const {
+    util::ReadContext& reader, const std::string& ref_string) const {
   if (reader.ok() && !rpc_serializer_.IsLocalDocumentKey(ref_string)) {
     reader.Fail(
         StringFormat("Tried to deserialize an invalid key: %s", ref_string));
@@ -857,6 +995,206 @@ BundleDocument BundleSerializer::DecodeDocument(JsonReader& reader,
       ObjectValue::FromMapValue(std::move(map_value))));
 }
 
+// Mark: BundleSerializer pull decoding
+
+BundleDocument BundleSerializer::DecodeDocument(JsonPullParser& parser) const {
+  ResourcePath path;
+  bool has_name = false;
+  SnapshotVersion update_time;
+  bool has_update_time = false;
+  Message<google_firestore_v1_MapValue> map_value;
+  bool has_fields = false;
+
+  parser.ReadBeginObject();
+  std::string name;
+  while (parser.ReadMemberName(&name)) {
+    if (name == "name") {
+      std::string document_name;
+      if (parser.PeekType() != JsonPullParser::Type::String) {
+        parser.Fail("Document name is not a string.");
+      } else if (parser.ReadString(&document_name)) {
+        path = DecodeResourceName(parser.context(), document_name);
+        has_name = true;
+      }
+    } else if (name == "updateTime") {
+      update_time = SnapshotVersion(DecodeTimestamp(parser));
+      has_update_time = true;
+    } else if (name == "fields" && !has_fields) {
+      if (parser.PeekType() != JsonPullParser::Type::Object) {
+        parser.Fail("mapValue's 'field' is not a valid map");
+      } else {
+        DecodeMapFields(parser, map_value.get());
+        has_fields = true;
+      }
+    } else {
+      parser.SkipValue();
+    }
+  }
+
+  if (!has_name) {
+    parser.Fail("Missing child 'name'");
+  } else if (!has_update_time) {
+    parser.Fail("Missing child 'updateTime'");
+  } else if (!has_fields) {
+    parser.Fail("mapValue is not a valid map");
+  }
+  // Return early if !ok(), `DocumentKey` aborts with invalid inputs.
+  if (!parser.ok()) {
+    return {};
+  }
+
+  return BundleDocument(MutableDocument::FoundDocument(
+      DocumentKey(std::move(path)), update_time,
+      ObjectValue::FromMapValue(std::move(map_value))));
+}
+
+Message<google_firestore_v1_Value> BundleSerializer::DecodeValue(
+    JsonPullParser& parser) const {
+  if (parser.PeekType() != JsonPullParser::Type::Object) {
+    parser.Fail("'value' is not encoded as JSON object");
+    return {};
+  }
+
+  // Well-formed values have exactly one member naming their type. Any other
+  // members are skipped, and only the first type is decoded.
+  Message<google_firestore_v1_Value> result;
+  bool decoded = false;
+  parser.ReadBeginObject();
+  std::string name;
+  std::string s;
+  while (parser.ReadMemberName(&name)) {
+    if (decoded) {
+      parser.SkipValue();
+      continue;
+    }
+
+    decoded = true;
+    if (name == "nullValue") {
+      parser.SkipValue();
+      result->which_value_type = google_firestore_v1_Value_null_value_tag;
+      result->null_value = {};
+    } else if (name == "booleanValue") {
+      bool value = false;
+      if (parser.PeekType() != JsonPullParser::Type::Boolean) {
+        parser.Fail("'booleanValue' is not encoded as a valid boolean");
+        return {};
+      }
+      parser.ReadBool(&value);
+      result->which_value_type = google_firestore_v1_Value_boolean_value_tag;
+      result->boolean_value = value;
+    } else if (name == "integerValue") {
+      result->which_value_type = google_firestore_v1_Value_integer_value_tag;
+      result->integer_value = ReadInt<int64_t>(parser);
+    } else if (name == "doubleValue") {
+      result->which_value_type = google_firestore_v1_Value_double_value_tag;
+      result->double_value = ReadDouble(parser);
+    } else if (name == "timestampValue") {
+      auto val = DecodeTimestamp(parser);
+      result->which_value_type = google_firestore_v1_Value_timestamp_value_tag;
+      result->timestamp_value.seconds = val.seconds();
+      result->timestamp_value.nanos = val.nanoseconds();
+    } else if (name == "stringValue") {
+      ReadStringMember(parser, "stringValue", &s);
+      result->which_value_type = google_firestore_v1_Value_string_value_tag;
+      result->string_value = nanopb::MakeBytesArray(s);
+    } else if (name == "bytesValue") {
+      ReadStringMember(parser, "bytesValue", &s);
+      result->which_value_type = google_firestore_v1_Value_bytes_value_tag;
+      result->bytes_value = DecodeBytesValue(parser.context(), s);
+    } else if (name == "referenceValue") {
+      ReadStringMember(parser, "referenceValue", &s);
+      result->which_value_type = google_firestore_v1_Value_reference_value_tag;
+      result->reference_value = DecodeReferenceValue(parser.context(), s);
+    } else if (name == "geoPointValue") {
+      result->which_value_type = google_firestore_v1_Value_geo_point_value_tag;
+      result->geo_point_value = DecodeGeoPointValue(parser);
+    } else if (name == "arrayValue") {
+      result->which_value_type = google_firestore_v1_Value_array_value_tag;
+      result->array_value = *DecodeArrayValue(parser).release();
+    } else if (name == "mapValue") {
+      result->which_value_type = google_firestore_v1_Value_map_value_tag;
+      result->map_value = *DecodeMapValue(parser).release();
+    } else {
+      decoded = false;
+      parser.SkipValue();
+    }
+  }
+
+  if (!decoded) {
+    parser.Fail("Failed to decode value, no type is recognized");
+    return {};
+  }
+  return result;
+}
+
+void BundleSerializer::DecodeMapFields(
+    JsonPullParser& parser, google_firestore_v1_MapValue* map_value) const {
+  std::vector<google_firestore_v1_MapValue_FieldsEntry> fields;
+  parser.ReadBeginObject();
+  std::string key;
+  while (parser.ReadMemberName(&key)) {
+    fields.push_back(
+        {nanopb::MakeBytesArray(key), *DecodeValue(parser).release()});
+  }
+  SetRepeatedField(&map_value->fields, &map_value->fields_count, fields);
+}
+
+Message<google_firestore_v1_MapValue> BundleSerializer::DecodeMapValue(
+    JsonPullParser& parser) const {
+  Message<google_firestore_v1_MapValue> map_value;
+  if (parser.PeekType() != JsonPullParser::Type::Object) {
+    parser.Fail("mapValue is not a valid map");
+    return map_value;
+  }
+
+  bool has_fields = false;
+  parser.ReadBeginObject();
+  std::string name;
+  while (parser.ReadMemberName(&name)) {
+    if (name != "fields" || has_fields) {
+      parser.SkipValue();
+    } else if (parser.PeekType() != JsonPullParser::Type::Object) {
+      parser.Fail("mapValue's 'field' is not a valid map");
+    } else {
+      DecodeMapFields(parser, map_value.get());
+      has_fields = true;
+    }
+  }
+
+  if (!has_fields) {
+    parser.Fail("mapValue is not a valid map");
+  }
+  return map_value;
+}
+
+Message<google_firestore_v1_ArrayValue> BundleSerializer::DecodeArrayValue(
+    JsonPullParser& parser) const {
+  Message<google_firestore_v1_ArrayValue> array_value;
+  if (parser.PeekType() != JsonPullParser::Type::Object) {
+    parser.SkipValue();
+    return array_value;
+  }
+
+  std::vector<google_firestore_v1_Value> values;
+  parser.ReadBeginObject();
+  std::string name;
+  while (parser.ReadMemberName(&name)) {
+    if (name != "values") {
+      parser.SkipValue();
+    } else if (parser.PeekType() != JsonPullParser::Type::Array) {
+      parser.Fail("'values' is not an array");
+    } else {
+      parser.ReadBeginArray();
+      while (parser.HasNextElement()) {
+        values.push_back(*DecodeValue(parser).release());
+      }
+    }
+  }
+
+  SetRepeatedField(&array_value->values, &array_value->values_count, values);
+  return array_value;
+}
+
 }  // namespace bundle
 }  // namespace firestore
 }  // namespace firebase
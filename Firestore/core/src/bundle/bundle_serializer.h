@@ -24,6 +24,7 @@
 #include "Firestore/core/src/bundle/bundle_document.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/bundled_document_metadata.h"
+#include "Firestore/core/src/bundle/json_pull_parser.h"
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/core/core_fwd.h"
 #include "Firestore/core/src/model/resource_path.h"
@@ -110,6 +111,14 @@ class BundleSerializer {
   BundleDocument DecodeDocument(JsonReader& reader,
                                 const nlohmann::json& document) const;
 
+  /**
+   * Decodes a `document` directly from `parser`, without first building a
+   * JSON tree of it. Documents hold most of the bytes in a bundle, which makes
+   * the tree the main cost of loading one. Failures are reported to the
+   * parser's context.
+   */
+  BundleDocument DecodeDocument(JsonPullParser& parser) const;
+
  private:
   BundledQuery DecodeBundledQuery(JsonReader& reader,
                                   const nlohmann::json& query) const;
@@ -135,13 +144,25 @@ class BundleSerializer {
 
   model::ResourcePath DecodeName(JsonReader& reader,
                                  const nlohmann::json& name) const;
+  model::ResourcePath DecodeResourceName(util::ReadContext& reader,
+                                         const std::string& name) const;
   nanopb::Message<google_firestore_v1_ArrayValue> DecodeArrayValue(
       JsonReader& reader, const nlohmann::json& array_json) const;
   nanopb::Message<google_firestore_v1_MapValue> DecodeMapValue(
       JsonReader& reader, const nlohmann::json& map_json) const;
-  pb_bytes_array_t* DecodeReferenceValue(JsonReader& reader,
+  pb_bytes_array_t* DecodeReferenceValue(util::ReadContext& reader,
                                          const std::string& ref_string) const;
 
+  nanopb::Message<google_firestore_v1_Value> DecodeValue(
+      JsonPullParser& parser) const;
+  nanopb::Message<google_firestore_v1_ArrayValue> DecodeArrayValue(
+      JsonPullParser& parser) const;
+  nanopb::Message<google_firestore_v1_MapValue> DecodeMapValue(
+      JsonPullParser& parser) const;
+  // Reads the `fields` object of a map value into `map_value`.
+  void DecodeMapFields(JsonPullParser& parser,
+                       google_firestore_v1_MapValue* map_value) const;
+
   remote::Serializer rpc_serializer_;
 };
 
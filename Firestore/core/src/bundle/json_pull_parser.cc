@@ -0,0 +1,442 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/bundle/json_pull_parser.h"
+
+#include <utility>
+
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace bundle {
+namespace {
+
+bool IsDigit(char c) {
+  return c >= '0' && c <= '9';
+}
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  if (c >= 'A' && c <= 'F') {
+    return c - 'A' + 10;
+  }
+  return -1;
+}
+
+void AppendUtf8(uint32_t code_point, std::string* out) {
+  if (code_point < 0x80) {
+    out->push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out->push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out->push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out->push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out->push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+}  // namespace
+
+constexpr size_t JsonPullParser::kMaxDepth;
+
+JsonPullParser::JsonPullParser(absl::string_view input,
+                               util::ReadContext* context)
+    : input_(input), context_(NOT_NULL(context)) {
+}
+
+void JsonPullParser::Fail(std::string description) {
+  context_->Fail(std::move(description));
+  pos_ = input_.size();
+}
+
+void JsonPullParser::SkipWhitespace() {
+  while (pos_ < input_.size()) {
+    char c = input_[pos_];
+    if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+      return;
+    }
+    ++pos_;
+  }
+}
+
+JsonPullParser::Type JsonPullParser::PeekType() {
+  if (!ok()) {
+    return Type::Invalid;
+  }
+
+  SkipWhitespace();
+  if (pos_ >= input_.size()) {
+    return Type::Invalid;
+  }
+
+  char c = input_[pos_];
+  switch (c) {
+    case '{':
+      return Type::Object;
+    case '[':
+      return Type::Array;
+    case '"':
+      return Type::String;
+    case 't':
+    case 'f':
+      return Type::Boolean;
+    case 'n':
+      return Type::Null;
+    default:
+      return c == '-' || IsDigit(c) ? Type::Number : Type::Invalid;
+  }
+}
+
+bool JsonPullParser::Consume(char c) {
+  if (!ok()) {
+    return false;
+  }
+
+  SkipWhitespace();
+  if (pos_ >= input_.size() || input_[pos_] != c) {
+    Fail(std::string("Expected '") + c + "' in JSON input");
+    return false;
+  }
+  ++pos_;
+  return true;
+}
+
+bool JsonPullParser::ConsumeLiteral(absl::string_view literal) {
+  if (!ok()) {
+    return false;
+  }
+
+  SkipWhitespace();
+  if (input_.substr(pos_, literal.size()) != literal) {
+    Fail("Expected '" + std::string(literal) + "' in JSON input");
+    return false;
+  }
+  pos_ += literal.size();
+  return true;
+}
+
+bool JsonPullParser::ReadBeginObject() {
+  return BeginContainer('{');
+}
+
+bool JsonPullParser::ReadBeginArray() {
+  return BeginContainer('[');
+}
+
+bool JsonPullParser::BeginContainer(char open) {
+  if (!Consume(open)) {
+    return false;
+  }
+  if (depth_ == kMaxDepth) {
+    Fail("JSON input is nested too deeply");
+    return false;
+  }
+  ++depth_;
+  at_container_start_ = true;
+  return true;
+}
+
+bool JsonPullParser::NextInContainer(char close) {
+  if (!ok()) {
+    return false;
+  }
+
+  SkipWhitespace();
+  if (pos_ < input_.size() && input_[pos_] == close) {
+    ++pos_;
+    --depth_;
+    at_container_start_ = false;
+    return false;
+  }
+
+  if (at_container_start_) {
+    at_container_start_ = false;
+    return true;
+  }
+  return Consume(',');
+}
+
+bool JsonPullParser::ReadMemberName(std::string* name) {
+  if (!NextInContainer('}')) {
+    return false;
+  }
+  return ReadString(name) && Consume(':');
+}
+
+bool JsonPullParser::HasNextElement() {
+  if (!NextInContainer(']')) {
+    return false;
+  }
+
+  // Catches trailing commas, which would otherwise be read as a missing value.
+  if (PeekType() == Type::Invalid) {
+    Fail("Expected a value in JSON array");
+    return false;
+  }
+  return true;
+}
+
+bool JsonPullParser::ReadString(std::string* value) {
+  if (!Consume('"')) {
+    return false;
+  }
+
+  value->clear();
+  size_t start = pos_;
+  while (pos_ < input_.size()) {
+    char c = input_[pos_];
+    if (c == '"') {
+      value->append(input_.data() + start, pos_ - start);
+      ++pos_;
+      return true;
+    } else if (c == '\\') {
+      value->append(input_.data() + start, pos_ - start);
+      ++pos_;
+      if (!ReadEscape(value)) {
+        return false;
+      }
+      start = pos_;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      Fail("Unescaped control character in JSON string");
+      return false;
+    } else {
+      ++pos_;
+    }
+  }
+
+  Fail("Unterminated JSON string");
+  return false;
+}
+
+bool JsonPullParser::ReadEscape(std::string* value) {
+  if (pos_ >= input_.size()) {
+    Fail("Unterminated JSON string");
+    return false;
+  }
+
+  char c = input_[pos_++];
+  switch (c) {
+    case '"':
+    case '\\':
+    case '/':
+      value->push_back(c);
+      return true;
+    case 'b':
+      value->push_back('\b');
+      return true;
+    case 'f':
+      value->push_back('\f');
+      return true;
+    case 'n':
+      value->push_back('\n');
+      return true;
+    case 'r':
+      value->push_back('\r');
+      return true;
+    case 't':
+      value->push_back('\t');
+      return true;
+    case 'u':
+      break;
+    default:
+      Fail("Invalid escape sequence in JSON string");
+      return false;
+  }
+
+  uint32_t code_point = 0;
+  if (!ReadHex4(&code_point)) {
+    return false;
+  }
+
+  if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+    // A high surrogate must be followed by an escaped low surrogate.
+    uint32_t low = 0;
+    if (input_.substr(pos_, 2) != "\\u") {
+      Fail("Unpaired surrogate in JSON string");
+      return false;
+    }
+    pos_ += 2;
+    if (!ReadHex4(&low)) {
+      return false;
+    }
+    if (low < 0xDC00 || low > 0xDFFF) {
+      Fail("Unpaired surrogate in JSON string");
+      return false;
+    }
+    code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+  } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+    Fail("Unpaired surrogate in JSON string");
+    return false;
+  }
+
+  AppendUtf8(code_point, value);
+  return true;
+}
+
+bool JsonPullParser::ReadHex4(uint32_t* code_unit) {
+  if (input_.size() - pos_ < 4) {
+    Fail("Invalid unicode escape in JSON string");
+    return false;
+  }
+
+  uint32_t result = 0;
+  for (int i = 0; i < 4; ++i) {
+    int digit = HexValue(input_[pos_ + i]);
+    if (digit < 0) {
+      Fail("Invalid unicode escape in JSON string");
+      return false;
+    }
+    result = (result << 4) | static_cast<uint32_t>(digit);
+  }
+  pos_ += 4;
+  *code_unit = result;
+  return true;
+}
+
+bool JsonPullParser::ReadNumber(absl::string_view* literal) {
+  if (PeekType() != Type::Number) {
+    Fail("Expected a number in JSON input");
+    return false;
+  }
+
+  size_t start = pos_;
+  if (input_[pos_] == '-') {
+    ++pos_;
+  }
+
+  // Validates the number grammar: an integer part without leading zeros, an
+  // optional fraction and an optional exponent.
+  size_t digits_start = pos_;
+  while (pos_ < input_.size() && IsDigit(input_[pos_])) {
+    ++pos_;
+  }
+  size_t integer_digits = pos_ - digits_start;
+  bool valid = integer_digits > 0 &&
+               (integer_digits == 1 || input_[digits_start] != '0');
+
+  if (valid && pos_ < input_.size() && input_[pos_] == '.') {
+    ++pos_;
+    size_t fraction_start = pos_;
+    while (pos_ < input_.size() && IsDigit(input_[pos_])) {
+      ++pos_;
+    }
+    valid = pos_ > fraction_start;
+  }
+
+  if (valid && pos_ < input_.size() &&
+      (input_[pos_] == 'e' || input_[pos_] == 'E')) {
+    ++pos_;
+    if (pos_ < input_.size() && (input_[pos_] == '+' || input_[pos_] == '-')) {
+      ++pos_;
+    }
+    size_t exponent_start = pos_;
+    while (pos_ < input_.size() && IsDigit(input_[pos_])) {
+      ++pos_;
+    }
+    valid = pos_ > exponent_start;
+  }
+
+  if (!valid) {
+    Fail("Invalid number in JSON input");
+    return false;
+  }
+
+  *literal = input_.substr(start, pos_ - start);
+  return true;
+}
+
+bool JsonPullParser::ReadBool(bool* value) {
+  if (PeekType() != Type::Boolean) {
+    Fail("Expected a boolean in JSON input");
+    return false;
+  }
+
+  if (input_[pos_] == 't') {
+    *value = true;
+    return ConsumeLiteral("true");
+  }
+  *value = false;
+  return ConsumeLiteral("false");
+}
+
+bool JsonPullParser::ReadNull() {
+  return ConsumeLiteral("null");
+}
+
+void JsonPullParser::SkipValue() {
+  std::string scratch;
+  absl::string_view literal;
+  bool unused = false;
+
+  switch (PeekType()) {
+    case Type::Object:
+      ReadBeginObject();
+      while (ReadMemberName(&scratch)) {
+        SkipValue();
+      }
+      break;
+    case Type::Array:
+      ReadBeginArray();
+      while (HasNextElement()) {
+        SkipValue();
+      }
+      break;
+    case Type::String:
+      ReadString(&scratch);
+      break;
+    case Type::Number:
+      ReadNumber(&literal);
+      break;
+    case Type::Boolean:
+      ReadBool(&unused);
+      break;
+    case Type::Null:
+      ReadNull();
+      break;
+    case Type::Invalid:
+      Fail("Expected a value in JSON input");
+      break;
+  }
+}
+
+bool JsonPullParser::ReadEnd() {
+  if (!ok()) {
+    return false;
+  }
+
+  SkipWhitespace();
+  if (pos_ != input_.size()) {
+    Fail("Unexpected trailing characters in JSON input");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace bundle
+}  // namespace firestore
+}  // namespace firebase
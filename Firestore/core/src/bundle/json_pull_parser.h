@@ -0,0 +1,171 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_BUNDLE_JSON_PULL_PARSER_H_
+#define FIRESTORE_CORE_SRC_BUNDLE_JSON_PULL_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Firestore/core/src/util/read_context.h"
+#include "absl/strings/string_view.h"
+
+namespace firebase {
+namespace firestore {
+namespace bundle {
+
+/**
+ * Reads a JSON text one value at a time, without building an in-memory
+ * representation of the whole text.
+ *
+ * The caller drives the parser according to the structure it expects:
+ *
+ *     parser.ReadBeginObject();
+ *     std::string name;
+ *     while (parser.ReadMemberName(&name)) {
+ *       if (name == "known") {
+ *         parser.ReadString(&value);
+ *       } else {
+ *         parser.SkipValue();
+ *       }
+ *     }
+ *
+ * Errors are reported to the given `ReadContext`. Once the context has failed,
+ * all reads fail without consuming further input.
+ *
+ * Callers read nested values recursively, so containers may only be nested
+ * `kMaxDepth` deep. Deeper input fails instead of overflowing the stack.
+ */
+class JsonPullParser {
+ public:
+  /** How many containers may be open at the same time. */
+  static constexpr size_t kMaxDepth = 200;
+
+  /** The type of a JSON value, as determined by its first character. */
+  enum class Type {
+    Object,
+    Array,
+    String,
+    Number,
+    Boolean,
+    Null,
+    Invalid,
+  };
+
+  /**
+   * Creates a parser over `input`. Both `input` and `context` must outlive the
+   * parser.
+   */
+  JsonPullParser(absl::string_view input, util::ReadContext* context);
+
+  bool ok() const {
+    return context_->ok();
+  }
+
+  util::ReadContext& context() {
+    return *context_;
+  }
+
+  /** Fails the underlying context and stops parsing. */
+  void Fail(std::string description);
+
+  /** Returns the type of the next value without consuming it. */
+  Type PeekType();
+
+  /** Consumes the `{` that begins an object. */
+  bool ReadBeginObject();
+
+  /**
+   * Reads the name of the next member of the current object, along with the
+   * `:` that follows it. Returns false once the `}` that ends the object has
+   * been consumed.
+   */
+  bool ReadMemberName(std::string* name);
+
+  /** Consumes the `[` that begins an array. */
+  bool ReadBeginArray();
+
+  /**
+   * Prepares to read the next element of the current array. Returns false once
+   * the `]` that ends the array has been consumed.
+   */
+  bool HasNextElement();
+
+  /** Reads a string value, replacing the contents of `value`. */
+  bool ReadString(std::string* value);
+
+  /**
+   * Reads a number value and returns its literal text, which the caller can
+   * convert to the numeric type it expects.
+   */
+  bool ReadNumber(absl::string_view* literal);
+
+  bool ReadBool(bool* value);
+
+  bool ReadNull();
+
+  /** Consumes the next value, including all nested values. */
+  void SkipValue();
+
+  /** Verifies that only whitespace remains in the input. */
+  bool ReadEnd();
+
+ private:
+  void SkipWhitespace();
+
+  /** Consumes `c` after any whitespace, failing if it is not next. */
+  bool Consume(char c);
+
+  /** Consumes the given literal, such as `true`. */
+  bool ConsumeLiteral(absl::string_view literal);
+
+  /** Decodes the escape sequence after a `\` into `value`. */
+  bool ReadEscape(std::string* value);
+
+  /** Reads the 4 hex digits of a `\u` escape. */
+  bool ReadHex4(uint32_t* code_unit);
+
+  /** Consumes `open`, which begins a container nested one level deeper. */
+  bool BeginContainer(char open);
+
+  /**
+   * Consumes the separator between two members or elements of the current
+   * container, or its closing character. Returns false if the container has
+   * ended.
+   */
+  bool NextInContainer(char close);
+
+  absl::string_view input_;
+  size_t pos_ = 0;
+  util::ReadContext* context_ = nullptr;
+
+  /**
+   * Whether a container was just opened, in which case its first member or
+   * element is not preceded by a comma. Nested containers are always read
+   * completely before their parent continues, so a single flag suffices.
+   */
+  bool at_container_start_ = false;
+
+  /** How many containers are open. */
+  size_t depth_ = 0;
+};
+
+}  // namespace bundle
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_BUNDLE_JSON_PULL_PARSER_H_
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/core/firestore_client.h"
 
+#include <algorithm>
 #include <functional>
 #include <future>  // NOLINT(build/c++11)
 #include <memory>
@@ -34,6 +35,7 @@
 #include "Firestore/core/src/core/sync_engine.h"
 #include "Firestore/core/src/core/view.h"
 #include "Firestore/core/src/credentials/credentials_provider.h"
+#include "Firestore/core/src/local/index_backfiller.h"
 #include "Firestore/core/src/local/leveldb_opener.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_documents_view.h"
@@ -75,7 +77,9 @@ using api::SnapshotMetadata;
 using credentials::AuthCredentialsProvider;
 using credentials::User;
 using firestore::Error;
+using local::IndexBackfiller;
 using local::LevelDbOpener;
+using local::LevelDbParams;
 using local::LocalStore;
 using local::LruParams;
 using local::MemoryPersistence;
@@ -131,16 +135,18 @@ std::shared_ptr<FirestoreClient> FirestoreClient::Create(
       // it is invoked synchronously on the calling thread. This ensures that
       // the first item enqueued on the worker queue is
       // `FirestoreClient::Initialize()`.
-      shared_client->worker_queue_->Enqueue([shared_client, user, settings] {
-        shared_client->Initialize(user, settings);
-      });
+      shared_client->worker_queue_->Enqueue(
+          "FirestoreClient::Initialize", [shared_client, user, settings] {
+            shared_client->Initialize(user, settings);
+          });
     } else {
-      shared_client->worker_queue_->Enqueue([shared_client, user] {
-        shared_client->worker_queue_->VerifyIsCurrentQueue();
+      shared_client->worker_queue_->Enqueue(
+          "FirestoreClient::HandleCredentialChange", [shared_client, user] {
+            shared_client->worker_queue_->VerifyIsCurrentQueue();
 
-        LOG_DEBUG("Credential Changed. Current user: %s", user.uid());
-        shared_client->sync_engine_->HandleCredentialChange(user);
-      });
+            LOG_DEBUG("Credential Changed. Current user: %s", user.uid());
+            shared_client->sync_engine_->HandleCredentialChange(user);
+          });
     }
   };
 
@@ -189,7 +195,8 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
     LevelDbOpener opener(database_info_);
 
     auto created =
-        opener.Create(LruParams::WithCacheSize(settings.cache_size_bytes()));
+        opener.Create(LruParams::WithCacheSize(settings.cache_size_bytes()),
+                      LevelDbParams::FromSettings(settings));
     // If leveldb fails to start then just throw up our hands: the error is
     // unrecoverable. There's nothing an end-user can do and nearly all
     // failures indicate the developer is doing something grossly wrong so we
@@ -204,6 +211,8 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
     if (settings.gc_enabled()) {
       ScheduleLruGarbageCollection();
     }
+    index_backfiller_ = absl::make_unique<IndexBackfiller>(static_cast<size_t>(
+        std::max(settings.index_backfill_max_documents(), 1)));
   } else {
     persistence_ = MemoryPersistence::WithEagerGarbageCollector();
   }
@@ -226,6 +235,16 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   sync_engine_ =
       absl::make_unique<SyncEngine>(local_store_.get(), remote_store_.get(),
                                     user, kMaxConcurrentLimboResolutions);
+  sync_engine_->set_bundle_chunk_size(settings.bundle_chunk_size());
+  sync_engine_->set_limbo_resolution_batch_size(static_cast<size_t>(
+      std::max(settings.limbo_resolution_batch_size(), 1)));
+  remote_store_->set_watch_coalescing_window(
+      std::chrono::milliseconds(settings.watch_coalescing_window_ms()));
+  remote_store_->set_max_pending_writes(
+      std::max(settings.max_pending_writes(), 1));
+  remote_store_->set_write_coalescing_max_mutations(static_cast<size_t>(
+      std::max(settings.write_coalescing_max_mutations(),
+               Settings::WriteCoalescingDisabled)));
 
   event_manager_ = absl::make_unique<EventManager>(sync_engine_.get());
 
@@ -236,6 +255,10 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   // refilling mutation queue, etc.) so must be started after LocalStore.
   local_store_->Start();
   remote_store_->Start();
+
+  if (index_backfiller_) {
+    ScheduleIndexBackfill();
+  }
 }
 
 FirestoreClient::~FirestoreClient() {
@@ -250,14 +273,15 @@ void FirestoreClient::Dispose() {
   // to `Firestore::ClearPersistence` or `Firestore::Terminate`, but that's OK
   // because that operation does not rely on any state in this FirestoreClient.
   std::promise<void> signal_disposing;
-  bool enqueued = worker_queue_->EnqueueEvenWhileRestricted([&, this] {
-    // Once this task has started running, AsyncQueue::Dispose will block on its
-    // completion. Signal as early as possible to lock out even restricted tasks
-    // as early as possible.
-    signal_disposing.set_value();
-
-    TerminateInternal();
-  });
+  bool enqueued = worker_queue_->EnqueueEvenWhileRestricted(
+      "FirestoreClient::Dispose", [&, this] {
+        // Once this task has started running, AsyncQueue::Dispose will block on
+        // its completion. Signal as early as possible to lock out even
+        // restricted tasks as early as possible.
+        signal_disposing.set_value();
+
+        TerminateInternal();
+      });
 
   // If we successfully enqueued the TerminateInternal task then wait for it to
   // start.
@@ -275,13 +299,14 @@ void FirestoreClient::Dispose() {
 
 void FirestoreClient::TerminateAsync(StatusCallback callback) {
   worker_queue_->EnterRestrictedMode();
-  worker_queue_->EnqueueEvenWhileRestricted([this, callback] {
-    TerminateInternal();
+  worker_queue_->EnqueueEvenWhileRestricted(
+      "FirestoreClient::TerminateAsync", [this, callback] {
+        TerminateInternal();
 
-    if (callback) {
-      user_executor_->Execute([=] { callback(Status::OK()); });
-    }
-  });
+        if (callback) {
+          user_executor_->Execute([=] { callback(Status::OK()); });
+        }
+      });
 }
 
 void FirestoreClient::TerminateInternal() {
@@ -295,6 +320,8 @@ void FirestoreClient::TerminateInternal() {
 
   // If we've scheduled LRU garbage collection, cancel it.
   lru_callback_.Cancel();
+  // Likewise for index backfilling.
+  backfill_callback_.Cancel();
 
   remote_store_->Shutdown();
   persistence_->Shutdown();
@@ -316,17 +343,34 @@ void FirestoreClient::ScheduleLruGarbageCollection() {
       gc_has_run_ ? regular_gc_delay_ : initial_gc_delay_;
 
   lru_callback_ = worker_queue_->EnqueueAfterDelay(
-      delay, TimerId::GarbageCollectionDelay, [this] {
+      delay, TimerId::GarbageCollectionDelay, "LocalStore::CollectGarbage",
+      [this] {
         local_store_->CollectGarbage(lru_delegate_->garbage_collector());
         gc_has_run_ = true;
         ScheduleLruGarbageCollection();
       });
 }
 
+/**
+ * Schedules a callback to write a bounded batch of index entries for documents
+ * that have not been indexed yet. Reschedules itself after each run.
+ */
+void FirestoreClient::ScheduleIndexBackfill() {
+  std::chrono::milliseconds delay =
+      backfill_has_run_ ? regular_backfill_delay_ : initial_backfill_delay_;
+
+  backfill_callback_ = worker_queue_->EnqueueAfterDelay(
+      delay, TimerId::IndexBackfill, "LocalStore::Backfill", [this] {
+        local_store_->Backfill(index_backfiller_.get());
+        backfill_has_run_ = true;
+        ScheduleIndexBackfill();
+      });
+}
+
 void FirestoreClient::DisableNetwork(StatusCallback callback) {
   VerifyNotTerminated();
 
-  worker_queue_->Enqueue([this, callback] {
+  worker_queue_->Enqueue("FirestoreClient::DisableNetwork", [this, callback] {
     remote_store_->DisableNetwork();
     if (callback) {
       user_executor_->Execute([=] { callback(Status::OK()); });
@@ -337,7 +381,7 @@ void FirestoreClient::DisableNetwork(StatusCallback callback) {
 void FirestoreClient::EnableNetwork(StatusCallback callback) {
   VerifyNotTerminated();
 
-  worker_queue_->Enqueue([this, callback] {
+  worker_queue_->Enqueue("FirestoreClient::EnableNetwork", [this, callback] {
     remote_store_->EnableNetwork();
     if (callback) {
       user_executor_->Execute([=] { callback(Status::OK()); });
@@ -355,9 +399,10 @@ void FirestoreClient::WaitForPendingWrites(StatusCallback callback) {
     }
   };
 
-  worker_queue_->Enqueue([this, async_callback] {
-    sync_engine_->RegisterPendingWritesCallback(std::move(async_callback));
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::WaitForPendingWrites", [this, async_callback] {
+        sync_engine_->RegisterPendingWritesCallback(std::move(async_callback));
+      });
 }
 
 void FirestoreClient::VerifyNotTerminated() {
@@ -382,9 +427,10 @@ std::shared_ptr<QueryListener> FirestoreClient::ListenToQuery(
   auto query_listener = QueryListener::Create(
       std::move(query), std::move(options), std::move(listener));
 
-  worker_queue_->Enqueue([this, query_listener] {
-    event_manager_->AddQueryListener(std::move(query_listener));
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::ListenToQuery", [this, query_listener] {
+        event_manager_->AddQueryListener(std::move(query_listener));
+      });
 
   return query_listener;
 }
@@ -397,6 +443,7 @@ void FirestoreClient::RemoveListener(
     return;
   }
   worker_queue_->Enqueue(
+      "FirestoreClient::RemoveListener",
       [this, listener] { event_manager_->RemoveQueryListener(listener); });
 }
 
@@ -406,33 +453,35 @@ void FirestoreClient::GetDocumentFromLocalCache(
 
   // TODO(c++14): move `callback` into lambda.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
-  worker_queue_->Enqueue([this, doc, shared_callback] {
-    Document document = local_store_->ReadDocument(doc.key());
-    StatusOr<DocumentSnapshot> maybe_snapshot;
-
-    if (document->is_found_document()) {
-      maybe_snapshot = DocumentSnapshot::FromDocument(
-          doc.firestore(), document,
-          SnapshotMetadata{document->has_local_mutations(),
-                           /*from_cache=*/true});
-    } else if (document->is_no_document()) {
-      maybe_snapshot = DocumentSnapshot::FromNoDocument(
-          doc.firestore(), doc.key(),
-          SnapshotMetadata{/*pending_writes=*/false,
-                           /*from_cache=*/true});
-    } else {
-      maybe_snapshot =
-          Status{Error::kErrorUnavailable,
-                 "Failed to get document from cache. (However, this document "
-                 "may exist on the server. Run again without setting source to "
-                 "FirestoreSourceCache to attempt to retrieve the document "};
-    }
+  worker_queue_->Enqueue(
+      "FirestoreClient::GetDocumentFromLocalCache",
+      [this, doc, shared_callback] {
+        Document document = local_store_->ReadDocument(doc.key());
+        StatusOr<DocumentSnapshot> maybe_snapshot;
+
+        if (document->is_found_document()) {
+          maybe_snapshot = DocumentSnapshot::FromDocument(
+              doc.firestore(), document,
+              SnapshotMetadata{document->has_local_mutations(),
+                               /*from_cache=*/true});
+        } else if (document->is_no_document()) {
+          maybe_snapshot = DocumentSnapshot::FromNoDocument(
+              doc.firestore(), doc.key(),
+              SnapshotMetadata{/*pending_writes=*/false,
+                               /*from_cache=*/true});
+        } else {
+          maybe_snapshot = Status{
+              Error::kErrorUnavailable,
+              "Failed to get document from cache. (However, this document "
+              "may exist on the server. Run again without setting source to "
+              "FirestoreSourceCache to attempt to retrieve the document "};
+        }
 
-    if (shared_callback) {
-      user_executor_->Execute(
-          [=] { shared_callback->OnEvent(std::move(maybe_snapshot)); });
-    }
-  });
+        if (shared_callback) {
+          user_executor_->Execute(
+              [=] { shared_callback->OnEvent(std::move(maybe_snapshot)); });
+        }
+      });
 }
 
 void FirestoreClient::GetDocumentsFromLocalCache(
@@ -441,32 +490,34 @@ void FirestoreClient::GetDocumentsFromLocalCache(
 
   // TODO(c++14): move `callback` into lambda.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
-  worker_queue_->Enqueue([this, query, shared_callback] {
-    QueryResult query_result = local_store_->ExecuteQuery(
-        query.query(), /* use_previous_results= */ true);
-
-    View view(query.query(), query_result.remote_keys());
-    ViewDocumentChanges view_doc_changes =
-        view.ComputeDocumentChanges(query_result.documents());
-    ViewChange view_change = view.ApplyChanges(view_doc_changes);
-    HARD_ASSERT(
-        view_change.limbo_changes().empty(),
-        "View returned limbo documents during local-only query execution.");
-
-    HARD_ASSERT(view_change.snapshot().has_value(), "Expected a snapshot");
-
-    ViewSnapshot snapshot = std::move(view_change.snapshot()).value();
-    SnapshotMetadata metadata(snapshot.has_pending_writes(),
-                              snapshot.from_cache());
-
-    QuerySnapshot result(query.firestore(), query.query(), std::move(snapshot),
-                         std::move(metadata));
-
-    if (shared_callback) {
-      user_executor_->Execute(
-          [=] { shared_callback->OnEvent(std::move(result)); });
-    }
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::GetDocumentsFromLocalCache",
+      [this, query, shared_callback] {
+        QueryResult query_result = local_store_->ExecuteQuery(
+            query.query(), /* use_previous_results= */ true);
+
+        View view(query.query(), query_result.remote_keys());
+        ViewDocumentChanges view_doc_changes =
+            view.ComputeDocumentChanges(query_result.documents());
+        ViewChange view_change = view.ApplyChanges(view_doc_changes);
+        HARD_ASSERT(
+            view_change.limbo_changes().empty(),
+            "View returned limbo documents during local-only query execution.");
+
+        HARD_ASSERT(view_change.snapshot().has_value(), "Expected a snapshot");
+
+        ViewSnapshot snapshot = std::move(view_change.snapshot()).value();
+        SnapshotMetadata metadata(snapshot.has_pending_writes(),
+                                  snapshot.from_cache());
+
+        QuerySnapshot result(query.firestore(), query.query(),
+                             std::move(snapshot), std::move(metadata));
+
+        if (shared_callback) {
+          user_executor_->Execute(
+              [=] { shared_callback->OnEvent(std::move(result)); });
+        }
+      });
 }
 
 void FirestoreClient::WriteMutations(std::vector<Mutation>&& mutations,
@@ -474,21 +525,22 @@ void FirestoreClient::WriteMutations(std::vector<Mutation>&& mutations,
   VerifyNotTerminated();
 
   // TODO(c++14): move `mutations` into lambda (C++14).
-  worker_queue_->Enqueue([this, mutations, callback]() mutable {
-    if (mutations.empty()) {
-      if (callback) {
-        user_executor_->Execute([=] { callback(Status::OK()); });
-      }
-    } else {
-      sync_engine_->WriteMutations(
-          std::move(mutations), [this, callback](Status error) {
-            // Dispatch the result back onto the user dispatch queue.
-            if (callback) {
-              user_executor_->Execute([=] { callback(std::move(error)); });
-            }
-          });
-    }
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::WriteMutations", [this, mutations, callback]() mutable {
+        if (mutations.empty()) {
+          if (callback) {
+            user_executor_->Execute([=] { callback(Status::OK()); });
+          }
+        } else {
+          sync_engine_->WriteMutations(
+              std::move(mutations), [this, callback](Status error) {
+                // Dispatch the result back onto the user dispatch queue.
+                if (callback) {
+                  user_executor_->Execute([=] { callback(std::move(error)); });
+                }
+              });
+        }
+      });
 }
 
 void FirestoreClient::Transaction(int max_attempts,
@@ -503,25 +555,29 @@ void FirestoreClient::Transaction(int max_attempts,
     }
   };
 
-  worker_queue_->Enqueue([this, max_attempts, update_callback, async_callback] {
-    sync_engine_->Transaction(max_attempts, worker_queue_,
-                              std::move(update_callback),
-                              std::move(async_callback));
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::Transaction",
+      [this, max_attempts, update_callback, async_callback] {
+        sync_engine_->Transaction(max_attempts, worker_queue_,
+                                  std::move(update_callback),
+                                  std::move(async_callback));
+      });
 }
 
 void FirestoreClient::AddSnapshotsInSyncListener(
     const std::shared_ptr<EventListener<Empty>>& user_listener) {
-  worker_queue_->Enqueue([this, user_listener] {
-    event_manager_->AddSnapshotsInSyncListener(std::move(user_listener));
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::AddSnapshotsInSyncListener", [this, user_listener] {
+        event_manager_->AddSnapshotsInSyncListener(std::move(user_listener));
+      });
 }
 
 void FirestoreClient::RemoveSnapshotsInSyncListener(
     const std::shared_ptr<EventListener<Empty>>& user_listener) {
-  worker_queue_->Enqueue([this, user_listener] {
-    event_manager_->RemoveSnapshotsInSyncListener(user_listener);
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::RemoveSnapshotsInSyncListener", [this, user_listener] {
+        event_manager_->RemoveSnapshotsInSyncListener(user_listener);
+      });
 }
 
 void FirestoreClient::LoadBundle(
@@ -533,9 +589,10 @@ void FirestoreClient::LoadBundle(
       remote::Serializer(database_info_.database_id()));
   auto reader = std::make_shared<bundle::BundleReader>(
       std::move(bundle_serializer), std::move(bundle_data));
-  worker_queue_->Enqueue([this, reader, result_task] {
-    sync_engine_->LoadBundle(std::move(reader), std::move(result_task));
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::LoadBundle", [this, reader, result_task] {
+        sync_engine_->LoadBundle(std::move(reader), std::move(result_task));
+      });
 }
 
 void FirestoreClient::GetNamedQuery(const std::string& name,
@@ -562,9 +619,18 @@ void FirestoreClient::GetNamedQuery(const std::string& name,
         }
       };
 
-  worker_queue_->Enqueue([this, name, async_callback] {
-    async_callback(local_store_->GetNamedQuery(name));
-  });
+  worker_queue_->Enqueue(
+      "FirestoreClient::GetNamedQuery", [this, name, async_callback] {
+        async_callback(local_store_->GetNamedQuery(name));
+      });
+}
+
+void FirestoreClient::EnableQueueInstrumentation() {
+  worker_queue_->EnableInstrumentation();
+}
+
+util::AsyncQueueStats::Snapshot FirestoreClient::GetQueueStats() const {
+  return worker_queue_->GetStatsSnapshot();
 }
 
 }  // namespace core
@@ -40,6 +40,7 @@ namespace firebase {
 namespace firestore {
 
 namespace local {
+class IndexBackfiller;
 class LocalStore;
 class LruDelegate;
 class Persistence;
@@ -181,6 +182,19 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   void GetNamedQuery(const std::string& name, api::QueryCallback callback);
 
+  /**
+   * Starts recording the wait and run times of the operations on the worker
+   * queue, by the labels they were enqueued with.
+   */
+  void EnableQueueInstrumentation();
+
+  /**
+   * Returns the statistics recorded about the worker queue since
+   * `EnableQueueInstrumentation` was called. `ToString` on the result formats
+   * them for logging.
+   */
+  util::AsyncQueueStats::Snapshot GetQueueStats() const;
+
   /** For usage in this class and testing only. */
   const std::shared_ptr<util::AsyncQueue>& worker_queue() const {
     return worker_queue_;
@@ -206,6 +220,8 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   void ScheduleLruGarbageCollection();
 
+  void ScheduleIndexBackfill();
+
   DatabaseInfo database_info_;
   std::shared_ptr<credentials::AppCheckCredentialsProvider>
       app_check_credentials_provider_;
@@ -234,9 +250,14 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   std::chrono::milliseconds initial_gc_delay_ = std::chrono::minutes(1);
   std::chrono::milliseconds regular_gc_delay_ = std::chrono::minutes(5);
   bool gc_has_run_ = false;
+  std::chrono::milliseconds initial_backfill_delay_ = std::chrono::seconds(15);
+  std::chrono::milliseconds regular_backfill_delay_ = std::chrono::minutes(1);
+  bool backfill_has_run_ = false;
   bool credentials_initialized_ = false;
   local::LruDelegate* _Nullable lru_delegate_;
   util::DelayedOperation lru_callback_;
+  std::unique_ptr<local::IndexBackfiller> index_backfiller_;
+  util::DelayedOperation backfill_callback_;
 };
 
 }  // namespace core
@@ -229,6 +229,13 @@ class Query {
   /** Returns true if the document matches the constraints of this query. */
   bool Matches(const model::Document& doc) const;
 
+  /**
+   * Returns true if the document is located where this query reads from,
+   * regardless of its contents. Documents for which this is false can never
+   * match the query.
+   */
+  bool MatchesPathAndCollectionGroup(const model::Document& doc) const;
+
   /**
    * Returns a comparator that will sort documents according to the order by
    * clauses in this query.
@@ -251,7 +258,6 @@ class Query {
   size_t Hash() const;
 
  private:
-  bool MatchesPathAndCollectionGroup(const model::Document& doc) const;
   bool MatchesFilters(const model::Document& doc) const;
   bool MatchesOrderBy(const model::Document& doc) const;
   bool MatchesBounds(const model::Document& doc) const;
@@ -16,10 +16,14 @@
 
 #include "Firestore/core/src/core/sync_engine.h"
 
+#include <algorithm>
+#include <vector>
+
 #include "Firestore/core/include/firebase/firestore/firestore_errors.h"
 #include "Firestore/core/src/bundle/bundle_element.h"
 #include "Firestore/core/src/bundle/bundle_loader.h"
 #include "Firestore/core/src/core/sync_engine_callback.h"
+#include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/core/transaction.h"
 #include "Firestore/core/src/core/transaction_runner.h"
 #include "Firestore/core/src/local/local_documents_view.h"
@@ -34,6 +38,7 @@
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/mutation_batch_result.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/status.h"
 #include "absl/strings/match.h"
@@ -84,6 +89,24 @@ bool ErrorIsInteresting(const Status& error) {
   return missing_index || no_permission;
 }
 
+/**
+ * Returns the ID of the collection that documents matching `query` are in, or
+ * the collection group for collection group queries.
+ */
+const std::string& CollectionIdOf(const Query& query) {
+  if (query.IsCollectionGroupQuery()) {
+    return *query.collection_group();
+  }
+
+  const model::ResourcePath& path = query.path();
+  if (query.IsDocumentQuery()) {
+    HARD_ASSERT(path.size() >= 2, "Document query has an invalid path: %s",
+                path.CanonicalString());
+    return path[path.size() - 2];
+  }
+  return path.last_segment();
+}
+
 }  // namespace
 
 SyncEngine::SyncEngine(LocalStore* local_store,
@@ -97,6 +120,10 @@ SyncEngine::SyncEngine(LocalStore* local_store,
       max_concurrent_limbo_resolutions_(max_concurrent_limbo_resolutions) {
 }
 
+void SyncEngine::set_limbo_resolution_batch_size(size_t batch_size) {
+  limbo_resolution_batch_size_ = std::max(batch_size, size_t{1});
+}
+
 void SyncEngine::AssertCallbackExists(absl::string_view source) {
   HARD_ASSERT(sync_engine_callback_,
               "Tried to call '%s' before callback was registered.", source);
@@ -149,6 +176,7 @@ ViewSnapshot SyncEngine::InitializeViewAndComputeSnapshot(const Query& query,
   auto query_view =
       std::make_shared<QueryView>(query, target_id, std::move(view));
   query_views_by_query_[query] = query_view;
+  IndexQueryView(query_view);
 
   queries_by_target_[target_id].push_back(query);
 
@@ -164,6 +192,7 @@ void SyncEngine::StopListening(const Query& query) {
   auto query_view = query_views_by_query_[query];
   HARD_ASSERT(query_view, "Trying to stop listening to a query not found");
 
+  UnindexQueryView(*query_view);
   query_views_by_query_.erase(query);
 
   TargetId target_id = query_view->target_id();
@@ -180,6 +209,7 @@ void SyncEngine::StopListening(const Query& query) {
 
 void SyncEngine::RemoveAndCleanupTarget(TargetId target_id, Status status) {
   for (const Query& query : queries_by_target_.at(target_id)) {
+    UnindexQueryView(*query_views_by_query_.at(query));
     query_views_by_query_.erase(query);
     if (!status.ok()) {
       sync_engine_callback_->OnError(query, status);
@@ -279,27 +309,21 @@ void SyncEngine::ApplyRemoteEvent(const RemoteEvent& remote_event) {
       continue;
     }
 
-    LimboResolution& limbo_resolution = it->second;
-    // Since this is a limbo resolution lookup, it's for a single document and
-    // it could be added, modified, or removed, but not a combination.
-    auto changed_documents_count = change.added_documents().size() +
-                                   change.modified_documents().size() +
-                                   change.removed_documents().size();
-    HARD_ASSERT(
-        changed_documents_count <= 1,
-        "Limbo resolution for single document contains multiple changes.");
-
-    if (!change.added_documents().empty()) {
-      limbo_resolution.document_received = true;
-    } else if (!change.modified_documents().empty()) {
-      HARD_ASSERT(limbo_resolution.document_received,
+    // Each document of a limbo resolution could be added, modified, or
+    // removed. A change without documents was probably just a CURRENT target
+    // change or similar.
+    DocumentKeySet& received = it->second.received_documents;
+    for (const DocumentKey& key : change.added_documents()) {
+      received = received.insert(key);
+    }
+    for (const DocumentKey& key : change.modified_documents()) {
+      HARD_ASSERT(received.contains(key),
                   "Received change for limbo target document without add.");
-    } else if (!change.removed_documents().empty()) {
-      HARD_ASSERT(limbo_resolution.document_received,
+    }
+    for (const DocumentKey& key : change.removed_documents()) {
+      HARD_ASSERT(received.contains(key),
                   "Received remove for limbo target document without add.");
-      limbo_resolution.document_received = false;
-    } else {
-      // This was probably just a CURRENT target change or similar.
+      received = received.erase(key);
     }
   }
 
@@ -312,30 +336,34 @@ void SyncEngine::HandleRejectedListen(TargetId target_id, Status error) {
 
   auto it = active_limbo_resolutions_by_target_.find(target_id);
   if (it != active_limbo_resolutions_by_target_.end()) {
-    DocumentKey limbo_key = it->second.key;
+    DocumentKeySet limbo_documents = it->second.keys;
     // Since this query failed, we won't want to manually unlisten to it.
     // So go ahead and remove it from bookkeeping.
-    active_limbo_targets_by_key_.erase(limbo_key);
+    for (const DocumentKey& limbo_key : limbo_documents) {
+      active_limbo_targets_by_key_.erase(limbo_key);
+    }
     active_limbo_resolutions_by_target_.erase(target_id);
     PumpEnqueuedLimboResolutions();
 
     // TODO(dimond): Retry on transient errors?
 
-    // It's a limbo doc. Create a synthetic event saying it was deleted. This is
-    // kind of a hack. Ideally, we would have a method in the local store to
-    // purge a document. However, it would be tricky to keep all of the local
-    // store's invariants with another method.
-    MutableDocument doc =
-        MutableDocument::NoDocument(limbo_key, SnapshotVersion::None());
+    // They're limbo docs. Create a synthetic event saying they were deleted.
+    // This is kind of a hack. Ideally, we would have a method in the local
+    // store to purge a document. However, it would be tricky to keep all of
+    // the local store's invariants with another method.
 
     // Explicitly instantiate these to work around a bug in the default
     // constructor of the std::unordered_map that comes with GCC 4.8. Without
     // this GCC emits a spurious "chosen constructor is explicit in
     // copy-initialization" error.
-    DocumentKeySet limbo_documents{limbo_key};
     RemoteEvent::TargetChangeMap target_changes;
     RemoteEvent::TargetSet target_mismatches;
-    DocumentUpdateMap document_updates{{limbo_key, doc}};
+    DocumentUpdateMap document_updates;
+    for (const DocumentKey& limbo_key : limbo_documents) {
+      document_updates.emplace(
+          limbo_key,
+          MutableDocument::NoDocument(limbo_key, SnapshotVersion::None()));
+    }
 
     RemoteEvent event{SnapshotVersion::None(), std::move(target_changes),
                       std::move(target_mismatches), std::move(document_updates),
@@ -407,9 +435,8 @@ void SyncEngine::HandleOnlineStateChange(model::OnlineState online_state) {
 
 DocumentKeySet SyncEngine::GetRemoteKeys(TargetId target_id) const {
   auto it = active_limbo_resolutions_by_target_.find(target_id);
-  if (it != active_limbo_resolutions_by_target_.end() &&
-      it->second.document_received) {
-    return DocumentKeySet{it->second.key};
+  if (it != active_limbo_resolutions_by_target_.end()) {
+    return it->second.received_documents;
   } else {
     DocumentKeySet keys;
     if (queries_by_target_.count(target_id) == 0) {
@@ -463,25 +490,100 @@ void SyncEngine::FailOutstandingPendingWriteCallbacks(
   pending_writes_callbacks_.clear();
 }
 
+void SyncEngine::IndexQueryView(const std::shared_ptr<QueryView>& query_view) {
+  query_views_by_collection_id_[CollectionIdOf(query_view->query())].push_back(
+      query_view);
+}
+
+void SyncEngine::UnindexQueryView(const QueryView& query_view) {
+  auto found =
+      query_views_by_collection_id_.find(CollectionIdOf(query_view.query()));
+  HARD_ASSERT(found != query_views_by_collection_id_.end(),
+              "Query view for %s is not indexed",
+              query_view.query().ToString());
+
+  auto& query_views = found->second;
+  query_views.erase(
+      std::remove_if(query_views.begin(), query_views.end(),
+                     [&](const std::shared_ptr<QueryView>& indexed) {
+                       return indexed.get() == &query_view;
+                     }),
+      query_views.end());
+  if (query_views.empty()) {
+    query_views_by_collection_id_.erase(found);
+  }
+}
+
+std::unordered_map<const SyncEngine::QueryView*, DocumentMap>
+SyncEngine::RouteDocumentChanges(const DocumentMap& changes) const {
+  std::unordered_map<const QueryView*, DocumentMap> changes_by_view;
+  for (const auto& kv : changes) {
+    const model::ResourcePath& path = kv.first.path();
+    auto found = query_views_by_collection_id_.find(path[path.size() - 2]);
+    if (found == query_views_by_collection_id_.end()) {
+      continue;
+    }
+
+    for (const auto& query_view : found->second) {
+      if (query_view->query().MatchesPathAndCollectionGroup(kv.second)) {
+        DocumentMap& view_changes = changes_by_view[query_view.get()];
+        view_changes = view_changes.insert(kv.first, kv.second);
+      }
+    }
+  }
+  return changes_by_view;
+}
+
 void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
     const DocumentMap& changes,
     const absl::optional<RemoteEvent>& maybe_remote_event) {
   std::vector<ViewSnapshot> new_snapshots;
   std::vector<LocalViewChanges> document_changes_in_all_views;
 
+  // Only hand each view the changed documents it could contain. Views without
+  // any still get their target change and sync state applied below.
+  std::unordered_map<const QueryView*, DocumentMap> changes_by_view =
+      RouteDocumentChanges(changes);
+
+  std::vector<QueryView*> query_views;
+  std::vector<ViewDocumentChanges> view_doc_changes;
+  std::vector<size_t> refills;
   for (const auto& entry : query_views_by_query_) {
-    const auto& query_view = entry.second;
-    View& view = query_view->view();
-    ViewDocumentChanges view_doc_changes = view.ComputeDocumentChanges(changes);
-    if (view_doc_changes.needs_refill()) {
-      // The query has a limit and some docs were removed/updated, so we need to
-      // re-run the query against the local store to make sure we didn't lose
-      // any good docs that had been past the limit.
-      QueryResult query_result = local_store_->ExecuteQuery(
-          query_view->query(), /* use_previous_results= */ false);
-      view_doc_changes = view.ComputeDocumentChanges(query_result.documents(),
-                                                     view_doc_changes);
+    QueryView* query_view = entry.second.get();
+    const View& view = query_view->view();
+    auto view_changes = changes_by_view.find(query_view);
+    if (view_changes != changes_by_view.end()) {
+      view_doc_changes.push_back(
+          view.ComputeDocumentChanges(view_changes->second));
+    } else {
+      view_doc_changes.push_back(view.UnchangedDocuments());
+    }
+    if (view_doc_changes.back().needs_refill()) {
+      refills.push_back(query_views.size());
     }
+    query_views.push_back(query_view);
+  }
+
+  if (!refills.empty()) {
+    // Some queries have a limit and some docs were removed/updated, so we need
+    // to re-run them against the local store to make sure we didn't lose any
+    // good docs that had been past the limit. They are re-run together so that
+    // they can share their reads.
+    std::vector<Query> queries;
+    for (size_t i : refills) {
+      queries.push_back(query_views[i]->query());
+    }
+    std::vector<DocumentMap> results = local_store_->ExecuteQueries(queries);
+    for (size_t j = 0; j < refills.size(); ++j) {
+      size_t i = refills[j];
+      view_doc_changes[i] = query_views[i]->view().ComputeDocumentChanges(
+          results[j], view_doc_changes[i]);
+    }
+  }
+
+  for (size_t i = 0; i < query_views.size(); ++i) {
+    QueryView* query_view = query_views[i];
+    View& view = query_view->view();
 
     absl::optional<TargetChange> target_changes;
     if (maybe_remote_event.has_value()) {
@@ -492,7 +594,7 @@ void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
       }
     }
     ViewChange view_change =
-        view.ApplyChanges(view_doc_changes, target_changes);
+        view.ApplyChanges(view_doc_changes[i], target_changes);
 
     UpdateTrackedLimboDocuments(view_change.limbo_changes(),
                                 query_view->target_id());
@@ -532,6 +634,10 @@ void SyncEngine::UpdateTrackedLimboDocuments(
         HARD_FAIL("Unknown limbo change type: %s", limbo_change.type());
     }
   }
+
+  // Starts the resolutions once all new documents in limbo are enqueued, such
+  // that they can share targets.
+  PumpEnqueuedLimboResolutions();
 }
 
 void SyncEngine::TrackLimboChange(const LimboDocumentChange& limbo_change) {
@@ -540,21 +646,29 @@ void SyncEngine::TrackLimboChange(const LimboDocumentChange& limbo_change) {
           active_limbo_targets_by_key_.end() &&
       enqueued_limbo_resolutions_.push_back(key)) {
     LOG_DEBUG("New document in limbo: %s", key.ToString());
-    PumpEnqueuedLimboResolutions();
   }
 }
 
 void SyncEngine::PumpEnqueuedLimboResolutions() {
   while (!enqueued_limbo_resolutions_.empty() &&
-         active_limbo_targets_by_key_.size() <
+         active_limbo_resolutions_by_target_.size() <
              max_concurrent_limbo_resolutions_) {
-    DocumentKey key = enqueued_limbo_resolutions_.front();
-    enqueued_limbo_resolutions_.pop_front();
     TargetId limbo_target_id = target_id_generator_.NextId();
-    active_limbo_resolutions_by_target_.emplace(limbo_target_id,
-                                                LimboResolution{key});
-    active_limbo_targets_by_key_.emplace(key, limbo_target_id);
-    remote_store_->Listen(TargetData(Query(key.path()).ToTarget(),
+    std::vector<DocumentKey> keys;
+    while (!enqueued_limbo_resolutions_.empty() &&
+           keys.size() < limbo_resolution_batch_size_) {
+      keys.push_back(enqueued_limbo_resolutions_.front());
+      enqueued_limbo_resolutions_.pop_front();
+      active_limbo_targets_by_key_.emplace(keys.back(), limbo_target_id);
+    }
+
+    DocumentKeySet key_set;
+    for (const DocumentKey& key : keys) {
+      key_set = key_set.insert(key);
+    }
+    active_limbo_resolutions_by_target_.emplace(
+        limbo_target_id, LimboResolution{std::move(key_set)});
+    remote_store_->Listen(TargetData(Target::ForDocuments(std::move(keys)),
                                      limbo_target_id, kIrrelevantSequenceNumber,
                                      QueryPurpose::LimboResolution));
   }
@@ -569,17 +683,36 @@ void SyncEngine::RemoveLimboTarget(const DocumentKey& key) {
   }
 
   TargetId limbo_target_id = it->second;
-  remote_store_->StopListening(limbo_target_id);
-  active_limbo_targets_by_key_.erase(key);
-  active_limbo_resolutions_by_target_.erase(limbo_target_id);
-  PumpEnqueuedLimboResolutions();
+  active_limbo_targets_by_key_.erase(it);
+
+  // The target keeps listening to the other documents it resolves.
+  LimboResolution& limbo_resolution =
+      active_limbo_resolutions_by_target_.at(limbo_target_id);
+  limbo_resolution.keys = limbo_resolution.keys.erase(key);
+  if (limbo_resolution.keys.empty()) {
+    remote_store_->StopListening(limbo_target_id);
+    active_limbo_resolutions_by_target_.erase(limbo_target_id);
+    PumpEnqueuedLimboResolutions();
+  }
 }
 
 absl::optional<BundleLoader> SyncEngine::ReadIntoLoader(
     const bundle::BundleMetadata& metadata,
     bundle::BundleReader& reader,
     api::LoadBundleTask& result_task) {
-  BundleLoader loader(local_store_, metadata);
+  absl::optional<bundle::BundleLoadCheckpoint> checkpoint;
+  if (bundle_chunk_size_ > 0) {
+    checkpoint = local_store_->GetBundleLoadCheckpoint(metadata);
+    if (checkpoint.has_value()) {
+      LOG_DEBUG("Resuming load of bundle %s after %s documents",
+                metadata.bundle_id(), checkpoint->documents_loaded());
+      reader.SkipDocumentsUntil(
+          static_cast<int64_t>(checkpoint->bytes_loaded()));
+    }
+  }
+
+  BundleLoader loader(local_store_, metadata, bundle_chunk_size_,
+                      std::move(checkpoint));
   int64_t current_bytes_read = 0;
   // Breaks when either error happened, or when there is no more element to
   // read.
@@ -609,6 +742,12 @@ absl::optional<BundleLoader> SyncEngine::ReadIntoLoader(
     }
 
     if (maybe_progress.ValueOrDie().has_value()) {
+      // Raise the changes of committed chunks right away, so that they do not
+      // accumulate for the whole bundle.
+      DocumentMap changes = loader.TakeCommittedChanges();
+      if (!changes.empty()) {
+        EmitNewSnapshotsAndNotifyLocalStore(changes, absl::nullopt);
+      }
       result_task.UpdateProgress(maybe_progress.ConsumeValueOrDie().value());
     }
   }
@@ -33,6 +33,7 @@
 #include "Firestore/core/src/core/target_id_generator.h"
 #include "Firestore/core/src/core/view.h"
 #include "Firestore/core/src/local/reference_set.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/remote/remote_store.h"
 #include "Firestore/core/src/util/random_access_queue.h"
@@ -153,6 +154,20 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
   void LoadBundle(std::shared_ptr<bundle::BundleReader> reader,
                   std::shared_ptr<api::LoadBundleTask> result_task);
 
+  /**
+   * Sets the number of documents that `LoadBundle()` commits per transaction,
+   * or 0 to commit all documents of a bundle at once.
+   */
+  void set_bundle_chunk_size(uint32_t bundle_chunk_size) {
+    bundle_chunk_size_ = bundle_chunk_size;
+  }
+
+  /**
+   * Sets how many documents in limbo may be resolved by a single target. At
+   * least one document is resolved per target.
+   */
+  void set_limbo_resolution_batch_size(size_t batch_size);
+
   // For tests only
   std::map<model::DocumentKey, model::TargetId>
   GetActiveLimboDocumentResolutions() const {
@@ -206,23 +221,29 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
     View view_;
   };
 
-  /** Tracks a limbo resolution. */
+  /** Tracks a limbo resolution, which listens to one or more documents. */
   class LimboResolution {
    public:
     LimboResolution() = default;
 
-    explicit LimboResolution(const model::DocumentKey& key) : key{key} {
+    explicit LimboResolution(model::DocumentKeySet keys)
+        : keys{std::move(keys)} {
     }
 
-    model::DocumentKey key;
+    /**
+     * The documents that are still in limbo and resolved by this target. A
+     * document that leaves limbo is removed, and the target is stopped once
+     * none are left.
+     */
+    model::DocumentKeySet keys;
 
     /**
-     * Set to true once we've received a document. This is used in
+     * The documents of the target that we've received. This is used in
      * RemoteKeysForTarget and ultimately used by `WatchChangeAggregator` to
-     * decide whether it needs to manufacture a delete event for the target once
+     * decide whether it needs to manufacture a delete event for a document once
      * the target is CURRENT.
      */
-    bool document_received = false;
+    model::DocumentKeySet received_documents;
   };
 
   void AssertCallbackExists(absl::string_view source);
@@ -232,6 +253,16 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
 
   void RemoveAndCleanupTarget(model::TargetId target_id, util::Status status);
 
+  void IndexQueryView(const std::shared_ptr<QueryView>& query_view);
+  void UnindexQueryView(const QueryView& query_view);
+
+  /**
+   * Splits `changes` by the query views whose queries could match them. Views
+   * without an entry have no changed documents they could contain.
+   */
+  std::unordered_map<const QueryView*, model::DocumentMap> RouteDocumentChanges(
+      const model::DocumentMap& changes) const;
+
   void RemoveLimboTarget(const model::DocumentKey& key);
 
   void EmitNewSnapshotsAndNotifyLocalStore(
@@ -247,10 +278,11 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
 
   /**
    * Starts listens for documents in limbo that are enqueued for resolution,
-   * subject to a maximum number of concurrent resolutions.
+   * subject to a maximum number of concurrent resolutions. Each listen
+   * resolves up to `limbo_resolution_batch_size_` documents.
    *
-   * The maximum number of concurrent limbo resolutions is defined in
-   * max_concurrent_limbo_resolutions_.
+   * The maximum number of concurrent limbo resolutions, which is the number of
+   * limbo targets, is defined in max_concurrent_limbo_resolutions_.
    *
    * Without bounding the number of concurrent resolutions, the server can fail
    * with "resource exhausted" errors which can lead to pathological client
@@ -305,8 +337,22 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
   /** Queries mapped to Targets, indexed by target ID. */
   std::unordered_map<model::TargetId, std::vector<Query>> queries_by_target_;
 
+  /**
+   * QueryViews for all active queries, indexed by the ID of the collection
+   * that their documents are in (the collection group for collection group
+   * queries). Used to find the views a changed document could belong to.
+   */
+  std::unordered_map<std::string, std::vector<std::shared_ptr<QueryView>>>
+      query_views_by_collection_id_;
+
   const size_t max_concurrent_limbo_resolutions_;
 
+  /** The maximum number of documents resolved by one limbo target. */
+  size_t limbo_resolution_batch_size_ = 1;
+
+  /** The number of documents committed per transaction by `LoadBundle()`. */
+  uint32_t bundle_chunk_size_ = 0;
+
   /**
    * The keys of documents that are in limbo for which we haven't yet started a
    * limbo resolution query.
@@ -28,6 +28,7 @@
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/util/equality.h"
+#include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/hashing.h"
 #include "Firestore/core/src/util/maps.h"
 #include "absl/strings/str_cat.h"
@@ -57,6 +58,23 @@ std::vector<google_firestore_v1_Value> MakeValueVector(
 
 }  // namespace
 
+Target Target::ForDocuments(std::vector<DocumentKey> keys) {
+  HARD_ASSERT(!keys.empty(), "A documents target needs at least one document");
+
+  // Matches the implicit order of a document query.
+  OrderByList order_bys = OrderByList().emplace_back(FieldPath::KeyFieldPath(),
+                                                     Direction::Ascending);
+  if (keys.size() == 1) {
+    return Target(keys.front().path(), nullptr, {}, std::move(order_bys),
+                  kNoLimit, absl::nullopt, absl::nullopt);
+  }
+
+  Target target(model::ResourcePath(), nullptr, {}, std::move(order_bys),
+                kNoLimit, absl::nullopt, absl::nullopt);
+  target.document_keys_ = std::move(keys);
+  return target;
+}
+
 // MARK: - Accessors
 
 bool Target::IsDocumentQuery() const {
@@ -64,6 +82,19 @@ bool Target::IsDocumentQuery() const {
          filters_.empty();
 }
 
+bool Target::IsDocumentsTarget() const {
+  return !document_keys_.empty() || IsDocumentQuery();
+}
+
+std::vector<DocumentKey> Target::GetDocumentKeys() const {
+  if (!document_keys_.empty()) {
+    return document_keys_;
+  }
+  HARD_ASSERT(IsDocumentQuery(), "Target %s doesn't list documents",
+              ToString());
+  return {DocumentKey(path_)};
+}
+
 // MARK: - Indexing support
 
 size_t Target::GetSegmentCount() const {
@@ -342,6 +373,15 @@ const std::string& Target::CanonicalId() const {
   std::string result;
   absl::StrAppend(&result, path_.CanonicalString());
 
+  // Add the documents of a target for several documents.
+  if (!document_keys_.empty()) {
+    absl::StrAppend(&result, "|docs:");
+    for (size_t i = 0; i < document_keys_.size(); ++i) {
+      absl::StrAppend(&result, i > 0 ? "," : "",
+                      document_keys_[i].path().CanonicalString());
+    }
+  }
+
   if (collection_group_) {
     absl::StrAppend(&result, "|cg:", *collection_group_);
   }
@@ -394,7 +434,8 @@ bool operator==(const Target& lhs, const Target& rhs) {
          util::Equals(lhs.collection_group(), rhs.collection_group()) &&
          lhs.filters() == rhs.filters() && lhs.order_bys() == rhs.order_bys() &&
          lhs.limit() == rhs.limit() && lhs.start_at() == rhs.start_at() &&
-         lhs.end_at() == rhs.end_at();
+         lhs.end_at() == rhs.end_at() &&
+         lhs.document_keys_ == rhs.document_keys_;
 }
 
 }  // namespace core
@@ -29,6 +29,7 @@
 #include "Firestore/core/src/core/filter.h"
 #include "Firestore/core/src/core/order_by.h"
 #include "Firestore/core/src/immutable/append_only_list.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/field_index.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/remote/serializer.h"
@@ -64,6 +65,14 @@ class Target {
 
   Target() = default;
 
+  /**
+   * Creates a target for the documents with the given keys, which don't need
+   * to be in the same collection. A target for a single document is the same
+   * as the target of its document query. Targets for several documents don't
+   * correspond to a query and can only be listened to.
+   */
+  static Target ForDocuments(std::vector<model::DocumentKey> keys);
+
   // MARK: - Accessors
 
   /** The base path of the target. */
@@ -79,6 +88,15 @@ class Target {
   /** Returns true if this Target is for a specific document. */
   bool IsDocumentQuery() const;
 
+  /**
+   * Returns true if this Target lists its documents by key, either as a
+   * document query or as created by `ForDocuments()`.
+   */
+  bool IsDocumentsTarget() const;
+
+  /** Returns the keys of the documents listed by a documents target. */
+  std::vector<model::DocumentKey> GetDocumentKeys() const;
+
   /** The filters on the documents returned by the target. */
   const FilterList& filters() const {
     return filters_;
@@ -146,6 +164,8 @@ class Target {
 
   friend std::ostream& operator<<(std::ostream& os, const Target& target);
 
+  friend bool operator==(const Target& lhs, const Target& rhs);
+
   size_t Hash() const;
 
  private:
@@ -216,6 +236,9 @@ class Target {
   absl::optional<Bound> start_at_;
   absl::optional<Bound> end_at_;
 
+  /** The documents of a target for several documents, otherwise empty. */
+  std::vector<model::DocumentKey> document_keys_;
+
   mutable std::string canonical_id_;
 };
 
@@ -232,6 +232,13 @@ ViewDocumentChanges View::ComputeDocumentChanges(
                              new_mutated_keys, needs_refill);
 }
 
+ViewDocumentChanges View::UnchangedDocuments() const {
+  // The document set never exceeds the limit once changes were applied, so
+  // there is nothing to trim either.
+  return ViewDocumentChanges(document_set_, DocumentViewChangeSet{},
+                             mutated_keys_, /* needs_refill= */ false);
+}
+
 bool View::ShouldWaitForSyncedDocument(const Document& new_doc,
                                        const Document& old_doc) const {
   // We suppress the initial change event for documents that were modified as
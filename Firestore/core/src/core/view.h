@@ -161,6 +161,12 @@ class View {
       const absl::optional<core::ViewDocumentChanges>& previous_changes =
           absl::nullopt) const;
 
+  /**
+   * Returns the result of `ComputeDocumentChanges()` for an empty set of doc
+   * changes, without iterating over anything.
+   */
+  core::ViewDocumentChanges UnchangedDocuments() const;
+
   /**
    * Updates the view with the given ViewDocumentChanges.
    *
@@ -26,6 +26,7 @@ namespace firestore {
 
 namespace bundle {
 
+class BundleLoadCheckpoint;
 class BundleMetadata;
 class NamedQuery;
 
@@ -68,6 +69,25 @@ class BundleCache {
    * Saves a `NamedQuery` from a bundle, using its name as the persistent key.
    */
   virtual void SaveNamedQuery(const bundle::NamedQuery& query) = 0;
+
+  /**
+   * Gets the checkpoint of an incomplete load of the bundle with the given id.
+   *
+   * @return The last `BundleLoadCheckpoint` saved for the given bundle id, or
+   * nullopt if no load of the bundle is in progress.
+   */
+  virtual absl::optional<bundle::BundleLoadCheckpoint> GetBundleLoadCheckpoint(
+      const std::string& bundle_id) const = 0;
+
+  /**
+   * Saves the checkpoint of a bundle load, replacing any checkpoint saved for
+   * the same bundle id.
+   */
+  virtual void SaveBundleLoadCheckpoint(
+      const bundle::BundleLoadCheckpoint& checkpoint) = 0;
+
+  /** Removes the checkpoint saved for the given bundle id, if any. */
+  virtual void RemoveBundleLoadCheckpoint(const std::string& bundle_id) = 0;
 };
 
 }  // namespace local
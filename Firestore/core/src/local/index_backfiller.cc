@@ -0,0 +1,120 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/index_backfiller.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_set>
+
+#include "Firestore/core/src/local/index_manager.h"
+#include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/src/util/log.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+using model::IndexOffset;
+using util::ComparisonResult;
+
+constexpr size_t IndexBackfiller::kDefaultMaxDocumentsToProcess;
+
+IndexBackfiller::IndexBackfiller(size_t max_documents_to_process)
+    : max_documents_to_process_(max_documents_to_process) {
+}
+
+IndexBackfillerResults IndexBackfiller::WriteIndexEntries(
+    IndexManager* index_manager, LocalDocumentsView* local_documents) {
+  auto start = std::chrono::steady_clock::now();
+
+  std::unordered_set<std::string> processed_collection_groups;
+  size_t documents_remaining = max_documents_to_process_;
+  while (documents_remaining > 0) {
+    absl::optional<std::string> collection_group =
+        index_manager->GetNextCollectionGroupToUpdate();
+    if (!collection_group.has_value() ||
+        processed_collection_groups.count(*collection_group) > 0) {
+      break;
+    }
+
+    LOG_DEBUG("Processing collection: %s", *collection_group);
+    size_t documents_processed = WriteEntriesForCollectionGroup(
+        index_manager, local_documents, *collection_group,
+        documents_remaining);
+    documents_remaining -= std::min(documents_processed, documents_remaining);
+    processed_collection_groups.insert(*std::move(collection_group));
+  }
+
+  if (processed_collection_groups.empty()) {
+    return IndexBackfillerResults::DidNotRun();
+  }
+
+  size_t documents_processed = max_documents_to_process_ - documents_remaining;
+  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start);
+  total_documents_processed_ += documents_processed;
+  total_duration_ += duration;
+
+  LOG_DEBUG("Index backfill processed %s documents in %s collection groups "
+            "in %sms",
+            documents_processed, processed_collection_groups.size(),
+            duration.count());
+
+  return IndexBackfillerResults{/* did_run= */ true,
+                                processed_collection_groups.size(),
+                                documents_processed, duration};
+}
+
+size_t IndexBackfiller::WriteEntriesForCollectionGroup(
+    IndexManager* index_manager,
+    LocalDocumentsView* local_documents,
+    const std::string& collection_group,
+    size_t documents_remaining_under_cap) {
+  // Use the earliest offset of all field indexes to query the local cache.
+  IndexOffset existing_offset = index_manager->GetMinOffset(collection_group);
+
+  LocalDocumentsResult next_batch = local_documents->GetNextDocuments(
+      collection_group, existing_offset, documents_remaining_under_cap);
+  index_manager->UpdateIndexEntries(next_batch.documents);
+
+  IndexOffset new_offset = GetNewOffset(existing_offset, next_batch);
+  index_manager->UpdateCollectionGroup(collection_group, new_offset);
+
+  return next_batch.documents.size();
+}
+
+IndexOffset IndexBackfiller::GetNewOffset(
+    const IndexOffset& existing_offset,
+    const LocalDocumentsResult& lookup_result) const {
+  IndexOffset max_offset = existing_offset;
+  for (const auto& entry : lookup_result.documents) {
+    IndexOffset new_offset = IndexOffset::FromDocument(entry.second);
+    if (new_offset.CompareTo(max_offset) == ComparisonResult::Descending) {
+      max_offset = new_offset;
+    }
+  }
+  return IndexOffset(
+      max_offset.read_time(), max_offset.document_key(),
+      std::max(lookup_result.largest_batch_id,
+               existing_offset.largest_batch_id()));
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_H_
+#define FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <string>
+
+#include "Firestore/core/src/api/settings.h"
+#include "Firestore/core/src/model/model_fwd.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+class IndexManager;
+struct LocalDocumentsResult;
+class LocalDocumentsView;
+
+struct IndexBackfillerResults {
+  static IndexBackfillerResults DidNotRun() {
+    return IndexBackfillerResults{/* did_run= */ false, 0, 0,
+                                  std::chrono::milliseconds(0)};
+  }
+
+  bool did_run;
+  size_t collection_groups_processed;
+  size_t documents_processed;
+  std::chrono::milliseconds duration;
+};
+
+/**
+ * Implements the steps for backfilling indexes: documents that were written
+ * before a field index was configured are read in bounded batches, ordered by
+ * read time, and their index entries are written.
+ *
+ * The backfiller keeps no reference to the local store; each run must happen
+ * inside a persistence transaction (see `LocalStore::Backfill`).
+ */
+class IndexBackfiller {
+ public:
+  /** The default maximum number of documents to process in each run. */
+  static constexpr size_t kDefaultMaxDocumentsToProcess =
+      api::Settings::DefaultIndexBackfillMaxDocuments;
+
+  explicit IndexBackfiller(
+      size_t max_documents_to_process = kDefaultMaxDocumentsToProcess);
+
+  /**
+   * Writes index entries for up to `max_documents_to_process()` documents,
+   * visiting the least recently updated collection groups first.
+   */
+  IndexBackfillerResults WriteIndexEntries(
+      IndexManager* index_manager, LocalDocumentsView* local_documents);
+
+  size_t max_documents_to_process() const {
+    return max_documents_to_process_;
+  }
+
+  void set_max_documents_to_process(size_t max_documents_to_process) {
+    max_documents_to_process_ = max_documents_to_process;
+  }
+
+  /** The number of documents processed over all runs. */
+  size_t total_documents_processed() const {
+    return total_documents_processed_;
+  }
+
+  /** The time spent writing index entries over all runs. */
+  std::chrono::milliseconds total_duration() const {
+    return total_duration_;
+  }
+
+ private:
+  /**
+   * Writes entries for the provided collection group. Returns the number of
+   * documents processed.
+   */
+  size_t WriteEntriesForCollectionGroup(IndexManager* index_manager,
+                                        LocalDocumentsView* local_documents,
+                                        const std::string& collection_group,
+                                        size_t documents_remaining_under_cap);
+
+  /** Returns the next offset based on the provided documents. */
+  model::IndexOffset GetNewOffset(
+      const model::IndexOffset& existing_offset,
+      const LocalDocumentsResult& lookup_result) const;
+
+  size_t max_documents_to_process_;
+  size_t total_documents_processed_ = 0;
+  std::chrono::milliseconds total_duration_{0};
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_H_
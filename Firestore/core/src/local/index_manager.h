@@ -142,6 +142,18 @@ class IndexManager {
   virtual absl::optional<std::vector<model::DocumentKey>>
   GetDocumentsMatchingTarget(const core::Target& target) = 0;
 
+  /**
+   * Returns an estimate of the number of documents that
+   * `GetDocumentsMatchingTarget()` reads to serve the given target, or
+   * `nullopt` if the target cannot be served from an index.
+   *
+   * The estimate only scans index entry keys and stops once `max_count`
+   * entries have been seen, so that callers can bound the cost of the
+   * estimate by the cost of the cheapest alternative.
+   */
+  virtual absl::optional<size_t> EstimateDocumentsMatchingTarget(
+      const core::Target& target, size_t max_count) = 0;
+
   /**
    * Returns the next collection group to update. Returns `nullopt` if no
    * group exists.
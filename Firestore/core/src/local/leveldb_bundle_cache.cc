@@ -24,15 +24,51 @@
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/ordered_code.h"
 
 namespace firebase {
 namespace firestore {
 namespace local {
 
+using bundle::BundleLoadCheckpoint;
 using bundle::BundleMetadata;
 using bundle::NamedQuery;
+using model::SnapshotVersion;
 using nanopb::Message;
 using nanopb::StringReader;
+using util::OrderedCode;
+
+namespace {
+
+std::string EncodeBundleLoadCheckpoint(const BundleLoadCheckpoint& checkpoint) {
+  std::string encoded;
+  OrderedCode::WriteSignedNumIncreasing(
+      &encoded, checkpoint.create_time().timestamp().seconds());
+  OrderedCode::WriteSignedNumIncreasing(
+      &encoded, checkpoint.create_time().timestamp().nanoseconds());
+  OrderedCode::WriteNumIncreasing(&encoded, checkpoint.documents_loaded());
+  OrderedCode::WriteNumIncreasing(&encoded, checkpoint.bytes_loaded());
+  return encoded;
+}
+
+BundleLoadCheckpoint DecodeBundleLoadCheckpoint(const std::string& bundle_id,
+                                                absl::string_view encoded) {
+  int64_t seconds = 0;
+  int64_t nanos = 0;
+  uint64_t documents_loaded = 0;
+  uint64_t bytes_loaded = 0;
+  if (!OrderedCode::ReadSignedNumIncreasing(&encoded, &seconds) ||
+      !OrderedCode::ReadSignedNumIncreasing(&encoded, &nanos) ||
+      !OrderedCode::ReadNumIncreasing(&encoded, &documents_loaded) ||
+      !OrderedCode::ReadNumIncreasing(&encoded, &bytes_loaded)) {
+    HARD_FAIL("Failed to read checkpoint of bundle %s", bundle_id);
+  }
+  return BundleLoadCheckpoint(
+      bundle_id, SnapshotVersion({seconds, static_cast<int32_t>(nanos)}),
+      static_cast<uint32_t>(documents_loaded), bytes_loaded);
+}
+
+}  // namespace
 
 LevelDbBundleCache::LevelDbBundleCache(LevelDbPersistence* db,
                                        LocalSerializer* serializer)
@@ -99,6 +135,32 @@ void LevelDbBundleCache::SaveNamedQuery(const NamedQuery& query) {
   db_->current_transaction()->Put(key, serializer_->EncodeNamedQuery(query));
 }
 
+absl::optional<BundleLoadCheckpoint>
+LevelDbBundleCache::GetBundleLoadCheckpoint(
+    const std::string& bundle_id) const {
+  auto key = LevelDbBundleLoadCheckpointKey::Key(bundle_id);
+  std::string encoded;
+  auto done = db_->current_transaction()->Get(key, &encoded);
+
+  if (!done.ok()) {
+    return absl::nullopt;
+  }
+
+  return DecodeBundleLoadCheckpoint(bundle_id, encoded);
+}
+
+void LevelDbBundleCache::SaveBundleLoadCheckpoint(
+    const BundleLoadCheckpoint& checkpoint) {
+  auto key = LevelDbBundleLoadCheckpointKey::Key(checkpoint.bundle_id());
+  db_->current_transaction()->Put(key, EncodeBundleLoadCheckpoint(checkpoint));
+}
+
+void LevelDbBundleCache::RemoveBundleLoadCheckpoint(
+    const std::string& bundle_id) {
+  db_->current_transaction()->Delete(
+      LevelDbBundleLoadCheckpointKey::Key(bundle_id));
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
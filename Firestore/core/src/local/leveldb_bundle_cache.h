@@ -19,6 +19,7 @@
 
 #include <string>
 
+#include "Firestore/core/src/bundle/bundle_load_checkpoint.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/local/bundle_cache.h"
@@ -46,6 +47,14 @@ class LevelDbBundleCache : public BundleCache {
 
   void SaveNamedQuery(const bundle::NamedQuery& query) override;
 
+  absl::optional<bundle::BundleLoadCheckpoint> GetBundleLoadCheckpoint(
+      const std::string& bundle_id) const override;
+
+  void SaveBundleLoadCheckpoint(
+      const bundle::BundleLoadCheckpoint& checkpoint) override;
+
+  void RemoveBundleLoadCheckpoint(const std::string& bundle_id) override;
+
  private:
   // The LevelDbBundleCache is owned by LevelDbPersistence.
   LevelDbPersistence* db_ = nullptr;
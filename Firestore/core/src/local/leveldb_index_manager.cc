@@ -31,6 +31,7 @@
 #include "Firestore/core/src/index/index_entry.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_statistics.h"
 #include "Firestore/core/src/local/leveldb_util.h"
 #include "Firestore/core/src/local/local_serializer.h"
 #include "Firestore/core/src/model/document_set.h"
@@ -389,6 +390,19 @@ void LevelDbIndexManager::DeleteFieldIndex(const FieldIndex& index) {
     }
   }
 
+  // Delete statistics from all users for this index id.
+  {
+    auto statistics_prefix =
+        LevelDbIndexStatisticsKey::KeyPrefix(index.index_id());
+    auto iter = db_->current_transaction()->NewIterator();
+    for (iter->Seek(statistics_prefix); iter->Valid(); iter->Next()) {
+      if (!absl::StartsWith(iter->key(), statistics_prefix)) {
+        break;
+      }
+      db_->current_transaction()->Delete(iter->key());
+    }
+  }
+
   auto group_index_iter = memoized_indexes_.find(index.collection_group());
   if (group_index_iter != memoized_indexes_.end()) {
     auto& index_map = group_index_iter->second;
@@ -517,40 +531,22 @@ IndexManager::IndexType LevelDbIndexManager::GetIndexType(
 
 absl::optional<std::vector<model::DocumentKey>>
 LevelDbIndexManager::GetDocumentsMatchingTarget(const core::Target& target) {
-  std::unordered_map<core::Target, model::FieldIndex> indexes;
-  for (const auto& sub_target : GetSubTargets(target)) {
-    auto index_opt = GetFieldIndex(sub_target);
-    if (!index_opt.has_value()) {
-      return absl::nullopt;
-    }
-
-    indexes.insert({sub_target, index_opt.value()});
+  auto indexes = GetIndexesForSubTargets(target);
+  if (!indexes.has_value()) {
+    return absl::nullopt;
   }
 
   std::vector<DocumentKey> result;
   std::unordered_set<std::string> existing_keys;
-  for (const auto& entry : indexes) {
+  for (const auto& entry : indexes.value()) {
     const Target& sub_target = entry.first;
     const FieldIndex& index = entry.second;
 
     LOG_DEBUG("Using index %s to execute target %s", index.collection_group(),
               sub_target.CanonicalId());
 
-    auto array_values = sub_target.GetArrayValues(index);
-    auto not_in_values = sub_target.GetNotInValues(index);
-    auto lower_bound = sub_target.GetLowerBound(index);
-    auto upper_bound = sub_target.GetUpperBound(index);
-
-    auto encoded_lower = EncodeBound(index, sub_target, lower_bound);
-    auto encoded_upper = EncodeBound(index, sub_target, upper_bound);
-    auto encoded_not_in = EncodeValues(index, sub_target, not_in_values);
-
-    auto index_ranges = GenerateIndexRanges(
-        index.index_id(), array_values, encoded_lower, lower_bound.inclusive,
-        encoded_upper, upper_bound.inclusive, encoded_not_in);
-
     auto iter = db_->current_transaction()->NewIterator();
-    for (const auto& range : index_ranges) {
+    for (const auto& range : GetIndexRanges(sub_target, index)) {
       int32_t count = 0;
       for (iter->Seek(range.lower); iter->Valid() && count < target.limit() &&
                                     iter->key() <= range.upper;
@@ -574,6 +570,67 @@ LevelDbIndexManager::GetDocumentsMatchingTarget(const core::Target& target) {
   return result;
 }
 
+absl::optional<size_t> LevelDbIndexManager::EstimateDocumentsMatchingTarget(
+    const core::Target& target, size_t max_count) {
+  auto indexes = GetIndexesForSubTargets(target);
+  if (!indexes.has_value()) {
+    return absl::nullopt;
+  }
+
+  // Only the keys of the index entries are scanned. Documents that are stored
+  // in multiple matching entries (e.g. for array-contains-any) are counted
+  // once per entry.
+  size_t total = 0;
+  for (const auto& entry : indexes.value()) {
+    auto iter = db_->current_transaction()->NewIterator();
+    for (const auto& range : GetIndexRanges(entry.first, entry.second)) {
+      int32_t count = 0;
+      for (iter->Seek(range.lower); iter->Valid() && count < target.limit() &&
+                                    iter->key() <= range.upper;
+           iter->Next()) {
+        if (total >= max_count) {
+          return max_count;
+        }
+        ++count;
+        ++total;
+      }
+    }
+  }
+
+  return total;
+}
+
+absl::optional<std::unordered_map<Target, FieldIndex>>
+LevelDbIndexManager::GetIndexesForSubTargets(const Target& target) const {
+  std::unordered_map<Target, FieldIndex> indexes;
+  for (const auto& sub_target : GetSubTargets(target)) {
+    auto index_opt = GetFieldIndex(sub_target);
+    if (!index_opt.has_value()) {
+      return absl::nullopt;
+    }
+
+    indexes.insert({sub_target, index_opt.value()});
+  }
+  return indexes;
+}
+
+std::vector<LevelDbIndexManager::IndexRange>
+LevelDbIndexManager::GetIndexRanges(const Target& sub_target,
+                                    const FieldIndex& index) {
+  auto array_values = sub_target.GetArrayValues(index);
+  auto not_in_values = sub_target.GetNotInValues(index);
+  auto lower_bound = sub_target.GetLowerBound(index);
+  auto upper_bound = sub_target.GetUpperBound(index);
+
+  auto encoded_lower = EncodeBound(index, sub_target, lower_bound);
+  auto encoded_upper = EncodeBound(index, sub_target, upper_bound);
+  auto encoded_not_in = EncodeValues(index, sub_target, not_in_values);
+
+  return GenerateIndexRanges(index.index_id(), array_values, encoded_lower,
+                             lower_bound.inclusive, encoded_upper,
+                             upper_bound.inclusive, encoded_not_in);
+}
+
 std::vector<std::string> LevelDbIndexManager::EncodeBound(
     const FieldIndex& index,
     const Target& target,
@@ -838,14 +895,31 @@ void LevelDbIndexManager::UpdateEntries(
     const FieldIndex& index,
     const std::set<IndexEntry>& existing_entries,
     const std::set<IndexEntry>& new_entries) {
+  int64_t entry_count_delta = 0;
   util::DiffSets<IndexEntry>(
       existing_entries, new_entries, {},
-      [this, document, index](const IndexEntry& entry) {
+      [this, document, index, &entry_count_delta](const IndexEntry& entry) {
         this->AddIndexEntry(document, index, entry);
+        ++entry_count_delta;
       },
-      [this, document, index](const IndexEntry& entry) {
+      [this, document, index, &entry_count_delta](const IndexEntry& entry) {
         this->DeleteIndexEntry(document, index, entry);
+        --entry_count_delta;
       });
+
+  if (entry_count_delta != 0) {
+    LevelDbTransaction* transaction = db_->current_transaction();
+    int64_t entry_count =
+        ReadIndexEntryCount(transaction, index.index_id(), uid_);
+    WriteIndexEntryCount(transaction, index.index_id(), uid_,
+                         entry_count + entry_count_delta);
+  }
+}
+
+int64_t LevelDbIndexManager::GetIndexEntryCount(
+    const FieldIndex& index) const {
+  return ReadIndexEntryCount(db_->current_transaction(), index.index_id(),
+                             uid_);
 }
 
 void LevelDbIndexManager::AddIndexEntry(const model::Document& document,
@@ -83,6 +83,9 @@ class LevelDbIndexManager : public IndexManager {
   absl::optional<std::vector<model::DocumentKey>> GetDocumentsMatchingTarget(
       const core::Target& target) override;
 
+  absl::optional<size_t> EstimateDocumentsMatchingTarget(
+      const core::Target& target, size_t max_count) override;
+
   absl::optional<std::string> GetNextCollectionGroupToUpdate() override;
 
   void UpdateCollectionGroup(const std::string& collection_group,
@@ -90,6 +93,12 @@ class LevelDbIndexManager : public IndexManager {
 
   void UpdateIndexEntries(const model::DocumentMap& documents) override;
 
+  /**
+   * Returns the number of entries the current user has in the given index.
+   * The count is maintained as entries are added and removed.
+   */
+  int64_t GetIndexEntryCount(const model::FieldIndex& index) const;
+
  private:
   using QueueForNextIndexToUpdate = std::priority_queue<
       model::FieldIndex*,
@@ -157,6 +166,17 @@ class LevelDbIndexManager : public IndexManager {
   const std::vector<core::Target> GetSubTargets(
       const core::Target& target) const;
 
+  /**
+   * Returns the field index used to serve each sub-target of `target`, or
+   * `nullopt` if any sub-target cannot be served from an index.
+   */
+  absl::optional<std::unordered_map<core::Target, model::FieldIndex>>
+  GetIndexesForSubTargets(const core::Target& target) const;
+
+  /** Returns the LevelDb key ranges that `index` scans to serve `target`. */
+  std::vector<IndexRange> GetIndexRanges(const core::Target& sub_target,
+                                         const model::FieldIndex& index);
+
   const model::IndexOffset GetMinOffset(
       const std::vector<model::FieldIndex>& indexes) const;
 
@@ -50,8 +50,11 @@ const char* kDocumentTargetsTable = "document_target";
 const char* kRemoteDocumentsTable = "remote_document";
 const char* kCollectionParentsTable = "collection_parent";
 const char* kRemoteDocumentReadTimeTable = "remote_document_read_time";
+const char* kRemoteDocumentReadTimeIndexTable =
+    "remote_document_read_time_index";
 const char* kBundlesTable = "bundles";
 const char* kNamedQueriesTable = "named_queries";
+const char* kBundleLoadCheckpointsTable = "bundle_load_checkpoints";
 const char* kIndexConfigurationTable = "index_configuration";
 const char* kIndexStateTable = "index_state";
 const char* kIndexEntriesTable = "index_entries";
@@ -65,6 +68,9 @@ const char* kDocumentOverlaysCollectionIndexTable =
 const char* kDocumentOverlaysCollectionGroupIndexTable =
     "document_overlays_collection_group_index";
 const char* kDataMigrationTable = "data_migration";
+const char* kCollectionStatisticsTable = "collection_statistics";
+const char* kIndexStatisticsTable = "index_statistics";
+const char* kCacheSizeTable = "cache_size";
 
 /**
  * Labels for the components of keys. These serve to make keys self-describing.
@@ -1173,6 +1179,12 @@ bool LevelDbCollectionParentKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kRemoteDocumentReadTimeTable);
+  return writer.result();
+}
+
 std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix(
     const model::ResourcePath& collection_path,
     model::SnapshotVersion read_time) {
@@ -1206,6 +1218,48 @@ bool LevelDbRemoteDocumentReadTimeKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbRemoteDocumentReadTimeIndexKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kRemoteDocumentReadTimeIndexTable);
+  return writer.result();
+}
+
+std::string LevelDbRemoteDocumentReadTimeIndexKey::Key(
+    const DocumentKey& document_key) {
+  Writer writer;
+  writer.WriteTableName(kRemoteDocumentReadTimeIndexTable);
+  writer.WriteResourcePath(document_key.path());
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+std::string LevelDbRemoteDocumentReadTimeIndexKey::EncodeValue(
+    absl::string_view read_time_key, int64_t document_size) {
+  std::string encoded;
+  OrderedCode::WriteSignedNumIncreasing(&encoded, document_size);
+  encoded.append(read_time_key.data(), read_time_key.size());
+  return encoded;
+}
+
+bool LevelDbRemoteDocumentReadTimeIndexKey::DecodeValue(
+    absl::string_view value,
+    std::string* read_time_key,
+    int64_t* document_size) {
+  if (!OrderedCode::ReadSignedNumIncreasing(&value, document_size)) {
+    return false;
+  }
+  read_time_key->assign(value.data(), value.size());
+  return true;
+}
+
+bool LevelDbRemoteDocumentReadTimeIndexKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kRemoteDocumentReadTimeIndexTable);
+  document_key_ = reader.ReadDocumentKey();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
 std::string LevelDbBundleKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kBundlesTable);
@@ -1228,6 +1282,28 @@ bool LevelDbBundleKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbBundleLoadCheckpointKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kBundleLoadCheckpointsTable);
+  return writer.result();
+}
+
+std::string LevelDbBundleLoadCheckpointKey::Key(absl::string_view bundle_id) {
+  Writer writer;
+  writer.WriteTableName(kBundleLoadCheckpointsTable);
+  writer.WriteBundleId(bundle_id);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+bool LevelDbBundleLoadCheckpointKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kBundleLoadCheckpointsTable);
+  bundle_id_ = reader.ReadBundleId();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
 std::string LevelDbNamedQueryKey::KeyPrefix() {
   Writer writer;
   writer.WriteTableName(kNamedQueriesTable);
@@ -1618,6 +1694,75 @@ bool LevelDbDataMigrationKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbCollectionStatisticsKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kCollectionStatisticsTable);
+  return writer.result();
+}
+
+std::string LevelDbCollectionStatisticsKey::Key(
+    const ResourcePath& collection_path) {
+  Writer writer;
+  writer.WriteTableName(kCollectionStatisticsTable);
+  writer.WriteResourcePath(collection_path);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+bool LevelDbCollectionStatisticsKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kCollectionStatisticsTable);
+  collection_path_ = reader.ReadResourcePath();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
+std::string LevelDbCacheSizeKey::Key() {
+  Writer writer;
+  writer.WriteTableName(kCacheSizeTable);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+bool LevelDbCacheSizeKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kCacheSizeTable);
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
+std::string LevelDbIndexStatisticsKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kIndexStatisticsTable);
+  return writer.result();
+}
+
+std::string LevelDbIndexStatisticsKey::KeyPrefix(int32_t index_id) {
+  Writer writer;
+  writer.WriteTableName(kIndexStatisticsTable);
+  writer.WriteIndexId(index_id);
+  return writer.result();
+}
+
+std::string LevelDbIndexStatisticsKey::Key(int32_t index_id,
+                                           absl::string_view user_id) {
+  Writer writer;
+  writer.WriteTableName(kIndexStatisticsTable);
+  writer.WriteIndexId(index_id);
+  writer.WriteUserId(user_id);
+  writer.WriteTerminator();
+  return writer.result();
+}
+
+bool LevelDbIndexStatisticsKey::Decode(absl::string_view key) {
+  Reader reader{key};
+  reader.ReadTableNameMatching(kIndexStatisticsTable);
+  index_id_ = reader.ReadIndexId();
+  user_id_ = reader.ReadUserId();
+  reader.ReadTerminator();
+  return reader.ok();
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -99,6 +99,10 @@ namespace local {
 //   - table_name: string = "named_queries"
 //   - name: string
 //
+// bundle_load_checkpoints:
+//   - table_name: string = "bundle_load_checkpoints"
+//   - bundle_id: string
+//
 // index_configuration:
 //   - table_name: string = "index_configuration"
 //   - index_id: int32_t
@@ -152,6 +156,15 @@ namespace local {
 // data_migration:
 //   - table_name: "data_migration"
 //   - migration_name: string
+//
+// collection_statistics:
+//   - table_name: "collection_statistics"
+//   - collection_path: ResourcePath
+//
+// index_statistics:
+//   - table_name: "index_statistics"
+//   - index_id: int32_t
+//   - user_id: string
 
 /**
  * Parses the given key and returns a human readable description of its
@@ -652,6 +665,11 @@ class LevelDbCollectionParentKey {
  */
 class LevelDbRemoteDocumentReadTimeKey {
  public:
+  /**
+   * Creates a key prefix that points just before the first key of the table.
+   */
+  static std::string KeyPrefix();
+
   /**
    * Creates a key prefix that points just before the first key for the given
    * collection_path and read_time.
@@ -698,6 +716,66 @@ class LevelDbRemoteDocumentReadTimeKey {
   model::SnapshotVersion read_time_;
 };
 
+/**
+ * A key in the remote document read time keys table, which stores for each
+ * remote document the key of its entry in the remote documents read time
+ * table and the size of its encoded entry. This allows the read time entry to
+ * be replaced when the document is read again, and the collection statistics
+ * to be updated without reading the previous entry.
+ */
+class LevelDbRemoteDocumentReadTimeIndexKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key of the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a complete key that points to the read time entry of a specific
+   * document.
+   */
+  static std::string Key(const model::DocumentKey& document_key);
+
+  /**
+   * Encodes the value stored for a document: the size of its encoded remote
+   * document entry followed by `read_time_key`, which may be empty if the
+   * document has no read time entry.
+   */
+  static std::string EncodeValue(absl::string_view read_time_key,
+                                 int64_t document_size);
+
+  /**
+   * Decodes a value written by `EncodeValue()`, storing its parts in
+   * `read_time_key` and `document_size`.
+   *
+   * @return true if the value successfully decoded.
+   */
+  ABSL_MUST_USE_RESULT
+  static bool DecodeValue(absl::string_view value,
+                          std::string* read_time_key,
+                          int64_t* document_size);
+
+  /**
+   * Decodes the given complete key, storing the decoded values in this
+   * instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+
+  /** The path to the document, as encoded in the key. */
+  const model::DocumentKey& document_key() const {
+    return document_key_;
+  }
+
+ private:
+  // Deliberately uninitialized: will be assigned in Decode
+  model::DocumentKey document_key_;
+};
+
 /**
  * A key in the bundles table, storing the bundle Id for each entry.
  */
@@ -733,6 +811,42 @@ class LevelDbBundleKey {
   std::string bundle_id_;
 };
 
+/**
+ * A key in the bundle_load_checkpoints table, storing the bundle Id for each
+ * entry.
+ */
+class LevelDbBundleLoadCheckpointKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key of the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a key that points to the key for the given bundle id.
+   */
+  static std::string Key(absl::string_view bundle_id);
+
+  /**
+   * Decodes the given complete key, storing the decoded values in this
+   * instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+
+  /** The bundle ID for this entry. */
+  const std::string& bundle_id() const {
+    return bundle_id_;
+  }
+
+ private:
+  std::string bundle_id_;
+};
+
 /**
  * A key in the named_queries table, storing the query name for each entry.
  */
@@ -1340,6 +1454,109 @@ class LevelDbDataMigrationKey {
   std::string migration_name_;
 };
 
+/**
+ * A key in the collection_statistics table, storing the statistics for the
+ * entries of a collection in the remote document cache.
+ */
+class LevelDbCollectionStatisticsKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key of the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a complete key that points to the statistics of a specific
+   * collection_path.
+   */
+  static std::string Key(const model::ResourcePath& collection_path);
+
+  /**
+   * Decodes the given complete key, storing the decoded values in this
+   * instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+
+  /** The collection path, as encoded in the key. */
+  const model::ResourcePath& collection_path() const {
+    return collection_path_;
+  }
+
+ private:
+  model::ResourcePath collection_path_;
+};
+
+/**
+ * A key to the single row in the cache_size table, storing the total size of
+ * the remote documents, targets and mutation batches in the database.
+ */
+class LevelDbCacheSizeKey {
+ public:
+  /** Creates a key that points to the single cache size row. */
+  static std::string Key();
+
+  /**
+   * Decodes the contents of a cache size key, essentially just verifying that
+   * the key has the correct table name.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+};
+
+/**
+ * A key in the index_statistics table, storing the statistics for the entries
+ * of a field index that belong to a user.
+ */
+class LevelDbIndexStatisticsKey {
+ public:
+  /**
+   * Creates a key prefix that points just before the first key of the table.
+   */
+  static std::string KeyPrefix();
+
+  /**
+   * Creates a key prefix that points just before the first key for the given
+   * index_id.
+   */
+  static std::string KeyPrefix(int32_t index_id);
+
+  /**
+   * Creates a complete key that points to the statistics of a specific
+   * index_id and user_id.
+   */
+  static std::string Key(int32_t index_id, absl::string_view user_id);
+
+  /**
+   * Decodes the given complete key, storing the decoded values in this
+   * instance.
+   *
+   * @return true if the key successfully decoded, false otherwise. If false is
+   * returned, this instance is in an undefined state until the next call to
+   * `Decode()`.
+   */
+  ABSL_MUST_USE_RESULT
+  bool Decode(absl::string_view key);
+
+  /** The index id, as encoded in the key. */
+  int32_t index_id() const {
+    return index_id_;
+  }
+
+  /** The user id, as encoded in the key. */
+  const std::string& user_id() const {
+    return user_id_;
+  }
+
+ private:
+  int32_t index_id_ = 0;
+  std::string user_id_;
+};
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -130,17 +130,22 @@ void LevelDbLruReferenceDelegate::EnumerateOrphanedDocuments(
 }
 
 int LevelDbLruReferenceDelegate::RemoveOrphanedDocuments(
-    ListenSequenceNumber upper_bound) {
+    ListenSequenceNumber upper_bound,
+    int max_documents,
+    DocumentKey* start_after) {
   int count = 0;
   db_->target_cache()->EnumerateOrphanedDocuments(
+      *start_after,
       [&](const DocumentKey& key, ListenSequenceNumber sequence_number) {
         if (sequence_number <= upper_bound) {
           if (!IsPinned(key)) {
             count++;
             db_->remote_document_cache()->Remove(key);
             RemoveSentinel(key);
+            *start_after = key;
           }
         }
+        return count < max_documents;
       });
   return count;
 }
@@ -16,12 +16,15 @@
 
 #include "Firestore/core/src/local/leveldb_migrations.h"
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <utility>
 
 #include "Firestore/Protos/nanopb/firestore/local/mutation.nanopb.h"
 #include "Firestore/Protos/nanopb/firestore/local/target.nanopb.h"
 #include "Firestore/core/src/local/leveldb_key.h"
+#include "Firestore/core/src/local/leveldb_statistics.h"
 #include "Firestore/core/src/local/memory_index_manager.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document_key.h"
@@ -370,6 +373,195 @@ void EnsureOverlayDataMigrationIsRequired(leveldb::DB* db) {
   transaction.Commit();
 }
 
+/** Deletes all rows whose key starts with `prefix` in the given transaction. */
+void DeleteRowsWithPrefix(LevelDbTransaction* transaction,
+                          const std::string& prefix) {
+  auto it = transaction->NewIterator();
+  for (it->Seek(prefix); it->Valid() && absl::StartsWith(it->key(), prefix);
+       it->Next()) {
+    transaction->Delete(it->key());
+  }
+}
+
+/**
+ * Migration 9.
+ *
+ * Computes the collection_statistics and index_statistics rows for the
+ * documents and index entries that were written before the statistics were
+ * maintained. Existing rows are recomputed, since an older client may have
+ * modified the data after a downgrade.
+ */
+void EnsureStatistics(leveldb::DB* db) {
+  LevelDbTransaction transaction(db, "Ensure statistics");
+
+  DeleteRowsWithPrefix(&transaction,
+                       LevelDbCollectionStatisticsKey::KeyPrefix());
+  DeleteRowsWithPrefix(&transaction, LevelDbIndexStatisticsKey::KeyPrefix());
+
+  std::map<ResourcePath, CollectionStatistics> collections;
+
+  std::string documents_prefix = LevelDbRemoteDocumentKey::KeyPrefix();
+  auto it = transaction.NewIterator();
+  it->Seek(documents_prefix);
+  LevelDbRemoteDocumentKey document_key;
+  for (; it->Valid() && absl::StartsWith(it->key(), documents_prefix);
+       it->Next()) {
+    HARD_ASSERT(document_key.Decode(it->key()),
+                "Failed to decode document key");
+    CollectionStatistics& statistics =
+        collections[document_key.document_key().path().PopLast()];
+    ++statistics.document_count;
+    statistics.byte_size += static_cast<int64_t>(it->value().size());
+  }
+
+  std::string read_times_prefix = LevelDbRemoteDocumentReadTimeKey::KeyPrefix();
+  it = transaction.NewIterator();
+  it->Seek(read_times_prefix);
+  LevelDbRemoteDocumentReadTimeKey read_time_key;
+  for (; it->Valid() && absl::StartsWith(it->key(), read_times_prefix);
+       it->Next()) {
+    HARD_ASSERT(read_time_key.Decode(it->key()),
+                "Failed to decode read time key");
+    auto found = collections.find(read_time_key.collection_path());
+    if (found != collections.end()) {
+      found->second.last_read_time =
+          std::max(found->second.last_read_time, read_time_key.read_time());
+    }
+  }
+
+  for (const auto& entry : collections) {
+    WriteCollectionStatistics(&transaction, entry.first, entry.second);
+  }
+
+  std::map<std::pair<int32_t, std::string>, int64_t> index_entry_counts;
+
+  std::string index_entries_prefix = LevelDbIndexEntryKey::KeyPrefix();
+  it = transaction.NewIterator();
+  it->Seek(index_entries_prefix);
+  LevelDbIndexEntryKey index_entry_key;
+  for (; it->Valid() && absl::StartsWith(it->key(), index_entries_prefix);
+       it->Next()) {
+    HARD_ASSERT(index_entry_key.Decode(it->key()),
+                "Failed to decode index entry key");
+    ++index_entry_counts[std::make_pair(index_entry_key.index_id(),
+                                        index_entry_key.user_id())];
+  }
+
+  for (const auto& entry : index_entry_counts) {
+    WriteIndexEntryCount(&transaction, entry.first.first, entry.first.second,
+                         entry.second);
+  }
+
+  SaveVersion(9, &transaction);
+  transaction.Commit();
+}
+
+/** Returns the total size of the values of the rows starting with `prefix`. */
+int64_t SumValueSizes(LevelDbTransaction* transaction,
+                      const std::string& prefix) {
+  int64_t byte_size = 0;
+  auto it = transaction->NewIterator();
+  for (it->Seek(prefix); it->Valid() && absl::StartsWith(it->key(), prefix);
+       it->Next()) {
+    byte_size += static_cast<int64_t>(it->value().size());
+  }
+  return byte_size;
+}
+
+/**
+ * Migration 10.
+ *
+ * Computes the cache_size row for the documents, targets and mutation batches
+ * that were written before it was maintained. The size of the documents is
+ * taken from the collection statistics computed by migration 9.
+ */
+void EnsureCacheByteSize(leveldb::DB* db) {
+  LevelDbTransaction transaction(db, "Ensure cache size");
+
+  int64_t byte_size = 0;
+  std::string statistics_prefix = LevelDbCollectionStatisticsKey::KeyPrefix();
+  auto it = transaction.NewIterator();
+  LevelDbCollectionStatisticsKey statistics_key;
+  for (it->Seek(statistics_prefix);
+       it->Valid() && absl::StartsWith(it->key(), statistics_prefix);
+       it->Next()) {
+    HARD_ASSERT(statistics_key.Decode(it->key()),
+                "Failed to decode collection statistics key");
+    byte_size +=
+        ReadCollectionStatistics(&transaction, statistics_key.collection_path())
+            .byte_size;
+  }
+
+  byte_size += SumValueSizes(&transaction, LevelDbTargetKey::KeyPrefix());
+  byte_size += SumValueSizes(&transaction, LevelDbMutationKey::KeyPrefix());
+  WriteCacheByteSize(&transaction, byte_size);
+
+  SaveVersion(10, &transaction);
+  transaction.Commit();
+}
+
+/**
+ * Migration 11.
+ *
+ * Builds the remote_document_read_time_index from the read time rows that
+ * were written before it was maintained, recording the size of each cached
+ * document. Re-adding a document used to leave its previous read time row
+ * behind, so only the newest row of each document is kept. Rows of documents
+ * that are no longer cached are deleted.
+ */
+void EnsureReadTimeIndex(leveldb::DB* db) {
+  LevelDbTransaction transaction(db, "Ensure read time index");
+
+  DeleteRowsWithPrefix(&transaction,
+                       LevelDbRemoteDocumentReadTimeIndexKey::KeyPrefix());
+
+  // The rows of a document sort by read time, so the last one is the newest.
+  std::map<DocumentKey, std::string> newest_read_time_keys;
+  std::string read_times_prefix = LevelDbRemoteDocumentReadTimeKey::KeyPrefix();
+  auto it = transaction.NewIterator();
+  LevelDbRemoteDocumentReadTimeKey read_time_key;
+  for (it->Seek(read_times_prefix);
+       it->Valid() && absl::StartsWith(it->key(), read_times_prefix);
+       it->Next()) {
+    HARD_ASSERT(read_time_key.Decode(it->key()),
+                "Failed to decode read time key");
+    DocumentKey document_key{
+        read_time_key.collection_path().Append(read_time_key.document_id())};
+    std::string& newest = newest_read_time_keys[document_key];
+    if (!newest.empty()) {
+      transaction.Delete(newest);
+    }
+    newest = it->key();
+  }
+
+  std::string documents_prefix = LevelDbRemoteDocumentKey::KeyPrefix();
+  it = transaction.NewIterator();
+  LevelDbRemoteDocumentKey document_key;
+  for (it->Seek(documents_prefix);
+       it->Valid() && absl::StartsWith(it->key(), documents_prefix);
+       it->Next()) {
+    HARD_ASSERT(document_key.Decode(it->key()),
+                "Failed to decode document key");
+    std::string newest_key;
+    auto found = newest_read_time_keys.find(document_key.document_key());
+    if (found != newest_read_time_keys.end()) {
+      newest_key = std::move(found->second);
+      newest_read_time_keys.erase(found);
+    }
+    transaction.Put(
+        LevelDbRemoteDocumentReadTimeIndexKey::Key(document_key.document_key()),
+        LevelDbRemoteDocumentReadTimeIndexKey::EncodeValue(
+            newest_key, static_cast<int64_t>(it->value().size())));
+  }
+
+  for (const auto& entry : newest_read_time_keys) {
+    transaction.Delete(entry.second);
+  }
+
+  SaveVersion(11, &transaction);
+  transaction.Commit();
+}
+
 }  // namespace
 
 LevelDbMigrations::SchemaVersion LevelDbMigrations::ReadSchemaVersion(
@@ -433,6 +625,18 @@ void LevelDbMigrations::RunMigrations(leveldb::DB* db,
   if (from_version < 8 && to_version >= 8) {
     EnsureOverlayDataMigrationIsRequired(db);
   }
+
+  if (from_version < 9 && to_version >= 9) {
+    EnsureStatistics(db);
+  }
+
+  if (from_version < 10 && to_version >= 10) {
+    EnsureCacheByteSize(db);
+  }
+
+  if (from_version < 11 && to_version >= 11) {
+    EnsureReadTimeIndex(db);
+  }
 }
 
 }  // namespace local
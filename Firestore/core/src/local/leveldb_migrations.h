@@ -73,8 +73,11 @@ class LevelDbMigrations {
  *   * Migration 6 populates the collection_parents index.
  *   * Migration 7 rewrites query_targets canonical ids in new format.
  *   * Migration 8 kicks off overlay data migration.
+ *   * Migration 9 computes the collection and index statistics.
+ *   * Migration 10 computes the total size of the cached data.
+ *   * Migration 11 builds the index from documents to their read time rows.
  */
-const LevelDbMigrations::SchemaVersion kSchemaVersion = 8;
+const LevelDbMigrations::SchemaVersion kSchemaVersion = 11;
 
 }  // namespace local
 }  // namespace firestore
@@ -29,6 +29,7 @@
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/model/resource_path.h"
+#include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/string_util.h"
@@ -167,7 +168,10 @@ MutationBatch LevelDbMutationQueue::AddMutationBatch(
   MutationBatch batch(batch_id, local_write_time, std::move(base_mutations),
                       std::move(mutations));
   std::string key = mutation_batch_key(batch_id);
-  db_->current_transaction()->Put(key, serializer_->EncodeMutationBatch(batch));
+  std::string contents =
+      nanopb::MakeStdString(serializer_->EncodeMutationBatch(batch));
+  db_->AdjustByteSize(static_cast<int64_t>(contents.size()));
+  db_->current_transaction()->Put(key, std::move(contents));
 
   // Store an empty value in the index which is equivalent to serializing a
   // GPBEmpty message. In the future if we wanted to store some other kind of
@@ -201,6 +205,7 @@ void LevelDbMutationQueue::RemoveMutationBatch(const MutationBatch& batch) {
               "Mutation batch %s not found; found %s", DescribeKey(key),
               DescribeKey(check_iterator->key()));
 
+  db_->AdjustByteSize(-static_cast<int64_t>(check_iterator->value().size()));
   db_->current_transaction()->Delete(key);
 
   for (const Mutation& mutation : batch.mutations()) {
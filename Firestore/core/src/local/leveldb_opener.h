@@ -37,6 +37,7 @@ class StatusOr;
 namespace local {
 
 class LevelDbPersistence;
+struct LevelDbParams;
 struct LruParams;
 
 class LevelDbOpener {
@@ -78,6 +79,13 @@ class LevelDbOpener {
   util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
       const LruParams& lru_params);
 
+  /**
+   * Creates the LevelDbPersistence instance as above, opening the database
+   * with the given options.
+   */
+  util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
+      const LruParams& lru_params, const LevelDbParams& leveldb_params);
+
   /**
    * Finds a suitable directory to serve as the root of all Firestore local
    * storage for all Firestore instances.
@@ -16,15 +16,16 @@
 
 #include "Firestore/core/src/local/leveldb_persistence.h"
 
-#include <limits>
 #include <utility>
 
+#include "Firestore/core/src/api/settings.h"
 #include "Firestore/core/src/core/database_info.h"
 #include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_lru_reference_delegate.h"
 #include "Firestore/core/src/local/leveldb_migrations.h"
 #include "Firestore/core/src/local/leveldb_opener.h"
+#include "Firestore/core/src/local/leveldb_statistics.h"
 #include "Firestore/core/src/local/leveldb_util.h"
 #include "Firestore/core/src/local/listen_sequence.h"
 #include "Firestore/core/src/local/lru_garbage_collector.h"
@@ -36,6 +37,8 @@
 #include "Firestore/core/src/util/string_util.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/match.h"
+#include "leveldb/cache.h"
+#include "leveldb/filter_policy.h"
 
 namespace firebase {
 namespace firestore {
@@ -76,11 +79,24 @@ std::set<std::string> CollectUserSet(LevelDbTransaction* transaction) {
 
 }  // namespace
 
+LevelDbParams LevelDbParams::Default() {
+  return FromSettings(api::Settings());
+}
+
+LevelDbParams LevelDbParams::FromSettings(const api::Settings& settings) {
+  return LevelDbParams{settings.leveldb_block_cache_size_bytes(),
+                       settings.leveldb_bloom_filter_bits_per_key(),
+                       settings.leveldb_write_buffer_size_bytes(),
+                       settings.leveldb_max_file_size_bytes(),
+                       settings.leveldb_compression_enabled()};
+}
+
 StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
     util::Path dir,
     LevelDbMigrations::SchemaVersion version,
     LocalSerializer serializer,
-    const LruParams& lru_params) {
+    const LruParams& lru_params,
+    const LevelDbParams& leveldb_params) {
   auto* fs = Filesystem::Default();
   Status status = EnsureDirectory(dir);
   if (!status.ok()) return status;
@@ -88,7 +104,10 @@ StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
   status = fs->ExcludeFromBackups(dir);
   if (!status.ok()) return status;
 
-  StatusOr<std::unique_ptr<DB>> created = OpenDb(dir);
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy;
+  std::unique_ptr<leveldb::Cache> block_cache;
+  StatusOr<std::unique_ptr<DB>> created =
+      OpenDb(dir, leveldb_params, &filter_policy, &block_cache);
   if (!created.ok()) return created.status();
 
   std::unique_ptr<DB> db = std::move(created).ValueOrDie();
@@ -96,12 +115,14 @@ StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
 
   LevelDbTransaction transaction(db.get(), "Start LevelDB");
   std::set<std::string> users = CollectUserSet(&transaction);
+  int64_t byte_size = ReadCacheByteSize(&transaction);
   transaction.Commit();
 
   // Explicit conversion is required to allow the StatusOr to be created.
-  std::unique_ptr<LevelDbPersistence> result(
-      new LevelDbPersistence(std::move(db), std::move(dir), std::move(users),
-                             std::move(serializer), lru_params));
+  std::unique_ptr<LevelDbPersistence> result(new LevelDbPersistence(
+      std::move(filter_policy), std::move(block_cache), std::move(db),
+      std::move(dir), std::move(users), std::move(serializer), lru_params));
+  result->byte_size_ = byte_size;
   return {std::move(result)};
 }
 
@@ -111,12 +132,26 @@ StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
                 lru_params);
 }
 
-LevelDbPersistence::LevelDbPersistence(std::unique_ptr<leveldb::DB> db,
-                                       util::Path directory,
-                                       std::set<std::string> users,
-                                       LocalSerializer serializer,
-                                       const LruParams& lru_params)
-    : db_(std::move(db)),
+StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
+    util::Path dir,
+    LocalSerializer serializer,
+    const LruParams& lru_params,
+    const LevelDbParams& leveldb_params) {
+  return Create(std::move(dir), kSchemaVersion, std::move(serializer),
+                lru_params, leveldb_params);
+}
+
+LevelDbPersistence::LevelDbPersistence(
+    std::unique_ptr<const leveldb::FilterPolicy> filter_policy,
+    std::unique_ptr<leveldb::Cache> block_cache,
+    std::unique_ptr<leveldb::DB> db,
+    util::Path directory,
+    std::set<std::string> users,
+    LocalSerializer serializer,
+    const LruParams& lru_params)
+    : filter_policy_(std::move(filter_policy)),
+      block_cache_(std::move(block_cache)),
+      db_(std::move(db)),
       directory_(std::move(directory)),
       users_(std::move(users)),
       serializer_(std::move(serializer)) {
@@ -150,9 +185,12 @@ Status LevelDbPersistence::EnsureDirectory(const Path& dir) {
   return Status::OK();
 }
 
-StatusOr<std::unique_ptr<DB>> LevelDbPersistence::OpenDb(const Path& dir) {
-  leveldb::Options options;
-  options.create_if_missing = true;
+StatusOr<std::unique_ptr<DB>> LevelDbPersistence::OpenDb(
+    const Path& dir,
+    const LevelDbParams& params,
+    std::unique_ptr<const leveldb::FilterPolicy>* filter_policy,
+    std::unique_ptr<leveldb::Cache>* block_cache) {
+  leveldb::Options options = LevelDbOptions(params, filter_policy, block_cache);
 
   DB* database = nullptr;
   leveldb::Status status = DB::Open(options, dir.ToUtf8String(), &database);
@@ -188,36 +226,13 @@ util::Status LevelDbPersistence::ClearPersistence(
 }
 
 StatusOr<int64_t> LevelDbPersistence::CalculateByteSize() {
-  auto* fs = Filesystem::Default();
-
-  // Accumulate the total size in an unsigned integer to avoid undefined
-  // behavior on overflow.
-  uint64_t count = 0;
-  auto iter = util::DirectoryIterator::Create(directory_);
-  for (; iter->Valid(); iter->Next()) {
-    StatusOr<int64_t> maybe_size = fs->FileSize(iter->file());
-    if (!maybe_size.ok()) {
-      return Status::FromCause("Failed to size LevelDB directory",
-                               maybe_size.status());
-    }
-
-    uint64_t old_count = count;
-    int64_t file_size = maybe_size.ValueOrDie();
-    count += file_size;
-
-    auto max_signed_value =
-        static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
-    if (count < old_count || count > max_signed_value) {
-      return Status(Error::kErrorOutOfRange,
-                    "Failed to size LevelDB: count overflowed");
-    }
-  }
+  return byte_size_ + pending_byte_size_delta_;
+}
 
-  if (!iter->status().ok()) {
-    return Status::FromCause("Failed to iterate over LevelDB files",
-                             iter->status());
-  }
-  return static_cast<int64_t>(count);
+void LevelDbPersistence::AdjustByteSize(int64_t delta) {
+  HARD_ASSERT(transaction_ != nullptr && !transaction_->read_only(),
+              "Changing the cache size outside of a read-write transaction");
+  pending_byte_size_delta_ += delta;
 }
 
 // MARK: - Persistence
@@ -318,10 +333,60 @@ void LevelDbPersistence::RunInternal(absl::string_view label,
   block();
 
   reference_delegate_->OnTransactionCommitted();
+  document_cache_->WritePendingStatistics();
+  if (pending_byte_size_delta_ != 0) {
+    byte_size_ += pending_byte_size_delta_;
+    pending_byte_size_delta_ = 0;
+    WriteCacheByteSize(transaction_.get(), byte_size_);
+  }
   transaction_->Commit();
   transaction_.reset();
 }
 
+void LevelDbPersistence::RunReadOnlyInternal(absl::string_view label,
+                                             std::function<void()> block) {
+  HARD_ASSERT(transaction_ == nullptr,
+              "Starting a transaction while one is already in progress");
+
+  transaction_ = LevelDbTransaction::ReadOnly(db_.get(), label);
+
+  block();
+
+  transaction_.reset();
+}
+
+leveldb::Options LevelDbOptions(
+    const LevelDbParams& params,
+    std::unique_ptr<const leveldb::FilterPolicy>* filter_policy,
+    std::unique_ptr<leveldb::Cache>* block_cache) {
+  leveldb::Options options;
+  options.create_if_missing = true;
+
+  // Non-positive sizes keep LevelDB's defaults. LevelDB clamps the remaining
+  // sizes to the ranges it supports.
+  if (params.block_cache_size_bytes > 0) {
+    block_cache->reset(leveldb::NewLRUCache(
+        static_cast<size_t>(params.block_cache_size_bytes)));
+    options.block_cache = block_cache->get();
+  }
+  if (params.bloom_filter_bits_per_key > 0) {
+    filter_policy->reset(
+        leveldb::NewBloomFilterPolicy(params.bloom_filter_bits_per_key));
+    options.filter_policy = filter_policy->get();
+  }
+  if (params.write_buffer_size_bytes > 0) {
+    options.write_buffer_size =
+        static_cast<size_t>(params.write_buffer_size_bytes);
+  }
+  if (params.max_file_size_bytes > 0) {
+    options.max_file_size = static_cast<size_t>(params.max_file_size_bytes);
+  }
+  options.compression = params.compression_enabled
+                            ? leveldb::kSnappyCompression
+                            : leveldb::kNoCompression;
+  return options;
+}
+
 leveldb::ReadOptions StandardReadOptions() {
   // For now this is paranoid, but perhaps disable that in production builds.
   leveldb::ReadOptions options;
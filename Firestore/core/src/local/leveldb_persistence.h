@@ -38,9 +38,18 @@
 #include "Firestore/core/src/util/path.h"
 #include "Firestore/core/src/util/statusor.h"
 
+namespace leveldb {
+class Cache;
+class FilterPolicy;
+}  // namespace leveldb
+
 namespace firebase {
 namespace firestore {
 
+namespace api {
+class Settings;
+}  // namespace api
+
 namespace core {
 class DatabaseInfo;
 }  // namespace core
@@ -50,6 +59,23 @@ namespace local {
 class LevelDbLruReferenceDelegate;
 struct LruParams;
 
+/** Options used to tune the LevelDB database that backs persistence. */
+struct LevelDbParams {
+  static LevelDbParams Default();
+
+  static LevelDbParams FromSettings(const api::Settings& settings);
+
+  /** The capacity of the cache of uncompressed blocks. */
+  int64_t block_cache_size_bytes;
+
+  /** The bits per key of each table's bloom filter, or 0 for no filters. */
+  int bloom_filter_bits_per_key;
+
+  int64_t write_buffer_size_bytes;
+  int64_t max_file_size_bytes;
+  bool compression_enabled;
+};
+
 /** A LevelDB-backed implementation of the Persistence interface. */
 class LevelDbPersistence : public Persistence {
  public:
@@ -60,6 +86,16 @@ class LevelDbPersistence : public Persistence {
   static util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
       util::Path dir, LocalSerializer serializer, const LruParams& lru_params);
 
+  /**
+   * Creates a LevelDB in the given directory, opening it with the given
+   * options.
+   */
+  static util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
+      util::Path dir,
+      LocalSerializer serializer,
+      const LruParams& lru_params,
+      const LevelDbParams& leveldb_params);
+
   ~LevelDbPersistence();
 
   LevelDbTransaction* current_transaction();
@@ -74,8 +110,19 @@ class LevelDbPersistence : public Persistence {
 
   static util::Status ClearPersistence(const core::DatabaseInfo& database_info);
 
+  /**
+   * Returns the total size in bytes of the encoded remote documents, targets
+   * and mutation batches, including the changes of the current transaction.
+   */
   util::StatusOr<int64_t> CalculateByteSize();
 
+  /**
+   * Records that the current transaction changed the size of the encoded
+   * remote documents, targets or mutation batches by `delta` bytes. The new
+   * total is saved when the transaction commits.
+   */
+  void AdjustByteSize(int64_t delta);
+
   // MARK: Persistence overrides
 
   model::ListenSequenceNumber current_sequence_number() const override;
@@ -106,9 +153,18 @@ class LevelDbPersistence : public Persistence {
   void RunInternal(absl::string_view label,
                    std::function<void()> block) override;
 
+  /**
+   * Runs `block` against a snapshot of the database, without buffering writes
+   * or starting a transaction in the reference delegate.
+   */
+  void RunReadOnlyInternal(absl::string_view label,
+                           std::function<void()> block) override;
+
  private:
   friend class LevelDbOverlayMigrationManagerTest;
-  LevelDbPersistence(std::unique_ptr<leveldb::DB> db,
+  LevelDbPersistence(std::unique_ptr<const leveldb::FilterPolicy> filter_policy,
+                     std::unique_ptr<leveldb::Cache> block_cache,
+                     std::unique_ptr<leveldb::DB> db,
                      util::Path directory,
                      std::set<std::string> users,
                      LocalSerializer serializer,
@@ -119,16 +175,27 @@ class LevelDbPersistence : public Persistence {
    */
   static util::Status EnsureDirectory(const util::Path& dir);
 
-  /** Opens the database within the given directory. */
+  /**
+   * Opens the database within the given directory. The filter policy and
+   * block cache that the database uses are returned through the given
+   * pointers, and must outlive it.
+   */
   static util::StatusOr<std::unique_ptr<leveldb::DB>> OpenDb(
-      const util::Path& dir);
+      const util::Path& dir,
+      const LevelDbParams& params,
+      std::unique_ptr<const leveldb::FilterPolicy>* filter_policy,
+      std::unique_ptr<leveldb::Cache>* block_cache);
 
   static util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
       util::Path dir,
       LevelDbMigrations::SchemaVersion schema_version,
       LocalSerializer serializer,
-      const LruParams& lru_params);
+      const LruParams& lru_params,
+      const LevelDbParams& leveldb_params = LevelDbParams::Default());
 
+  // Declared before `db_`, which uses them until it is destroyed.
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy_;
+  std::unique_ptr<leveldb::Cache> block_cache_;
   std::unique_ptr<leveldb::DB> db_;
 
   util::Path directory_;
@@ -151,8 +218,24 @@ class LevelDbPersistence : public Persistence {
   std::unique_ptr<LevelDbLruReferenceDelegate> reference_delegate_;
 
   std::unique_ptr<LevelDbTransaction> transaction_;
+
+  /** The total size of the cached data, as of the last commit. */
+  int64_t byte_size_ = 0;
+
+  /** The change to `byte_size_` made by the current transaction. */
+  int64_t pending_byte_size_delta_ = 0;
 };
 
+/**
+ * Returns the options used to open a database with the given params. The
+ * filter policy and block cache that the options use are returned through the
+ * given pointers, and must outlive any database opened with the options.
+ */
+leveldb::Options LevelDbOptions(
+    const LevelDbParams& params,
+    std::unique_ptr<const leveldb::FilterPolicy>* filter_policy,
+    std::unique_ptr<leveldb::Cache>* block_cache);
+
 /** Returns a standard set of read options. */
 leveldb::ReadOptions StandardReadOptions();
 
@@ -16,17 +16,24 @@
 
 #include "Firestore/core/src/local/leveldb_remote_document_cache.h"
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <thread>  // NOLINT(build/c++11)
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
-#include "Firestore/Protos/nanopb/firestore/local/maybe_document.nanopb.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_statistics.h"
 #include "Firestore/core/src/local/local_serializer.h"
+#include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/model/document_key_set.h"
+#include "Firestore/core/src/model/field_index.h"
 #include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/overlay.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/background_queue.h"
@@ -43,14 +50,16 @@ namespace {
 using core::Query;
 using leveldb::Status;
 using model::DocumentKey;
+using model::DocumentKeyHash;
 using model::DocumentKeySet;
+using model::IndexOffset;
 using model::MutableDocument;
 using model::MutableDocumentMap;
 using model::ResourcePath;
 using model::SnapshotVersion;
-using nanopb::Message;
 using nanopb::StringReader;
 using util::BackgroundQueue;
+using util::ComparisonResult;
 using util::Executor;
 
 /**
@@ -85,6 +94,15 @@ class AsyncResults {
   std::mutex mutex_;
 };
 
+/** Adds the pending changes in `delta` to `statistics`. */
+void ApplyStatisticsDelta(const CollectionStatistics& delta,
+                          CollectionStatistics* statistics) {
+  statistics->document_count += delta.document_count;
+  statistics->byte_size += delta.byte_size;
+  statistics->last_read_time =
+      std::max(statistics->last_read_time, delta.last_read_time);
+}
+
 }  // namespace
 
 LevelDbRemoteDocumentCache::LevelDbRemoteDocumentCache(
@@ -106,22 +124,103 @@ void LevelDbRemoteDocumentCache::Add(const MutableDocument& document,
                                      const SnapshotVersion& read_time) {
   const DocumentKey& key = document.key();
   const ResourcePath& path = key.path();
+  ResourcePath collection_path = path.PopLast();
+  LevelDbTransaction* transaction = db_->current_transaction();
 
   std::string ldb_document_key = LevelDbRemoteDocumentKey::Key(key);
-  db_->current_transaction()->Put(ldb_document_key,
-                                  serializer_->EncodeMaybeDocument(document));
+  std::string contents =
+      nanopb::MakeStdString(serializer_->EncodeMaybeDocument(document));
+  int64_t document_size = static_cast<int64_t>(contents.size());
 
+  // The read time index holds the previous entry's size and read time key, so
+  // replacing a document never requires reading the document itself.
   std::string ldb_read_time_key = LevelDbRemoteDocumentReadTimeKey::Key(
-      path.PopLast(), read_time, path.last_segment());
-  db_->current_transaction()->Put(ldb_read_time_key, "");
+      collection_path, read_time, path.last_segment());
+  std::string ldb_read_time_index_key =
+      LevelDbRemoteDocumentReadTimeIndexKey::Key(key);
+
+  CollectionStatistics& statistics = pending_statistics_[collection_path];
+  int64_t delta = document_size;
+  std::string index_value;
+  if (transaction->Get(ldb_read_time_index_key, &index_value).ok()) {
+    std::string previous_key;
+    int64_t previous_size = 0;
+    HARD_ASSERT(LevelDbRemoteDocumentReadTimeIndexKey::DecodeValue(
+                    index_value, &previous_key, &previous_size),
+                "Failed to decode the read time index entry for %s",
+                key.ToString());
+    delta -= previous_size;
+    // Replaces the document's previous read time entry, which would otherwise
+    // be found by collection group scans that stop before the new entry.
+    if (!previous_key.empty() && previous_key != ldb_read_time_key) {
+      transaction->Delete(previous_key);
+    }
+  } else {
+    ++statistics.document_count;
+  }
+  statistics.byte_size += delta;
+  statistics.last_read_time = std::max(statistics.last_read_time, read_time);
+  db_->AdjustByteSize(delta);
+
+  transaction->Put(ldb_document_key, std::move(contents));
+  transaction->Put(ldb_read_time_key, "");
+  transaction->Put(ldb_read_time_index_key,
+                   LevelDbRemoteDocumentReadTimeIndexKey::EncodeValue(
+                       ldb_read_time_key, document_size));
 
   NOT_NULL(index_manager_);
-  index_manager_->AddToCollectionParentIndex(document.key().path().PopLast());
+  index_manager_->AddToCollectionParentIndex(collection_path);
 }
 
 void LevelDbRemoteDocumentCache::Remove(const DocumentKey& key) {
-  std::string ldb_key = LevelDbRemoteDocumentKey::Key(key);
-  db_->current_transaction()->Delete(ldb_key);
+  LevelDbTransaction* transaction = db_->current_transaction();
+
+  std::string ldb_read_time_index_key =
+      LevelDbRemoteDocumentReadTimeIndexKey::Key(key);
+  std::string index_value;
+  if (transaction->Get(ldb_read_time_index_key, &index_value).ok()) {
+    std::string read_time_key;
+    int64_t document_size = 0;
+    HARD_ASSERT(LevelDbRemoteDocumentReadTimeIndexKey::DecodeValue(
+                    index_value, &read_time_key, &document_size),
+                "Failed to decode the read time index entry for %s",
+                key.ToString());
+
+    CollectionStatistics& statistics =
+        pending_statistics_[key.path().PopLast()];
+    --statistics.document_count;
+    statistics.byte_size -= document_size;
+    db_->AdjustByteSize(-document_size);
+
+    if (!read_time_key.empty()) {
+      transaction->Delete(read_time_key);
+    }
+    transaction->Delete(ldb_read_time_index_key);
+  }
+
+  transaction->Delete(LevelDbRemoteDocumentKey::Key(key));
+}
+
+CollectionStatistics LevelDbRemoteDocumentCache::GetCollectionStatistics(
+    const ResourcePath& collection_path) const {
+  CollectionStatistics statistics =
+      ReadCollectionStatistics(db_->current_transaction(), collection_path);
+  auto pending = pending_statistics_.find(collection_path);
+  if (pending != pending_statistics_.end()) {
+    ApplyStatisticsDelta(pending->second, &statistics);
+  }
+  return statistics;
+}
+
+void LevelDbRemoteDocumentCache::WritePendingStatistics() {
+  LevelDbTransaction* transaction = db_->current_transaction();
+  for (const auto& entry : pending_statistics_) {
+    CollectionStatistics statistics =
+        ReadCollectionStatistics(transaction, entry.first);
+    ApplyStatisticsDelta(entry.second, &statistics);
+    WriteCollectionStatistics(transaction, entry.first, statistics);
+  }
+  pending_statistics_.clear();
 }
 
 MutableDocument LevelDbRemoteDocumentCache::Get(const DocumentKey& key) {
@@ -131,7 +230,8 @@ MutableDocument LevelDbRemoteDocumentCache::Get(const DocumentKey& key) {
   if (status.IsNotFound()) {
     return MutableDocument::InvalidDocument(key);
   } else if (status.ok()) {
-    return DecodeMaybeDocument(value, key);
+    return DecodeMaybeDocument(
+        std::make_shared<const std::string>(std::move(value)), key);
   } else {
     HARD_FAIL("Fetch document for key (%s) failed with status: %s",
               key.ToString(), status.ToString());
@@ -153,7 +253,7 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
       results.Insert(
           std::make_pair(key, MutableDocument::InvalidDocument(key)));
     } else {
-      const std::string& contents = it->value();
+      auto contents = std::make_shared<const std::string>(it->value());
       tasks.Execute([this, &results, &key, contents] {
         results.Insert(std::make_pair(key, DecodeMaybeDocument(contents, key)));
       });
@@ -170,33 +270,160 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
 }
 
 MutableDocumentMap LevelDbRemoteDocumentCache::GetAllExisting(
-    const DocumentKeySet& keys) {
-  MutableDocumentMap docs = LevelDbRemoteDocumentCache::GetAll(keys);
-  MutableDocumentMap result;
-  for (const auto& kv : docs) {
-    const DocumentKey& key = kv.first;
-    auto& document = kv.second;
-    if (document.is_found_document()) {
-      result = result.insert(key, document);
+    const DocumentKeySet& keys, const DocumentFilter& filter) {
+  BackgroundQueue tasks(executor_.get());
+  AsyncResults<MutableDocument> results;
+
+  LevelDbRemoteDocumentKey current_key;
+  auto it = db_->current_transaction()->NewIterator();
+
+  for (const DocumentKey& key : keys) {
+    it->Seek(LevelDbRemoteDocumentKey::Key(key));
+    if (!it->Valid() || !current_key.Decode(it->key()) ||
+        current_key.document_key() != key) {
+      continue;
     }
+
+    auto contents = std::make_shared<const std::string>(it->value());
+    tasks.Execute([this, &results, &filter, &key, contents] {
+      MutableDocument document = DecodeMaybeDocument(contents, key);
+      if (document.is_found_document() && filter(document)) {
+        results.Insert(std::move(document));
+      }
+    });
   }
 
-  return result;
+  tasks.AwaitAll();
+
+  MutableDocumentMap map;
+  for (const MutableDocument& doc : results.Result()) {
+    map = map.insert(doc.key(), doc);
+  }
+  return map;
 }
 
-model::MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
+MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
     const std::string& collection_group,
-    const model::IndexOffset& offset,
+    const IndexOffset& offset,
     size_t limit) const {
-  (void)collection_group;
-  (void)offset;
-  (void)limit;
-  // TODO(cheryllin): Implement GetAll() together with backfiller
-  return model::MutableDocumentMap();
+  NOT_NULL(index_manager_);
+  if (limit == 0) {
+    return {};
+  }
+
+  // The read time index is keyed by collection path, so each collection in the
+  // group is scanned separately. Since the results are limited to `limit`
+  // entries overall, no collection can contribute more than `limit` entries.
+  std::vector<IndexOffset> entries;
+  auto it = db_->current_transaction()->NewIterator();
+  LevelDbRemoteDocumentReadTimeKey current_key;
+  for (const ResourcePath& parent :
+       index_manager_->GetCollectionParents(collection_group)) {
+    ResourcePath path = parent.Append(collection_group);
+    size_t collection_entries = 0;
+    it->Seek(
+        LevelDbRemoteDocumentReadTimeKey::KeyPrefix(path, offset.read_time()));
+    for (; collection_entries < limit && it->Valid() &&
+           current_key.Decode(it->key()) &&
+           current_key.collection_path() == path;
+         it->Next()) {
+      IndexOffset entry(current_key.read_time(),
+                        DocumentKey(path.Append(current_key.document_id())),
+                        IndexOffset::InitialLargestBatchId());
+      if (entry.CompareTo(offset) != ComparisonResult::Descending) {
+        // The entry sorts before or at the offset.
+        continue;
+      }
+      entries.push_back(std::move(entry));
+      ++collection_entries;
+    }
+  }
+
+  // Keep the `limit` entries that come first in (read time, key) order.
+  auto by_offset = [](const IndexOffset& lhs, const IndexOffset& rhs) {
+    return lhs.CompareTo(rhs) == ComparisonResult::Ascending;
+  };
+  if (entries.size() > limit) {
+    std::partial_sort(entries.begin(), entries.begin() + limit, entries.end(),
+                      by_offset);
+    entries.erase(entries.begin() + limit, entries.end());
+  }
+
+  // Documents cached before the read time index keys existed may still appear
+  // at several read times. Their latest read time wins.
+  std::unordered_map<DocumentKey, SnapshotVersion, DocumentKeyHash> read_times;
+  for (const IndexOffset& entry : entries) {
+    auto inserted = read_times.emplace(entry.document_key(), entry.read_time());
+    if (!inserted.second && inserted.first->second < entry.read_time()) {
+      inserted.first->second = entry.read_time();
+    }
+  }
+
+  BackgroundQueue tasks(executor_.get());
+  AsyncResults<MutableDocument> results;
+
+  LevelDbRemoteDocumentKey document_key;
+  for (const auto& kv : read_times) {
+    const DocumentKey& key = kv.first;
+    it->Seek(LevelDbRemoteDocumentKey::Key(key));
+    if (!it->Valid() || !document_key.Decode(it->key()) ||
+        document_key.document_key() != key) {
+      // The document was removed since it was indexed by read time.
+      continue;
+    }
+
+    auto contents = std::make_shared<const std::string>(it->value());
+    const SnapshotVersion& read_time = kv.second;
+    tasks.Execute([this, &results, &key, &read_time, contents] {
+      MutableDocument document = DecodeMaybeDocument(contents, key);
+      document.WithReadTime(read_time);
+      results.Insert(std::move(document));
+    });
+  }
+
+  tasks.AwaitAll();
+
+  MutableDocumentMap map;
+  for (const MutableDocument& doc : results.Result()) {
+    map = map.insert(doc.key(), doc);
+  }
+  return map;
 }
 
 MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
     const model::ResourcePath& path, const model::IndexOffset& offset) {
+  return GetAllMatching(
+      path, offset, [](const MutableDocument&) { return true; },
+      /* context= */ nullptr);
+}
+
+MutableDocumentMap LevelDbRemoteDocumentCache::GetDocumentsMatchingQuery(
+    const Query& query,
+    const model::IndexOffset& offset,
+    const model::OverlayByDocumentKeyMap& mutated_docs,
+    QueryContext* context) {
+  HARD_ASSERT(!query.IsCollectionGroupQuery() && !query.IsDocumentQuery(),
+              "GetDocumentsMatchingQuery() only supports collection queries");
+
+  // `Query::Matches()` lazily memoizes the normalized order-bys. Compute them
+  // up front so that the concurrent decode tasks only read shared state.
+  query.order_bys();
+
+  return GetAllMatching(
+      query.path(), offset, [&](const MutableDocument& document) {
+        // Documents with local mutations may match once their overlay is
+        // applied, so let the caller decide.
+        return mutated_docs.find(document.key()) != mutated_docs.end() ||
+               query.Matches(document);
+      },
+      context);
+}
+
+MutableDocumentMap LevelDbRemoteDocumentCache::GetAllMatching(
+    const model::ResourcePath& path,
+    const model::IndexOffset& offset,
+    const DocumentFilter& filter,
+    QueryContext* context) {
   // Use the query path as a prefix for testing if a document matches the query.
   size_t immediate_children_path_length = path.size() + 1;
 
@@ -231,7 +458,10 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
       }
     }
 
-    return LevelDbRemoteDocumentCache::GetAllExisting(remote_keys);
+    if (context) {
+      context->IncrementDocumentsRead(remote_keys.size());
+    }
+    return GetAllExisting(remote_keys, filter);
   } else {
     BackgroundQueue tasks(executor_.get());
     AsyncResults<MutableDocument> results;
@@ -258,11 +488,14 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
         break;
       }
 
-      const std::string& contents = it->value();
-      tasks.Execute([this, &results, document_key, contents] {
+      if (context) {
+        context->IncrementDocumentsRead(1);
+      }
+      auto contents = std::make_shared<const std::string>(it->value());
+      tasks.Execute([this, &results, &filter, document_key, contents] {
         MutableDocument document = DecodeMaybeDocument(contents, document_key);
-        if (document.is_found_document()) {
-          results.Insert(document);
+        if (document.is_found_document() && filter(document)) {
+          results.Insert(std::move(document));
         }
       });
     }
@@ -278,12 +511,13 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
 }
 
 MutableDocument LevelDbRemoteDocumentCache::DecodeMaybeDocument(
-    absl::string_view encoded, const DocumentKey& key) {
-  StringReader reader{encoded};
-
-  auto message = Message<firestore_client_MaybeDocument>::TryParse(&reader);
+    std::shared_ptr<const std::string> encoded, const DocumentKey& key) const {
+  // Document fields are decoded on demand, so that documents rejected by a
+  // query filter (which usually only reads a few fields) are never fully
+  // decoded.
+  StringReader reader;
   MutableDocument maybe_document =
-      serializer_->DecodeMaybeDocument(&reader, *message);
+      serializer_->DecodeMaybeDocumentLazily(&reader, std::move(encoded));
 
   if (!reader.ok()) {
     HARD_FAIL("MaybeDocument proto failed to parse: %s",
@@ -296,6 +530,40 @@ MutableDocument LevelDbRemoteDocumentCache::DecodeMaybeDocument(
   return maybe_document;
 }
 
+size_t LevelDbRemoteDocumentCache::EstimateCollectionSize(
+    const ResourcePath& path, size_t max_count) const {
+  int64_t document_count = GetCollectionStatistics(path).document_count;
+  return std::min(static_cast<size_t>(std::max<int64_t>(document_count, 0)),
+                  max_count);
+}
+
+size_t LevelDbRemoteDocumentCache::EstimateChangedDocuments(
+    const ResourcePath& path,
+    const model::IndexOffset& offset,
+    size_t max_count) const {
+  if (offset.read_time() == SnapshotVersion::None()) {
+    return EstimateCollectionSize(path, max_count);
+  }
+
+  // Only the read time index is scanned, the same way `GetAllMatching()` finds
+  // the documents that changed since `offset`.
+  size_t count = 0;
+  auto it = db_->current_transaction()->NewIterator();
+  it->Seek(util::ImmediateSuccessor(
+      LevelDbRemoteDocumentReadTimeKey::KeyPrefix(path, offset.read_time())));
+  LevelDbRemoteDocumentReadTimeKey current_key;
+  for (; count < max_count && it->Valid() && current_key.Decode(it->key()) &&
+         current_key.collection_path() == path;
+       it->Next()) {
+    if (current_key.read_time() > offset.read_time() ||
+        DocumentKey(path.Append(current_key.document_id())) >
+            offset.document_key()) {
+      ++count;
+    }
+  }
+  return count;
+}
+
 void LevelDbRemoteDocumentCache::SetIndexManager(IndexManager* manager) {
   index_manager_ = NOT_NULL(manager);
 }
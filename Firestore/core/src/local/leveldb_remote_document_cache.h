@@ -17,14 +17,18 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_REMOTE_DOCUMENT_CACHE_H_
 
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include "Firestore/core/src/local/leveldb_index_manager.h"
+#include "Firestore/core/src/local/leveldb_statistics.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/types.h"
 #include "absl/strings/string_view.h"
 
@@ -58,18 +62,62 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
                                    size_t limit) const override;
   model::MutableDocumentMap GetAll(const model::ResourcePath& path,
                                    const model::IndexOffset& offset) override;
+  model::MutableDocumentMap GetDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      const model::OverlayByDocumentKeyMap& mutated_docs,
+      QueryContext* context) override;
+
+  size_t EstimateCollectionSize(const model::ResourcePath& path,
+                                size_t max_count) const override;
+
+  size_t EstimateChangedDocuments(const model::ResourcePath& path,
+                                  const model::IndexOffset& offset,
+                                  size_t max_count) const override;
 
   void SetIndexManager(IndexManager* manager) override;
 
+  /**
+   * Returns the statistics for the entries of the collection at
+   * `collection_path`, which are maintained by `Add()` and `Remove()`.
+   */
+  CollectionStatistics GetCollectionStatistics(
+      const model::ResourcePath& collection_path) const;
+
+  /**
+   * Writes the statistics changes made by the current transaction, updating
+   * each affected collection's row once. Called by LevelDbPersistence before
+   * the transaction commits.
+   */
+  void WritePendingStatistics();
+
  private:
+  /**
+   * A predicate evaluated on each decoded document. It runs on the concurrent
+   * decode executor, so it must only read shared state.
+   */
+  using DocumentFilter = std::function<bool(const model::MutableDocument&)>;
+
   /**
    * Looks up a set of entries in the cache, returning only existing entries of
-   * Type::Document.
+   * Type::Document that pass `filter`.
+   */
+  model::MutableDocumentMap GetAllExisting(const model::DocumentKeySet& keys,
+                                           const DocumentFilter& filter);
+
+  /**
+   * Returns the existing documents that are immediate children of `path`, sort
+   * after `offset` and pass `filter`. Counts the documents that were read in
+   * `context` if it is not null.
    */
-  model::MutableDocumentMap GetAllExisting(const model::DocumentKeySet& keys);
+  model::MutableDocumentMap GetAllMatching(const model::ResourcePath& path,
+                                           const model::IndexOffset& offset,
+                                           const DocumentFilter& filter,
+                                           QueryContext* context);
 
-  model::MutableDocument DecodeMaybeDocument(absl::string_view encoded,
-                                             const model::DocumentKey& key);
+  model::MutableDocument DecodeMaybeDocument(
+      std::shared_ptr<const std::string> encoded,
+      const model::DocumentKey& key) const;
 
   // The LevelDbRemoteDocumentCache instance is owned by LevelDbPersistence.
   LevelDbPersistence* db_;
@@ -79,6 +127,13 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
   LocalSerializer* serializer_ = nullptr;
 
   std::unique_ptr<util::Executor> executor_;
+
+  /**
+   * The changes to the collection statistics made by the current transaction,
+   * keyed by collection path. Each entry holds deltas of the count and size,
+   * and the latest read time added.
+   */
+  std::map<model::ResourcePath, CollectionStatistics> pending_statistics_;
 };
 
 }  // namespace local
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/leveldb_statistics.h"
+
+#include <string>
+#include <utility>
+
+#include "Firestore/core/src/local/leveldb_key.h"
+#include "Firestore/core/src/local/leveldb_transaction.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/ordered_code.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using leveldb::Status;
+using model::ResourcePath;
+using model::SnapshotVersion;
+using util::OrderedCode;
+
+std::string EncodeCollectionStatistics(const CollectionStatistics& statistics) {
+  std::string encoded;
+  OrderedCode::WriteSignedNumIncreasing(&encoded, statistics.document_count);
+  OrderedCode::WriteSignedNumIncreasing(&encoded, statistics.byte_size);
+  OrderedCode::WriteSignedNumIncreasing(
+      &encoded, statistics.last_read_time.timestamp().seconds());
+  OrderedCode::WriteSignedNumIncreasing(
+      &encoded, statistics.last_read_time.timestamp().nanoseconds());
+  return encoded;
+}
+
+CollectionStatistics DecodeCollectionStatistics(absl::string_view encoded) {
+  CollectionStatistics statistics;
+  int64_t seconds = 0;
+  int64_t nanos = 0;
+  if (!OrderedCode::ReadSignedNumIncreasing(&encoded,
+                                            &statistics.document_count) ||
+      !OrderedCode::ReadSignedNumIncreasing(&encoded, &statistics.byte_size) ||
+      !OrderedCode::ReadSignedNumIncreasing(&encoded, &seconds) ||
+      !OrderedCode::ReadSignedNumIncreasing(&encoded, &nanos)) {
+    HARD_FAIL("Failed to read collection statistics");
+  }
+  statistics.last_read_time =
+      SnapshotVersion({seconds, static_cast<int32_t>(nanos)});
+  return statistics;
+}
+
+}  // namespace
+
+bool operator==(const CollectionStatistics& lhs,
+                const CollectionStatistics& rhs) {
+  return lhs.document_count == rhs.document_count &&
+         lhs.byte_size == rhs.byte_size &&
+         lhs.last_read_time == rhs.last_read_time;
+}
+
+CollectionStatistics ReadCollectionStatistics(
+    LevelDbTransaction* transaction, const ResourcePath& collection_path) {
+  std::string value;
+  Status status = transaction->Get(
+      LevelDbCollectionStatisticsKey::Key(collection_path), &value);
+  if (status.IsNotFound()) {
+    return {};
+  }
+  HARD_ASSERT(status.ok(), "Failed to read collection statistics for %s: %s",
+              collection_path.CanonicalString(), status.ToString());
+  return DecodeCollectionStatistics(value);
+}
+
+void WriteCollectionStatistics(LevelDbTransaction* transaction,
+                               const ResourcePath& collection_path,
+                               const CollectionStatistics& statistics) {
+  std::string key = LevelDbCollectionStatisticsKey::Key(collection_path);
+  if (statistics.document_count <= 0) {
+    transaction->Delete(key);
+  } else {
+    transaction->Put(std::move(key), EncodeCollectionStatistics(statistics));
+  }
+}
+
+int64_t ReadCacheByteSize(LevelDbTransaction* transaction) {
+  std::string value;
+  Status status = transaction->Get(LevelDbCacheSizeKey::Key(), &value);
+  if (status.IsNotFound()) {
+    return 0;
+  }
+  HARD_ASSERT(status.ok(), "Failed to read cache size: %s", status.ToString());
+
+  absl::string_view encoded = value;
+  int64_t byte_size = 0;
+  if (!OrderedCode::ReadSignedNumIncreasing(&encoded, &byte_size)) {
+    HARD_FAIL("Failed to read cache size");
+  }
+  return byte_size;
+}
+
+void WriteCacheByteSize(LevelDbTransaction* transaction, int64_t byte_size) {
+  std::string encoded;
+  OrderedCode::WriteSignedNumIncreasing(&encoded, byte_size);
+  transaction->Put(LevelDbCacheSizeKey::Key(), std::move(encoded));
+}
+
+int64_t ReadIndexEntryCount(LevelDbTransaction* transaction,
+                            int32_t index_id,
+                            absl::string_view user_id) {
+  std::string value;
+  Status status = transaction->Get(
+      LevelDbIndexStatisticsKey::Key(index_id, user_id), &value);
+  if (status.IsNotFound()) {
+    return 0;
+  }
+  HARD_ASSERT(status.ok(), "Failed to read index statistics for %s: %s",
+              index_id, status.ToString());
+
+  absl::string_view encoded = value;
+  int64_t entry_count = 0;
+  if (!OrderedCode::ReadSignedNumIncreasing(&encoded, &entry_count)) {
+    HARD_FAIL("Failed to read index statistics for %s", index_id);
+  }
+  return entry_count;
+}
+
+void WriteIndexEntryCount(LevelDbTransaction* transaction,
+                          int32_t index_id,
+                          absl::string_view user_id,
+                          int64_t entry_count) {
+  std::string key = LevelDbIndexStatisticsKey::Key(index_id, user_id);
+  if (entry_count <= 0) {
+    transaction->Delete(key);
+  } else {
+    std::string encoded;
+    OrderedCode::WriteSignedNumIncreasing(&encoded, entry_count);
+    transaction->Put(std::move(key), std::move(encoded));
+  }
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_STATISTICS_H_
+#define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_STATISTICS_H_
+
+#include <cstdint>
+
+#include "Firestore/core/src/model/resource_path.h"
+#include "Firestore/core/src/model/snapshot_version.h"
+#include "absl/strings/string_view.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+class LevelDbTransaction;
+
+/**
+ * Statistics for the entries of a collection in the remote document cache,
+ * stored in the collection_statistics table.
+ *
+ * The statistics are updated in the same transaction as the entries they
+ * describe, so reading them never requires a scan of the collection.
+ */
+struct CollectionStatistics {
+  /** The number of entries, including deleted and unknown documents. */
+  int64_t document_count = 0;
+
+  /** The total size of the encoded entries, in bytes. */
+  int64_t byte_size = 0;
+
+  /** The latest read time of any entry that was added. */
+  model::SnapshotVersion last_read_time = model::SnapshotVersion::None();
+};
+
+bool operator==(const CollectionStatistics& lhs,
+                const CollectionStatistics& rhs);
+
+inline bool operator!=(const CollectionStatistics& lhs,
+                       const CollectionStatistics& rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * Reads the statistics for the collection at `collection_path`. Returns empty
+ * statistics if the collection has no entries.
+ */
+CollectionStatistics ReadCollectionStatistics(
+    LevelDbTransaction* transaction,
+    const model::ResourcePath& collection_path);
+
+/**
+ * Writes the statistics for the collection at `collection_path`. The row is
+ * deleted once the collection no longer has any entries.
+ */
+void WriteCollectionStatistics(LevelDbTransaction* transaction,
+                               const model::ResourcePath& collection_path,
+                               const CollectionStatistics& statistics);
+
+/**
+ * Reads the total size in bytes of the encoded remote documents, targets and
+ * mutation batches, which is kept in the cache_size table.
+ */
+int64_t ReadCacheByteSize(LevelDbTransaction* transaction);
+
+/** Writes the total size of the cached data to the cache_size table. */
+void WriteCacheByteSize(LevelDbTransaction* transaction, int64_t byte_size);
+
+/**
+ * Reads the number of index entries that `user_id` has for the field index
+ * with `index_id`.
+ */
+int64_t ReadIndexEntryCount(LevelDbTransaction* transaction,
+                            int32_t index_id,
+                            absl::string_view user_id);
+
+/**
+ * Writes the number of index entries that `user_id` has for the field index
+ * with `index_id`. The row is deleted once the count drops to zero.
+ */
+void WriteIndexEntryCount(LevelDbTransaction* transaction,
+                          int32_t index_id,
+                          absl::string_view user_id,
+                          int64_t entry_count);
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_LEVELDB_STATISTICS_H_
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/leveldb_target_cache.h"
 
+#include <memory>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -29,6 +30,7 @@
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/nanopb/byte_string.h"
+#include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/string_apple.h"
@@ -97,6 +99,21 @@ void LevelDbTargetCache::Start() {
     HARD_FAIL("Failed to decode last remote snapshot version, reason: '%s'",
               reader.status().ToString());
   }
+
+  // Record the encoded size of each target, so that saving or removing a
+  // target can update the cache size without reading the previous entry.
+  std::string target_prefix = LevelDbTargetKey::KeyPrefix();
+  std::unique_ptr<leveldb::Iterator> it(
+      db_->ptr()->NewIterator(LevelDbTransaction::DefaultReadOptions()));
+  LevelDbTargetKey row_key;
+  for (it->Seek(target_prefix);
+       it->Valid() &&
+       absl::StartsWith(MakeStringView(it->key()), target_prefix);
+       it->Next()) {
+    HARD_ASSERT(row_key.Decode(it->key()), "Failed to decode target key");
+    target_sizes_[row_key.target_id()] =
+        static_cast<int64_t>(it->value().size());
+  }
 }
 
 void LevelDbTargetCache::AddTarget(const TargetData& target_data) {
@@ -126,8 +143,12 @@ void LevelDbTargetCache::RemoveTarget(const TargetData& target_data) {
 
   RemoveMatchingKeysForTarget(target_id);
 
-  std::string key = LevelDbTargetKey::Key(target_id);
-  db_->current_transaction()->Delete(key);
+  auto target_size = target_sizes_.find(target_id);
+  if (target_size != target_sizes_.end()) {
+    db_->AdjustByteSize(-target_size->second);
+    target_sizes_.erase(target_size);
+  }
+  db_->current_transaction()->Delete(LevelDbTargetKey::Key(target_id));
 
   std::string index_key =
       LevelDbQueryTargetKey::Key(target_data.target().CanonicalId(), target_id);
@@ -226,6 +247,8 @@ size_t LevelDbTargetCache::RemoveTargets(
       // Remove the DocumentKey to TargetId mapping
       RemoveMatchingKeysForTarget(target_id);
       // Remove the TargetId to Target mapping
+      db_->AdjustByteSize(-static_cast<int64_t>(it->value().size()));
+      target_sizes_.erase(target_id);
       db_->current_transaction()->Delete(it->key());
 
       removed_targets.insert(target_id);
@@ -365,9 +388,23 @@ void LevelDbTargetCache::SetLastRemoteSnapshotVersion(SnapshotVersion version) {
 
 void LevelDbTargetCache::EnumerateOrphanedDocuments(
     const OrphanedDocumentCallback& callback) {
+  EnumerateOrphanedDocuments(
+      DocumentKey(),
+      [&](const DocumentKey& key, ListenSequenceNumber sequence_number) {
+        callback(key, sequence_number);
+        return true;
+      });
+}
+
+void LevelDbTargetCache::EnumerateOrphanedDocuments(
+    const DocumentKey& start_after,
+    const std::function<bool(const DocumentKey&, ListenSequenceNumber)>&
+        callback) {
   std::string document_target_prefix = LevelDbDocumentTargetKey::KeyPrefix();
   auto it = db_->current_transaction()->NewIterator();
-  it->Seek(document_target_prefix);
+  it->Seek(start_after.path().empty()
+               ? document_target_prefix
+               : LevelDbDocumentTargetKey::KeyPrefix(start_after.path()));
   ListenSequenceNumber next_to_report = 0;
   DocumentKey key_to_report;
   LevelDbDocumentTargetKey key;
@@ -375,11 +412,14 @@ void LevelDbTargetCache::EnumerateOrphanedDocuments(
   for (; it->Valid() && absl::StartsWith(it->key(), document_target_prefix);
        it->Next()) {
     HARD_ASSERT(key.Decode(it->key()), "Failed to decode DocumentTarget key");
+    if (!start_after.path().empty() && key.document_key() <= start_after) {
+      continue;
+    }
     if (key.IsSentinel()) {
       // if next_to_report is non-zero, report it, this is a new key so the last
       // one must be not be a member of any targets.
-      if (next_to_report != 0) {
-        callback(key_to_report, next_to_report);
+      if (next_to_report != 0 && !callback(key_to_report, next_to_report)) {
+        return;
       }
       // set next_to_report to be this sequence number. It's the next one we
       // might report, if we don't find any targets for this document.
@@ -402,8 +442,15 @@ void LevelDbTargetCache::EnumerateOrphanedDocuments(
 void LevelDbTargetCache::Save(const TargetData& target_data) {
   TargetId target_id = target_data.target_id();
   std::string key = LevelDbTargetKey::Key(target_id);
-  db_->current_transaction()->Put(key,
-                                  serializer_->EncodeTargetData(target_data));
+  std::string contents =
+      nanopb::MakeStdString(serializer_->EncodeTargetData(target_data));
+
+  int64_t& target_size = target_sizes_[target_id];
+  int64_t size = static_cast<int64_t>(contents.size());
+  db_->AdjustByteSize(size - target_size);
+  target_size = size;
+
+  db_->current_transaction()->Put(key, std::move(contents));
 }
 
 bool LevelDbTargetCache::UpdateMetadata(const TargetData& target_data) {
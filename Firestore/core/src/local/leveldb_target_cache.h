@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_TARGET_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_TARGET_CACHE_H_
 
+#include <cstdint>
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -125,6 +127,15 @@ class LevelDbTargetCache : public TargetCache {
 
   void EnumerateOrphanedDocuments(const OrphanedDocumentCallback& callback);
 
+  /**
+   * Enumerates the orphaned documents that sort after `start_after` in key
+   * order, until `callback` returns false.
+   */
+  void EnumerateOrphanedDocuments(
+      const model::DocumentKey& start_after,
+      const std::function<bool(const model::DocumentKey&,
+                               model::ListenSequenceNumber)>& callback);
+
  private:
   void Save(const TargetData& target_data);
   bool UpdateMetadata(const TargetData& target_data);
@@ -152,6 +163,12 @@ class LevelDbTargetCache : public TargetCache {
   /** A write-through cached copy of the metadata for the target cache. */
   nanopb::Message<firestore_client_TargetGlobal> metadata_;
 
+  /**
+   * A write-through cache of the size of each target's encoded entry, which
+   * keeps the cache size up to date without reading the previous entries.
+   */
+  std::unordered_map<model::TargetId, int64_t> target_sizes_;
+
   model::SnapshotVersion last_remote_snapshot_version_;
 };
 
@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <cstring>
 #include <type_traits>
 
 #include "Firestore/core/src/local/leveldb_transaction.h"
@@ -35,12 +36,55 @@ using leveldb::WriteOptions;
 namespace firebase {
 namespace firestore {
 namespace local {
+namespace {
+
+/**
+ * The size of the blocks that the arena copies keys and values into. Larger
+ * strings are given a block of their own.
+ */
+constexpr size_t kArenaBlockSize = 32 * 1024;
+
+Slice ToSlice(absl::string_view view) {
+  return Slice(view.data(), view.size());
+}
+
+}  // namespace
+
+char* LevelDbTransaction::Arena::Allocate(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  if (size > kArenaBlockSize / 4) {
+    // Doesn't waste the remainder of the current block on a large string.
+    blocks_.emplace_back(new char[size]);
+    return blocks_.back().get();
+  }
+
+  if (size > remaining_) {
+    blocks_.emplace_back(new char[kArenaBlockSize]);
+    next_ = blocks_.back().get();
+    remaining_ = kArenaBlockSize;
+  }
+  char* result = next_;
+  next_ += size;
+  remaining_ -= size;
+  return result;
+}
+
+absl::string_view LevelDbTransaction::Arena::Copy(absl::string_view data) {
+  char* result = Allocate(data.size());
+  if (result) {
+    std::memcpy(result, data.data(), data.size());
+  }
+  return absl::string_view(result, data.size());
+}
 
 LevelDbTransaction::Iterator::Iterator(LevelDbTransaction* txn)
     : db_iter_(txn->db_->NewIterator(txn->read_options_)),
       last_version_(txn->version_),
       txn_(txn),
-      mutations_iter_(txn->mutations_.begin()),
+      changes_iter_(txn->changes_.begin()),
       current_(),
       is_mutation_(false),
       // Iterator doesn't really point to anything yet, so is
@@ -49,7 +93,7 @@ LevelDbTransaction::Iterator::Iterator(LevelDbTransaction* txn)
 }
 
 void LevelDbTransaction::Iterator::UpdateCurrent() {
-  bool mutation_is_valid = mutations_iter_ != txn_->mutations_.end();
+  bool mutation_is_valid = changes_iter_ != txn_->changes_.end();
   is_valid_ = mutation_is_valid || db_iter_->Valid();
 
   if (is_valid_) {
@@ -62,10 +106,12 @@ void LevelDbTransaction::Iterator::UpdateCurrent() {
       // than the current mutation key, we are looking at a mutation next. It's
       // either sooner in the iteration or directly shadowing the underlying
       // committed value in leveldb.
-      is_mutation_ = db_iter_->key().compare(mutations_iter_->first) >= 0;
+      is_mutation_ =
+          db_iter_->key().compare(ToSlice(changes_iter_->first)) >= 0;
     }
     if (is_mutation_) {
-      current_ = *mutations_iter_;
+      current_ = {std::string(changes_iter_->first),
+                  std::string(changes_iter_->second.value)};
     } else {
       current_ = {db_iter_->key().ToString(), db_iter_->value().ToString()};
     }
@@ -80,7 +126,8 @@ void LevelDbTransaction::Iterator::Seek(const std::string& key) {
   }
   HARD_ASSERT(db_iter_->status().ok(), "leveldb iterator reported an error: %s",
               db_iter_->status().ToString());
-  mutations_iter_ = txn_->mutations_.lower_bound(key);
+  changes_iter_ = txn_->changes_.lower_bound(key);
+  SkipDeletedChanges();
   UpdateCurrent();
   last_version_ = txn_->version_;
 }
@@ -96,7 +143,21 @@ const std::string& LevelDbTransaction::Iterator::value() const {
 }
 
 bool LevelDbTransaction::Iterator::IsDeleted(leveldb::Slice slice) {
-  return txn_->deletions_.find(slice.ToString()) != txn_->deletions_.end();
+  // Avoids a lookup for every key that is iterated over when nothing was
+  // deleted, which is always the case in read-only transactions.
+  if (txn_->deleted_keys_ == 0) {
+    return false;
+  }
+  auto found =
+      txn_->changes_.find(absl::string_view(slice.data(), slice.size()));
+  return found != txn_->changes_.end() && found->second.deleted;
+}
+
+void LevelDbTransaction::Iterator::SkipDeletedChanges() {
+  while (changes_iter_ != txn_->changes_.end() &&
+         changes_iter_->second.deleted) {
+    ++changes_iter_;
+  }
 }
 
 bool LevelDbTransaction::Iterator::SyncToTransaction() {
@@ -126,10 +187,12 @@ void LevelDbTransaction::Iterator::Next() {
   if (!advanced && is_valid_) {
     if (is_mutation_) {
       // A mutation might be shadowing leveldb. If so, advance both.
-      if (db_iter_->Valid() && db_iter_->key() == mutations_iter_->first) {
+      if (db_iter_->Valid() &&
+          db_iter_->key() == ToSlice(changes_iter_->first)) {
         AdvanceLDB();
       }
-      ++mutations_iter_;
+      ++changes_iter_;
+      SkipDeletedChanges();
     } else {
       AdvanceLDB();
     }
@@ -147,6 +210,22 @@ LevelDbTransaction::LevelDbTransaction(DB* db,
       label_(label) {
 }
 
+std::unique_ptr<LevelDbTransaction> LevelDbTransaction::ReadOnly(
+    DB* db, absl::string_view label) {
+  ReadOptions read_options = DefaultReadOptions();
+  read_options.snapshot = db->GetSnapshot();
+  auto transaction =
+      absl::make_unique<LevelDbTransaction>(db, label, read_options);
+  transaction->snapshot_ = read_options.snapshot;
+  return transaction;
+}
+
+LevelDbTransaction::~LevelDbTransaction() {
+  if (snapshot_) {
+    db_->ReleaseSnapshot(snapshot_);
+  }
+}
+
 const ReadOptions& LevelDbTransaction::DefaultReadOptions() {
   static_assert(std::is_trivially_destructible<ReadOptions>::value,
                 "ReadOptions should be trivially-destructible; otherwise, it "
@@ -167,9 +246,27 @@ const WriteOptions& LevelDbTransaction::DefaultWriteOptions() {
   return options;
 }
 
-void LevelDbTransaction::Put(std::string key, std::string value) {
-  deletions_.erase(key);
-  mutations_[std::move(key)] = std::move(value);
+void LevelDbTransaction::Put(absl::string_view key, absl::string_view value) {
+  HARD_ASSERT(!read_only(), "Put in read-only transaction %s", label_);
+  auto found = changes_.find(key);
+  if (found == changes_.end()) {
+    found = changes_
+                .emplace(arena_.Copy(key), PendingChange{{}, nullptr, 0, false})
+                .first;
+  } else if (found->second.deleted) {
+    found->second.deleted = false;
+    --deleted_keys_;
+  }
+
+  PendingChange& change = found->second;
+  if (value.size() > change.capacity) {
+    change.slot = arena_.Allocate(value.size());
+    change.capacity = value.size();
+  }
+  if (!value.empty()) {
+    std::memcpy(change.slot, value.data(), value.size());
+  }
+  change.value = absl::string_view(change.slot, value.size());
   version_++;
 }
 
@@ -179,35 +276,46 @@ LevelDbTransaction::NewIterator() {
 }
 
 Status LevelDbTransaction::Get(absl::string_view key, std::string* value) {
-  std::string key_string(key);
-  if (deletions_.find(key_string) != deletions_.end()) {
-    return Status::NotFound(key_string + " is not present in the transaction");
-  } else {
-    Mutations::iterator iter{mutations_.find(key_string)};
-    if (iter != mutations_.end()) {
-      *value = iter->second;
-      return Status::OK();
-    } else {
-      return db_->Get(read_options_, key_string, value);
-    }
+  auto found = changes_.find(key);
+  if (found == changes_.end()) {
+    return db_->Get(read_options_, ToSlice(key), value);
+  } else if (found->second.deleted) {
+    return Status::NotFound(std::string(key) +
+                            " is not present in the transaction");
   }
+
+  value->assign(found->second.value.data(), found->second.value.size());
+  return Status::OK();
 }
 
 void LevelDbTransaction::Delete(absl::string_view key) {
-  std::string to_delete(key);
-  deletions_.insert(to_delete);
-  mutations_.erase(to_delete);
+  HARD_ASSERT(!read_only(), "Delete in read-only transaction %s", label_);
+  auto found = changes_.find(key);
+  if (found == changes_.end()) {
+    changes_.emplace(arena_.Copy(key), PendingChange{{}, nullptr, 0, true});
+    ++deleted_keys_;
+  } else if (!found->second.deleted) {
+    // Keeps the slot, in case the key is written again.
+    found->second.value = {};
+    found->second.deleted = true;
+    ++deleted_keys_;
+  }
   version_++;
 }
 
 void LevelDbTransaction::Commit() {
-  WriteBatch batch;
-  for (const auto& deletion : deletions_) {
-    batch.Delete(deletion);
+  if (read_only()) {
+    return;
   }
 
-  for (const auto& entry : mutations_) {
-    batch.Put(entry.first, entry.second);
+  // Keys and values are copied into the batch straight from the arena.
+  WriteBatch batch;
+  for (const auto& entry : changes_) {
+    if (entry.second.deleted) {
+      batch.Delete(ToSlice(entry.first));
+    } else {
+      batch.Put(ToSlice(entry.first), ToSlice(entry.second.value));
+    }
   }
 
   LOG_DEBUG("Committing transaction: %s", ToString());
@@ -219,18 +327,22 @@ void LevelDbTransaction::Commit() {
 
 std::string LevelDbTransaction::ToString() {
   std::string dest = absl::StrCat("<LevelDbTransaction ", label_, ": ");
-  size_t changes = deletions_.size() + mutations_.size();
+  size_t changes = changes_.size();
   size_t bytes = 0;  // accumulator for size of individual mutations.
   dest += std::to_string(changes) + " changes ";
   std::string items;  // accumulator for individual changes.
-  for (const auto& deletion : deletions_) {
-    absl::StrAppend(&items, "\n  - Delete ", DescribeKey(deletion));
-  }
-  for (const auto& entry : mutations_) {
-    size_t change_bytes = entry.second.size();
-    bytes += change_bytes;
-    absl::StrAppend(&items, "\n  - Put ", DescribeKey(entry.first), " (",
-                    change_bytes, " bytes)");
+  for (const auto& entry : changes_) {
+    if (entry.second.deleted) {
+      absl::StrAppend(&items, "\n  - Delete ", DescribeKey(entry.first));
+    }
+  }
+  for (const auto& entry : changes_) {
+    if (!entry.second.deleted) {
+      size_t change_bytes = entry.second.value.size();
+      bytes += change_bytes;
+      absl::StrAppend(&items, "\n  - Put ", DescribeKey(entry.first), " (",
+                      change_bytes, " bytes)");
+    }
   }
   absl::StrAppend(&dest, "(", bytes, " bytes):", items, ">");
   return dest;
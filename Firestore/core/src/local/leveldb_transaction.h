@@ -20,9 +20,9 @@
 #include <cstdint>
 #include <map>
 #include <memory>
-#include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/nanopb/message.h"
@@ -38,10 +38,47 @@ namespace local {
  * LevelDBTransaction tracks pending changes to entries in leveldb, including
  * deletions. It also provides an Iterator to traverse a merged view of pending
  * changes and committed values.
+ *
+ * A read-only transaction (see `ReadOnly()`) instead reads from a consistent
+ * snapshot of the database, and its iterators read leveldb directly.
  */
 class LevelDbTransaction {
-  using Deletions = std::set<std::string>;
-  using Mutations = std::map<std::string, std::string>;
+  /** A pending change to a key: either its new value or its deletion. */
+  struct PendingChange {
+    // Points into `slot`, unless the key is deleted.
+    absl::string_view value;
+
+    // The arena memory holding the key's value. Rewriting the key reuses it
+    // when the new value fits, so keys written on every mutation (such as
+    // counters and metadata rows) don't grow the arena.
+    char* slot;
+    size_t capacity;
+
+    bool deleted;
+  };
+
+  /**
+   * Pending changes by key. Keys and values point into `arena_`, such that a
+   * change needs a single allocation for its map node.
+   */
+  using Changes = std::map<absl::string_view, PendingChange>;
+
+  /**
+   * Owns the bytes of the pending keys and values. Strings are copied into
+   * large blocks, which are all released together with the transaction.
+   */
+  class Arena {
+   public:
+    /** Returns `size` bytes of memory, or null if `size` is zero. */
+    char* Allocate(size_t size);
+
+    absl::string_view Copy(absl::string_view data);
+
+   private:
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char* next_ = nullptr;
+    size_t remaining_ = 0;
+  };
 
  public:
   /**
@@ -87,11 +124,14 @@ class LevelDbTransaction {
     void AdvanceLDB();
 
     /**
-     * Returns true if the given slice matches a key present in the deletions_
-     * set.
+     * Returns true if the given slice matches a key that is deleted in the
+     * transaction.
      */
     bool IsDeleted(leveldb::Slice slice);
 
+    /** Advances `changes_iter_` past any deletions. */
+    void SkipDeletedChanges();
+
     /**
      * Syncs with the underlying transaction. If the transaction has been
      * updated, the mutation iterator may need to be reset. Returns true if this
@@ -112,13 +152,13 @@ class LevelDbTransaction {
     int32_t last_version_;
     // The underlying transaction.
     LevelDbTransaction* txn_;
-    Mutations::iterator mutations_iter_;
+    Changes::const_iterator changes_iter_;
     // We save the current key and value so that once an iterator is Valid(), it
     // remains so at least until the next call to Seek() or Next(), even if the
     // underlying data is deleted.
     std::pair<std::string, std::string> current_;
-    // True if current_ represents an entry in the mutations_ map, rather than
-    // committed data.
+    // True if current_ represents a pending change, rather than committed
+    // data.
     bool is_mutation_;
     // True if the iterator pointed to a valid entry the last time Next() or
     // Seek() was called.
@@ -135,6 +175,15 @@ class LevelDbTransaction {
 
   LevelDbTransaction& operator=(const LevelDbTransaction& other) = delete;
 
+  ~LevelDbTransaction();
+
+  /**
+   * Creates a transaction that reads from a snapshot of `db` taken now and
+   * that cannot be written to.
+   */
+  static std::unique_ptr<LevelDbTransaction> ReadOnly(leveldb::DB* db,
+                                                      absl::string_view label);
+
   /**
    * Returns a default set of ReadOptions
    */
@@ -146,7 +195,11 @@ class LevelDbTransaction {
   static const leveldb::WriteOptions& DefaultWriteOptions();
 
   size_t changed_keys() const {
-    return mutations_.size() + deletions_.size();
+    return changes_.size();
+  }
+
+  bool read_only() const {
+    return snapshot_ != nullptr;
   }
 
   /**
@@ -159,15 +212,15 @@ class LevelDbTransaction {
    * Schedules the row identified by `key` to be set to `value` when this
    * transaction commits.
    */
-  void Put(std::string key, std::string value);
+  void Put(absl::string_view key, absl::string_view value);
 
   /**
    * Schedules the row identified by `key` to be set to the given protocol
    * buffer message when this transaction commits.
    */
   template <typename T>
-  void Put(std::string key, const nanopb::Message<T>& message) {
-    Put(std::move(key), MakeStdString(message));
+  void Put(absl::string_view key, const nanopb::Message<T>& message) {
+    Put(key, MakeStdString(message));
   }
 
   /**
@@ -186,7 +239,8 @@ class LevelDbTransaction {
 
   /**
    * Commits the transaction. All pending changes are written. The transaction
-   * should not be used after calling this method.
+   * should not be used after calling this method. Committing a read-only
+   * transaction does nothing.
    */
   void Commit();
 
@@ -194,10 +248,15 @@ class LevelDbTransaction {
 
  private:
   leveldb::DB* db_ = nullptr;
-  Mutations mutations_;
-  Deletions deletions_;
+  Arena arena_;
+  Changes changes_;
+  size_t deleted_keys_ = 0;
   leveldb::ReadOptions read_options_;
   leveldb::WriteOptions write_options_;
+
+  /** The snapshot read by a read-only transaction, owned by `db_`. */
+  const leveldb::Snapshot* snapshot_ = nullptr;
+
   int32_t version_ = 0;
   std::string label_;
 };
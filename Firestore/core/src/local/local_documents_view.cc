@@ -26,8 +26,8 @@
 
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/immutable/sorted_set.h"
-#include "Firestore/core/src/local/local_write_result.h"
 #include "Firestore/core/src/local/mutation_queue.h"
+#include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
@@ -76,21 +76,26 @@ Document LocalDocumentsView::GetDocument(
 }
 
 DocumentMap LocalDocumentsView::GetDocumentsMatchingQuery(
-    const Query& query, const model::IndexOffset& offset) {
+    const Query& query,
+    const model::IndexOffset& offset,
+    QueryContext* context) {
   if (query.IsDocumentQuery()) {
-    return GetDocumentsMatchingDocumentQuery(query.path());
+    return GetDocumentsMatchingDocumentQuery(query.path(), context);
   } else if (query.IsCollectionGroupQuery()) {
-    return GetDocumentsMatchingCollectionGroupQuery(query, offset);
+    return GetDocumentsMatchingCollectionGroupQuery(query, offset, context);
   } else {
-    return GetDocumentsMatchingCollectionQuery(query, offset);
+    return GetDocumentsMatchingCollectionQuery(query, offset, context);
   }
 }
 
 DocumentMap LocalDocumentsView::GetDocumentsMatchingDocumentQuery(
-    const ResourcePath& doc_path) {
+    const ResourcePath& doc_path, QueryContext* context) {
   DocumentMap result;
   // Just do a simple document lookup.
   Document doc = GetDocument(DocumentKey{doc_path});
+  if (context) {
+    context->IncrementDocumentsRead(1);
+  }
   if (doc->is_found_document()) {
     result = result.insert(doc->key(), doc);
   }
@@ -98,7 +103,7 @@ DocumentMap LocalDocumentsView::GetDocumentsMatchingDocumentQuery(
 }
 
 model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
-    const Query& query, const IndexOffset& offset) {
+    const Query& query, const IndexOffset& offset, QueryContext* context) {
   HARD_ASSERT(
       query.path().empty(),
       "Currently we only support collection group queries at the root.");
@@ -114,7 +119,7 @@ model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
     Query collection_query =
         query.AsCollectionQueryAtPath(parent.Append(collection_id));
     DocumentMap collection_results =
-        GetDocumentsMatchingCollectionQuery(collection_query, offset);
+        GetDocumentsMatchingCollectionQuery(collection_query, offset, context);
     for (const auto& kv : collection_results) {
       const DocumentKey& key = kv.first;
       results = results.insert(key, Document(kv.second));
@@ -124,12 +129,15 @@ model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
 }
 
 DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
-    const Query& query, const IndexOffset& offset) {
-  MutableDocumentMap remote_documents =
-      remote_document_cache_->GetAll(query.path(), offset);
+    const Query& query, const IndexOffset& offset, QueryContext* context) {
   // Get locally persisted mutation batches.
   OverlayByDocumentKeyMap overlays = document_overlay_cache_->GetOverlays(
       query.path(), offset.largest_batch_id());
+  // Only remote documents that match the query, or that have an overlay that
+  // might make them match, are returned by the cache.
+  MutableDocumentMap remote_documents =
+      remote_document_cache_->GetDocumentsMatchingQuery(query, offset,
+                                                        overlays, context);
 
   // As documents might match the query because of their overlay we need to
   // include documents for all overlays in the initial document set.
@@ -161,6 +169,46 @@ DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
   return results;
 }
 
+LocalDocumentsResult LocalDocumentsView::GetNextDocuments(
+    const std::string& collection_group,
+    const IndexOffset& offset,
+    size_t count) {
+  MutableDocumentMap docs =
+      remote_document_cache_->GetAll(collection_group, offset, count);
+  OverlayByDocumentKeyMap overlays;
+  if (count > docs.size()) {
+    overlays = document_overlay_cache_->GetOverlays(
+        collection_group, offset.largest_batch_id(), count - docs.size());
+  }
+
+  BatchId largest_batch_id = IndexOffset::InitialLargestBatchId();
+  for (const auto& entry : overlays) {
+    if (docs.find(entry.first) == docs.end()) {
+      docs =
+          docs.insert(entry.first, GetBaseDocument(entry.first, entry.second));
+    }
+    // The callsite will use the largest batch ID together with the latest read
+    // time to create a new index offset. Since we only process batch IDs if
+    // all remote documents have been read, no overlay will increase the
+    // overall read time. This is why we only need to special case the batch
+    // id.
+    largest_batch_id =
+        std::max(largest_batch_id, entry.second.largest_batch_id());
+  }
+
+  PopulateOverlays(overlays, DocumentKeySet::FromKeysOf(docs));
+  model::OverlayedDocumentMap overlayed_docs =
+      ComputeViews(docs, std::move(overlays), DocumentKeySet{});
+
+  LocalDocumentsResult result;
+  result.largest_batch_id = largest_batch_id;
+  for (const auto& entry : overlayed_docs) {
+    result.documents =
+        result.documents.insert(entry.first, entry.second.document());
+  }
+  return result;
+}
+
 Document LocalDocumentsView::GetDocument(const DocumentKey& key) {
   absl::optional<Overlay> overlay = document_overlay_cache_->GetOverlay(key);
   MutableDocument document = GetBaseDocument(key, overlay);
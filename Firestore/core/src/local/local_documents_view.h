@@ -27,8 +27,10 @@
 #include "Firestore/core/src/local/mutation_queue.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/field_index.h"
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/overlayed_document.h"
+#include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/util/range.h"
 
 namespace firebase {
@@ -39,11 +41,20 @@ class Query;
 }  // namespace core
 
 namespace local {
-class LocalWriteResult;
+class QueryContext;
 }  // namespace local
 
 namespace local {
 
+/** The documents returned by `LocalDocumentsView::GetNextDocuments`. */
+struct LocalDocumentsResult {
+  /** The largest batch ID of the overlays applied to `documents`. */
+  model::BatchId largest_batch_id = model::IndexOffset::InitialLargestBatchId();
+
+  /** The documents that follow the offset, with their overlays applied. */
+  model::DocumentMap documents;
+};
+
 /**
  * A readonly view of the local state of all documents we're tracking (i.e. we
  * have a cached version in the RemoteDocumentCache or local mutations for the
@@ -116,10 +127,34 @@ class LocalDocumentsView {
    *
    * @param query The query to match documents against.
    * @param offset Read time and document key to start scanning by (exclusive).
+   * @param context If not null, counts the documents read from the remote
+   *     document cache.
    */
   // Virtual for testing.
   virtual model::DocumentMap GetDocumentsMatchingQuery(
-      const core::Query& query, const model::IndexOffset& offset);
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      QueryContext* context);
+
+  /**
+   * Given a collection group, returns the next documents that follow the
+   * provided offset, along with an updated batch ID.
+   *
+   * The documents returned by this method are ordered by remote version from
+   * the provided offset. If there are no more remote documents after the
+   * provided offset, documents with mutations in order of batch id from the
+   * offset are returned. Since all documents in a batch are returned together,
+   * the total number of documents returned can exceed `count`.
+   *
+   * @param collection_group The collection group for the documents.
+   * @param offset The offset to index into.
+   * @param count The number of documents to return.
+   * @return The documents that follow the provided offset and the last
+   * processed batch id.
+   */
+  LocalDocumentsResult GetNextDocuments(const std::string& collection_group,
+                                        const model::IndexOffset& offset,
+                                        size_t count);
 
  private:
   friend class QueryEngine;
@@ -132,14 +167,18 @@ class LocalDocumentsView {
 
   /** Performs a simple document lookup for the given path. */
   model::DocumentMap GetDocumentsMatchingDocumentQuery(
-      const model::ResourcePath& doc_path);
+      const model::ResourcePath& doc_path, QueryContext* context);
 
   model::DocumentMap GetDocumentsMatchingCollectionGroupQuery(
-      const core::Query& query, const model::IndexOffset& offset);
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      QueryContext* context);
 
   /** Queries the remote documents and overlays mutations. */
   model::DocumentMap GetDocumentsMatchingCollectionQuery(
-      const core::Query& query, const model::IndexOffset& offset);
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      QueryContext* context);
 
   RemoteDocumentCache* remote_document_cache() {
     return remote_document_cache_;
@@ -66,12 +66,15 @@ using model::SnapshotVersion;
 using nanopb::ByteString;
 using nanopb::CheckedSize;
 using nanopb::CopyBytesArray;
+using nanopb::EncodedField;
+using nanopb::ForEachEncodedField;
 using nanopb::MakeArray;
 using nanopb::Message;
 using nanopb::Reader;
 using nanopb::ReleaseFieldOwnership;
 using nanopb::SafeReadBoolean;
 using nanopb::SetRepeatedField;
+using nanopb::StringReader;
 using nanopb::Writer;
 using util::Status;
 using util::StringFormat;
@@ -135,6 +138,56 @@ MutableDocument LocalSerializer::DecodeMaybeDocument(
   UNREACHABLE();
 }
 
+MutableDocument LocalSerializer::DecodeMaybeDocumentLazily(
+    Reader* reader, std::shared_ptr<const std::string> encoded) const {
+  if (!reader->status().ok()) return {};
+
+  absl::string_view encoded_document;
+  pb_size_t document_type = 0;
+  bool has_committed_mutations = false;
+  bool ok = ForEachEncodedField(*encoded, [&](const EncodedField& field) {
+    switch (field.tag) {
+      case firestore_client_MaybeDocument_no_document_tag:
+      case firestore_client_MaybeDocument_unknown_document_tag:
+        document_type = field.tag;
+        break;
+
+      case firestore_client_MaybeDocument_document_tag:
+        document_type = field.tag;
+        encoded_document = field.bytes;
+        break;
+
+      case firestore_client_MaybeDocument_has_committed_mutations_tag:
+        has_committed_mutations = field.varint != 0;
+        break;
+
+      default:
+        break;
+    }
+    return true;
+  });
+  if (!ok) {
+    reader->Fail("Invalid MaybeDocument proto");
+    return {};
+  }
+
+  if (document_type != firestore_client_MaybeDocument_document_tag) {
+    // Missing and unknown documents have no fields, so there is nothing to
+    // defer.
+    StringReader proto_reader{*encoded};
+    auto message =
+        Message<firestore_client_MaybeDocument>::TryParse(&proto_reader);
+    MutableDocument document = DecodeMaybeDocument(&proto_reader, *message);
+    if (!proto_reader.ok()) {
+      reader->set_status(proto_reader.status());
+    }
+    return document;
+  }
+
+  return DecodeDocumentLazily(reader, std::move(encoded), encoded_document,
+                              has_committed_mutations);
+}
+
 google_firestore_v1_Document LocalSerializer::EncodeDocument(
     const MutableDocument& doc) const {
   google_firestore_v1_Document result{};
@@ -179,6 +232,42 @@ MutableDocument LocalSerializer::DecodeDocument(
   return document;
 }
 
+MutableDocument LocalSerializer::DecodeDocumentLazily(
+    Reader* reader,
+    std::shared_ptr<const std::string> buffer,
+    absl::string_view encoded_document,
+    bool has_committed_mutations) const {
+  // Decode everything but `Document.fields`, which is left to the ObjectValue.
+  ByteString name;
+  google_protobuf_Timestamp update_time{};
+  bool ok = ForEachEncodedField(
+      encoded_document, [&](const EncodedField& field) {
+        if (field.tag == google_firestore_v1_Document_name_tag) {
+          name = ByteString(field.bytes);
+        } else if (field.tag == google_firestore_v1_Document_update_time_tag) {
+          StringReader timestamp_reader{field.bytes};
+          timestamp_reader.Read(google_protobuf_Timestamp_fields, &update_time);
+          reader->set_status(timestamp_reader.status());
+        }
+        return reader->ok();
+      });
+  if (!ok) {
+    reader->Fail("Invalid Document proto");
+  }
+  if (!reader->ok()) return {};
+
+  SnapshotVersion version =
+      rpc_serializer_.DecodeVersion(reader->context(), update_time);
+
+  MutableDocument document = MutableDocument::FoundDocument(
+      rpc_serializer_.DecodeKey(reader->context(), name.get()), version,
+      ObjectValue::FromEncodedDocument(std::move(buffer), encoded_document));
+  if (has_committed_mutations) {
+    document.SetHasCommittedMutations();
+  }
+  return document;
+}
+
 firestore_client_NoDocument LocalSerializer::EncodeNoDocument(
     const MutableDocument& no_doc) const {
   firestore_client_NoDocument result{};
@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_LOCAL_LOCAL_SERIALIZER_H_
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -26,6 +27,7 @@
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/src/util/status_fwd.h"
+#include "absl/strings/string_view.h"
 
 namespace firebase {
 namespace firestore {
@@ -100,6 +102,17 @@ class LocalSerializer {
   model::MutableDocument DecodeMaybeDocument(
       nanopb::Reader* reader, firestore_client_MaybeDocument& proto) const;
 
+  /**
+   * @brief Decodes the encoded bytes of a MaybeDocument proto to the
+   * equivalent model, without decoding the fields of a found document.
+   *
+   * Only the key, version and flags are decoded up front; the returned
+   * document's ObjectValue decodes its fields on first access (see
+   * `ObjectValue::FromEncodedDocument`) and keeps `encoded` alive until then.
+   */
+  model::MutableDocument DecodeMaybeDocumentLazily(
+      nanopb::Reader* reader, std::shared_ptr<const std::string> encoded) const;
+
   /**
    * @brief Encodes a TargetData to the equivalent nanopb proto, representing a
    * ::firestore::proto::Target, for local storage.
@@ -188,6 +201,12 @@ class LocalSerializer {
                                         google_firestore_v1_Document& proto,
                                         bool has_committed_mutations) const;
 
+  model::MutableDocument DecodeDocumentLazily(
+      nanopb::Reader* reader,
+      std::shared_ptr<const std::string> buffer,
+      absl::string_view encoded_document,
+      bool has_committed_mutations) const;
+
   firestore_client_NoDocument EncodeNoDocument(
       const model::MutableDocument& no_doc) const;
 
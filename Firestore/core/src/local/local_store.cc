@@ -22,6 +22,7 @@
 
 #include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/bundle_cache.h"
+#include "Firestore/core/src/local/index_backfiller.h"
 #include "Firestore/core/src/local/local_documents_view.h"
 #include "Firestore/core/src/local/local_view_changes.h"
 #include "Firestore/core/src/local/local_write_result.h"
@@ -467,18 +468,18 @@ void LocalStore::NotifyLocalViewChanges(
 
 absl::optional<MutationBatch> LocalStore::GetNextMutationBatch(
     BatchId batch_id) {
-  return persistence_->Run("NextMutationBatchAfterBatchID", [&] {
+  return persistence_->RunReadOnly("NextMutationBatchAfterBatchID", [&] {
     return mutation_queue_->NextMutationBatchAfterBatchId(batch_id);
   });
 }
 
 const Document LocalStore::ReadDocument(const DocumentKey& key) {
-  return persistence_->Run("ReadDocument",
-                           [&] { return local_documents_->GetDocument(key); });
+  return persistence_->RunReadOnly(
+      "ReadDocument", [&] { return local_documents_->GetDocument(key); });
 }
 
 BatchId LocalStore::GetHighestUnacknowledgedBatchId() {
-  return persistence_->Run("GetHighestUnacknowledgedBatchId", [&] {
+  return persistence_->RunReadOnly("GetHighestUnacknowledgedBatchId", [&] {
     return mutation_queue_->GetHighestUnacknowledgedBatchId();
   });
 }
@@ -534,7 +535,7 @@ void LocalStore::ReleaseTarget(TargetId target_id) {
 
 QueryResult LocalStore::ExecuteQuery(const Query& query,
                                      bool use_previous_results) {
-  return persistence_->Run("ExecuteQuery", [&] {
+  return persistence_->RunReadOnly("ExecuteQuery", [&] {
     absl::optional<TargetData> target_data = GetTargetData(query.ToTarget());
     SnapshotVersion last_limbo_free_snapshot_version;
     DocumentKeySet remote_keys;
@@ -554,20 +555,66 @@ QueryResult LocalStore::ExecuteQuery(const Query& query,
   });
 }
 
+QueryExplanation LocalStore::ExplainQuery(const Query& query,
+                                          bool use_previous_results) {
+  return persistence_->RunReadOnly("ExplainQuery", [&] {
+    absl::optional<TargetData> target_data = GetTargetData(query.ToTarget());
+    if (!target_data || !use_previous_results) {
+      return query_engine_->Explain(query, SnapshotVersion::None(),
+                                    DocumentKeySet{});
+    }
+
+    return query_engine_->Explain(
+        query, target_data->last_limbo_free_snapshot_version(),
+        target_cache_->GetMatchingKeys(target_data->target_id()));
+  });
+}
+
+std::vector<DocumentMap> LocalStore::ExecuteQueries(
+    const std::vector<Query>& queries) {
+  return persistence_->RunReadOnly("ExecuteQueries", [&] {
+    return query_engine_->GetDocumentsMatchingQueries(queries);
+  });
+}
+
 DocumentKeySet LocalStore::GetRemoteDocumentKeys(TargetId target_id) {
-  return persistence_->Run("RemoteDocumentKeysForTarget", [&] {
+  return persistence_->RunReadOnly("RemoteDocumentKeysForTarget", [&] {
     return target_cache_->GetMatchingKeys(target_id);
   });
 }
 
 LruResults LocalStore::CollectGarbage(LruGarbageCollector* garbage_collector) {
-  return persistence_->Run("Collect garbage", [&] {
+  LruResults results = persistence_->Run("Collect garbage", [&] {
     return garbage_collector->Collect(target_data_by_target_);
   });
+
+  // Each batch of orphaned documents is removed in its own transaction, so
+  // that a transaction only holds a bounded number of removals.
+  bool remove_next_batch = garbage_collector->removal_pending();
+  while (remove_next_batch) {
+    remove_next_batch = persistence_->Run("Remove orphaned documents", [&] {
+      return garbage_collector->RemoveNextBatch(&results);
+    });
+  }
+  return results;
+}
+
+IndexBackfillerResults LocalStore::Backfill(IndexBackfiller* index_backfiller) {
+  // The next collection group to update is kept in memory. Without field
+  // indexes there is none, so no transaction (and no sequence number) is
+  // spent on finding that out.
+  if (!index_manager_->GetNextCollectionGroupToUpdate()) {
+    return IndexBackfillerResults::DidNotRun();
+  }
+
+  return persistence_->Run("Backfill indexes", [&] {
+    return index_backfiller->WriteIndexEntries(index_manager_,
+                                               local_documents_.get());
+  });
 }
 
 bool LocalStore::HasNewerBundle(const bundle::BundleMetadata& metadata) {
-  return persistence_->Run("Has newer bundle", [&] {
+  return persistence_->RunReadOnly("Has newer bundle", [&] {
     absl::optional<bundle::BundleMetadata> cached_metadata =
         bundle_cache_->GetBundleMetadata(metadata.bundle_id());
     return cached_metadata.has_value() &&
@@ -575,9 +622,24 @@ bool LocalStore::HasNewerBundle(const bundle::BundleMetadata& metadata) {
   });
 }
 
+absl::optional<bundle::BundleLoadCheckpoint>
+LocalStore::GetBundleLoadCheckpoint(const bundle::BundleMetadata& metadata) {
+  return persistence_->RunReadOnly("Get bundle load checkpoint", [&] {
+    absl::optional<bundle::BundleLoadCheckpoint> checkpoint =
+        bundle_cache_->GetBundleLoadCheckpoint(metadata.bundle_id());
+    if (checkpoint.has_value() && !checkpoint->IsFor(metadata)) {
+      // The checkpoint belongs to an earlier version of the bundle.
+      return absl::optional<bundle::BundleLoadCheckpoint>();
+    }
+    return checkpoint;
+  });
+}
+
 void LocalStore::SaveBundle(const bundle::BundleMetadata& metadata) {
-  return persistence_->Run(
-      "Save bundle", [&] { bundle_cache_->SaveBundleMetadata(metadata); });
+  return persistence_->Run("Save bundle", [&] {
+    bundle_cache_->SaveBundleMetadata(metadata);
+    bundle_cache_->RemoveBundleLoadCheckpoint(metadata.bundle_id());
+  });
 }
 
 DocumentMap LocalStore::ApplyBundledDocuments(
@@ -586,31 +648,56 @@ DocumentMap LocalStore::ApplyBundledDocuments(
   // they will not get garbage collected right away.
   TargetData umbrella_target = AllocateTarget(NewUmbrellaTarget(bundle_id));
   return persistence_->Run("Apply bundle documents", [&] {
-    DocumentKeySet keys;
-    DocumentUpdateMap document_updates;
-    DocumentVersionMap versions;
-
-    for (const auto& kv : bundled_documents) {
-      const DocumentKey& key = kv.first;
-      const auto& doc = kv.second;
-      if (doc.is_found_document()) {
-        keys = keys.insert(key);
-      }
-      document_updates.emplace(key, doc);
-      versions.emplace(key, doc.version());
-    }
-
     target_cache_->RemoveMatchingKeysForTarget(umbrella_target.target_id());
-    target_cache_->AddMatchingKeys(keys, umbrella_target.target_id());
+    return WriteBundledDocuments(bundled_documents,
+                                 umbrella_target.target_id());
+  });
+}
 
-    auto result = PopulateDocumentChanges(document_updates, versions,
-                                          SnapshotVersion::None());
-    return local_documents_->GetLocalViewOfDocuments(
-        std::move(result.changed_docs),
-        std::move(result.existence_changed_keys));
+DocumentMap LocalStore::ApplyBundledDocumentChunk(
+    const MutableDocumentMap& bundled_documents,
+    const bundle::BundleLoadCheckpoint& checkpoint) {
+  TargetData umbrella_target =
+      AllocateTarget(NewUmbrellaTarget(checkpoint.bundle_id()));
+  return persistence_->Run("Apply bundle document chunk", [&] {
+    absl::optional<bundle::BundleLoadCheckpoint> previous_checkpoint =
+        bundle_cache_->GetBundleLoadCheckpoint(checkpoint.bundle_id());
+    if (!previous_checkpoint.has_value() ||
+        previous_checkpoint->create_time() != checkpoint.create_time()) {
+      // This is the first chunk of this bundle version. The keys of earlier
+      // versions no longer need to be retained.
+      target_cache_->RemoveMatchingKeysForTarget(umbrella_target.target_id());
+    }
+    bundle_cache_->SaveBundleLoadCheckpoint(checkpoint);
+    return WriteBundledDocuments(bundled_documents,
+                                 umbrella_target.target_id());
   });
 }
 
+DocumentMap LocalStore::WriteBundledDocuments(
+    const MutableDocumentMap& bundled_documents, TargetId umbrella_target_id) {
+  DocumentKeySet keys;
+  DocumentUpdateMap document_updates;
+  DocumentVersionMap versions;
+
+  for (const auto& kv : bundled_documents) {
+    const DocumentKey& key = kv.first;
+    const auto& doc = kv.second;
+    if (doc.is_found_document()) {
+      keys = keys.insert(key);
+    }
+    document_updates.emplace(key, doc);
+    versions.emplace(key, doc.version());
+  }
+
+  target_cache_->AddMatchingKeys(keys, umbrella_target_id);
+
+  auto result = PopulateDocumentChanges(document_updates, versions,
+                                        SnapshotVersion::None());
+  return local_documents_->GetLocalViewOfDocuments(
+      std::move(result.changed_docs), std::move(result.existence_changed_keys));
+}
+
 void LocalStore::SaveNamedQuery(const bundle::NamedQuery& query,
                                 const model::DocumentKeySet& keys) {
   // Allocate a target for the named query such that it can be resumed from
@@ -640,8 +727,8 @@ void LocalStore::SaveNamedQuery(const bundle::NamedQuery& query,
 
 absl::optional<bundle::NamedQuery> LocalStore::GetNamedQuery(
     const std::string& query) {
-  return persistence_->Run("Get named query",
-                           [&] { return bundle_cache_->GetNamedQuery(query); });
+  return persistence_->RunReadOnly(
+      "Get named query", [&] { return bundle_cache_->GetNamedQuery(query); });
 }
 
 Target LocalStore::NewUmbrellaTarget(const std::string& bundle_id) {
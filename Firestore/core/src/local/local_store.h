@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "Firestore/core/src/bundle/bundle_callback.h"
+#include "Firestore/core/src/bundle/bundle_load_checkpoint.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/core/target_id_generator.h"
@@ -53,6 +54,7 @@ class TargetChange;
 namespace local {
 
 class BundleCache;
+class IndexBackfiller;
 class IndexManager;
 class LocalDocumentsView;
 class LocalViewChanges;
@@ -61,10 +63,12 @@ class LruGarbageCollector;
 class MutationQueue;
 class Persistence;
 class QueryEngine;
+struct QueryExplanation;
 class QueryResult;
 class RemoteDocumentCache;
 class TargetCache;
 
+struct IndexBackfillerResults;
 struct LruResults;
 
 /**
@@ -219,6 +223,21 @@ class LocalStore : public bundle::BundleCallback {
    */
   QueryResult ExecuteQuery(const core::Query& query, bool use_previous_results);
 
+  /**
+   * Runs the specified query like `ExecuteQuery()` and describes the plans the
+   * query engine considered, along with the number of documents it read.
+   */
+  QueryExplanation ExplainQuery(const core::Query& query,
+                                bool use_previous_results);
+
+  /**
+   * Runs the specified queries against the local store in a single transaction
+   * without using results from previous executions, and returns the matching
+   * documents of each query in the order of `queries`.
+   */
+  std::vector<model::DocumentMap> ExecuteQueries(
+      const std::vector<core::Query>& queries);
+
   /**
    * Notify the local store of the changed views to locally pin / unpin
    * documents.
@@ -243,15 +262,35 @@ class LocalStore : public bundle::BundleCallback {
    */
   model::BatchId GetHighestUnacknowledgedBatchId();
 
+  /**
+   * Runs a garbage collection. Orphaned documents are removed in batches, each
+   * in its own transaction, until the collection's time budget is used up.
+   */
   LruResults CollectGarbage(LruGarbageCollector* garbage_collector);
 
+  /**
+   * Writes index entries for a bounded batch of documents that have not been
+   * indexed yet, and advances the index offsets accordingly.
+   */
+  IndexBackfillerResults Backfill(IndexBackfiller* index_backfiller);
+
   /**
    * Returns whether the given bundle has already been loaded and its create
    * time is newer or equal to the currently loading bundle.
    */
   bool HasNewerBundle(const bundle::BundleMetadata& metadata);
 
-  /** Saves the given `BundleMetadata` to local persistence. */
+  /**
+   * Returns the checkpoint of an interrupted chunked load of the given bundle,
+   * or `nullopt` if no load of this bundle version has committed documents.
+   */
+  absl::optional<bundle::BundleLoadCheckpoint> GetBundleLoadCheckpoint(
+      const bundle::BundleMetadata& metadata);
+
+  /**
+   * Saves the given `BundleMetadata` to local persistence and removes the
+   * checkpoint of its chunked load.
+   */
   void SaveBundle(const bundle::BundleMetadata& metadata) override;
 
   /**
@@ -265,6 +304,14 @@ class LocalStore : public bundle::BundleCallback {
       const model::MutableDocumentMap& documents,
       const std::string& bundle_id) override;
 
+  /**
+   * Applies a chunk of the documents from a bundle to the "ground-state"
+   * (remote) documents and saves `checkpoint` in the same transaction.
+   */
+  model::DocumentMap ApplyBundledDocumentChunk(
+      const model::MutableDocumentMap& documents,
+      const bundle::BundleLoadCheckpoint& checkpoint) override;
+
   /** Saves the given `NamedQuery` to local persistence. */
   void SaveNamedQuery(const bundle::NamedQuery& query,
                       const model::DocumentKeySet& keys) override;
@@ -286,6 +333,15 @@ class LocalStore : public bundle::BundleCallback {
 
   void StartMutationQueue();
 
+  /**
+   * Writes `documents` to the remote document cache and adds the keys of the
+   * found documents to the umbrella target of their bundle. Must be called in
+   * a transaction.
+   */
+  model::DocumentMap WriteBundledDocuments(
+      const model::MutableDocumentMap& documents,
+      model::TargetId umbrella_target_id);
+
   void StartIndexManager();
 
   void ApplyBatchResult(const model::MutationBatchResult& batch_result);
@@ -16,15 +16,17 @@
 
 #include "Firestore/core/src/local/lru_garbage_collector.h"
 
+#include <algorithm>
 #include <chrono>  // NOLINT(build/c++11)
-#include <queue>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/include/firebase/firestore/timestamp.h"
 #include "Firestore/core/src/api/settings.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/statusor.h"
 
@@ -49,54 +51,70 @@ static Millis::rep MillisecondsBetween(const Timestamp& start,
 }
 
 /**
- * RollingSequenceNumberBuffer tracks the nth sequence number in a series.
- * Sequence numbers may be added out of order.
+ * RollingSequenceNumberBuffer keeps the lowest `max_elements` sequence numbers
+ * in a series. Sequence numbers may be added out of order.
  */
 class RollingSequenceNumberBuffer {
  public:
   explicit RollingSequenceNumberBuffer(size_t max_elements)
-      : queue_(std::priority_queue<ListenSequenceNumber>()),
-        max_elements_(max_elements) {
+      : max_elements_(max_elements) {
   }
 
   RollingSequenceNumberBuffer(const RollingSequenceNumberBuffer& other) =
       delete;
 
   void AddElement(ListenSequenceNumber sequence_number) {
-    if (queue_.size() < max_elements_) {
-      queue_.push(sequence_number);
-    } else {
-      ListenSequenceNumber highest_value = queue_.top();
-      if (sequence_number < highest_value) {
-        queue_.pop();
-        queue_.push(sequence_number);
-      }
+    if (heap_.size() < max_elements_) {
+      heap_.push_back(sequence_number);
+      std::push_heap(heap_.begin(), heap_.end());
+    } else if (!heap_.empty() && sequence_number < heap_.front()) {
+      // Replaces the highest value that is kept.
+      std::pop_heap(heap_.begin(), heap_.end());
+      heap_.back() = sequence_number;
+      std::push_heap(heap_.begin(), heap_.end());
     }
   }
 
   ListenSequenceNumber max_value() const {
-    return queue_.top();
+    return heap_.front();
+  }
+
+  /**
+   * Returns the nth lowest sequence number in the series, counting from 1.
+   * Only the lowest `max_elements` can be found.
+   */
+  ListenSequenceNumber NthLowestValue(size_t n) const {
+    HARD_ASSERT(n > 0 && n <= heap_.size(),
+                "Sequence number %s of %s is not kept", n, heap_.size());
+    std::vector<ListenSequenceNumber> values = heap_;
+    std::nth_element(values.begin(), values.begin() + (n - 1), values.end());
+    return values[n - 1];
   }
 
   size_t size() const {
-    return queue_.size();
+    return heap_.size();
   }
 
  private:
-  std::priority_queue<ListenSequenceNumber> queue_;
+  // A max-heap, such that the highest value is replaced first.
+  std::vector<ListenSequenceNumber> heap_;
   const size_t max_elements_;
 };
 
+int CountForPercentile(int percentile, size_t total_count) {
+  return static_cast<int>((percentile / 100.0f) * total_count);
+}
+
 }  // namespace
 
 const ListenSequenceNumber kListenSequenceNumberInvalid = -1;
 
 LruParams LruParams::Default() {
-  return LruParams{100 * 1024 * 1024, 10, 1000};
+  return LruParams{100 * 1024 * 1024, 10, 1000, 1000, Millis(100)};
 }
 
 LruParams LruParams::Disabled() {
-  return LruParams{api::Settings::CacheSizeUnlimited, 0, 0};
+  return LruParams{api::Settings::CacheSizeUnlimited, 0, 0, 0, Millis(0)};
 }
 
 LruParams LruParams::WithCacheSize(int64_t cache_size) {
@@ -120,6 +138,21 @@ LruResults LruGarbageCollector::Collect(const LiveQueryMap& live_targets) {
     return LruResults::DidNotRun();
   }
 
+  if (pending_removal_) {
+    LOG_DEBUG("Resuming the removal of orphaned documents at or below %s",
+              pending_removal_->upper_bound);
+    removal_start_ = std::chrono::steady_clock::now();
+    Timestamp start = Timestamp::Now();
+    int num_documents_removed = RemovePendingBatch();
+    return LruResults{/* did_run= */ true,
+                      0,
+                      0,
+                      num_documents_removed,
+                      Millis(0),
+                      Millis(0),
+                      Millis(MillisecondsBetween(start, Timestamp::Now()))};
+  }
+
   StatusOr<int64_t> maybe_current_size = CalculateByteSize();
   if (!maybe_current_size.ok()) {
     LOG_ERROR(
@@ -146,47 +179,80 @@ LruResults LruGarbageCollector::RunGarbageCollection(
     const LiveQueryMap& live_targets) {
   Timestamp start = Timestamp::Now();
 
-  // Cap at the configured max
-  int sequence_numbers = QueryCountForPercentile(params_.percentile_to_collect);
-  if (sequence_numbers > params_.maximum_sequence_numbers_to_collect) {
-    sequence_numbers = params_.maximum_sequence_numbers_to_collect;
-  }
-  Timestamp counted_targets = Timestamp::Now();
-
-  ListenSequenceNumber upper_bound =
-      SequenceNumberForQueryCount(sequence_numbers);
+  int sequence_numbers = 0;
+  ListenSequenceNumber upper_bound = FindUpperBound(&sequence_numbers);
   Timestamp found_upper_bound = Timestamp::Now();
 
   int num_targets_removed = RemoveTargets(upper_bound, live_targets);
   Timestamp removed_targets = Timestamp::Now();
 
-  int num_documents_removed = RemoveOrphanedDocuments(upper_bound);
+  // Only the first batch of orphaned documents is removed here. The remaining
+  // batches are removed by `RemoveNextBatch()`.
+  int num_documents_removed = 0;
+  removal_start_ = std::chrono::steady_clock::now();
+  if (upper_bound != kListenSequenceNumberInvalid) {
+    pending_removal_ = PendingRemoval{upper_bound, DocumentKey()};
+    num_documents_removed = RemovePendingBatch();
+  }
   Timestamp removed_documents = Timestamp::Now();
 
   std::string desc = "LRU Garbage Collection:\n";
-  absl::StrAppend(&desc, "\tCounted targets in ",
-                  MillisecondsBetween(start, counted_targets), "ms\n");
   absl::StrAppend(&desc, "\tDetermined least recently used ", sequence_numbers,
                   " sequence numbers in ",
-                  MillisecondsBetween(counted_targets, found_upper_bound),
-                  "ms\n");
+                  MillisecondsBetween(start, found_upper_bound), "ms\n");
   absl::StrAppend(&desc, "\tRemoved ", num_targets_removed, " targets in ",
                   MillisecondsBetween(found_upper_bound, removed_targets),
                   "ms\n");
-  absl::StrAppend(&desc, "\tRemoved ", num_documents_removed, " documents in ",
+  absl::StrAppend(&desc, "\tRemoved ", num_documents_removed,
+                  " documents in the first batch in ",
                   MillisecondsBetween(removed_targets, removed_documents),
                   "ms\n");
   absl::StrAppend(&desc, "Total duration: ",
                   MillisecondsBetween(start, removed_documents), "ms");
   LOG_DEBUG(desc.c_str());
 
-  return LruResults{/* did_run= */ true, sequence_numbers, num_targets_removed,
-                    num_documents_removed};
+  return LruResults{
+      /* did_run= */ true,
+      sequence_numbers,
+      num_targets_removed,
+      num_documents_removed,
+      Millis(MillisecondsBetween(start, found_upper_bound)),
+      Millis(MillisecondsBetween(found_upper_bound, removed_targets)),
+      Millis(MillisecondsBetween(removed_targets, removed_documents))};
+}
+
+ListenSequenceNumber LruGarbageCollector::FindUpperBound(
+    int* sequence_numbers) {
+  // The upper bound is among the lowest `maximum_sequence_numbers_to_collect`
+  // sequence numbers, so only those need to be kept while counting them all.
+  RollingSequenceNumberBuffer buffer(
+      static_cast<size_t>(params_.maximum_sequence_numbers_to_collect));
+  size_t total_count = 0;
+
+  delegate_->EnumerateTargetSequenceNumbers(
+      [&](ListenSequenceNumber sequence_number) {
+        ++total_count;
+        buffer.AddElement(sequence_number);
+      });
+
+  delegate_->EnumerateOrphanedDocuments(
+      [&](const DocumentKey&, ListenSequenceNumber sequence_number) {
+        ++total_count;
+        buffer.AddElement(sequence_number);
+      });
+
+  // Cap at the configured max
+  *sequence_numbers = std::min(
+      CountForPercentile(params_.percentile_to_collect, total_count),
+      params_.maximum_sequence_numbers_to_collect);
+  if (*sequence_numbers == 0) {
+    return kListenSequenceNumberInvalid;
+  }
+  return buffer.NthLowestValue(static_cast<size_t>(*sequence_numbers));
 }
 
 int LruGarbageCollector::QueryCountForPercentile(int percentile) {
-  size_t total_count = delegate_->GetSequenceNumberCount();
-  return static_cast<int>((percentile / 100.0f) * total_count);
+  return CountForPercentile(percentile, delegate_->GetSequenceNumberCount());
 }
 
 ListenSequenceNumber LruGarbageCollector::SequenceNumberForQueryCount(
@@ -217,7 +283,53 @@ int LruGarbageCollector::RemoveTargets(ListenSequenceNumber sequence_number,
 
 int LruGarbageCollector::RemoveOrphanedDocuments(
     ListenSequenceNumber sequence_number) {
-  return delegate_->RemoveOrphanedDocuments(sequence_number);
+  int max_documents = std::max(params_.documents_per_removal_batch, 1);
+  DocumentKey start_after;
+  int count = 0;
+  int removed = 0;
+  do {
+    removed = delegate_->RemoveOrphanedDocuments(sequence_number,
+                                                 max_documents, &start_after);
+    count += removed;
+  } while (removed == max_documents);
+  return count;
+}
+
+bool LruGarbageCollector::RemoveNextBatch(LruResults* results) {
+  auto within_budget = [&] {
+    return std::chrono::steady_clock::now() - removal_start_ <
+           params_.removal_time_budget;
+  };
+  if (!pending_removal_ || !within_budget()) {
+    return false;
+  }
+
+  Timestamp start = Timestamp::Now();
+  results->documents_removed += RemovePendingBatch();
+  results->remove_documents_duration +=
+      Millis(MillisecondsBetween(start, Timestamp::Now()));
+
+  if (pending_removal_ && !within_budget()) {
+    LOG_DEBUG(
+        "Garbage collection used up its time budget after removing %s "
+        "documents; the next collection resumes the removal",
+        results->documents_removed);
+    return false;
+  }
+  return pending_removal_.has_value();
+}
+
+int LruGarbageCollector::RemovePendingBatch() {
+  HARD_ASSERT(pending_removal_.has_value(), "No removal is pending");
+  int max_documents = std::max(params_.documents_per_removal_batch, 1);
+  int removed = delegate_->RemoveOrphanedDocuments(
+      pending_removal_->upper_bound, max_documents,
+      &pending_removal_->start_after);
+  if (removed < max_documents) {
+    // All documents have been visited.
+    pending_removal_ = absl::nullopt;
+  }
+  return removed;
 }
 
 }  // namespace local
@@ -17,13 +17,16 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LRU_GARBAGE_COLLECTOR_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LRU_GARBAGE_COLLECTOR_H_
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <unordered_map>
 
 #include "Firestore/core/src/local/reference_delegate.h"
 #include "Firestore/core/src/local/target_cache.h"
 #include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/util/status_fwd.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -45,17 +48,45 @@ struct LruParams {
   int64_t min_bytes_threshold;
   int percentile_to_collect;
   int maximum_sequence_numbers_to_collect;
+
+  /**
+   * The maximum number of orphaned documents removed by a single batch, each
+   * of which is run in its own transaction.
+   */
+  int documents_per_removal_batch;
+
+  /**
+   * The time after which a collection stops removing batches of orphaned
+   * documents. The next collection resumes the removal where it stopped.
+   */
+  std::chrono::milliseconds removal_time_budget;
 };
 
 struct LruResults {
   static LruResults DidNotRun() {
-    return LruResults{/* did_run= */ false, 0, 0, 0};
+    return LruResults{/* did_run= */ false,
+                      0,
+                      0,
+                      0,
+                      std::chrono::milliseconds(0),
+                      std::chrono::milliseconds(0),
+                      std::chrono::milliseconds(0)};
   }
 
   bool did_run;
   int sequence_numbers_collected;
   int targets_removed;
   int documents_removed;
+
+  /**
+   * The time spent counting the cached sequence numbers and finding the upper
+   * bound of those to collect, which takes a single pass over them.
+   */
+  std::chrono::milliseconds find_upper_bound_duration;
+  std::chrono::milliseconds remove_targets_duration;
+
+  /** The time spent removing all batches of orphaned documents. */
+  std::chrono::milliseconds remove_documents_duration;
 };
 
 using LiveQueryMap = std::unordered_map<model::TargetId, TargetData>;
@@ -91,12 +122,18 @@ class LruDelegate : public ReferenceDelegate {
       const OrphanedDocumentCallback& callback) = 0;
 
   /**
-   * Removes all unreferenced documents from the cache that have a sequence
-   * number less than or equal to the given sequence number. Returns the number
-   * of documents removed.
+   * Removes unreferenced documents from the cache that have a sequence number
+   * less than or equal to `upper_bound`, visiting the documents that sort after
+   * `*start_after` in key order. Stops once `max_documents` documents have been
+   * removed and sets `*start_after` to the last document removed, so that a
+   * later call resumes after it.
+   *
+   * Returns the number of documents removed, which is less than
+   * `max_documents` once all documents have been visited.
    */
-  virtual int RemoveOrphanedDocuments(
-      model::ListenSequenceNumber sequence_number) = 0;
+  virtual int RemoveOrphanedDocuments(model::ListenSequenceNumber upper_bound,
+                                      int max_documents,
+                                      model::DocumentKey* start_after) = 0;
 
   /**
    * Removes all targets that are not currently being listened to and have a
@@ -145,15 +182,67 @@ class LruGarbageCollector {
    */
   int RemoveOrphanedDocuments(model::ListenSequenceNumber sequence_number);
 
+  /**
+   * Starts a garbage collection: finds the upper bound of the sequence numbers
+   * to collect, removes the targets at or below it and removes the first batch
+   * of orphaned documents. The remaining batches are removed by
+   * `RemoveNextBatch()`.
+   *
+   * If the documents of an earlier collection have not all been removed, that
+   * removal is resumed instead, with the same upper bound.
+   */
   local::LruResults Collect(const LiveQueryMap& live_targets);
 
+  /**
+   * Removes the next batch of orphaned documents of the current collection
+   * and adds it to `results`. Each batch should be run in its own transaction.
+   *
+   * Returns whether another batch should be removed, which is not the case
+   * once all documents have been removed or the collection has used up
+   * `removal_time_budget`.
+   */
+  bool RemoveNextBatch(LruResults* results);
+
+  /**
+   * Returns whether the orphaned documents of a collection have not all been
+   * removed yet.
+   */
+  bool removal_pending() const {
+    return pending_removal_.has_value();
+  }
+
  private:
+  /** The progress of removing the orphaned documents of a collection. */
+  struct PendingRemoval {
+    model::ListenSequenceNumber upper_bound;
+    model::DocumentKey start_after;
+  };
+
   LruResults RunGarbageCollection(const LiveQueryMap& live_targets);
 
+  /** Removes the next batch of the pending removal, returning its size. */
+  int RemovePendingBatch();
+
+  /**
+   * Finds the sequence number at or below which the configured percentile of
+   * the cached targets and orphaned documents fall, capped at
+   * `maximum_sequence_numbers_to_collect`. Counting and selection share a
+   * single pass over the sequence numbers.
+   *
+   * @param sequence_numbers Receives the number of sequence numbers below the
+   *     returned upper bound.
+   */
+  model::ListenSequenceNumber FindUpperBound(int* sequence_numbers);
+
   // Delegate owns the LruGarbageCollector; this is a back pointer.
   LruDelegate* delegate_;
 
   LruParams params_ = LruParams::Default();
+
+  absl::optional<PendingRemoval> pending_removal_;
+
+  /** When the current collection started removing orphaned documents. */
+  std::chrono::steady_clock::time_point removal_start_;
 };
 
 }  // namespace local
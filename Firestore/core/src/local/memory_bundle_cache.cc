@@ -22,6 +22,7 @@ namespace firebase {
 namespace firestore {
 namespace local {
 
+using bundle::BundleLoadCheckpoint;
 using bundle::BundleMetadata;
 using bundle::NamedQuery;
 
@@ -51,6 +52,25 @@ void MemoryBundleCache::SaveNamedQuery(const NamedQuery& query) {
   named_queries_[query.query_name()] = query;
 }
 
+absl::optional<BundleLoadCheckpoint> MemoryBundleCache::GetBundleLoadCheckpoint(
+    const std::string& bundle_id) const {
+  auto got = checkpoints_.find(bundle_id);
+  if (got == checkpoints_.end()) {
+    return absl::nullopt;
+  }
+  return absl::make_optional(got->second);
+}
+
+void MemoryBundleCache::SaveBundleLoadCheckpoint(
+    const BundleLoadCheckpoint& checkpoint) {
+  checkpoints_[checkpoint.bundle_id()] = checkpoint;
+}
+
+void MemoryBundleCache::RemoveBundleLoadCheckpoint(
+    const std::string& bundle_id) {
+  checkpoints_.erase(bundle_id);
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
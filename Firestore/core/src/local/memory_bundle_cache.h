@@ -20,6 +20,7 @@
 #include <string>
 #include <unordered_map>
 
+#include "Firestore/core/src/bundle/bundle_load_checkpoint.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/local/bundle_cache.h"
@@ -41,9 +42,18 @@ class MemoryBundleCache : public BundleCache {
 
   void SaveNamedQuery(const bundle::NamedQuery& query) override;
 
+  absl::optional<bundle::BundleLoadCheckpoint> GetBundleLoadCheckpoint(
+      const std::string& bundle_id) const override;
+
+  void SaveBundleLoadCheckpoint(
+      const bundle::BundleLoadCheckpoint& checkpoint) override;
+
+  void RemoveBundleLoadCheckpoint(const std::string& bundle_id) override;
+
  private:
   std::unordered_map<std::string, bundle::BundleMetadata> bundles_;
   std::unordered_map<std::string, bundle::NamedQuery> named_queries_;
+  std::unordered_map<std::string, bundle::BundleLoadCheckpoint> checkpoints_;
 };
 
 }  // namespace local
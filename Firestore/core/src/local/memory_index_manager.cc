@@ -116,6 +116,13 @@ MemoryIndexManager::GetDocumentsMatchingTarget(const core::Target& target) {
   return {};
 }
 
+absl::optional<size_t> MemoryIndexManager::EstimateDocumentsMatchingTarget(
+    const core::Target& target, size_t max_count) {
+  (void)target;
+  (void)max_count;
+  return absl::nullopt;
+}
+
 absl::optional<std::string>
 MemoryIndexManager::GetNextCollectionGroupToUpdate() {
   return absl::nullopt;
@@ -79,6 +79,9 @@ class MemoryIndexManager : public IndexManager {
   absl::optional<std::vector<model::DocumentKey>> GetDocumentsMatchingTarget(
       const core::Target& target) override;
 
+  absl::optional<size_t> EstimateDocumentsMatchingTarget(
+      const core::Target& target, size_t max_count) override;
+
   absl::optional<std::string> GetNextCollectionGroupToUpdate() override;
 
   void UpdateCollectionGroup(const std::string& collection_group,
@@ -121,13 +121,18 @@ int MemoryLruReferenceDelegate::RemoveTargets(
 }
 
 int MemoryLruReferenceDelegate::RemoveOrphanedDocuments(
-    model::ListenSequenceNumber upper_bound) {
+    model::ListenSequenceNumber upper_bound,
+    int max_documents,
+    DocumentKey* start_after) {
   std::vector<DocumentKey> removed =
       persistence_->remote_document_cache()->RemoveOrphanedDocuments(
-          this, upper_bound);
+          this, upper_bound, *start_after, static_cast<size_t>(max_documents));
   for (const auto& key : removed) {
     sequence_numbers_.erase(key);
   }
+  if (!removed.empty()) {
+    *start_after = removed.back();
+  }
   return static_cast<int>(removed.size());
 }
 
@@ -73,7 +73,9 @@ class MemoryLruReferenceDelegate : public LruDelegate {
   void EnumerateOrphanedDocuments(
       const OrphanedDocumentCallback& callback) override;
 
-  int RemoveOrphanedDocuments(model::ListenSequenceNumber upper_bound) override;
+  int RemoveOrphanedDocuments(model::ListenSequenceNumber upper_bound,
+                              int max_documents,
+                              model::DocumentKey* start_after) override;
   int RemoveTargets(model::ListenSequenceNumber sequence_number,
                     const LiveQueryMap& live_queries) override;
 
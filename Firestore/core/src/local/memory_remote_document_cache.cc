@@ -16,11 +16,15 @@
 
 #include "Firestore/core/src/local/memory_remote_document_cache.h"
 
+#include <algorithm>
+
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/memory_lru_reference_delegate.h"
 #include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/local/sizer.h"
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/overlay.h"
 #include "Firestore/core/src/util/hard_assert.h"
 
 namespace firebase {
@@ -74,13 +78,40 @@ MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
   return results;
 }
 
-// This method should only be called from the IndexBackfiller if LevelDB is
-// enabled.
-MutableDocumentMap MemoryRemoteDocumentCache::GetAll(const std::string&,
-                                                     const model::IndexOffset&,
-                                                     size_t) const {
-  util::ThrowInvalidArgument(
-      "getAll(String, IndexOffset, int) is not supported.");
+MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
+    const std::string& collection_group,
+    const model::IndexOffset& offset,
+    size_t limit) const {
+  std::vector<MutableDocument> documents;
+  for (const auto& kv : docs_) {
+    const MutableDocument& document = kv.second;
+    if (!kv.first.HasCollectionGroup(collection_group)) {
+      continue;
+    }
+    if (model::IndexOffset::FromDocument(document).CompareTo(offset) !=
+        util::ComparisonResult::Descending) {
+      // The document sorts before the offset.
+      continue;
+    }
+    documents.push_back(document);
+  }
+
+  // Keep the `limit` documents that come first in (read time, key) order.
+  size_t count = std::min(limit, documents.size());
+  std::partial_sort(documents.begin(), documents.begin() + count,
+                    documents.end(),
+                    [](const MutableDocument& lhs, const MutableDocument& rhs) {
+                      return model::IndexOffset::DocumentCompare(lhs, rhs) ==
+                             util::ComparisonResult::Ascending;
+                    });
+
+  MutableDocumentMap results;
+  for (size_t i = 0; i < count; ++i) {
+    // Note: We create an explicit copy to prevent modifications on the backing
+    // data.
+    results = results.insert(documents[i].key(), documents[i].Clone());
+  }
+  return results;
 }
 
 MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
@@ -115,13 +146,44 @@ MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
   return results;
 }
 
+MutableDocumentMap MemoryRemoteDocumentCache::GetDocumentsMatchingQuery(
+    const Query& query,
+    const model::IndexOffset& offset,
+    const model::OverlayByDocumentKeyMap& mutated_docs,
+    QueryContext* context) {
+  HARD_ASSERT(!query.IsCollectionGroupQuery() && !query.IsDocumentQuery(),
+              "GetDocumentsMatchingQuery() only supports collection queries");
+
+  MutableDocumentMap documents = GetAll(query.path(), offset);
+  if (context) {
+    context->IncrementDocumentsRead(documents.size());
+  }
+
+  MutableDocumentMap results;
+  for (const auto& kv : documents) {
+    const MutableDocument& document = kv.second;
+    if (document.is_found_document() &&
+        (mutated_docs.find(kv.first) != mutated_docs.end() ||
+         query.Matches(document))) {
+      results = results.insert(kv.first, document);
+    }
+  }
+  return results;
+}
+
 std::vector<DocumentKey> MemoryRemoteDocumentCache::RemoveOrphanedDocuments(
     MemoryLruReferenceDelegate* reference_delegate,
-    ListenSequenceNumber upper_bound) {
+    ListenSequenceNumber upper_bound,
+    const DocumentKey& start_after,
+    size_t max_documents) {
   std::vector<DocumentKey> removed;
   auto updated_docs = docs_;
-  for (const auto& kv : docs_) {
-    const DocumentKey& key = kv.first;
+  for (auto it = docs_.lower_bound(start_after);
+       removed.size() < max_documents && it != docs_.end(); ++it) {
+    const DocumentKey& key = it->first;
+    if (key == start_after) {
+      continue;
+    }
     if (!reference_delegate->IsPinnedAtSequenceNumber(upper_bound, key)) {
       updated_docs = updated_docs.erase(key);
       removed.push_back(key);
@@ -140,6 +202,46 @@ int64_t MemoryRemoteDocumentCache::CalculateByteSize(const Sizer& sizer) {
   return count;
 }
 
+size_t MemoryRemoteDocumentCache::EstimateCollectionSize(
+    const model::ResourcePath& path, size_t max_count) const {
+  size_t count = 0;
+  DocumentKey prefix{path.Append("")};
+  size_t immediate_children_path_length = path.size() + 1;
+  for (auto it = docs_.lower_bound(prefix);
+       count < max_count && it != docs_.end(); ++it) {
+    const DocumentKey& key = it->first;
+    if (!path.IsPrefixOf(key.path())) {
+      break;
+    }
+    if (key.path().size() == immediate_children_path_length) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+size_t MemoryRemoteDocumentCache::EstimateChangedDocuments(
+    const model::ResourcePath& path,
+    const model::IndexOffset& offset,
+    size_t max_count) const {
+  size_t count = 0;
+  DocumentKey prefix{path.Append("")};
+  size_t immediate_children_path_length = path.size() + 1;
+  for (auto it = docs_.lower_bound(prefix);
+       count < max_count && it != docs_.end(); ++it) {
+    const DocumentKey& key = it->first;
+    if (!path.IsPrefixOf(key.path())) {
+      break;
+    }
+    if (key.path().size() == immediate_children_path_length &&
+        model::IndexOffset::FromDocument(it->second).CompareTo(offset) ==
+            util::ComparisonResult::Descending) {
+      ++count;
+    }
+  }
+  return count;
+}
+
 void MemoryRemoteDocumentCache::SetIndexManager(IndexManager* manager) {
   index_manager_ = NOT_NULL(manager);
 }
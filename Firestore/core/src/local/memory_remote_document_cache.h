@@ -47,16 +47,34 @@ class MemoryRemoteDocumentCache : public RemoteDocumentCache {
 
   model::MutableDocument Get(const model::DocumentKey& key) override;
   model::MutableDocumentMap GetAll(const model::DocumentKeySet& keys) override;
-  model::MutableDocumentMap GetAll(const std::string&,
-                                   const model::IndexOffset&,
-                                   size_t) const override;
+  model::MutableDocumentMap GetAll(const std::string& collection_group,
+                                   const model::IndexOffset& offset,
+                                   size_t limit) const override;
   model::MutableDocumentMap GetAll(const model::ResourcePath& path,
                                    const model::IndexOffset& offset) override;
+  model::MutableDocumentMap GetDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      const model::OverlayByDocumentKeyMap& mutated_docs,
+      QueryContext* context) override;
+  size_t EstimateCollectionSize(const model::ResourcePath& path,
+                                size_t max_count) const override;
+  size_t EstimateChangedDocuments(const model::ResourcePath& path,
+                                  const model::IndexOffset& offset,
+                                  size_t max_count) const override;
+
   void SetIndexManager(IndexManager* manager) override;
 
+  /**
+   * Removes the documents that sort after `start_after` and are not pinned at
+   * `upper_bound`, in key order, stopping after `max_documents` documents.
+   * Returns the keys of the removed documents.
+   */
   std::vector<model::DocumentKey> RemoveOrphanedDocuments(
       MemoryLruReferenceDelegate* reference_delegate,
-      model::ListenSequenceNumber upper_bound);
+      model::ListenSequenceNumber upper_bound,
+      const model::DocumentKey& start_after,
+      size_t max_documents);
 
   int64_t CalculateByteSize(const Sizer& sizer);
 
@@ -190,9 +190,30 @@ class Persistence {
     return result;
   }
 
+  /**
+   * Like `Run`, but for a block that only reads. Implementations may run the
+   * block against a consistent snapshot without tracking changes, in which
+   * case the block must not write or use the reference delegate.
+   */
+  template <typename F>
+  auto RunReadOnly(absl::string_view label, F block) ->
+      typename std::enable_if<!std::is_same<void, decltype(block())>::value,
+                              decltype(block())>::type {
+    decltype(block()) result;
+
+    RunReadOnlyInternal(label, [&]() mutable { result = block(); });
+
+    return result;
+  }
+
  private:
   virtual void RunInternal(absl::string_view label,
                            std::function<void()> block) = 0;
+
+  virtual void RunReadOnlyInternal(absl::string_view label,
+                                   std::function<void()> block) {
+    RunInternal(label, std::move(block));
+  }
 };
 
 }  // namespace local
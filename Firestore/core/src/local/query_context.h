@@ -0,0 +1,53 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_QUERY_CONTEXT_H_
+#define FIRESTORE_CORE_SRC_LOCAL_QUERY_CONTEXT_H_
+
+#include <cstddef>
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+/**
+ * Collects statistics about the execution of a query as it is passed down to
+ * the caches that read documents.
+ */
+class QueryContext {
+ public:
+  /**
+   * Returns the number of documents read from the remote document cache,
+   * including documents that were discarded because they don't match the
+   * query.
+   */
+  size_t documents_read() const {
+    return documents_read_;
+  }
+
+  void IncrementDocumentsRead(size_t count) {
+    documents_read_ += count;
+  }
+
+ private:
+  size_t documents_read_ = 0;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_QUERY_CONTEXT_H_
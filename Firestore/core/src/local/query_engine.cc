@@ -16,6 +16,10 @@
 
 #include "Firestore/core/src/local/query_engine.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -25,8 +29,11 @@
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_set.h"
 #include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/snapshot_version.h"
+#include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/string_format.h"
 
 namespace firebase {
 namespace firestore {
@@ -40,36 +47,435 @@ using model::DocumentMap;
 using model::DocumentSet;
 using model::MutableDocument;
 using model::SnapshotVersion;
+using util::ComparisonResult;
+using util::StringFormat;
+
+namespace {
+
+/**
+ * The number of targets whose scan-based estimates are cached. The cache is
+ * cleared once it is full, which only costs a re-estimate per target.
+ */
+const size_t kMaxCachedScanEstimates = 100;
+
+/**
+ * Selects the documents that fall within the limit of a query without sorting
+ * all candidates.
+ *
+ * The candidates are kept in a heap of at most `limit` documents whose top is
+ * the document that sorts last within the limit, which is the one evicted when
+ * a better candidate is added. Adding n documents takes O(n log limit) time
+ * and O(limit) memory.
+ */
+class LimitedDocuments {
+ public:
+  explicit LimitedDocuments(const Query& query)
+      : comparator_(query.Comparator()),
+        limit_(static_cast<size_t>(query.limit())),
+        keep_first_(query.limit_type() == LimitType::First) {
+  }
+
+  void Add(const Document& document) {
+    auto heap_order = [this](const Document& lhs, const Document& rhs) {
+      return Precedes(lhs, rhs);
+    };
+
+    if (heap_.size() < limit_) {
+      heap_.push_back(document);
+      std::push_heap(heap_.begin(), heap_.end(), heap_order);
+    } else if (limit_ > 0 && Precedes(document, heap_.front())) {
+      std::pop_heap(heap_.begin(), heap_.end(), heap_order);
+      heap_.back() = document;
+      std::push_heap(heap_.begin(), heap_.end(), heap_order);
+    }
+  }
+
+  /** Returns the documents within the limit, in no particular order. */
+  std::vector<Document> Release() {
+    return std::move(heap_);
+  }
+
+ private:
+  /** Returns true if `lhs` is a better candidate for the limit than `rhs`. */
+  bool Precedes(const Document& lhs, const Document& rhs) const {
+    ComparisonResult result = comparator_.Compare(lhs, rhs);
+    return keep_first_ ? result == ComparisonResult::Ascending
+                       : result == ComparisonResult::Descending;
+  }
+
+  model::DocumentComparator comparator_;
+  size_t limit_;
+  bool keep_first_;
+  std::vector<Document> heap_;
+};
+
+/**
+ * Returns the documents that fall within the limit of `query`. All documents
+ * must match the query.
+ */
+DocumentMap ApplyLimit(const Query& query, const DocumentMap& documents) {
+  if (!query.has_limit() ||
+      documents.size() <= static_cast<size_t>(query.limit())) {
+    return documents;
+  }
+
+  LimitedDocuments limited(query);
+  for (const auto& entry : documents) {
+    limited.Add(entry.second);
+  }
+
+  DocumentMap result;
+  for (Document& document : limited.Release()) {
+    result = result.insert(document->key(), std::move(document));
+  }
+  return result;
+}
+
+}  // namespace
+
+std::string QueryPlan::ToString() const {
+  const char* name = "";
+  switch (strategy) {
+    case Strategy::Index:
+      name = "Index";
+      break;
+    case Strategy::RemoteKeys:
+      name = "RemoteKeys";
+      break;
+    case Strategy::FullCollectionScan:
+      name = "FullCollectionScan";
+      break;
+  }
+  return StringFormat("%s(estimated_documents=%s)", name, estimated_documents);
+}
+
+std::string QueryExplanation::ToString() const {
+  std::string candidates;
+  for (const QueryPlan& plan : candidate_plans) {
+    if (!candidates.empty()) {
+      candidates += ", ";
+    }
+    candidates += plan.ToString();
+  }
+  return StringFormat(
+      "QueryExplanation(chosen_plan=%s, candidate_plans=[%s], "
+      "overlay_count=%s, documents_read=%s, documents_returned=%s)",
+      chosen_plan.ToString(), candidates, overlay_count, documents_read,
+      documents_returned);
+}
+
+constexpr size_t QueryEngine::kMaxScanEstimateReuses;
 
 void QueryEngine::Initialize(LocalDocumentsView* local_documents) {
   local_documents_view_ = local_documents;
   index_manager_ = local_documents->index_manager();
+  scan_estimates_.clear();
 }
 
 const DocumentMap QueryEngine::GetDocumentsMatchingQuery(
     const Query& query,
     const SnapshotVersion& last_limbo_free_snapshot_version,
-    const DocumentKeySet& remote_keys) const {
+    const DocumentKeySet& remote_keys) {
+  return ExecuteQuery(query, last_limbo_free_snapshot_version, remote_keys,
+                      /* explanation= */ nullptr);
+}
+
+std::vector<DocumentMap> QueryEngine::GetDocumentsMatchingQueries(
+    const std::vector<Query>& queries) {
   HARD_ASSERT(local_documents_view_ && index_manager_,
               "Initialize() not called");
 
-  const absl::optional<DocumentMap> index_result =
-      PerformQueryUsingIndex(query);
-  if (index_result.has_value()) {
-    return index_result.value();
+  std::vector<DocumentMap> results(queries.size());
+
+  // Without previous results, a collection query that cannot use an index is
+  // always executed as a full collection scan. Group these by collection.
+  std::map<model::ResourcePath, std::vector<size_t>> scans;
+  for (size_t i = 0; i < queries.size(); ++i) {
+    const Query& query = queries[i];
+    if (query.IsDocumentQuery() || query.IsCollectionGroupQuery() ||
+        (!query.MatchesAllDocuments() &&
+         index_manager_->GetIndexType(query.ToTarget()) !=
+             IndexManager::IndexType::NONE)) {
+      results[i] =
+          GetDocumentsMatchingQuery(query, SnapshotVersion::None(), {});
+    } else {
+      scans[query.path()].push_back(i);
+    }
   }
 
-  const absl::optional<DocumentMap> key_result = PerformQueryUsingRemoteKeys(
-      query, remote_keys, last_limbo_free_snapshot_version);
-  if (key_result.has_value()) {
-    return key_result.value();
+  for (const auto& scan : scans) {
+    const std::vector<size_t>& indexes = scan.second;
+    if (indexes.size() == 1) {
+      results[indexes.front()] =
+          ExecuteFullCollectionScan(queries[indexes.front()]);
+      continue;
+    }
+
+    LOG_DEBUG("Using a shared collection scan to execute %s queries on %s",
+              indexes.size(), scan.first.CanonicalString());
+    DocumentMap documents = local_documents_view_->GetDocumentsMatchingQuery(
+        Query(scan.first), model::IndexOffset::None(),
+        /* context= */ nullptr);
+    for (size_t i : indexes) {
+      const Query& query = queries[i];
+      DocumentMap matching;
+      for (const auto& entry : documents) {
+        if (query.Matches(entry.second)) {
+          matching = matching.insert(entry.first, entry.second);
+        }
+      }
+      results[i] = ApplyLimit(query, matching);
+    }
   }
 
-  return ExecuteFullCollectionScan(query);
+  return results;
+}
+
+QueryExplanation QueryEngine::Explain(
+    const Query& query,
+    const SnapshotVersion& last_limbo_free_snapshot_version,
+    const DocumentKeySet& remote_keys) {
+  QueryExplanation explanation;
+  ExecuteQuery(query, last_limbo_free_snapshot_version, remote_keys,
+               &explanation);
+  return explanation;
+}
+
+const DocumentMap QueryEngine::ExecuteQuery(
+    const Query& query,
+    const SnapshotVersion& last_limbo_free_snapshot_version,
+    const DocumentKeySet& remote_keys,
+    QueryExplanation* explanation) {
+  HARD_ASSERT(local_documents_view_ && index_manager_,
+              "Initialize() not called");
+
+  // All plans read the documents with local mutations, so their overlays do
+  // not change which plan is the cheapest. They are only counted to explain
+  // the estimates.
+  size_t overlay_count = explanation ? CountOverlays(query) : 0;
+  std::vector<QueryPlan> plans =
+      PlanQuery(query, last_limbo_free_snapshot_version, remote_keys,
+                overlay_count, /* explain= */ explanation != nullptr);
+
+  context_ = QueryContext();
+  for (const QueryPlan& plan : plans) {
+    absl::optional<DocumentMap> result;
+    switch (plan.strategy) {
+      case QueryPlan::Strategy::Index:
+        result = PerformQueryUsingIndex(query);
+        break;
+      case QueryPlan::Strategy::RemoteKeys:
+        result = PerformQueryUsingRemoteKeys(query, remote_keys,
+                                             last_limbo_free_snapshot_version);
+        break;
+      case QueryPlan::Strategy::FullCollectionScan:
+        result = ExecuteFullCollectionScan(query);
+        break;
+    }
+
+    if (result.has_value()) {
+      if (explanation) {
+        explanation->chosen_plan = plan;
+        explanation->candidate_plans = plans;
+        explanation->overlay_count = overlay_count;
+        explanation->documents_read = context_.documents_read();
+        explanation->documents_returned = result->size();
+      }
+      return *std::move(result);
+    }
+  }
+
+  HARD_FAIL("A full collection scan must always produce results");
+}
+
+std::vector<QueryPlan> QueryEngine::PlanQuery(
+    const Query& query,
+    const SnapshotVersion& last_limbo_free_snapshot_version,
+    const DocumentKeySet& remote_keys,
+    size_t overlay_count,
+    bool explain) {
+  // Queries that match all documents don't benefit from using indexes or
+  // key-based lookups. Queries that have never seen a snapshot without limbo
+  // documents cannot re-use their previous results.
+  bool can_use_filters = !query.MatchesAllDocuments();
+  bool can_use_remote_keys =
+      can_use_filters &&
+      last_limbo_free_snapshot_version != SnapshotVersion::None();
+  const core::Target& target = query.ToTarget();
+  IndexManager::IndexType index_type =
+      can_use_filters ? index_manager_->GetIndexType(target)
+                      : IndexManager::IndexType::NONE;
+
+  if (!can_use_remote_keys && index_type == IndexManager::IndexType::NONE &&
+      !explain) {
+    // A full collection scan is the only plan, so there is no need to estimate
+    // its cost.
+    return {{QueryPlan::Strategy::FullCollectionScan, overlay_count}};
+  }
+
+  // Partial indexes are scanned without the query's limit (see
+  // `PerformQueryUsingIndex()`).
+  const Query index_query =
+      index_type == IndexManager::IndexType::PARTIAL
+          ? query.WithLimitToFirst(core::Target::kNoLimit)
+          : query;
+  const core::Target& index_target = index_query.ToTarget();
+  model::IndexOffset index_offset =
+      index_type == IndexManager::IndexType::NONE
+          ? model::IndexOffset::None()
+          : index_manager_->GetMinOffset(index_target);
+
+  // Estimating the plans scans index entries and read times, and the memory
+  // cache even counts the collection's size by walking its documents. Outside
+  // of `Explain()`, the estimates of a target are re-used while its indexes
+  // don't change, since stale estimates can only make the engine pick a slower
+  // plan. Every `kMaxScanEstimateReuses` executions, the collection's size is
+  // read again and the target is re-estimated if it changed by more than a
+  // factor of two.
+  absl::optional<size_t> collection_documents;
+  auto cached = scan_estimates_.find(target);
+  bool reuse_estimates =
+      !explain && cached != scan_estimates_.end() &&
+      cached->second.index_type == index_type &&
+      cached->second.index_offset.CompareTo(index_offset) ==
+          ComparisonResult::Same &&
+      cached->second.counted_changed_documents == can_use_remote_keys;
+  if (reuse_estimates && cached->second.reuses >= kMaxScanEstimateReuses) {
+    collection_documents =
+        EstimateDocuments(query, model::IndexOffset::None(),
+                          std::numeric_limits<size_t>::max());
+    size_t estimated_documents = cached->second.collection_documents;
+    reuse_estimates = *collection_documents <= 2 * estimated_documents &&
+                      estimated_documents <= 2 * *collection_documents;
+    cached->second.reuses = 0;
+  }
+
+  ScanEstimates estimates;
+  if (reuse_estimates) {
+    ++cached->second.reuses;
+    estimates = cached->second;
+  } else {
+    if (!collection_documents) {
+      collection_documents =
+          EstimateDocuments(query, model::IndexOffset::None(),
+                            std::numeric_limits<size_t>::max());
+    }
+    estimates.collection_documents = *collection_documents;
+    estimates.index_type = index_type;
+    estimates.index_offset = index_offset;
+    estimates.counted_changed_documents = can_use_remote_keys;
+
+    // A plan that reads more documents than the cheapest plan found so far is
+    // never chosen, so its estimate can stop counting just past that plan's
+    // cost. `counted` documents of the plan have already been estimated.
+    size_t max_documents = estimates.collection_documents;
+    auto count_limit = [&](size_t counted) -> size_t {
+      return counted > max_documents ? 0 : max_documents + 1 - counted;
+    };
+
+    // Both the index and the previous results are completed with the
+    // documents that changed since they were last updated (see
+    // `AppendRemainingResults()`).
+    if (can_use_remote_keys) {
+      estimates.changed_documents = EstimateDocuments(
+          query,
+          model::IndexOffset::CreateSuccessor(last_limbo_free_snapshot_version),
+          count_limit(remote_keys.size()));
+      max_documents = std::min(
+          max_documents, remote_keys.size() + estimates.changed_documents);
+    }
+
+    if (index_type != IndexManager::IndexType::NONE) {
+      absl::optional<size_t> index_documents =
+          index_manager_->EstimateDocumentsMatchingTarget(index_target,
+                                                          count_limit(0));
+      HARD_ASSERT(
+          index_documents.has_value(),
+          "index manager must return estimates for partial and full indexes.");
+      estimates.index_documents =
+          *index_documents + EstimateDocuments(query, index_offset,
+                                               count_limit(*index_documents));
+    }
+
+    if (scan_estimates_.size() >= kMaxCachedScanEstimates) {
+      scan_estimates_.clear();
+    }
+    scan_estimates_[target] = estimates;
+  }
+
+  // The index is preferred over the previous results, and both are preferred
+  // over a full collection scan, if their estimates are the same.
+  std::vector<QueryPlan> plans;
+  if (index_type != IndexManager::IndexType::NONE) {
+    plans.push_back({QueryPlan::Strategy::Index,
+                     estimates.index_documents + overlay_count});
+  }
+  if (can_use_remote_keys) {
+    plans.push_back(
+        {QueryPlan::Strategy::RemoteKeys,
+         remote_keys.size() + estimates.changed_documents + overlay_count});
+  }
+  plans.push_back({QueryPlan::Strategy::FullCollectionScan,
+                   estimates.collection_documents + overlay_count});
+
+  // Plans with the same estimate keep their order of preference.
+  std::stable_sort(plans.begin(), plans.end(),
+                   [](const QueryPlan& lhs, const QueryPlan& rhs) {
+                     return lhs.estimated_documents < rhs.estimated_documents;
+                   });
+  return plans;
+}
+
+size_t QueryEngine::EstimateDocuments(const Query& query,
+                                      const model::IndexOffset& offset,
+                                      size_t max_count) const {
+  if (query.IsDocumentQuery()) {
+    return std::min<size_t>(1, max_count);
+  }
+
+  RemoteDocumentCache* remote_document_cache =
+      local_documents_view_->remote_document_cache();
+  if (!query.IsCollectionGroupQuery()) {
+    return remote_document_cache->EstimateChangedDocuments(query.path(), offset,
+                                                           max_count);
+  }
+
+  const std::string& collection_id = *query.collection_group();
+  size_t count = 0;
+  for (const model::ResourcePath& parent :
+       index_manager_->GetCollectionParents(collection_id)) {
+    if (count >= max_count) {
+      break;
+    }
+    count += remote_document_cache->EstimateChangedDocuments(
+        parent.Append(collection_id), offset, max_count - count);
+  }
+  return count;
+}
+
+size_t QueryEngine::CountOverlays(const Query& query) const {
+  DocumentOverlayCache* document_overlay_cache =
+      local_documents_view_->document_overlay_cache();
+  if (query.IsDocumentQuery()) {
+    return document_overlay_cache->GetOverlay(model::DocumentKey(query.path()))
+                   .has_value()
+               ? 1
+               : 0;
+  }
+
+  int since_batch_id = model::IndexOffset::InitialLargestBatchId();
+  if (query.IsCollectionGroupQuery()) {
+    return document_overlay_cache
+        ->GetOverlays(*query.collection_group(), since_batch_id,
+                      std::numeric_limits<size_t>::max())
+        .size();
+  }
+  return document_overlay_cache->GetOverlays(query.path(), since_batch_id)
+      .size();
 }
 
 const absl::optional<DocumentMap> QueryEngine::PerformQueryUsingIndex(
-    const Query& query) const {
+    const Query& query) {
   if (query.MatchesAllDocuments()) {
     // Don't use indexes for queries that can be executed by scanning the
     // collection.
@@ -93,34 +499,20 @@ const absl::optional<DocumentMap> QueryEngine::PerformQueryUsingIndex(
     // of documents in the wrong order (e.g. if the index doesn't include a
     // segment for one of the orderBys). Therefore a limit should not be applied
     // in such cases.
-    const Query query_with_limit =
-        query.WithLimitToFirst(core::Target::kNoLimit);
-    return PerformQueryUsingIndex(query_with_limit);
+    return PerformQueryUsingIndexWithoutLimit(query);
   }
 
-  auto keys = index_manager_->GetDocumentsMatchingTarget(target);
-  HARD_ASSERT(
-      keys.has_value(),
-      "index manager must return results for partial and full indexes.");
-
   DocumentKeySet remote_keys;
-  for (auto key : keys.value()) {
-    remote_keys = remote_keys.insert(key);
-  }
-
-  DocumentMap indexedDocuments =
-      local_documents_view_->GetDocuments(remote_keys);
+  DocumentMap indexed_documents = GetIndexedDocuments(target, &remote_keys);
   model::IndexOffset offset = index_manager_->GetMinOffset(target);
 
-  DocumentSet previous_results = ApplyQuery(query, indexedDocuments);
+  DocumentSet previous_results = ApplyQuery(query, indexed_documents);
   if (NeedsRefill(query, previous_results, remote_keys, offset.read_time())) {
     // A limit query whose boundaries change due to local edits can be re-run
     // against the cache by excluding the limit. This ensures that all documents
     // that match the query's filters are included in the result set. The SDK
     // can then apply the limit once all local edits are incorporated.
-    const Query query_with_limit =
-        query.WithLimitToFirst(core::Target::kNoLimit);
-    return PerformQueryUsingIndex(query_with_limit);
+    return PerformQueryUsingIndexWithoutLimit(query);
   }
 
   // Retrieve all results for documents that were updated since the last
@@ -128,10 +520,40 @@ const absl::optional<DocumentMap> QueryEngine::PerformQueryUsingIndex(
   return AppendRemainingResults(previous_results, query, offset);
 }
 
+const DocumentMap QueryEngine::PerformQueryUsingIndexWithoutLimit(
+    const Query& query) {
+  const Query query_without_limit =
+      query.WithLimitToFirst(core::Target::kNoLimit);
+  const core::Target& target = query_without_limit.ToTarget();
+
+  DocumentKeySet remote_keys;
+  DocumentMap indexed_documents = GetIndexedDocuments(target, &remote_keys);
+  model::IndexOffset offset = index_manager_->GetMinOffset(target);
+
+  // The index lookup ignores the limit, but the limit is still applied to the
+  // documents that were read so that only those within it are retained.
+  return AppendRemainingResults(ApplyQuery(query, indexed_documents), query,
+                                offset);
+}
+
+DocumentMap QueryEngine::GetIndexedDocuments(
+    const core::Target& target, DocumentKeySet* indexed_keys) {
+  auto keys = index_manager_->GetDocumentsMatchingTarget(target);
+  HARD_ASSERT(
+      keys.has_value(),
+      "index manager must return results for partial and full indexes.");
+
+  for (const model::DocumentKey& key : keys.value()) {
+    *indexed_keys = indexed_keys->insert(key);
+  }
+  context_.IncrementDocumentsRead(indexed_keys->size());
+  return local_documents_view_->GetDocuments(*indexed_keys);
+}
+
 const absl::optional<DocumentMap> QueryEngine::PerformQueryUsingRemoteKeys(
     const Query& query,
     const DocumentKeySet& remote_keys,
-    const SnapshotVersion& last_limbo_free_snapshot_version) const {
+    const SnapshotVersion& last_limbo_free_snapshot_version) {
   // Queries that match all documents don't benefit from using key-based
   // lookups. It is more efficient to scan all documents in a collection, rather
   // than to perform individual lookups.
@@ -146,6 +568,7 @@ const absl::optional<DocumentMap> QueryEngine::PerformQueryUsingRemoteKeys(
   }
 
   DocumentMap documents = local_documents_view_->GetDocuments(remote_keys);
+  context_.IncrementDocumentsRead(remote_keys.size());
   DocumentSet previous_results = ApplyQuery(query, documents);
 
   if ((query.has_limit_to_first() || query.has_limit_to_last()) &&
@@ -170,6 +593,21 @@ DocumentSet QueryEngine::ApplyQuery(const Query& query,
   // documents do not necessarily still match the query.
   DocumentSet query_results(query.Comparator());
 
+  if (query.has_limit()) {
+    // Only sort the documents that fall within the limit.
+    LimitedDocuments limited(query);
+    for (const auto& document_entry : documents) {
+      const Document& doc = document_entry.second;
+      if (doc->is_found_document() && query.Matches(doc)) {
+        limited.Add(doc);
+      }
+    }
+    for (const Document& doc : limited.Release()) {
+      query_results = query_results.insert(doc);
+    }
+    return query_results;
+  }
+
   for (const auto& document_entry : documents) {
     const Document& doc = document_entry.second;
     if (doc->is_found_document()) {
@@ -192,7 +630,8 @@ bool QueryEngine::NeedsRefill(
   }
 
   // The query needs to be refilled if a previously matching document no longer
-  // matches.
+  // matches. Since `ApplyQuery()` only keeps the documents within the limit,
+  // this also refills the query if there are more remote keys than the limit.
   if (remote_keys.size() != sorted_previous_results.size()) {
     return true;
   }
@@ -218,20 +657,22 @@ bool QueryEngine::NeedsRefill(
 }
 
 const DocumentMap QueryEngine::ExecuteFullCollectionScan(
-    const Query& query) const {
+    const Query& query) {
   LOG_DEBUG("Using full collection scan to execute query: %s",
             query.ToString());
-  return local_documents_view_->GetDocumentsMatchingQuery(
-      query, model::IndexOffset::None());
+  DocumentMap documents = local_documents_view_->GetDocumentsMatchingQuery(
+      query, model::IndexOffset::None(), &context_);
+  return ApplyLimit(query, documents);
 }
 
 const DocumentMap QueryEngine::AppendRemainingResults(
     const DocumentSet& indexed_results,
     const Query& query,
-    const model::IndexOffset& offset) const {
+    const model::IndexOffset& offset) {
   // Retrieve all results for documents that were updated since the offset.
   DocumentMap remaining_results =
-      local_documents_view_->GetDocumentsMatchingQuery(query, offset);
+      local_documents_view_->GetDocumentsMatchingQuery(query, offset,
+                                                       &context_);
 
   // We merge `previous_results` into `update_results`, since `update_results`
   // is already a DocumentMap. If a document is contained in both lists, then
@@ -239,7 +680,7 @@ const DocumentMap QueryEngine::AppendRemainingResults(
   for (const Document& entry : indexed_results) {
     remaining_results = remaining_results.insert(entry->key(), entry);
   }
-  return remaining_results;
+  return ApplyLimit(query, remaining_results);
 }
 
 }  // namespace local
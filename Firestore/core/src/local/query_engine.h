@@ -17,6 +17,15 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_QUERY_ENGINE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_QUERY_ENGINE_H_
 
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Firestore/core/src/core/target.h"
+#include "Firestore/core/src/local/index_manager.h"
+#include "Firestore/core/src/local/query_context.h"
+#include "Firestore/core/src/model/field_index.h"
 #include "Firestore/core/src/model/model_fwd.h"
 
 namespace firebase {
@@ -24,6 +33,7 @@ namespace firestore {
 
 namespace core {
 class Query;
+class Target;
 enum class LimitType;
 }  // namespace core
 
@@ -32,6 +42,57 @@ namespace local {
 class LocalDocumentsView;
 class IndexManager;
 
+/** A strategy the QueryEngine considered for executing a query. */
+struct QueryPlan {
+  enum class Strategy {
+    /** Reads the documents referenced by a field index. */
+    Index,
+    /** Re-uses the documents that matched the target at the last snapshot. */
+    RemoteKeys,
+    /** Reads all documents in the query's collection. */
+    FullCollectionScan,
+  };
+
+  Strategy strategy;
+
+  /**
+   * The estimated number of documents read by the plan, including the
+   * documents that changed since the index or the previous results were last
+   * updated. To keep planning cheap, an estimate stops counting once the plan
+   * is known to be more expensive than a plan that was estimated before it.
+   */
+  size_t estimated_documents;
+
+  std::string ToString() const;
+};
+
+/** Describes how the QueryEngine executed a query. */
+struct QueryExplanation {
+  /** The plan that produced the results. */
+  QueryPlan chosen_plan;
+
+  /** All plans that were considered, cheapest first. */
+  std::vector<QueryPlan> candidate_plans;
+
+  /**
+   * The number of documents with local mutations in the query's collection.
+   * Every plan reads these documents, so they are included in all estimates.
+   */
+  size_t overlay_count = 0;
+
+  /**
+   * The number of documents read by all plans that were executed, including
+   * the documents that a collection scan discarded because they don't match
+   * the query.
+   */
+  size_t documents_read = 0;
+
+  /** The number of documents returned to the caller. */
+  size_t documents_returned = 0;
+
+  std::string ToString() const;
+};
+
 // TODO(cheryllin): Add function name into documentation which configures index
 // (e.g. setIndexConfiguration).
 /**
@@ -40,18 +101,33 @@ class IndexManager;
  * the runtime complexity of the query - the result set is equivalent across all
  * implementations.
  *
- * The Query engine will use indexed-based execution if a user has configured
- * any index that can be used to execute query. Otherwise, the engine will try
- * to optimize the query by re-using a previously persisted query result. If
- * that is not possible, the query will be executed via a full collection scan.
+ * The Query engine estimates the number of documents that each eligible mode
+ * reads and uses the cheapest one. Index-based execution is eligible if a user
+ * has configured any index that can be used to execute query. Re-using a
+ * previously persisted query result is eligible if the query has been in sync
+ * with the backend. A full collection scan is always eligible. If modes have
+ * the same estimate, they are preferred in that order. `Explain()` describes
+ * the plans that were considered for a query.
+ *
+ * The estimates are based on statistics that are cheap to compute: the number
+ * of index entries in the ranges scanned by the index, the number of keys in
+ * the persisted query result, the number of documents in the collection and
+ * the number of documents that changed since the index or the persisted query
+ * result were last updated. Since these scan index entries, read times or (in
+ * memory) the collection itself, they are cached per target. A target is
+ * re-estimated when its indexes change, or when its collection's size, which
+ * is checked every `kMaxScanEstimateReuses` executions, changes by more than a
+ * factor of two. The collection is not estimated when a full collection scan is
+ * the only eligible mode, unless the query is explained, and explained queries
+ * are always re-estimated.
  *
- * Index-based execution is the default when available. The query engine
- * supports partial indexed execution and merges the result from the index
- * lookup with documents that have not yet been indexed. The index evaluation
- * matches the backend's format and as such, the SDK can use indexing for all
- * queries that the backend supports.
+ * For index-based execution, the query engine supports partial indexed
+ * execution and merges the result from the index lookup with documents that
+ * have not yet been indexed. The index evaluation matches the backend's format
+ * and as such, the SDK can use indexing for all queries that the backend
+ * supports.
  *
- * If no index exists, the query engine tries to take advantage of the target
+ * Without an index, the query engine tries to take advantage of the target
  * document mapping in the TargetCache. These mappings exists for all queries
  * that have been synced with the backend at least once and allow the query
  * engine to only read documents that previously matched a query plus any
@@ -64,6 +140,12 @@ class IndexManager;
  */
 class QueryEngine {
  public:
+  /**
+   * The number of executions that re-use the cached estimates of a target
+   * before its collection's size is checked again.
+   */
+  static constexpr size_t kMaxScanEstimateReuses = 10;
+
   virtual ~QueryEngine() = default;
 
   /**
@@ -77,15 +159,111 @@ class QueryEngine {
   const model::DocumentMap GetDocumentsMatchingQuery(
       const core::Query& query,
       const model::SnapshotVersion& last_limbo_free_snapshot_version,
-      const model::DocumentKeySet& remote_keys) const;
+      const model::DocumentKeySet& remote_keys);
+
+  /**
+   * Executes several queries without re-using their previous results, as is
+   * done when views need to be refilled. Queries that would scan the same
+   * collection share a single scan. Returns the results in the order of
+   * `queries`.
+   */
+  std::vector<model::DocumentMap> GetDocumentsMatchingQueries(
+      const std::vector<core::Query>& queries);
+
+  /**
+   * Executes the query like `GetDocumentsMatchingQuery()` and describes the
+   * plans that were considered, along with the number of documents that were
+   * actually read.
+   */
+  QueryExplanation Explain(
+      const core::Query& query,
+      const model::SnapshotVersion& last_limbo_free_snapshot_version,
+      const model::DocumentKeySet& remote_keys);
 
  private:
+  /**
+   * Executes the cheapest plan for `query`, falling back to the next cheapest
+   * plan if a plan cannot produce results. Fills in `explanation` if it is not
+   * null.
+   */
+  const model::DocumentMap ExecuteQuery(
+      const core::Query& query,
+      const model::SnapshotVersion& last_limbo_free_snapshot_version,
+      const model::DocumentKeySet& remote_keys,
+      QueryExplanation* explanation);
+
+  /**
+   * The estimates that require scanning index entries or read times, which
+   * are cached per target (see `PlanQuery()`).
+   */
+  struct ScanEstimates {
+    /** The number of documents in the query's collection when estimated. */
+    size_t collection_documents = 0;
+
+    /** The index that was estimated, if any. */
+    IndexManager::IndexType index_type = IndexManager::IndexType::NONE;
+    model::IndexOffset index_offset = model::IndexOffset::None();
+
+    /** The documents read by the index plan. */
+    size_t index_documents = 0;
+
+    /** Whether the documents changed since the previous results are counted. */
+    bool counted_changed_documents = false;
+
+    /** The documents that changed since the last limbo-free snapshot. */
+    size_t changed_documents = 0;
+
+    /** The executions that re-used these estimates since they were checked. */
+    size_t reuses = 0;
+  };
+
+  /**
+   * Returns the plans that can execute `query`, ordered by their estimated
+   * cost. `overlay_count` is added to every estimate. Unless `explain` is true,
+   * a full collection scan that is the only plan is not estimated, and the
+   * scan-based estimates of a previous execution of the query's target are
+   * re-used while its indexes and its collection's size don't change much.
+   */
+  std::vector<QueryPlan> PlanQuery(
+      const core::Query& query,
+      const model::SnapshotVersion& last_limbo_free_snapshot_version,
+      const model::DocumentKeySet& remote_keys,
+      size_t overlay_count,
+      bool explain);
+
+  /**
+   * Returns the number of documents cached for the query's collection (or
+   * collection group) that sort after `offset`, counting at most `max_count`
+   * documents.
+   */
+  size_t EstimateDocuments(const core::Query& query,
+                           const model::IndexOffset& offset,
+                           size_t max_count) const;
+
+  /** Returns the number of overlays for documents in the query's results. */
+  size_t CountOverlays(const core::Query& query) const;
+
   /**
    * Performs an indexed query that evaluates the query based on a collection's
    * persisted index values. Returns nullopt if an index is not available.
    */
   const absl::optional<model::DocumentMap> PerformQueryUsingIndex(
-      const core::Query& query) const;
+      const core::Query& query);
+
+  /**
+   * Performs an indexed query that reads all index entries matching the
+   * query's filters, regardless of its limit. The limit is then applied to the
+   * documents that were read.
+   */
+  const model::DocumentMap PerformQueryUsingIndexWithoutLimit(
+      const core::Query& query);
+
+  /**
+   * Returns the documents for all index entries that match `target`, storing
+   * their keys in `indexed_keys`.
+   */
+  model::DocumentMap GetIndexedDocuments(
+      const core::Target& target, model::DocumentKeySet* indexed_keys);
 
   /**
    * Performs a query based on the target's persisted query mapping. Returns
@@ -94,9 +272,12 @@ class QueryEngine {
   const absl::optional<model::DocumentMap> PerformQueryUsingRemoteKeys(
       const core::Query& query,
       const model::DocumentKeySet& remote_keys,
-      const model::SnapshotVersion& last_limbo_free_snapshot_version) const;
+      const model::SnapshotVersion& last_limbo_free_snapshot_version);
 
-  /** Applies the query filter and sorting to the provided documents. */
+  /**
+   * Applies the query filter and sorting to the provided documents. For limit
+   * queries, only the documents within the limit are returned.
+   */
   model::DocumentSet ApplyQuery(const core::Query& query,
                                 const model::DocumentMap& documents) const;
 
@@ -119,20 +300,30 @@ class QueryEngine {
       const model::SnapshotVersion& limbo_free_snapshot_version) const;
 
   const model::DocumentMap ExecuteFullCollectionScan(
-      const core::Query& query) const;
+      const core::Query& query);
 
   /**
    * Combines the results from an indexed execution with the remaining documents
-   * that have not yet been indexed.
+   * that have not yet been indexed. For limit queries, only the documents
+   * within the limit are returned.
    */
   const model::DocumentMap AppendRemainingResults(
       const model::DocumentSet& indexedResults,
       const core::Query& query,
-      const model::IndexOffset& offset) const;
+      const model::IndexOffset& offset);
 
   LocalDocumentsView* local_documents_view_ = nullptr;
 
   IndexManager* index_manager_ = nullptr;
+
+  /**
+   * Counts the documents read by the current query. Queries are only executed
+   * on the worker queue.
+   */
+  QueryContext context_;
+
+  /** The scan-based estimates of recently executed targets. */
+  std::unordered_map<core::Target, ScanEstimates> scan_estimates_;
 };
 
 }  // namespace local
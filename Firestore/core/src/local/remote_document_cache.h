@@ -31,6 +31,7 @@ class Query;
 namespace local {
 
 class IndexManager;
+class QueryContext;
 
 /**
  * Represents cached documents received from the remote backend.
@@ -108,6 +109,57 @@ class RemoteDocumentCache {
   virtual model::MutableDocumentMap GetAll(
       const model::ResourcePath& path, const model::IndexOffset& offset) = 0;
 
+  /**
+   * Executes a collection query against the cached Document entries, only
+   * returning documents that match the query.
+   *
+   * Unlike `GetAll(path, offset)`, the query's filters, order-bys and bounds
+   * are evaluated while the documents are read, so that non-matching documents
+   * never make it into the result map.
+   *
+   * Cached DeletedDocument entries have no bearing on query results.
+   *
+   * @param query The collection query to match documents against. Must not be
+   * a collection group or document query.
+   * @param offset The read time and document key to start scanning at
+   * (exclusive).
+   * @param mutated_docs The documents with local mutations. These are returned
+   * regardless of whether their remote version matches the query, since their
+   * overlay may make them match.
+   * @param context If not null, counts the documents that were read, matching
+   * or not.
+   * @return The set of matching documents.
+   */
+  virtual model::MutableDocumentMap GetDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      const model::OverlayByDocumentKeyMap& mutated_docs,
+      QueryContext* context) = 0;
+
+  /**
+   * Returns the number of entries cached for the collection at `path`,
+   * excluding documents in subcollections. Counting stops once `max_count`
+   * entries have been seen.
+   *
+   * No documents are read, so this is considerably cheaper than `GetAll()`.
+   * Since cached DeletedDocument entries are counted as well, the result is an
+   * upper bound on the number of documents a collection scan returns.
+   */
+  virtual size_t EstimateCollectionSize(const model::ResourcePath& path,
+                                        size_t max_count) const = 0;
+
+  /**
+   * Returns the number of entries cached for the collection at `path` that
+   * sort after `offset`, i.e. the entries that `GetAll(path, offset)` reads.
+   * Counting stops once `max_count` entries have been seen.
+   *
+   * Like `EstimateCollectionSize()`, no documents are read and the result is
+   * an upper bound.
+   */
+  virtual size_t EstimateChangedDocuments(const model::ResourcePath& path,
+                                          const model::IndexOffset& offset,
+                                          size_t max_count) const = 0;
+
   /**
    * Sets the index manager used by remote document cache.
    *
@@ -60,7 +60,8 @@ TargetData::TargetData(Target target,
                        QueryPurpose purpose,
                        SnapshotVersion snapshot_version,
                        SnapshotVersion last_limbo_free_snapshot_version,
-                       ByteString resume_token)
+                       ByteString resume_token,
+                       absl::optional<int32_t> expected_count)
     : target_(std::move(target)),
       target_id_(target_id),
       sequence_number_(sequence_number),
@@ -68,7 +69,8 @@ TargetData::TargetData(Target target,
       snapshot_version_(std::move(snapshot_version)),
       last_limbo_free_snapshot_version_(
           std::move(last_limbo_free_snapshot_version)),
-      resume_token_(std::move(resume_token)) {
+      resume_token_(std::move(resume_token)),
+      expected_count_(expected_count) {
 }
 
 TargetData::TargetData(Target target,
@@ -95,7 +97,7 @@ TargetData TargetData::WithSequenceNumber(
     ListenSequenceNumber sequence_number) const {
   return TargetData(target_, target_id_, sequence_number, purpose_,
                     snapshot_version_, last_limbo_free_snapshot_version_,
-                    resume_token_);
+                    resume_token_, expected_count_);
 }
 
 TargetData TargetData::WithResumeToken(ByteString resume_token,
@@ -109,7 +111,14 @@ TargetData TargetData::WithLastLimboFreeSnapshotVersion(
     SnapshotVersion last_limbo_free_snapshot_version) const {
   return TargetData(target_, target_id_, sequence_number_, purpose_,
                     snapshot_version_,
-                    std::move(last_limbo_free_snapshot_version), resume_token_);
+                    std::move(last_limbo_free_snapshot_version), resume_token_,
+                    expected_count_);
+}
+
+TargetData TargetData::WithExpectedCount(int32_t expected_count) const {
+  return TargetData(target_, target_id_, sequence_number_, purpose_,
+                    snapshot_version_, last_limbo_free_snapshot_version_,
+                    resume_token_, expected_count);
 }
 
 bool operator==(const TargetData& lhs, const TargetData& rhs) {
@@ -117,12 +126,13 @@ bool operator==(const TargetData& lhs, const TargetData& rhs) {
          lhs.sequence_number() == rhs.sequence_number() &&
          lhs.purpose() == rhs.purpose() &&
          lhs.snapshot_version() == rhs.snapshot_version() &&
-         lhs.resume_token() == rhs.resume_token();
+         lhs.resume_token() == rhs.resume_token() &&
+         lhs.expected_count() == rhs.expected_count();
 }
 
 size_t TargetData::Hash() const {
   return util::Hash(target_, target_id_, sequence_number_, purpose_,
-                    snapshot_version_, resume_token_);
+                    snapshot_version_, resume_token_, expected_count_);
 }
 
 std::string TargetData::ToString() const {
@@ -132,13 +142,16 @@ std::string TargetData::ToString() const {
 }
 
 std::ostream& operator<<(std::ostream& os, const TargetData& value) {
-  return os << "TargetData(target=" << value.target_
-            << ", target_id=" << value.target_id_
-            << ", purpose=" << value.purpose_
-            << ", version=" << value.snapshot_version_
-            << ", last_limbo_free_snapshot_version="
-            << value.last_limbo_free_snapshot_version_
-            << ", resume_token=" << value.resume_token_ << ")";
+  os << "TargetData(target=" << value.target_
+     << ", target_id=" << value.target_id_ << ", purpose=" << value.purpose_
+     << ", version=" << value.snapshot_version_
+     << ", last_limbo_free_snapshot_version="
+     << value.last_limbo_free_snapshot_version_
+     << ", resume_token=" << value.resume_token_;
+  if (value.expected_count_.has_value()) {
+    os << ", expected_count=" << *value.expected_count_;
+  }
+  return os << ")";
 }
 
 }  // namespace local
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_TARGET_DATA_H_
 #define FIRESTORE_CORE_SRC_LOCAL_TARGET_DATA_H_
 
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -26,6 +27,7 @@
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/nanopb/byte_string.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -67,6 +69,8 @@ class TargetData {
    *     target to be resumed after disconnecting without retransmitting all the
    *     data that matches the query. The resume token essentially identifies a
    *     point in time from which the server should resume sending results.
+   * @param expected_count The number of documents that last matched the
+   *     target at the resume token, if known.
    */
   TargetData(core::Target target,
              model::TargetId target_id,
@@ -74,7 +78,8 @@ class TargetData {
              QueryPurpose purpose,
              model::SnapshotVersion snapshot_version,
              model::SnapshotVersion last_limbo_free_snapshot_version,
-             nanopb::ByteString resume_token);
+             nanopb::ByteString resume_token,
+             absl::optional<int32_t> expected_count = absl::nullopt);
 
   /**
    * Convenience constructor for use when creating a TargetData for the first
@@ -142,13 +147,23 @@ class TargetData {
     return resume_token_;
   }
 
+  /**
+   * The number of documents that last matched the target at the resume token.
+   * Only set on the copy that is sent to the backend when resuming a target,
+   * so that watch can include a bloom filter in an existence filter mismatch.
+   */
+  const absl::optional<int32_t>& expected_count() const {
+    return expected_count_;
+  }
+
   /** Creates a new target data instance with an updated sequence number. */
   TargetData WithSequenceNumber(
       model::ListenSequenceNumber sequence_number) const;
 
   /**
    * Creates a new target data instance with an updated resume token and
-   * snapshot version.
+   * snapshot version. The expected count is cleared, since it described the
+   * result set at the previous resume token.
    */
   TargetData WithResumeToken(nanopb::ByteString resume_token,
                              model::SnapshotVersion snapshot_version) const;
@@ -160,6 +175,12 @@ class TargetData {
   TargetData WithLastLimboFreeSnapshotVersion(
       model::SnapshotVersion last_limbo_free_snapshot_version) const;
 
+  /**
+   * Creates a new target data instance with the number of documents that last
+   * matched the target.
+   */
+  TargetData WithExpectedCount(int32_t expected_count) const;
+
   friend bool operator==(const TargetData& lhs, const TargetData& rhs);
 
   size_t Hash() const;
@@ -176,6 +197,7 @@ class TargetData {
   model::SnapshotVersion snapshot_version_;
   model::SnapshotVersion last_limbo_free_snapshot_version_;
   nanopb::ByteString resume_token_;
+  absl::optional<int32_t> expected_count_;
 };
 
 inline bool operator!=(const TargetData& lhs, const TargetData& rhs) {
@@ -107,7 +107,8 @@ MutableDocument MutableDocument::Clone() const {
           document_type_,
           version_,
           read_time_,
-          std::make_shared<ObjectValue>(DeepClone(value_->Get())),
+          // Copying keeps lazily-decoded values lazy.
+          std::make_shared<ObjectValue>(*value_),
           document_state_};
 }
 
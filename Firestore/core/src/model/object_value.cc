@@ -17,13 +17,19 @@
 #include "Firestore/core/src/model/object_value.h"
 
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
 #include <set>
+#include <string>
+#include <utility>
 
 #include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
 #include "Firestore/core/src/nanopb/fields_array.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/hashing.h"
 #include "absl/types/span.h"
 
@@ -34,6 +40,8 @@ namespace model {
 namespace {
 
 using nanopb::CheckedSize;
+using nanopb::EncodedField;
+using nanopb::ForEachEncodedField;
 using nanopb::FreeFieldsArray;
 using nanopb::FreeNanopbMessage;
 using nanopb::MakeArray;
@@ -43,6 +51,7 @@ using nanopb::MakeStringView;
 using nanopb::Message;
 using nanopb::ReleaseFieldOwnership;
 using nanopb::SetRepeatedField;
+using nanopb::StringReader;
 
 struct MapEntryKeyCompare {
   bool operator()(const google_firestore_v1_MapValue_FieldsEntry& entry,
@@ -179,8 +188,111 @@ void ApplyChanges(
   parent->fields_count = CheckedSize(target_count);
 }
 
+/**
+ * Splits an encoded `Document.FieldsEntry` into its key and its encoded value.
+ */
+void ParseFieldsEntry(absl::string_view encoded_entry,
+                      absl::string_view* key,
+                      absl::string_view* value) {
+  bool ok = ForEachEncodedField(encoded_entry, [&](const EncodedField& entry) {
+    switch (entry.tag) {
+      case google_firestore_v1_Document_FieldsEntry_key_tag:
+        *key = entry.bytes;
+        break;
+      case google_firestore_v1_Document_FieldsEntry_value_tag:
+        *value = entry.bytes;
+        break;
+      default:
+        break;
+    }
+    return true;
+  });
+  HARD_ASSERT(ok, "Failed to decode document field entry");
+}
+
+/**
+ * Returns the encoded value of every top-level field of the encoded Document
+ * proto, by key. Like the decoder, the last entry wins if a key is repeated.
+ */
+std::map<std::string, absl::string_view> FindEncodedFields(
+    absl::string_view encoded_document) {
+  std::map<std::string, absl::string_view> result;
+  bool ok = ForEachEncodedField(
+      encoded_document, [&](const EncodedField& field) {
+        if (field.tag == google_firestore_v1_Document_fields_tag) {
+          absl::string_view key;
+          absl::string_view value;
+          ParseFieldsEntry(field.bytes, &key, &value);
+          result[std::string(key)] = value;
+        }
+        return true;
+      });
+  HARD_ASSERT(ok, "Failed to decode document fields");
+  return result;
+}
+
+Message<google_firestore_v1_Value> DecodeFieldValue(
+    absl::string_view encoded_value, absl::string_view key) {
+  StringReader reader{encoded_value};
+  auto decoded = Message<google_firestore_v1_Value>::TryParse(&reader);
+  HARD_ASSERT(reader.ok(), "Failed to decode document field '%s': %s", key,
+              reader.status().ToString());
+  SortFields(*decoded);
+  return decoded;
+}
+
+/**
+ * Decodes the top-level field `segment` of the encoded Document proto without
+ * decoding any of the document's other fields. Returns `nullopt` if the
+ * document does not contain the field.
+ */
+absl::optional<Message<google_firestore_v1_Value>> DecodeField(
+    absl::string_view encoded_document, absl::string_view segment) {
+  // Keep walking after a match, since a repeated key overrides earlier ones.
+  bool found = false;
+  absl::string_view found_value;
+  bool ok = ForEachEncodedField(
+      encoded_document, [&](const EncodedField& field) {
+        if (field.tag != google_firestore_v1_Document_fields_tag) return true;
+
+        absl::string_view key;
+        absl::string_view value;
+        ParseFieldsEntry(field.bytes, &key, &value);
+        if (key == segment) {
+          found = true;
+          found_value = value;
+        }
+        return true;
+      });
+  HARD_ASSERT(ok, "Failed to decode document fields");
+
+  if (!found) return absl::nullopt;
+  return DecodeFieldValue(found_value, segment);
+}
+
 }  // namespace
 
+class ObjectValue::LazyFields {
+ public:
+  LazyFields(std::shared_ptr<const std::string> buffer,
+             absl::string_view encoded_document)
+      : buffer(std::move(buffer)), encoded_document(encoded_document) {
+  }
+
+  // Owns the bytes that `encoded_document` points into.
+  std::shared_ptr<const std::string> buffer;
+  absl::string_view encoded_document;
+
+  std::mutex mutex;
+
+  // Top-level fields decoded by `Get(path)`, or `nullopt` for fields that do
+  // not exist. Values returned by `Get(path)` point into them, so
+  // `Materialize()` moves them into `ObjectValue::value_` instead of decoding
+  // them again.
+  std::map<std::string, absl::optional<Message<google_firestore_v1_Value>>>
+      decoded_fields;
+};
+
 ObjectValue::ObjectValue() {
   value_->which_value_type = google_firestore_v1_Value_map_value_tag;
   value_->map_value = {};
@@ -193,10 +305,33 @@ ObjectValue::ObjectValue(Message<google_firestore_v1_Value> value)
   SortFields(*value_);
 }
 
-ObjectValue::ObjectValue(const ObjectValue& other)
-    : value_(DeepClone(*other.value_)) {
+ObjectValue::ObjectValue(const ObjectValue& other) {
+  std::shared_ptr<LazyFields> other_lazy_fields = other.LoadLazyFields();
+  if (other_lazy_fields) {
+    // Share the encoded bytes instead of decoding them.
+    lazy_fields_ = std::make_shared<LazyFields>(
+        other_lazy_fields->buffer, other_lazy_fields->encoded_document);
+    materialized_ = false;
+  } else {
+    value_ = DeepClone(other.Materialize());
+  }
+}
+
+ObjectValue::ObjectValue(ObjectValue&& other) noexcept
+    : value_(std::move(other.value_)),
+      lazy_fields_(std::move(other.lazy_fields_)),
+      materialized_(other.materialized_.load()) {
 }
 
+ObjectValue& ObjectValue::operator=(ObjectValue&& other) noexcept {
+  value_ = std::move(other.value_);
+  lazy_fields_ = std::move(other.lazy_fields_);
+  materialized_ = other.materialized_.load();
+  return *this;
+}
+
+ObjectValue::~ObjectValue() = default;
+
 ObjectValue ObjectValue::FromMapValue(
     Message<google_firestore_v1_MapValue> map_value) {
   Message<google_firestore_v1_Value> value;
@@ -221,8 +356,71 @@ ObjectValue ObjectValue::FromFieldsEntry(
   return ObjectValue{std::move(value)};
 }
 
+ObjectValue ObjectValue::FromEncodedDocument(
+    std::shared_ptr<const std::string> buffer,
+    absl::string_view encoded_document) {
+  ObjectValue result;
+  result.lazy_fields_ =
+      std::make_shared<LazyFields>(std::move(buffer), encoded_document);
+  result.materialized_ = false;
+  return result;
+}
+
+bool ObjectValue::is_lazy() const {
+  return !materialized_.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<ObjectValue::LazyFields> ObjectValue::LoadLazyFields() const {
+  if (materialized_.load(std::memory_order_acquire)) return nullptr;
+
+  // Another thread may release the lazy fields concurrently.
+  return std::atomic_load(&lazy_fields_);
+}
+
+const google_firestore_v1_Value& ObjectValue::Materialize() const {
+  std::shared_ptr<LazyFields> lazy_fields = LoadLazyFields();
+  if (!lazy_fields) return *value_;
+
+  std::lock_guard<std::mutex> lock(lazy_fields->mutex);
+  if (materialized_.load(std::memory_order_relaxed)) return *value_;
+
+  std::map<std::string, absl::string_view> encoded_fields =
+      FindEncodedFields(lazy_fields->encoded_document);
+  auto& decoded_fields = lazy_fields->decoded_fields;
+
+  Message<google_firestore_v1_Value> value;
+  value->which_value_type = google_firestore_v1_Value_map_value_tag;
+  value->map_value.fields_count = CheckedSize(encoded_fields.size());
+  value->map_value.fields =
+      MakeArray<google_firestore_v1_MapValue_FieldsEntry>(
+          value->map_value.fields_count);
+
+  // `std::map` iterates in key order, so the fields come out sorted.
+  google_firestore_v1_MapValue_FieldsEntry* entry = value->map_value.fields;
+  for (const auto& encoded_field : encoded_fields) {
+    entry->key = MakeBytesArray(encoded_field.first);
+    auto decoded = decoded_fields.find(encoded_field.first);
+    if (decoded != decoded_fields.end() && decoded->second) {
+      entry->value = *decoded->second->release();
+    } else {
+      entry->value = *DecodeFieldValue(encoded_field.second,
+                                       encoded_field.first)
+                          .release();
+    }
+    ++entry;
+  }
+
+  value_ = std::move(value);
+  materialized_.store(true, std::memory_order_release);
+
+  // Drop the encoded bytes and the per-field cache. Threads that loaded the
+  // lazy fields before this point keep them alive until they are done.
+  std::atomic_store(&lazy_fields_, std::shared_ptr<LazyFields>());
+  return *value_;
+}
+
 FieldMask ObjectValue::ToFieldMask() const {
-  return ExtractFieldMask(value_->map_value);
+  return ExtractFieldMask(Materialize().map_value);
 }
 
 FieldMask ObjectValue::ExtractFieldMask(
@@ -256,13 +454,38 @@ FieldMask ObjectValue::ExtractFieldMask(
 absl::optional<google_firestore_v1_Value> ObjectValue::Get(
     const FieldPath& path) const {
   if (path.empty()) {
-    return *value_;
+    return Materialize();
   }
 
-  google_firestore_v1_Value nested_value = *value_;
-  for (const std::string& segment : path) {
+  auto segment = path.begin();
+  google_firestore_v1_Value nested_value;
+  std::shared_ptr<LazyFields> lazy_fields = LoadLazyFields();
+  if (lazy_fields) {
+    std::lock_guard<std::mutex> lock(lazy_fields->mutex);
+    if (materialized_.load(std::memory_order_relaxed)) {
+      nested_value = *value_;
+    } else {
+      // Only decode the top-level field that the path starts with.
+      auto& decoded_fields = lazy_fields->decoded_fields;
+      auto found = decoded_fields.find(*segment);
+      if (found == decoded_fields.end()) {
+        found = decoded_fields
+                    .emplace(*segment,
+                             DecodeField(lazy_fields->encoded_document,
+                                         *segment))
+                    .first;
+      }
+      if (!found->second) return absl::nullopt;
+      nested_value = **found->second;
+      ++segment;
+    }
+  } else {
+    nested_value = *value_;
+  }
+
+  for (; segment != path.end(); ++segment) {
     google_firestore_v1_MapValue_FieldsEntry* entry =
-        FindEntry(nested_value, segment);
+        FindEntry(nested_value, *segment);
     if (!entry) return absl::nullopt;
     nested_value = entry->value;
   }
@@ -270,12 +493,13 @@ absl::optional<google_firestore_v1_Value> ObjectValue::Get(
 }
 
 google_firestore_v1_Value ObjectValue::Get() const {
-  return *value_;
+  return Materialize();
 }
 
 void ObjectValue::Set(const FieldPath& path,
                       Message<google_firestore_v1_Value> value) {
   HARD_ASSERT(!path.empty(), "Cannot set field for empty path on ObjectValue");
+  Materialize();
 
   google_firestore_v1_MapValue* parent_map = ParentMap(path.PopLast());
 
@@ -286,6 +510,8 @@ void ObjectValue::Set(const FieldPath& path,
 }
 
 void ObjectValue::SetAll(TransformMap data) {
+  Materialize();
+
   FieldPath parent;
 
   std::map<std::string, Message<google_firestore_v1_Value>> upserts;
@@ -318,6 +544,7 @@ void ObjectValue::SetAll(TransformMap data) {
 
 void ObjectValue::Delete(const FieldPath& path) {
   HARD_ASSERT(!path.empty(), "Cannot delete field with empty path");
+  Materialize();
 
   google_firestore_v1_Value* nested_value = value_.get();
   for (const std::string& segment : path.PopLast()) {
@@ -335,11 +562,11 @@ void ObjectValue::Delete(const FieldPath& path) {
 }
 
 std::string ObjectValue::ToString() const {
-  return CanonicalId(*value_);
+  return CanonicalId(Materialize());
 }
 
 size_t ObjectValue::Hash() const {
-  return util::Hash(CanonicalId(*value_));
+  return util::Hash(CanonicalId(Materialize()));
 }
 
 google_firestore_v1_MapValue* ObjectValue::ParentMap(const FieldPath& path) {
@@ -378,6 +605,19 @@ google_firestore_v1_MapValue* ObjectValue::ParentMap(const FieldPath& path) {
   return &parent->map_value;
 }
 
+bool operator==(const ObjectValue& lhs, const ObjectValue& rhs) {
+  // Identical encodings always decode to identical values.
+  std::shared_ptr<ObjectValue::LazyFields> lhs_lazy_fields =
+      lhs.LoadLazyFields();
+  std::shared_ptr<ObjectValue::LazyFields> rhs_lazy_fields =
+      rhs.LoadLazyFields();
+  if (lhs_lazy_fields && rhs_lazy_fields &&
+      lhs_lazy_fields->encoded_document == rhs_lazy_fields->encoded_document) {
+    return true;
+  }
+  return lhs.Materialize() == rhs.Materialize();
+}
+
 }  // namespace model
 }  // namespace firestore
 }  // namespace firebase
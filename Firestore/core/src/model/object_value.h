@@ -17,7 +17,9 @@
 #ifndef FIRESTORE_CORE_SRC_MODEL_OBJECT_VALUE_H_
 #define FIRESTORE_CORE_SRC_MODEL_OBJECT_VALUE_H_
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <set>
 #include <string>
@@ -30,6 +32,7 @@
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
 
 namespace firebase {
@@ -45,12 +48,14 @@ class ObjectValue {
   /** Creates a new ObjectValue */
   explicit ObjectValue(nanopb::Message<google_firestore_v1_Value> value);
 
-  ObjectValue(ObjectValue&& other) noexcept = default;
-  ObjectValue& operator=(ObjectValue&& other) noexcept = default;
+  ObjectValue(ObjectValue&& other) noexcept;
+  ObjectValue& operator=(ObjectValue&& other) noexcept;
   ObjectValue(const ObjectValue& other);
 
   ObjectValue& operator=(const ObjectValue&) = delete;
 
+  ~ObjectValue();
+
   /**
    * Creates a new ObjectValue that is backed by the given `map_value`.
    * ObjectValue takes on ownership of the data.
@@ -67,6 +72,24 @@ class ObjectValue {
   static ObjectValue FromFieldsEntry(
       google_firestore_v1_Document_FieldsEntry* fields_entry, pb_size_t count);
 
+  /**
+   * Creates a new ObjectValue that is backed by the encoded bytes of a
+   * `google_firestore_v1_Document` proto, without decoding them.
+   *
+   * Fields are decoded on demand: `Get(path)` only decodes the top-level field
+   * that `path` starts with, while any operation that needs the whole value
+   * (such as `Get()`, `ToFieldMask()` or any mutation) decodes all fields
+   * once.
+   *
+   * @param buffer Owns the encoded bytes and is kept alive by this ObjectValue
+   * and its copies.
+   * @param encoded_document The encoded Document proto. Must point into
+   * `buffer`.
+   */
+  static ObjectValue FromEncodedDocument(
+      std::shared_ptr<const std::string> buffer,
+      absl::string_view encoded_document);
+
   /** Recursively extracts the FieldPaths that are set in this ObjectValue. */
   FieldMask ToFieldMask() const;
 
@@ -114,6 +137,12 @@ class ObjectValue {
 
   size_t Hash() const;
 
+  /**
+   * Returns true if this ObjectValue was created from encoded bytes and has
+   * not yet decoded all of its fields.
+   */
+  bool is_lazy() const;
+
   friend bool operator==(const ObjectValue& lhs, const ObjectValue& rhs);
   friend std::ostream& operator<<(std::ostream& out,
                                   const ObjectValue& object_value);
@@ -128,12 +157,34 @@ class ObjectValue {
    */
   google_firestore_v1_MapValue* ParentMap(const FieldPath& path);
 
-  nanopb::Message<google_firestore_v1_Value> value_;
+  /** The encoded fields and decoding state of a lazy ObjectValue. */
+  class LazyFields;
+
+  /**
+   * Returns the fully decoded value. The first call on a lazy ObjectValue
+   * decodes all fields that `Get(path)` has not decoded yet, and then releases
+   * the encoded bytes.
+   */
+  const google_firestore_v1_Value& Materialize() const;
+
+  /** Returns the lazy fields, or null once all fields have been decoded. */
+  std::shared_ptr<LazyFields> LoadLazyFields() const;
+
+  // For lazy ObjectValues, `value_` is populated by `Materialize()`.
+  mutable nanopb::Message<google_firestore_v1_Value> value_;
+
+  // Only set for ObjectValues created with `FromEncodedDocument()` until they
+  // are materialized. Access to the decoded state is synchronized internally
+  // since documents may be read from the API layer while the worker queue
+  // evaluates queries against them.
+  mutable std::shared_ptr<LazyFields> lazy_fields_;
+
+  // Whether `value_` holds all fields. Checked first so that reads of a
+  // materialized ObjectValue don't need to lock.
+  mutable std::atomic<bool> materialized_{true};
 };
 
-inline bool operator==(const ObjectValue& lhs, const ObjectValue& rhs) {
-  return *lhs.value_ == *rhs.value_;
-}
+bool operator==(const ObjectValue& lhs, const ObjectValue& rhs);
 
 inline bool operator!=(const ObjectValue& lhs, const ObjectValue& rhs) {
   return !(lhs == rhs);
@@ -141,7 +192,7 @@ inline bool operator!=(const ObjectValue& lhs, const ObjectValue& rhs) {
 
 inline std::ostream& operator<<(std::ostream& out,
                                 const ObjectValue& object_value) {
-  return out << "ObjectValue(" << *object_value.value_ << ")";
+  return out << "ObjectValue(" << object_value.Materialize() << ")";
 }
 
 }  // namespace model
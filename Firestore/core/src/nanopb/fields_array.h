@@ -129,6 +129,11 @@ inline const pb_field_t* FieldsArray<google_firestore_v1_Target_QueryTarget>() {
   return google_firestore_v1_Target_QueryTarget_fields;
 }
 
+template <>
+inline const pb_field_t* FieldsArray<google_firestore_v1_Document>() {
+  return google_firestore_v1_Document_fields;
+}
+
 template <>
 inline const pb_field_t* FieldsArray<google_firestore_v1_Value>() {
   return google_firestore_v1_Value_fields;
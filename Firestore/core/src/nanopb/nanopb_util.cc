@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/nanopb/nanopb_util.h"
 
+#include <pb_decode.h>
+
 #include <cstdlib>
 
 #include "Firestore/core/src/util/hard_assert.h"
@@ -78,6 +80,48 @@ absl::string_view MakeStringView(const ByteString& bytes) {
   return absl::string_view{str, bytes.size()};
 }
 
+bool ForEachEncodedField(
+    absl::string_view message,
+    const std::function<bool(const EncodedField&)>& visitor) {
+  const auto* data = reinterpret_cast<const uint8_t*>(message.data());
+  pb_istream_t stream = pb_istream_from_buffer(data, message.size());
+
+  pb_wire_type_t wire_type;
+  uint32_t tag;
+  bool eof;
+  while (pb_decode_tag(&stream, &wire_type, &tag, &eof)) {
+    EncodedField field;
+    field.tag = tag;
+
+    switch (wire_type) {
+      case PB_WT_VARINT:
+        if (!pb_decode_varint(&stream, &field.varint)) return false;
+        break;
+
+      case PB_WT_STRING: {
+        uint32_t size;
+        if (!pb_decode_varint32(&stream, &size) || size > stream.bytes_left) {
+          return false;
+        }
+        size_t offset = message.size() - stream.bytes_left;
+        field.bytes = message.substr(offset, size);
+        // Advance past the payload without copying it.
+        if (!pb_read(&stream, nullptr, size)) return false;
+        break;
+      }
+
+      default:
+        if (!pb_skip_field(&stream, wire_type)) return false;
+        continue;
+    }
+
+    if (!visitor(field)) return true;
+  }
+
+  // `pb_decode_tag` also fails on a clean end of the stream.
+  return eof;
+}
+
 }  // namespace nanopb
 }  // namespace firestore
 }  // namespace firebase
@@ -19,7 +19,9 @@
 
 #include <pb.h>
 
+#include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -30,6 +32,7 @@
 #include "Firestore/core/src/util/nullability.h"
 #include "absl/base/casts.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
 
 namespace firebase {
 namespace firestore {
@@ -166,6 +169,36 @@ void ReleaseFieldOwnership(T* _Nonnull fields, pb_size_t fields_count) {
   }
 }
 
+/** A single top-level field of an encoded Nanopb proto. */
+struct EncodedField {
+  /** The field number, as declared in the `.proto` file. */
+  uint32_t tag = 0;
+
+  /**
+   * The payload of a length-delimited field (strings, bytes and nested
+   * messages). Points into the buffer passed to `ForEachEncodedField`.
+   */
+  absl::string_view bytes;
+
+  /** The value of a varint field (integers, bools and enums). */
+  uint64_t varint = 0;
+};
+
+/**
+ * Walks the top-level fields of the encoded proto in `message` without
+ * decoding it, invoking `visitor` for each length-delimited and varint field.
+ * Fixed-width fields are skipped. The walk stops early if `visitor` returns
+ * false.
+ *
+ * This allows reading a few fields of a large message (or locating a nested
+ * message to decode later) without allocating the whole Nanopb struct.
+ *
+ * @return false if `message` is not a well-formed proto.
+ */
+bool ForEachEncodedField(
+    absl::string_view message,
+    const std::function<bool(const EncodedField&)>& visitor);
+
 #if __OBJC__
 inline ByteString MakeByteString(NSData* _Nullable value) {
   if (value == nil) return ByteString();
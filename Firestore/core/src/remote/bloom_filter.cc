@@ -0,0 +1,111 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/bloom_filter.h"
+
+#include <utility>
+
+#include "Firestore/core/src/util/md5.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/string_format.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using util::Md5Digest;
+using util::Status;
+using util::StatusOr;
+using util::StringFormat;
+
+uint64_t LoadLittleEndian64(const uint8_t* bytes) {
+  uint64_t result = 0;
+  for (int i = 7; i >= 0; --i) {
+    result = (result << 8) | bytes[i];
+  }
+  return result;
+}
+
+}  // namespace
+
+StatusOr<BloomFilter> BloomFilter::Create(std::vector<uint8_t> bitmap,
+                                          int32_t padding,
+                                          int32_t hash_count) {
+  if (padding < 0 || padding >= 8) {
+    return Status{Error::kErrorInvalidArgument,
+                  StringFormat("Invalid padding: %s", padding)};
+  }
+  if (hash_count < 0) {
+    return Status{Error::kErrorInvalidArgument,
+                  StringFormat("Invalid hash count: %s", hash_count)};
+  }
+  if (bitmap.empty() && (padding != 0 || hash_count != 0)) {
+    return Status{Error::kErrorInvalidArgument,
+                  StringFormat("Expected padding and hash count of an empty "
+                               "bloom filter to be 0, got %s and %s",
+                               padding, hash_count)};
+  }
+  if (!bitmap.empty() && hash_count == 0) {
+    return Status{Error::kErrorInvalidArgument,
+                  "Invalid hash count of a non-empty bloom filter: 0"};
+  }
+
+  auto bit_count = static_cast<int32_t>(bitmap.size() * 8) - padding;
+  return BloomFilter{std::move(bitmap), bit_count, hash_count};
+}
+
+BloomFilter::BloomFilter(std::vector<uint8_t> bitmap,
+                         int32_t bit_count,
+                         int32_t hash_count)
+    : bitmap_{std::move(bitmap)},
+      bit_count_{bit_count},
+      hash_count_{hash_count} {
+}
+
+bool BloomFilter::MightContain(absl::string_view value) const {
+  // An empty filter was built from no entries at all.
+  if (bit_count_ == 0) {
+    return false;
+  }
+
+  Md5Digest digest = util::CalculateMd5Digest(value);
+  uint64_t h1 = LoadLittleEndian64(digest.data());
+  uint64_t h2 = LoadLittleEndian64(digest.data() + 8);
+
+  // Unsigned arithmetic wraps around modulo 2^64, as the backend's does.
+  for (int32_t i = 0; i < hash_count_; ++i) {
+    uint64_t combined = h1 + static_cast<uint64_t>(i) * h2;
+    if (!IsBitSet(combined % static_cast<uint64_t>(bit_count_))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BloomFilter::IsBitSet(uint64_t index) const {
+  uint8_t byte = bitmap_[index / 8];
+  return (byte & (1 << (index % 8))) != 0;
+}
+
+bool operator==(const BloomFilter& lhs, const BloomFilter& rhs) {
+  return lhs.bit_count() == rhs.bit_count() &&
+         lhs.hash_count() == rhs.hash_count() && lhs.bitmap() == rhs.bitmap();
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
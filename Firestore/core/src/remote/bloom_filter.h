@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_REMOTE_BLOOM_FILTER_H_
+#define FIRESTORE_CORE_SRC_REMOTE_BLOOM_FILTER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Firestore/core/src/util/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+/**
+ * A bloom filter as sent by the backend in existence filters, over the names of
+ * the documents in a target.
+ *
+ * Entries are hashed with MD5, whose digest is read as two little-endian 64-bit
+ * hashes `h1` and `h2`. The `i`-th bit for an entry is then
+ * `(h1 + i * h2) % bit_count`, for `i` in `[0, hash_count)`.
+ */
+class BloomFilter {
+ public:
+  /**
+   * Creates a bloom filter from its bitmap, the number of padding bits at the
+   * end of the bitmap and the number of hashes per entry. Returns an error if
+   * these are inconsistent with each other.
+   */
+  static util::StatusOr<BloomFilter> Create(std::vector<uint8_t> bitmap,
+                                            int32_t padding,
+                                            int32_t hash_count);
+
+  /**
+   * Returns false if `value` was definitely not added to the filter, and true
+   * if it probably was.
+   */
+  bool MightContain(absl::string_view value) const;
+
+  const std::vector<uint8_t>& bitmap() const {
+    return bitmap_;
+  }
+
+  int32_t bit_count() const {
+    return bit_count_;
+  }
+
+  int32_t hash_count() const {
+    return hash_count_;
+  }
+
+ private:
+  BloomFilter(std::vector<uint8_t> bitmap,
+              int32_t bit_count,
+              int32_t hash_count);
+
+  bool IsBitSet(uint64_t index) const;
+
+  std::vector<uint8_t> bitmap_;
+  int32_t bit_count_ = 0;
+  int32_t hash_count_ = 0;
+};
+
+bool operator==(const BloomFilter& lhs, const BloomFilter& rhs);
+
+inline bool operator!=(const BloomFilter& lhs, const BloomFilter& rhs) {
+  return !(lhs == rhs);
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_REMOTE_BLOOM_FILTER_H_
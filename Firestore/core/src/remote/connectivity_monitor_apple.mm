@@ -144,7 +144,7 @@ class ConnectivityMonitorApple : public ConnectivityMonitor {
     SCNetworkReachabilityFlags flags{};
     if (!SCNetworkReachabilityGetFlags(reachability_, &flags)) return;
 
-    queue()->Enqueue([this, flags] {
+    queue()->Enqueue("ConnectivityMonitor::OnEnteredForeground", [this, flags] {
       auto status = ToNetworkStatus(flags);
       if (status != NetworkStatus::Unavailable) {
         // There may have been network changes while Firestore was in the
@@ -162,6 +162,7 @@ class ConnectivityMonitorApple : public ConnectivityMonitor {
 
   void OnReachabilityChanged(SCNetworkReachabilityFlags flags) {
     queue()->Enqueue(
+        "ConnectivityMonitor::OnReachabilityChanged",
         [this, flags] { MaybeInvokeCallbacks(ToNetworkStatus(flags)); });
   }
 
@@ -287,6 +287,7 @@ void Datastore::ResumeRpcWithCredentials(const OnCredentials& on_credentials) {
     const std::string& app_check_token = credentials->app_check;
 
     strong_this->worker_queue_->EnqueueRelaxed(
+        "Datastore::ResumeRpcWithCredentials",
         [weak_this, auth_token, app_check_token, on_credentials] {
           auto strong_this = weak_this.lock();
           if (!strong_this) {
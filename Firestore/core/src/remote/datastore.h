@@ -101,6 +101,11 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
   virtual std::shared_ptr<WriteStream> CreateWriteStream(
       WriteStreamCallback* callback);
 
+  /** Returns the ID of the database that this datastore reads and writes. */
+  const model::DatabaseId& database_id() const {
+    return datastore_serializer_.serializer().database_id();
+  }
+
   void CommitMutations(const std::vector<model::Mutation>& mutations,
                        CommitCallback&& callback);
   void LookupDocuments(const std::vector<model::DocumentKey>& keys,
@@ -101,8 +101,9 @@ void ExponentialBackoff::BackoffAndRun(AsyncQueue::Operation&& operation) {
         desired_delay_with_jitter.count(), delay_so_far.count());
   }
 
-  delayed_operation_ =
-      queue_->EnqueueAfterDelay(remaining_delay, timer_id_, [this, operation] {
+  delayed_operation_ = queue_->EnqueueAfterDelay(
+      remaining_delay, timer_id_, "ExponentialBackoff::BackoffAndRun",
+      [this, operation] {
         last_attempt_time_ = chr::steady_clock::now();
         operation();
       });
@@ -22,6 +22,24 @@
 namespace firebase {
 namespace firestore {
 namespace remote {
+namespace {
+
+// Labels the operations that deliver completions in `AsyncQueue` statistics.
+const char* LabelFor(GrpcCompletion::Type type) {
+  switch (type) {
+    case GrpcCompletion::Type::Start:
+      return "GrpcCompletion::Start";
+    case GrpcCompletion::Type::Read:
+      return "GrpcCompletion::Read";
+    case GrpcCompletion::Type::Write:
+      return "GrpcCompletion::Write";
+    case GrpcCompletion::Type::Finish:
+      return "GrpcCompletion::Finish";
+  }
+  return nullptr;
+}
+
+}  // namespace
 
 using util::AsyncQueue;
 
@@ -90,7 +108,7 @@ void GrpcCompletion::Complete(bool ok) {
   // operation run. If this weren't a retain that ordering would have the
   // callback use after free.
   auto shared_this = grpc_ownership_;
-  worker_queue_->Enqueue([shared_this, ok] {
+  worker_queue_->Enqueue(LabelFor(type_), [shared_this, ok] {
     if (shared_this->callback_) {
       shared_this->callback_(ok, shared_this);
     }
@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/remote/grpc_nanopb.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "Firestore/core/include/firebase/firestore/firestore_errors.h"
@@ -28,13 +30,11 @@ namespace firebase {
 namespace firestore {
 namespace remote {
 
-using nanopb::ByteString;
-using nanopb::ByteStringWriter;
 using util::Status;
 
 ByteBufferReader::ByteBufferReader(const grpc::ByteBuffer& buffer) {
-  std::vector<grpc::Slice> slices;
-  grpc::Status status = buffer.Dump(&slices);
+  // Dumping only takes references to the slices, their bytes aren't copied.
+  grpc::Status status = buffer.Dump(&slices_);
   // Conversion may fail if compression is used and gRPC tries to decompress an
   // ill-formed buffer.
   if (!status.ok()) {
@@ -45,14 +45,16 @@ ByteBufferReader::ByteBufferReader(const grpc::ByteBuffer& buffer) {
     return;
   }
 
-  ByteStringWriter writer;
-  writer.Reserve(buffer.Length());
-  for (const auto& slice : slices) {
-    writer.Append(slice.begin(), slice.size());
+  // Most buffers hold a single slice, which nanopb can read directly without
+  // going through the callback.
+  if (slices_.size() == 1) {
+    stream_ = pb_istream_from_buffer(slices_[0].begin(), slices_[0].size());
+    return;
   }
 
-  bytes_ = writer.Release();
-  stream_ = pb_istream_from_buffer(bytes_.data(), bytes_.size());
+  stream_.callback = ReadFromSlices;
+  stream_.state = this;
+  stream_.bytes_left = buffer.Length();
 }
 
 void ByteBufferReader::Read(const pb_field_t* fields, void* dest_struct) {
@@ -63,6 +65,35 @@ void ByteBufferReader::Read(const pb_field_t* fields, void* dest_struct) {
   }
 }
 
+bool ByteBufferReader::ReadFromSlices(pb_istream_t* stream,
+                                      pb_byte_t* buf,
+                                      size_t count) {
+  auto reader = static_cast<ByteBufferReader*>(stream->state);
+  const std::vector<grpc::Slice>& slices = reader->slices_;
+
+  while (count > 0) {
+    if (reader->slice_index_ == slices.size()) {
+      PB_RETURN_ERROR(stream, "end-of-stream");
+    }
+
+    const grpc::Slice& slice = slices[reader->slice_index_];
+    size_t to_read = std::min(count, slice.size() - reader->slice_offset_);
+    // Nanopb passes no buffer when it skips over bytes.
+    if (buf) {
+      std::memcpy(buf, slice.begin() + reader->slice_offset_, to_read);
+      buf += to_read;
+    }
+    count -= to_read;
+
+    reader->slice_offset_ += to_read;
+    if (reader->slice_offset_ == slice.size()) {
+      ++reader->slice_index_;
+      reader->slice_offset_ = 0;
+    }
+  }
+  return true;
+}
+
 namespace {
 
 bool AppendToGrpcBuffer(pb_ostream_t* stream,
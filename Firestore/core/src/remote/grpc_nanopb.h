@@ -20,9 +20,9 @@
 #include <pb.h>
 #include <pb_decode.h>
 
+#include <cstddef>
 #include <vector>
 
-#include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/nanopb/writer.h"
@@ -32,20 +32,37 @@ namespace firebase {
 namespace firestore {
 namespace remote {
 
-/** A `Reader` that reads from the given `grpc::ByteBuffer`. */
+/**
+ * A `Reader` that reads from the given `grpc::ByteBuffer`.
+ *
+ * Nanopb decodes straight from the slices of the buffer; fields that span
+ * several slices are assembled as they are read, without first copying the
+ * whole buffer into contiguous memory. A buffer with a single slice is read
+ * as a plain memory buffer.
+ */
 class ByteBufferReader : public nanopb::Reader {
  public:
   /**
-   * Copies the given `buffer` and associates the resulting stream with this
-   * `ByteBufferReader`.
+   * Associates the slices of the given `buffer` with this `ByteBufferReader`.
+   * The slices share ownership of their bytes, so `buffer` doesn't have to
+   * outlive the reader.
    */
-  // TODO(varconst): avoid copying the buffer.
   explicit ByteBufferReader(const grpc::ByteBuffer& buffer);
 
+  ByteBufferReader(const ByteBufferReader&) = delete;
+  ByteBufferReader& operator=(const ByteBufferReader&) = delete;
+
   void Read(const pb_field_t* fields, void* dest_struct) override;
 
  private:
-  nanopb::ByteString bytes_;
+  static bool ReadFromSlices(pb_istream_t* stream,
+                             pb_byte_t* buf,
+                             size_t count);
+
+  std::vector<grpc::Slice> slices_;
+  // The position of the next byte to read.
+  size_t slice_index_ = 0;
+  size_t slice_offset_ = 0;
   pb_istream_t stream_{};
 };
 
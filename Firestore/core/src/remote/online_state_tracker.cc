@@ -61,7 +61,8 @@ void OnlineStateTracker::HandleWatchStreamStart() {
   HARD_ASSERT(!online_state_timer_,
               "online_state_timer_ shouldn't be started yet");
   online_state_timer_ = worker_queue_->EnqueueAfterDelay(
-      kOnlineStateTimeout, TimerId::OnlineStateTimeout, [this] {
+      kOnlineStateTimeout, TimerId::OnlineStateTimeout,
+      "OnlineStateTracker::OnlineStateTimeout", [this] {
         online_state_timer_ = {};
 
         HARD_ASSERT(state_ == OnlineState::Unknown,
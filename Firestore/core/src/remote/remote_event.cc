@@ -16,9 +16,13 @@
 
 #include "Firestore/core/src/remote/remote_event.h"
 
+#include <algorithm>
+#include <string>
 #include <utility>
 
 #include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/remote/bloom_filter.h"
+#include "absl/strings/str_cat.h"
 
 namespace firebase {
 namespace firestore {
@@ -28,6 +32,7 @@ using core::DocumentViewChange;
 using core::Target;
 using local::QueryPurpose;
 using local::TargetData;
+using model::DatabaseId;
 using model::DocumentKey;
 using model::DocumentKeySet;
 using model::MutableDocument;
@@ -37,6 +42,79 @@ using nanopb::ByteString;
 
 // TargetChange
 
+namespace {
+
+enum class Membership {
+  Unchanged,
+  Added,
+  Modified,
+  Removed,
+};
+
+Membership GetMembership(const TargetChange& change, const DocumentKey& key) {
+  if (change.added_documents().contains(key)) {
+    return Membership::Added;
+  } else if (change.modified_documents().contains(key)) {
+    return Membership::Modified;
+  } else if (change.removed_documents().contains(key)) {
+    return Membership::Removed;
+  }
+  return Membership::Unchanged;
+}
+
+/** Returns the prefix of the names of the documents in the given database. */
+std::string DocumentNamePrefix(const DatabaseId& database_id) {
+  return absl::StrCat("projects/", database_id.project_id(), "/databases/",
+                      database_id.database_id(), "/documents/");
+}
+
+}  // namespace
+
+TargetChange TargetChange::Coalesce(const TargetChange& earlier,
+                                    const TargetChange& later) {
+  DocumentKeySet keys = earlier.added_documents()
+                            .union_with(earlier.modified_documents())
+                            .union_with(earlier.removed_documents())
+                            .union_with(later.added_documents())
+                            .union_with(later.modified_documents())
+                            .union_with(later.removed_documents());
+
+  DocumentKeySet added;
+  DocumentKeySet modified;
+  DocumentKeySet removed;
+  for (const DocumentKey& key : keys) {
+    Membership first = GetMembership(earlier, key);
+    Membership second = GetMembership(later, key);
+
+    // Whether the document belonged to the target before `earlier`, and
+    // whether it does after `later`.
+    bool before = first == Membership::Modified ||
+                  first == Membership::Removed ||
+                  (first == Membership::Unchanged &&
+                   (second == Membership::Modified ||
+                    second == Membership::Removed));
+    bool after = second == Membership::Added ||
+                 second == Membership::Modified ||
+                 (second == Membership::Unchanged &&
+                  (first == Membership::Added ||
+                   first == Membership::Modified));
+
+    if (!before && after) {
+      added = added.insert(key);
+    } else if (before && after) {
+      modified = modified.insert(key);
+    } else if (before && !after) {
+      removed = removed.insert(key);
+    }
+  }
+
+  const ByteString& resume_token = later.resume_token().empty()
+                                       ? earlier.resume_token()
+                                       : later.resume_token();
+  return TargetChange{resume_token, later.current(), std::move(added),
+                      std::move(modified), std::move(removed)};
+}
+
 bool operator==(const TargetChange& lhs, const TargetChange& rhs) {
   return lhs.resume_token() == rhs.resume_token() &&
          lhs.current() == rhs.current() &&
@@ -45,6 +123,44 @@ bool operator==(const TargetChange& lhs, const TargetChange& rhs) {
          lhs.removed_documents() == rhs.removed_documents();
 }
 
+// RemoteEvent
+
+RemoteEvent RemoteEvent::Coalesce(const RemoteEvent& earlier,
+                                  const RemoteEvent& later) {
+  TargetChangeMap target_changes = earlier.target_changes();
+  for (const auto& entry : later.target_changes()) {
+    auto found = target_changes.find(entry.first);
+    if (found == target_changes.end()) {
+      target_changes.emplace(entry.first, entry.second);
+    } else {
+      found->second = TargetChange::Coalesce(found->second, entry.second);
+    }
+  }
+
+  TargetSet target_mismatches = earlier.target_mismatches();
+  target_mismatches.insert(later.target_mismatches().begin(),
+                           later.target_mismatches().end());
+
+  model::DocumentUpdateMap document_updates = earlier.document_updates();
+  for (const auto& entry : later.document_updates()) {
+    document_updates[entry.first] = entry.second;
+  }
+
+  // A document is only a limbo change if its latest update came from limbo
+  // resolution alone.
+  DocumentKeySet limbo_document_changes = later.limbo_document_changes();
+  for (const DocumentKey& key : earlier.limbo_document_changes()) {
+    if (later.document_updates().find(key) == later.document_updates().end()) {
+      limbo_document_changes = limbo_document_changes.insert(key);
+    }
+  }
+
+  return RemoteEvent{
+      std::max(earlier.snapshot_version(), later.snapshot_version()),
+      std::move(target_changes), std::move(target_mismatches),
+      std::move(document_updates), std::move(limbo_document_changes)};
+}
+
 // TargetState
 
 void TargetState::UpdateResumeToken(ByteString resume_token) {
@@ -215,28 +331,28 @@ void WatchChangeAggregator::HandleExistenceFilter(
   absl::optional<TargetData> target_data = TargetDataForActiveTarget(target_id);
   if (target_data) {
     const Target& target = target_data->target();
-    if (target.IsDocumentQuery()) {
-      if (expected_count == 0) {
-        // The existence filter told us the document does not exist. We deduce
-        // that this document does not exist and apply a deleted document to our
-        // updates. Without applying this deleted document there might be
-        // another query that will raise this document as part of a snapshot
-        // until it is resolved, essentially exposing inconsistency between
-        // queries.
-        DocumentKey key{target.path()};
+    if (target.IsDocumentsTarget() && expected_count == 0) {
+      // The existence filter told us the documents do not exist. We deduce
+      // that these documents do not exist and apply deleted documents to our
+      // updates. Without applying these deleted documents there might be
+      // another query that will raise them as part of a snapshot until they
+      // are resolved, essentially exposing inconsistency between queries.
+      for (const DocumentKey& key : target.GetDocumentKeys()) {
         RemoveDocumentFromTarget(
             target_id, key,
             MutableDocument::NoDocument(key, SnapshotVersion::None()));
-      } else {
-        HARD_ASSERT(expected_count == 1,
-                    "Single document existence filter with count: %s",
-                    expected_count);
       }
+    } else if (target.IsDocumentQuery()) {
+      HARD_ASSERT(expected_count == 1,
+                  "Single document existence filter with count: %s",
+                  expected_count);
     } else {
       int current_size = GetCurrentDocumentCountForTarget(target_id);
-      if (current_size != expected_count) {
-        // Existence filter mismatch: We reset the mapping and raise a new
-        // snapshot with `isFromCache:true`.
+      if (current_size != expected_count &&
+          !ApplyBloomFilter(existence_filter.filter(), target_id,
+                            current_size)) {
+        // Existence filter mismatch that the bloom filter couldn't resolve: We
+        // reset the mapping and raise a new snapshot with `isFromCache:true`.
         ResetTarget(target_id);
         pending_target_resets_.insert(target_id);
       }
@@ -255,19 +371,21 @@ RemoteEvent WatchChangeAggregator::CreateRemoteEvent(
     absl::optional<TargetData> target_data =
         TargetDataForActiveTarget(target_id);
     if (target_data) {
-      if (target_state.current() && target_data->target().IsDocumentQuery()) {
-        // Document queries for document that don't exist can produce an empty
-        // result set. To update our local cache, we synthesize a document
-        // delete if we have not previously received the document. This resolves
-        // the limbo state of the document, removing it from
+      const Target& target = target_data->target();
+      if (target_state.current() && target.IsDocumentsTarget()) {
+        // Targets for documents that don't exist can produce an empty result
+        // set. To update our local cache, we synthesize a document delete for
+        // each document that we have not previously received. This resolves
+        // the limbo state of the documents, removing them from
         // SyncEngine::limbo_document_refs_.
-        DocumentKey key{target_data->target().path()};
-        if (pending_document_updates_.find(key) ==
-                pending_document_updates_.end() &&
-            !TargetContainsDocument(target_id, key)) {
-          RemoveDocumentFromTarget(
-              target_id, key,
-              MutableDocument::NoDocument(key, snapshot_version));
+        for (const DocumentKey& key : target.GetDocumentKeys()) {
+          if (pending_document_updates_.find(key) ==
+                  pending_document_updates_.end() &&
+              !TargetContainsDocument(target_id, key)) {
+            RemoveDocumentFromTarget(
+                target_id, key,
+                MutableDocument::NoDocument(key, snapshot_version));
+          }
         }
       }
 
@@ -370,6 +488,41 @@ int WatchChangeAggregator::GetCurrentDocumentCountForTarget(
          target_change.removed_documents().size();
 }
 
+bool WatchChangeAggregator::ApplyBloomFilter(
+    const ExistenceFilter& existence_filter,
+    TargetId target_id,
+    int current_count) {
+  const absl::optional<BloomFilter>& unchanged_names =
+      existence_filter.unchanged_names();
+  // An empty bloom filter can't tell any documents apart, so the target is
+  // reset as if there was none.
+  if (!unchanged_names || unchanged_names->bit_count() == 0) {
+    return false;
+  }
+
+  // Documents with pending changes were sent since the resume token, so the
+  // bloom filter of unchanged documents says nothing about them.
+  TargetChange pending_changes = EnsureTargetState(target_id).ToTargetChange();
+  std::string name_prefix =
+      DocumentNamePrefix(target_metadata_provider_->GetDatabaseId());
+
+  int removed_count = 0;
+  DocumentKeySet existing_keys =
+      target_metadata_provider_->GetRemoteKeysForTarget(target_id);
+  for (const DocumentKey& key : existing_keys) {
+    if (GetMembership(pending_changes, key) != Membership::Unchanged) {
+      continue;
+    }
+    std::string name = name_prefix + key.path().CanonicalString();
+    if (!unchanged_names->MightContain(name)) {
+      RemoveDocumentFromTarget(target_id, key, absl::nullopt);
+      ++removed_count;
+    }
+  }
+
+  return current_count - removed_count == existence_filter.count();
+}
+
 void WatchChangeAggregator::RecordPendingTargetRequest(TargetId target_id) {
   // For each request we get we need to record we need a response for it.
   TargetState& target_state = EnsureTargetState(target_id);
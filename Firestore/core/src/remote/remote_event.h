@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "Firestore/core/src/core/view_snapshot.h"
+#include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/mutable_document.h"
@@ -62,6 +63,9 @@ class TargetMetadataProvider {
    */
   virtual absl::optional<local::TargetData> GetTargetDataForTarget(
       model::TargetId target_id) const = 0;
+
+  /** Returns the ID of the database that the targets are listened to in. */
+  virtual const model::DatabaseId& GetDatabaseId() const = 0;
 };
 
 /**
@@ -79,6 +83,14 @@ class TargetChange {
     return TargetChange(current);
   }
 
+  /**
+   * Combines the changes to one target from two consecutive remote events. The
+   * document changes in `later` must have been computed relative to the state
+   * after `earlier` was applied.
+   */
+  static TargetChange Coalesce(const TargetChange& earlier,
+                               const TargetChange& later);
+
   TargetChange() = default;
 
   TargetChange(nanopb::ByteString resume_token,
@@ -255,6 +267,13 @@ class RemoteEvent {
         limbo_document_changes_{std::move(limbo_document_changes)} {
   }
 
+  /**
+   * Combines two consecutive remote events into one that has the same effect
+   * on the local store as applying `earlier` followed by `later`.
+   */
+  static RemoteEvent Coalesce(const RemoteEvent& earlier,
+                              const RemoteEvent& later);
+
   /** The snapshot version this event brings us up to. */
   const model::SnapshotVersion& snapshot_version() const {
     return snapshot_version_;
@@ -317,8 +336,9 @@ class WatchChangeAggregator {
 
   /**
    * Handles existence filters and synthesizes deletes for filter mismatches.
-   * Targets that are invalidated by filter mismatches are added to
-   * `pending_target_resets_`.
+   * Documents that the bloom filter of a mismatched existence filter shows to
+   * no longer match are removed from the target. Targets that are still
+   * invalidated by filter mismatches are added to `pending_target_resets_`.
    */
   void HandleExistenceFilter(
       const ExistenceFilterWatchChange& existence_filter);
@@ -374,6 +394,17 @@ class WatchChangeAggregator {
    */
   int GetCurrentDocumentCountForTarget(model::TargetId target_id);
 
+  /**
+   * Removes the documents of the target that are definitely absent from the
+   * bloom filter of `existence_filter`. Returns true if the target then has as
+   * many documents as `existence_filter` counts, such that it doesn't need to
+   * be reset, and false if there is no usable bloom filter or if false
+   * positives of the bloom filter leave the counts different.
+   */
+  bool ApplyBloomFilter(const ExistenceFilter& existence_filter,
+                        model::TargetId target_id,
+                        int current_count);
+
   // PORTING NOTE: this method exists only for consistency with other platforms;
   // in C++, it's pretty much unnecessary.
   TargetState& EnsureTargetState(model::TargetId target_id);
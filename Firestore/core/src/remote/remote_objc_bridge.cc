@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/remote/remote_objc_bridge.h"
 
+#include <pb_encode.h>
+
 #include <map>
 
 #include "Firestore/core/src/core/database_info.h"
@@ -48,6 +50,7 @@ using model::SnapshotVersion;
 using model::TargetId;
 using nanopb::ByteString;
 using nanopb::MakeArray;
+using nanopb::MakeMessage;
 using nanopb::Message;
 using nanopb::Reader;
 using remote::ByteBufferReader;
@@ -132,6 +135,15 @@ WriteStreamSerializer::EncodeHandshake() const {
   return result;
 }
 
+Message<google_firestore_v1_WriteRequest>
+WriteStreamSerializer::EncodeHandshake(
+    const ByteString& stream_id, const ByteString& last_stream_token) const {
+  Message<google_firestore_v1_WriteRequest> result = EncodeHandshake();
+  result->stream_id = nanopb::CopyBytesArray(stream_id.get());
+  result->stream_token = nanopb::CopyBytesArray(last_stream_token.get());
+  return result;
+}
+
 Message<google_firestore_v1_WriteRequest>
 WriteStreamSerializer::EncodeWriteMutationsRequest(
     const std::vector<Mutation>& mutations,
@@ -158,6 +170,15 @@ WriteStreamSerializer::EncodeEmptyMutationsList(
   return EncodeWriteMutationsRequest({}, last_stream_token);
 }
 
+size_t WriteStreamSerializer::EncodedMutationSize(
+    const Mutation& mutation) const {
+  Message<google_firestore_v1_Write> write =
+      MakeMessage(serializer_.EncodeMutation(mutation));
+  size_t size = 0;
+  pb_get_encoded_size(&size, write.fields(), write.get());
+  return size;
+}
+
 Message<google_firestore_v1_WriteResponse> WriteStreamSerializer::ParseResponse(
     Reader* reader) const {
   return Message<google_firestore_v1_WriteResponse>::TryParse(reader);
@@ -94,11 +94,17 @@ class WriteStreamSerializer {
   explicit WriteStreamSerializer(Serializer serializer);
 
   nanopb::Message<google_firestore_v1_WriteRequest> EncodeHandshake() const;
+  /** Encodes a handshake that resumes the stream with the given ID. */
+  nanopb::Message<google_firestore_v1_WriteRequest> EncodeHandshake(
+      const nanopb::ByteString& stream_id,
+      const nanopb::ByteString& last_stream_token) const;
   nanopb::Message<google_firestore_v1_WriteRequest> EncodeWriteMutationsRequest(
       const std::vector<model::Mutation>& mutations,
       const nanopb::ByteString& last_stream_token) const;
   nanopb::Message<google_firestore_v1_WriteRequest> EncodeEmptyMutationsList(
       const nanopb::ByteString& last_stream_token) const;
+  /** Returns the size of the given mutation once encoded as a write. */
+  size_t EncodedMutationSize(const model::Mutation& mutation) const;
 
   nanopb::Message<google_firestore_v1_WriteResponse> ParseResponse(
       nanopb::Reader* reader) const;
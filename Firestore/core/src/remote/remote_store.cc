@@ -16,8 +16,11 @@
 
 #include "Firestore/core/src/remote/remote_store.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/core/transaction.h"
 #include "Firestore/core/src/local/local_store.h"
@@ -40,8 +43,10 @@ using local::LocalStore;
 using local::QueryPurpose;
 using local::TargetData;
 using model::BatchId;
+using model::DatabaseId;
 using model::DocumentKeySet;
 using model::kBatchIdUnknown;
+using model::Mutation;
 using model::MutationBatch;
 using model::MutationBatchResult;
 using model::MutationResult;
@@ -52,11 +57,20 @@ using nanopb::ByteString;
 using util::AsyncQueue;
 using util::Status;
 
+/** The backend accepts at most this many writes in one request. */
+constexpr size_t kMaxMutationsPerWriteRequest = 500;
+
+/**
+ * Coalesced batches add up to at most this many bytes of mutations, which
+ * leaves room for the rest of the request under the backend's 10 MiB limit.
+ */
+constexpr size_t kMaxCoalescedWriteBytes = 9 * 1024 * 1024;
+
 /**
- * The maximum number of pending writes to allow.
- * TODO(b/35853402): Negotiate this value with the backend.
+ * How long a resumed write stream may go without responding to the writes
+ * that were sent before it was resumed.
  */
-constexpr int kMaxPendingWrites = 10;
+const AsyncQueue::Milliseconds kResumedWritesTimeout{std::chrono::seconds(10)};
 
 RemoteStore::RemoteStore(
     LocalStore* local_store,
@@ -66,8 +80,10 @@ RemoteStore::RemoteStore(
     std::function<void(model::OnlineState)> online_state_handler)
     : local_store_{local_store},
       datastore_{std::move(datastore)},
+      worker_queue_{worker_queue},
       online_state_tracker_{worker_queue, std::move(online_state_handler)},
-      connectivity_monitor_{NOT_NULL(connectivity_monitor)} {
+      connectivity_monitor_{NOT_NULL(connectivity_monitor)},
+      write_coalescing_max_bytes_{kMaxCoalescedWriteBytes} {
   datastore_->Start();
 
   // Create streams (but note they're not started yet)
@@ -133,6 +149,10 @@ void RemoteStore::DisableNetworkInternal() {
               write_pipeline_.size());
     write_pipeline_.clear();
   }
+  // The pipeline is refilled from the `LocalStore` and sent on a new stream.
+  sent_write_requests_.clear();
+  uncoalesced_batches_ = 0;
+  write_stream_->set_stream_id({});
 
   CleanUpWatchStreamState();
 }
@@ -193,7 +213,16 @@ void RemoteStore::SendWatchRequest(const TargetData& target_data) {
   // We need to increment the expected number of pending responses we're due
   // from watch so we wait for the ack to process any messages from this target.
   watch_change_aggregator_->RecordPendingTargetRequest(target_data.target_id());
-  watch_stream_->WatchQuery(target_data);
+
+  // When resuming, tell watch how many documents we think match the target so
+  // that it can send a bloom filter along with a mismatching existence filter.
+  if (!target_data.resume_token().empty()) {
+    int32_t expected_count = static_cast<int32_t>(
+        GetRemoteKeysForTarget(target_data.target_id()).size());
+    watch_stream_->WatchQuery(target_data.WithExpectedCount(expected_count));
+  } else {
+    watch_stream_->WatchQuery(target_data);
+  }
 }
 
 void RemoteStore::SendUnwatchRequest(TargetId target_id) {
@@ -219,6 +248,9 @@ void RemoteStore::StartWatchStream() {
 }
 
 void RemoteStore::CleanUpWatchStreamState() {
+  // The held back snapshot is consistent, so it is applied rather than
+  // dropped along with the aggregator.
+  FlushCoalescedRemoteEvent();
   watch_change_aggregator_.reset();
 }
 
@@ -348,12 +380,73 @@ void RemoteStore::RaiseWatchSnapshot(const SnapshotVersion& snapshot_version) {
   }
 
   // Finally handle remote event
+  ApplyOrCoalesceRemoteEvent(std::move(remote_event));
+}
+
+void RemoteStore::ApplyOrCoalesceRemoteEvent(RemoteEvent remote_event) {
+  // Events with mismatches reset their targets, which is only done on the
+  // event that reports them.
+  if (watch_coalescing_window_.count() <= 0 ||
+      !remote_event.target_mismatches().empty()) {
+    FlushCoalescedRemoteEvent();
+    sync_engine_->ApplyRemoteEvent(remote_event);
+    return;
+  }
+
+  if (coalesced_remote_event_) {
+    if (CanCoalesce(*coalesced_remote_event_, remote_event)) {
+      coalesced_remote_event_ =
+          RemoteEvent::Coalesce(*coalesced_remote_event_, remote_event);
+      return;
+    }
+    FlushCoalescedRemoteEvent();
+  }
+
+  // The timer is not pushed back by later snapshots, which bounds the latency
+  // added to the first one.
+  coalesced_remote_event_ = std::move(remote_event);
+  coalescing_timer_ = worker_queue_->EnqueueAfterDelay(
+      watch_coalescing_window_, util::TimerId::WatchSnapshotCoalescing,
+      "RemoteStore::FlushCoalescedRemoteEvent", [this] {
+        coalescing_timer_ = {};
+        FlushCoalescedRemoteEvent();
+      });
+}
+
+bool RemoteStore::CanCoalesce(const RemoteEvent& earlier,
+                              const RemoteEvent& later) const {
+  // `LocalStore` persists a resume token together with the version of the
+  // event that carries it. A token that `later` does not replace would be
+  // persisted with a version it does not correspond to.
+  for (const auto& entry : earlier.target_changes()) {
+    if (entry.second.resume_token().empty()) {
+      continue;
+    }
+    auto found = later.target_changes().find(entry.first);
+    if (found == later.target_changes().end() ||
+        found->second.resume_token().empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void RemoteStore::FlushCoalescedRemoteEvent() {
+  if (!coalesced_remote_event_) {
+    return;
+  }
+
+  coalescing_timer_.Cancel();
+  RemoteEvent remote_event = std::move(*coalesced_remote_event_);
+  coalesced_remote_event_.reset();
   sync_engine_->ApplyRemoteEvent(remote_event);
 }
 
 void RemoteStore::ProcessTargetError(const WatchTargetChange& change) {
   HARD_ASSERT(!change.cause().ok(), "Handling target error without a cause");
 
+  FlushCoalescedRemoteEvent();
+
   // Ignore targets that have been removed already.
   for (TargetId target_id : change.target_ids()) {
     auto found = listen_targets_.find(target_id);
@@ -380,9 +473,11 @@ void RemoteStore::FillWritePipeline() {
       }
       break;
     }
-    AddToWritePipeline(*batch);
+    write_pipeline_.push_back(*batch);
     last_batch_id_retrieved = batch->batch_id();
   }
+  // Sends the new batches together, such that they can be coalesced.
+  SendUnsentWrites();
 
   if (ShouldStartWriteStream()) {
     StartWriteStream();
@@ -390,17 +485,85 @@ void RemoteStore::FillWritePipeline() {
 }
 
 bool RemoteStore::CanAddToWritePipeline() const {
-  return CanUseNetwork() && write_pipeline_.size() < kMaxPendingWrites;
+  auto max_pending_writes = static_cast<size_t>(write_pipeline_depth_.depth());
+  return CanUseNetwork() && write_pipeline_.size() < max_pending_writes;
 }
 
-void RemoteStore::AddToWritePipeline(const MutationBatch& batch) {
-  HARD_ASSERT(CanAddToWritePipeline(),
-              "AddToWritePipeline called when pipeline is full");
+void RemoteStore::set_write_coalescing_max_mutations(size_t max_mutations) {
+  write_coalescing_max_mutations_ =
+      std::min(max_mutations, kMaxMutationsPerWriteRequest);
+}
 
-  write_pipeline_.push_back(batch);
+void RemoteStore::set_write_coalescing_max_bytes(size_t max_bytes) {
+  write_coalescing_max_bytes_ = std::min(max_bytes, kMaxCoalescedWriteBytes);
+}
+
+size_t RemoteStore::SentBatchCount() const {
+  size_t count = 0;
+  for (const SentWriteRequest& request : sent_write_requests_) {
+    count += request.batch_count;
+  }
+  return count;
+}
+
+size_t RemoteStore::EncodedSize(const MutationBatch& batch) const {
+  size_t size = 0;
+  for (const Mutation& mutation : batch.mutations()) {
+    size += write_stream_->EncodedMutationSize(mutation);
+  }
+  return size;
+}
+
+void RemoteStore::SendUnsentWrites() {
+  if (!write_stream_->IsOpen() || !write_stream_->handshake_complete()) {
+    return;
+  }
+
+  size_t next = SentBatchCount();
+  while (next < write_pipeline_.size()) {
+    // Counts how many of the batches that follow fit into the request.
+    size_t batch_count = 1;
+    size_t mutation_count = write_pipeline_[next].mutations().size();
+    if (uncoalesced_batches_ > 0) {
+      --uncoalesced_batches_;
+    } else {
+      // Batches are only encoded for their size once they could be coalesced
+      // by their mutation count.
+      size_t byte_count = 0;
+      while (next + batch_count < write_pipeline_.size()) {
+        const MutationBatch& batch = write_pipeline_[next + batch_count];
+        size_t added = batch.mutations().size();
+        if (mutation_count + added > write_coalescing_max_mutations_) {
+          break;
+        }
+        if (batch_count == 1) {
+          byte_count = EncodedSize(write_pipeline_[next]);
+        }
+        size_t added_bytes = EncodedSize(batch);
+        if (byte_count + added_bytes > write_coalescing_max_bytes_) {
+          break;
+        }
+        mutation_count += added;
+        byte_count += added_bytes;
+        ++batch_count;
+      }
+    }
+
+    if (batch_count == 1) {
+      write_stream_->WriteMutations(write_pipeline_[next].mutations());
+    } else {
+      std::vector<Mutation> mutations;
+      mutations.reserve(mutation_count);
+      for (size_t i = next; i != next + batch_count; ++i) {
+        const std::vector<Mutation>& batch = write_pipeline_[i].mutations();
+        mutations.insert(mutations.end(), batch.begin(), batch.end());
+      }
+      write_stream_->WriteMutations(mutations);
+    }
 
-  if (write_stream_->IsOpen() && write_stream_->handshake_complete()) {
-    write_stream_->WriteMutations(batch.mutations());
+    sent_write_requests_.push_back(
+        SentWriteRequest{batch_count, std::chrono::steady_clock::now()});
+    next += batch_count;
   }
 }
 
@@ -423,26 +586,118 @@ void RemoteStore::OnWriteStreamHandshakeComplete() {
   // Record the stream token.
   local_store_->SetLastStreamToken(write_stream_->last_stream_token());
 
-  // Send the write pipeline now that the stream is established.
-  for (const MutationBatch& write : write_pipeline_) {
-    write_stream_->WriteMutations(write.mutations());
+  // A resumed stream still responds to the writes that were sent on it before
+  // it failed, so only the rest are sent. Otherwise, the whole pipeline is.
+  if (write_stream_->handshake_resumed()) {
+    // The round trips of the resumed writes are measured from now, such that
+    // the time the stream was down doesn't shrink the pipeline.
+    auto now = std::chrono::steady_clock::now();
+    for (SentWriteRequest& request : sent_write_requests_) {
+      request.sent = now;
+    }
+
+    // Writes that were lost on the way to the failed stream never get a
+    // response, so the resumed stream is only trusted for a while.
+    resumed_write_requests_ = sent_write_requests_.size();
+    if (resumed_write_requests_ > 0) {
+      ScheduleResumedWritesTimeout();
+    }
+  } else {
+    sent_write_requests_.clear();
   }
+  SendUnsentWrites();
+}
+
+void RemoteStore::ScheduleResumedWritesTimeout() {
+  resumed_writes_timer_.Cancel();
+  resumed_writes_timer_ = worker_queue_->EnqueueAfterDelay(
+      kResumedWritesTimeout, util::TimerId::WriteStreamResumeTimeout,
+      "RemoteStore::RestartResumedWriteStream", [this] {
+        resumed_writes_timer_ = {};
+        RestartResumedWriteStream();
+      });
+}
+
+void RemoteStore::RestartResumedWriteStream() {
+  LOG_DEBUG(
+      "RemoteStore %s resumed write stream did not respond to %s writes; "
+      "sending the write pipeline again on a new stream",
+      this, resumed_write_requests_);
+
+  // As when the network is disabled, the pipeline is refilled from the
+  // `LocalStore`. Stopping the stream gracefully makes it forget its ID, so
+  // the next one is not resumed.
+  write_pipeline_.clear();
+  sent_write_requests_.clear();
+  uncoalesced_batches_ = 0;
+  write_stream_->Stop();
+
+  FillWritePipeline();
 }
 
 void RemoteStore::OnWriteStreamMutationResult(
     SnapshotVersion commit_version,
     std::vector<MutationResult> mutation_results) {
   // This is a response to a write containing mutations and should be correlated
-  // to the first write in our write pipeline.
+  // to the first write in our write pipeline. The write may have coalesced
+  // several batches, whose results follow each other in the same order.
   HARD_ASSERT(!write_pipeline_.empty(), "Got result for empty write pipeline");
 
-  MutationBatch batch = write_pipeline_.front();
-  write_pipeline_.erase(write_pipeline_.begin());
+  // Acknowledged writes are only released once the remote documents reflect
+  // them, so watch snapshots must not be held back past a write result.
+  FlushCoalescedRemoteEvent();
+
+  size_t batch_count = 1;
+  absl::optional<WritePipelineDepth::Duration> round_trip;
+  if (!sent_write_requests_.empty()) {
+    const SentWriteRequest& request = sent_write_requests_.front();
+    batch_count = request.batch_count;
+    round_trip = std::chrono::steady_clock::now() - request.sent;
+    sent_write_requests_.pop_front();
+  }
+
+  // Each response to a resumed write shows that the stream is still replaying
+  // them, so the timeout starts over.
+  if (resumed_write_requests_ > 0) {
+    --resumed_write_requests_;
+    if (resumed_write_requests_ > 0) {
+      ScheduleResumedWritesTimeout();
+    } else {
+      resumed_writes_timer_.Cancel();
+    }
+  }
+
+  size_t next_result = 0;
+  for (size_t i = 0; i != batch_count; ++i) {
+    HARD_ASSERT(!write_pipeline_.empty(),
+                "Got results for more batches than were written");
+    MutationBatch batch = write_pipeline_.front();
+    write_pipeline_.erase(write_pipeline_.begin());
 
-  MutationBatchResult batch_result(std::move(batch), commit_version,
-                                   std::move(mutation_results),
-                                   write_stream_->last_stream_token());
-  sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+    if (round_trip) {
+      write_pipeline_depth_.OnWriteAcknowledged(*round_trip);
+    }
+
+    std::vector<MutationResult> batch_results;
+    if (batch_count == 1) {
+      batch_results = std::move(mutation_results);
+    } else {
+      size_t batch_size = batch.mutations().size();
+      HARD_ASSERT(next_result + batch_size <= mutation_results.size(),
+                  "Got too few results for the coalesced batches");
+      // `MutationResult` can only be move-constructed, not assigned.
+      batch_results.reserve(batch_size);
+      for (size_t j = 0; j != batch_size; ++j) {
+        batch_results.push_back(std::move(mutation_results[next_result + j]));
+      }
+      next_result += batch_size;
+    }
+
+    MutationBatchResult batch_result(std::move(batch), commit_version,
+                                     std::move(batch_results),
+                                     write_stream_->last_stream_token());
+    sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+  }
 
   // It's possible that with the completion of this mutation another slot has
   // freed up.
@@ -450,6 +705,9 @@ void RemoteStore::OnWriteStreamMutationResult(
 }
 
 void RemoteStore::OnWriteStreamClose(const Status& status) {
+  resumed_write_requests_ = 0;
+  resumed_writes_timer_.Cancel();
+
   if (status.ok()) {
     // Graceful stop (due to Stop() or idle timeout). Make sure that's
     // desirable.
@@ -464,6 +722,7 @@ void RemoteStore::OnWriteStreamClose(const Status& status) {
     // go/firestore-client-errors
     if (write_stream_->handshake_complete()) {
       // This error affects the actual writes.
+      write_pipeline_depth_.OnStreamInterrupted();
       HandleWriteError(status);
     } else {
       // If there was an error before the handshake finished, it's possible that
@@ -494,6 +753,7 @@ void RemoteStore::HandleHandshakeError(const Status& status) {
         "error code: '%s', details: '%s'",
         this, token, status.code(), status.error_message());
     write_stream_->set_last_stream_token({});
+    write_stream_->set_stream_id({});
     local_store_->SetLastStreamToken({});
   } else {
     // Some other error, don't reset stream token. Our stream logic will just
@@ -510,15 +770,32 @@ void RemoteStore::HandleWriteError(const Status& status) {
     return;
   }
 
-  // If this was a permanent error, the request itself was the problem so it's
-  // not going to succeed if we resend it.
-  MutationBatch batch = write_pipeline_.front();
-  write_pipeline_.erase(write_pipeline_.begin());
+  FlushCoalescedRemoteEvent();
+
+  // The stream failed on this write, so the writes after it are sent again on
+  // a new stream.
+  size_t batch_count = sent_write_requests_.empty()
+                           ? 1
+                           : sent_write_requests_.front().batch_count;
+  sent_write_requests_.clear();
+  write_stream_->set_stream_id({});
 
   // In this case it's also unlikely that the server itself is melting
   // down--this was just a bad request so inhibit backoff on the next restart.
   write_stream_->InhibitBackoff();
 
+  if (batch_count > 1) {
+    // Any of the coalesced batches may have caused the error, so they are sent
+    // again one at a time to find out which one to reject.
+    uncoalesced_batches_ = batch_count;
+    return;
+  }
+
+  // If this was a permanent error, the request itself was the problem so it's
+  // not going to succeed if we resend it.
+  MutationBatch batch = write_pipeline_.front();
+  write_pipeline_.erase(write_pipeline_.begin());
+
   sync_engine_->HandleRejectedWrite(batch.batch_id(), status);
 
   // It's possible that with the completion of this mutation another slot has
@@ -537,7 +814,23 @@ std::shared_ptr<Transaction> RemoteStore::CreateTransaction() {
 }
 
 DocumentKeySet RemoteStore::GetRemoteKeysForTarget(TargetId target_id) const {
-  return sync_engine_->GetRemoteKeys(target_id);
+  DocumentKeySet keys = sync_engine_->GetRemoteKeys(target_id);
+  if (!coalesced_remote_event_) {
+    return keys;
+  }
+
+  const RemoteEvent::TargetChangeMap& target_changes =
+      coalesced_remote_event_->target_changes();
+  auto found = target_changes.find(target_id);
+  if (found == target_changes.end()) {
+    return keys;
+  }
+
+  const TargetChange& target_change = found->second;
+  for (const auto& key : target_change.removed_documents()) {
+    keys = keys.erase(key);
+  }
+  return keys.union_with(target_change.added_documents());
 }
 
 absl::optional<TargetData> RemoteStore::GetTargetDataForTarget(
@@ -547,6 +840,10 @@ absl::optional<TargetData> RemoteStore::GetTargetDataForTarget(
                                         : absl::optional<TargetData>{};
 }
 
+const DatabaseId& RemoteStore::GetDatabaseId() const {
+  return datastore_->database_id();
+}
+
 void RemoteStore::RestartNetwork() {
   is_network_enabled_ = false;
   DisableNetworkInternal();
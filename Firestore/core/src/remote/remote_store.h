@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 
+#include <chrono>  // NOLINT(build/c++11)
+#include <deque>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -31,9 +33,11 @@
 #include "Firestore/core/src/remote/remote_event.h"
 #include "Firestore/core/src/remote/watch_change.h"
 #include "Firestore/core/src/remote/watch_stream.h"
+#include "Firestore/core/src/remote/write_pipeline_depth.h"
 #include "Firestore/core/src/remote/write_stream.h"
 #include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/src/util/status_fwd.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -118,6 +122,37 @@ class RemoteStore : public TargetMetadataProvider,
     sync_engine_ = sync_engine;
   }
 
+  /**
+   * Sets how long consistent watch snapshots may be held back so that several
+   * of them can be applied to the `SyncEngine` as one `RemoteEvent`. A zero
+   * window applies every snapshot as soon as it is raised.
+   */
+  void set_watch_coalescing_window(util::AsyncQueue::Milliseconds window) {
+    watch_coalescing_window_ = window;
+  }
+
+  /**
+   * Sets how many writes may be in flight at once. The write pipeline starts
+   * out shallower and only deepens while the backend keeps up with it.
+   */
+  void set_max_pending_writes(int max_pending_writes) {
+    write_pipeline_depth_ = WritePipelineDepth(max_pending_writes);
+  }
+
+  /**
+   * Sets how many mutations adjacent batches in the write pipeline may add up
+   * to when they are sent in one write request. The backend commits such
+   * batches together. Zero sends each batch in a request of its own.
+   */
+  void set_write_coalescing_max_mutations(size_t max_mutations);
+
+  /**
+   * Sets how many bytes of encoded mutations adjacent batches may add up to
+   * when they are sent in one write request. A batch that is larger on its own
+   * is still sent, in a request of its own.
+   */
+  void set_write_coalescing_max_bytes(size_t max_bytes);
+
   /**
    * Starts up the remote store, creating streams, restoring state from
    * `LocalStore`, etc.
@@ -178,12 +213,6 @@ class RemoteStore : public TargetMetadataProvider,
    */
   void FillWritePipeline();
 
-  /**
-   * Queues additional writes to be sent to the write stream, sending them
-   * immediately if the write stream is established.
-   */
-  void AddToWritePipeline(const model::MutationBatch& batch);
-
   /** Returns a new transaction backed by this remote store. */
   // TODO(c++14): return a plain value when it becomes possible to move
   // `Transaction` into lambdas.
@@ -193,6 +222,7 @@ class RemoteStore : public TargetMetadataProvider,
       model::TargetId target_id) const override;
   absl::optional<local::TargetData> GetTargetDataForTarget(
       model::TargetId target_id) const override;
+  const model::DatabaseId& GetDatabaseId() const override;
 
   void OnWatchStreamOpen() override;
   void OnWatchStreamChange(
@@ -220,6 +250,21 @@ class RemoteStore : public TargetMetadataProvider,
    */
   void RaiseWatchSnapshot(const model::SnapshotVersion& snapshot_version);
 
+  /**
+   * Passes the `remote_event` on to the `SyncEngine`, or holds it back to be
+   * coalesced with the snapshots that follow it within the coalescing window.
+   */
+  void ApplyOrCoalesceRemoteEvent(RemoteEvent remote_event);
+
+  /**
+   * Returns true if `later` can be folded into `earlier` without losing
+   * information that `LocalStore` would otherwise persist.
+   */
+  bool CanCoalesce(const RemoteEvent& earlier, const RemoteEvent& later) const;
+
+  /** Applies the remote event that is being held back, if any. */
+  void FlushCoalescedRemoteEvent();
+
   /** Process a target error and passes the error along to `SyncEngine`. */
   void ProcessTargetError(const WatchTargetChange& change);
 
@@ -237,6 +282,30 @@ class RemoteStore : public TargetMetadataProvider,
    */
   bool ShouldStartWriteStream() const;
 
+  /** Returns how many batches from the front of the pipeline were sent. */
+  size_t SentBatchCount() const;
+
+  /** Returns how many bytes the batch's mutations add to a write request. */
+  size_t EncodedSize(const model::MutationBatch& batch) const;
+
+  /**
+   * Sends the batches in the pipeline that weren't sent yet, coalescing them
+   * if enabled, once the write stream is ready for them.
+   */
+  void SendUnsentWrites();
+
+  /**
+   * Restarts the write stream unless the writes it resumed are answered in
+   * time, pushing back the deadline if it was already set.
+   */
+  void ScheduleResumedWritesTimeout();
+
+  /**
+   * Sends the whole write pipeline again on a new write stream, because the
+   * resumed one stopped responding to the writes it owes a response for.
+   */
+  void RestartResumedWriteStream();
+
   void HandleHandshakeError(const util::Status& status);
   void HandleWriteError(const util::Status& status);
 
@@ -261,6 +330,8 @@ class RemoteStore : public TargetMetadataProvider,
   /** The client-side proxy for interacting with the backend. */
   std::shared_ptr<Datastore> datastore_;
 
+  std::shared_ptr<util::AsyncQueue> worker_queue_;
+
   /**
    * A mapping of watched targets that the client cares about tracking and the
    * user has explicitly called a 'listen' for this target.
@@ -286,9 +357,25 @@ class RemoteStore : public TargetMetadataProvider,
   std::shared_ptr<WriteStream> write_stream_;
   std::unique_ptr<WatchChangeAggregator> watch_change_aggregator_;
 
+  util::AsyncQueue::Milliseconds watch_coalescing_window_{0};
+
   /**
-   * A list of up to `kMaxPendingWrites` writes that we have fetched from the
-   * `LocalStore` via `FillWritePipeline` and have or will send to the write
+   * A remote event that has been raised but not yet applied, because
+   * coalescing is enabled. Its document changes are reflected in
+   * `GetRemoteKeysForTarget`, such that the snapshots raised after it are
+   * computed relative to it.
+   */
+  absl::optional<RemoteEvent> coalesced_remote_event_;
+
+  /** Applies `coalesced_remote_event_` once the window has elapsed. */
+  util::DelayedOperation coalescing_timer_;
+
+  /** Decides how many writes `write_pipeline_` may hold. */
+  WritePipelineDepth write_pipeline_depth_{WritePipelineDepth::kInitialDepth};
+
+  /**
+   * A list of up to `write_pipeline_depth_` writes that we have fetched from
+   * the `LocalStore` via `FillWritePipeline` and have or will send to the write
    * stream.
    *
    * Whenever `write_pipeline_` is not empty, the `RemoteStore` will attempt to
@@ -304,6 +391,38 @@ class RemoteStore : public TargetMetadataProvider,
    * the `write_pipeline_` as we receive responses.
    */
   std::vector<model::MutationBatch> write_pipeline_;
+
+  /** A write request that was sent and not yet responded to. */
+  struct SentWriteRequest {
+    /** How many batches of the pipeline the request contains. */
+    size_t batch_count;
+    std::chrono::steady_clock::time_point sent;
+  };
+
+  /**
+   * The requests that contain the batches at the front of `write_pipeline_`,
+   * which were sent on the current write stream or on the stream it resumed.
+   * The batches after them have not been sent yet.
+   */
+  std::deque<SentWriteRequest> sent_write_requests_;
+
+  /**
+   * How many of `sent_write_requests_` were sent before the write stream was
+   * resumed and are still waiting for a response.
+   */
+  size_t resumed_write_requests_ = 0;
+
+  /** Restarts the write stream if the resumed writes go unanswered. */
+  util::DelayedOperation resumed_writes_timer_;
+
+  size_t write_coalescing_max_mutations_ = 0;
+  size_t write_coalescing_max_bytes_ = 0;
+
+  /**
+   * How many batches are sent one per request before batches are coalesced
+   * again. Set after a request with coalesced batches is rejected.
+   */
+  size_t uncoalesced_batches_ = 0;
 };
 
 }  // namespace remote
@@ -26,6 +26,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
 #include "Firestore/Protos/nanopb/google/firestore/v1/firestore.nanopb.h"
@@ -48,8 +49,10 @@
 #include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/nanopb/writer.h"
+#include "Firestore/core/src/remote/bloom_filter.h"
 #include "Firestore/core/src/timestamp_internal.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/status.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_format.h"
@@ -172,6 +175,29 @@ FieldPath InvalidFieldPath() {
   return FieldPath::EmptyPath();
 }
 
+/**
+ * Decodes the bloom filter of an existence filter. The bloom filter only saves
+ * the client from re-running the query, so an invalid one is dropped rather
+ * than failing the watch stream.
+ */
+absl::optional<BloomFilter> DecodeBloomFilter(
+    const google_firestore_v1_BloomFilter& proto) {
+  std::vector<uint8_t> bitmap;
+  if (proto.bits.bitmap) {
+    bitmap.assign(proto.bits.bitmap->bytes,
+                  proto.bits.bitmap->bytes + proto.bits.bitmap->size);
+  }
+
+  StatusOr<BloomFilter> filter = BloomFilter::Create(
+      std::move(bitmap), proto.bits.padding, proto.hash_count);
+  if (!filter.ok()) {
+    LOG_WARN("Ignoring invalid bloom filter in existence filter: %s",
+             filter.status().ToString());
+    return absl::nullopt;
+  }
+  return std::move(filter).ValueOrDie();
+}
+
 }  // namespace
 
 Serializer::Serializer(DatabaseId database_id)
@@ -623,7 +649,7 @@ google_firestore_v1_Target Serializer::EncodeTarget(
   google_firestore_v1_Target result{};
   const Target& target = target_data.target();
 
-  if (target.IsDocumentQuery()) {
+  if (target.IsDocumentsTarget()) {
     result.which_target_type = google_firestore_v1_Target_documents_tag;
     result.target_type.documents = EncodeDocumentsTarget(target);
   } else {
@@ -636,6 +662,13 @@ google_firestore_v1_Target Serializer::EncodeTarget(
     result.which_resume_type = google_firestore_v1_Target_resume_token_tag;
     result.resume_type.resume_token =
         nanopb::CopyBytesArray(target_data.resume_token().get());
+
+    // The expected count only means something relative to a resume point;
+    // watch uses it to decide whether to send a bloom filter on a mismatch.
+    if (target_data.expected_count().has_value()) {
+      result.has_expected_count = true;
+      result.expected_count.value = *target_data.expected_count();
+    }
   }
 
   return result;
@@ -645,9 +678,12 @@ google_firestore_v1_Target_DocumentsTarget Serializer::EncodeDocumentsTarget(
     const core::Target& target) const {
   google_firestore_v1_Target_DocumentsTarget result{};
 
-  result.documents_count = 1;
+  std::vector<DocumentKey> keys = target.GetDocumentKeys();
+  result.documents_count = CheckedSize(keys.size());
   result.documents = MakeArray<pb_bytes_array_t*>(result.documents_count);
-  result.documents[0] = EncodeQueryPath(target.path());
+  for (pb_size_t i = 0; i < result.documents_count; ++i) {
+    result.documents[i] = EncodeKey(keys[i]);
+  }
 
   return result;
 }
@@ -1393,7 +1429,12 @@ std::unique_ptr<WatchChange> Serializer::DecodeDocumentRemove(
 
 std::unique_ptr<WatchChange> Serializer::DecodeExistenceFilterWatchChange(
     ReadContext*, const google_firestore_v1_ExistenceFilter& filter) const {
-  ExistenceFilter existence_filter{filter.count};
+  absl::optional<BloomFilter> unchanged_names;
+  if (filter.has_unchanged_names) {
+    unchanged_names = DecodeBloomFilter(filter.unchanged_names);
+  }
+
+  ExistenceFilter existence_filter{filter.count, std::move(unchanged_names)};
   return absl::make_unique<ExistenceFilterWatchChange>(existence_filter,
                                                        filter.target_id);
 }
@@ -143,6 +143,7 @@ void Stream::RequestCredentials() {
     const std::string& app_check_token = credentials->app_check;
 
     strong_this->worker_queue_->EnqueueRelaxed(
+        "Stream::ResumeStartWithCredentials",
         [weak_this, auth_token, app_check_token, initial_close_count] {
           auto strong_this = weak_this.lock();
           // Streams can be stopped while waiting for authorization, so need
@@ -188,7 +189,7 @@ void Stream::OnStreamStart() {
   NotifyStreamOpen();
 
   health_check_ = worker_queue_->EnqueueAfterDelay(
-      kHealthyTimeout, health_check_timer_id_, [this] {
+      kHealthyTimeout, health_check_timer_id_, "Stream::HealthCheck", [this] {
         {
           if (IsOpen()) {
             state_ = State::Healthy;
@@ -236,7 +237,7 @@ void Stream::MarkIdle() {
 
   if (IsOpen() && !idleness_timer_) {
     idleness_timer_ = worker_queue_->EnqueueAfterDelay(
-        kIdleTimeout, idle_timer_id_, [this] { Stop(); });
+        kIdleTimeout, idle_timer_id_, "Stream::StopIdle", [this] { Stop(); });
   }
 }
 
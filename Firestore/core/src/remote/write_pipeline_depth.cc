@@ -0,0 +1,58 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/write_pipeline_depth.h"
+
+#include <algorithm>
+
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+constexpr int WritePipelineDepth::kInitialDepth;
+
+WritePipelineDepth::WritePipelineDepth(int max_depth)
+    : min_depth_(std::min(kInitialDepth, max_depth)),
+      max_depth_(max_depth),
+      depth_(min_depth_) {
+  HARD_ASSERT(max_depth > 0, "Invalid write pipeline depth %s", max_depth);
+}
+
+void WritePipelineDepth::OnWriteAcknowledged(Duration round_trip) {
+  fastest_round_trip_ = std::min(fastest_round_trip_, round_trip);
+
+  if (round_trip <= fastest_round_trip_ * 2) {
+    ++acknowledged_in_time_;
+    if (acknowledged_in_time_ >= depth_ && depth_ < max_depth_) {
+      ++depth_;
+      acknowledged_in_time_ = 0;
+    }
+  } else if (depth_ > min_depth_) {
+    --depth_;
+    acknowledged_in_time_ = 0;
+  }
+}
+
+void WritePipelineDepth::OnStreamInterrupted() {
+  depth_ = std::max(min_depth_, depth_ / 2);
+  acknowledged_in_time_ = 0;
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
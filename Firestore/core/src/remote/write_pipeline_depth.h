@@ -0,0 +1,69 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_REMOTE_WRITE_PIPELINE_DEPTH_H_
+#define FIRESTORE_CORE_SRC_REMOTE_WRITE_PIPELINE_DEPTH_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+/**
+ * Decides how many writes `RemoteStore` keeps in flight on the write stream.
+ *
+ * The depth starts at `kInitialDepth`. Each time a whole pipeline of writes is
+ * acknowledged within twice the fastest round trip seen so far, the backend is
+ * keeping up and the depth grows by one, up to the maximum. A slower round
+ * trip means writes are queueing up, so the depth shrinks by one, and an
+ * interrupted stream halves it. The depth never drops below the initial one.
+ */
+class WritePipelineDepth {
+ public:
+  using Duration = std::chrono::steady_clock::duration;
+
+  /** The depth the pipeline starts at, which used to be its fixed size. */
+  static constexpr int kInitialDepth = 10;
+
+  explicit WritePipelineDepth(int max_depth);
+
+  int depth() const {
+    return depth_;
+  }
+
+  /** Adjusts the depth to the round trip of a write that was acknowledged. */
+  void OnWriteAcknowledged(Duration round_trip);
+
+  /** Backs off after the write stream failed with writes in flight. */
+  void OnStreamInterrupted();
+
+ private:
+  int min_depth_ = 0;
+  int max_depth_ = 0;
+  int depth_ = 0;
+
+  // The number of writes acknowledged in time since the depth last changed.
+  int acknowledged_in_time_ = 0;
+
+  Duration fastest_round_trip_ = Duration::max();
+};
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_REMOTE_WRITE_PIPELINE_DEPTH_H_
@@ -68,18 +68,31 @@ const ByteString& WriteStream::last_stream_token() const {
   return last_stream_token_;
 }
 
+void WriteStream::set_stream_id(ByteString stream_id) {
+  stream_id_ = std::move(stream_id);
+}
+
+const ByteString& WriteStream::stream_id() const {
+  return stream_id_;
+}
+
 void WriteStream::WriteHandshake() {
   EnsureOnQueue();
   HARD_ASSERT(IsOpen(), "Writing handshake requires an opened stream");
   HARD_ASSERT(!handshake_complete(), "Handshake already completed");
 
-  auto request = write_serializer_.EncodeHandshake();
+  auto request = EncodeHandshake();
   LOG_DEBUG("%s initial request: %s", GetDebugDescription(),
             request.ToString());
   Write(MakeByteBuffer(request));
+}
 
-  // TODO(dimond): Support stream resumption. We intentionally do not set the
-  // stream token on the handshake, ignoring any stream token we might have.
+Message<google_firestore_v1_WriteRequest> WriteStream::EncodeHandshake() const {
+  // A stream can only be resumed from a response that was received on it.
+  if (!stream_id_.empty() && !last_stream_token_.empty()) {
+    return write_serializer_.EncodeHandshake(stream_id_, last_stream_token_);
+  }
+  return write_serializer_.EncodeHandshake();
 }
 
 void WriteStream::WriteMutations(const std::vector<Mutation>& mutations) {
@@ -94,6 +107,10 @@ void WriteStream::WriteMutations(const std::vector<Mutation>& mutations) {
   Write(MakeByteBuffer(request));
 }
 
+size_t WriteStream::EncodedMutationSize(const Mutation& mutation) const {
+  return write_serializer_.EncodedMutationSize(mutation);
+}
+
 std::unique_ptr<GrpcStream> WriteStream::CreateGrpcStream(
     GrpcConnection* grpc_connection,
     const AuthToken& auth_token,
@@ -124,6 +141,12 @@ void WriteStream::NotifyStreamClose(const Status& status) {
   // Delegate's logic might depend on whether handshake was completed, so only
   // reset it after notifying.
   handshake_complete_ = false;
+  handshake_resumed_ = false;
+
+  // A stream that was finished gracefully can't be resumed.
+  if (status.ok()) {
+    stream_id_ = {};
+  }
 }
 
 Status WriteStream::NotifyStreamResponse(const grpc::ByteBuffer& message) {
@@ -141,7 +164,13 @@ Status WriteStream::NotifyStreamResponse(const grpc::ByteBuffer& message) {
   response->stream_token = nullptr;
 
   if (!handshake_complete()) {
-    // The first response is the handshake response
+    // The first response is the handshake response. The server keeps the ID
+    // of the stream it resumed, and assigns a new one otherwise.
+    ByteString stream_id = ByteString::Take(response->stream_id);
+    response->stream_id = nullptr;
+    handshake_resumed_ = !stream_id_.empty() && stream_id == stream_id_;
+    stream_id_ = std::move(stream_id);
+
     handshake_complete_ = true;
     callback_->OnWriteStreamHandshakeComplete();
   } else {
@@ -87,6 +87,10 @@ class WriteStreamCallback {
  * submitting multiple batches of mutations at the same time, it's
  * okay to use the same stream token for the calls to `WriteMutations`.
  *
+ * If the previous stream failed, the handshake asks the server to resume it
+ * from the last stream token. A resumed stream goes on to deliver the
+ * responses to the mutations that were written before it failed.
+ *
  * This class is not intended as a base class; all virtual methods exist only
  * for the sake of tests.
  */
@@ -112,6 +116,19 @@ class WriteStream : public Stream {
    */
   const nanopb::ByteString& last_stream_token() const;
 
+  /**
+   * Sets the ID of the stream to resume on the next handshake. An empty ID
+   * starts a new stream.
+   */
+  void set_stream_id(nanopb::ByteString stream_id);
+
+  /**
+   * The ID the server assigned to the last stream that completed its
+   * handshake. It is forgotten once that stream is stopped gracefully, since
+   * the server then releases it.
+   */
+  const nanopb::ByteString& stream_id() const;
+
   /**
    * Tracks whether or not a handshake has been successfully exchanged and
    * the stream is ready to accept mutations.
@@ -120,20 +137,38 @@ class WriteStream : public Stream {
     return handshake_complete_;
   }
 
+  /**
+   * Whether the completed handshake resumed the previous stream, rather than
+   * starting a new one.
+   */
+  bool handshake_resumed() const {
+    return handshake_resumed_;
+  }
+
   /**
    * Sends an initial stream token to the server, performing the handshake
-   * required to make the StreamingWrite RPC work.
+   * required to make the StreamingWrite RPC work. Asks to resume the previous
+   * stream if both its ID and a stream token are known.
    */
   virtual void WriteHandshake();
 
   /** Sends a group of mutations to the Firestore backend to apply. */
   virtual void WriteMutations(const std::vector<model::Mutation>& mutations);
 
+  /** Returns how many bytes the given mutation adds to a write request. */
+  size_t EncodedMutationSize(const model::Mutation& mutation) const;
+
  protected:
   // For tests only
   void SetHandshakeComplete(bool value = true) {
     handshake_complete_ = value;
   }
+  void SetHandshakeResumed(bool value = true) {
+    handshake_resumed_ = value;
+  }
+
+  /** Encodes the initial request that `WriteHandshake` sends. */
+  nanopb::Message<google_firestore_v1_WriteRequest> EncodeHandshake() const;
 
  private:
   std::unique_ptr<GrpcStream> CreateGrpcStream(
@@ -153,7 +188,9 @@ class WriteStream : public Stream {
   WriteStreamSerializer write_serializer_;
   WriteStreamCallback* callback_ = nullptr;
   bool handshake_complete_ = false;
+  bool handshake_resumed_ = false;
   nanopb::ByteString last_stream_token_;
+  nanopb::ByteString stream_id_;
 };
 
 }  // namespace remote
@@ -26,6 +26,14 @@
 namespace firebase {
 namespace firestore {
 namespace util {
+namespace {
+
+AsyncQueueStats::Duration ToStatsDuration(
+    std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<AsyncQueueStats::Duration>(duration);
+}
+
+}  // namespace
 
 std::shared_ptr<AsyncQueue> AsyncQueue::Create(
     std::unique_ptr<Executor> executor) {
@@ -57,6 +65,13 @@ void AsyncQueue::Dispose() {
   }
 
   executor_->Dispose();
+
+  // The executor drops the operations that didn't start, so they are never
+  // dequeued.
+  AsyncQueueStats* stats = stats_.load(std::memory_order_acquire);
+  if (stats) {
+    stats->RecordAllDiscarded();
+  }
 }
 
 void AsyncQueue::VerifyIsCurrentExecutor() const {
@@ -76,6 +91,25 @@ void AsyncQueue::VerifyIsCurrentQueue() const {
 }
 
 void AsyncQueue::ExecuteBlocking(const Operation& operation) {
+  ExecuteBlocking(nullptr, operation);
+}
+
+void AsyncQueue::ExecuteBlocking(const char* label,
+                                 const Operation& operation) {
+  AsyncQueueStats* stats = stats_.load(std::memory_order_acquire);
+  if (!stats) {
+    RunOperation(operation);
+    return;
+  }
+
+  // Direct execution doesn't wait on the queue.
+  auto start = StatsClock::now();
+  RunOperation(operation);
+  stats->RecordOperation(label, AsyncQueueStats::Duration(0),
+                         ToStatsDuration(StatsClock::now() - start));
+}
+
+void AsyncQueue::RunOperation(const Operation& operation) {
   // This is not guarded by `is_shutting_down_` because it is the execution
   // of the operation, not scheduling. Checking `is_shutting_down_` here
   // would mean *all* operations will not run after shutdown, which is not
@@ -91,15 +125,24 @@ void AsyncQueue::ExecuteBlocking(const Operation& operation) {
 }
 
 bool AsyncQueue::Enqueue(const Operation& operation) {
+  return Enqueue(nullptr, operation);
+}
+
+bool AsyncQueue::Enqueue(const char* label, const Operation& operation) {
   VerifySequentialOrder();
-  return EnqueueRelaxed(operation);
+  return EnqueueRelaxed(label, operation);
 }
 
 bool AsyncQueue::EnqueueEvenWhileRestricted(const Operation& operation) {
+  return EnqueueEvenWhileRestricted(nullptr, operation);
+}
+
+bool AsyncQueue::EnqueueEvenWhileRestricted(const char* label,
+                                            const Operation& operation) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (mode_ == Mode::kDisposed) return false;
 
-  executor_->Execute(Wrap(operation));
+  executor_->Execute(Wrap(label, operation));
   return true;
 }
 
@@ -109,16 +152,28 @@ bool AsyncQueue::is_running() const {
 }
 
 bool AsyncQueue::EnqueueRelaxed(const Operation& operation) {
+  return EnqueueRelaxed(nullptr, operation);
+}
+
+bool AsyncQueue::EnqueueRelaxed(const char* label,
+                                const Operation& operation) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (mode_ != Mode::kRunning) return false;
 
-  executor_->Execute(Wrap(operation));
+  executor_->Execute(Wrap(label, operation));
   return true;
 }
 
 DelayedOperation AsyncQueue::EnqueueAfterDelay(Milliseconds delay,
                                                const TimerId timer_id,
                                                const Operation& operation) {
+  return EnqueueAfterDelay(delay, timer_id, nullptr, operation);
+}
+
+DelayedOperation AsyncQueue::EnqueueAfterDelay(Milliseconds delay,
+                                               const TimerId timer_id,
+                                               const char* label,
+                                               const Operation& operation) {
   std::lock_guard<std::mutex> lock(mutex_);
   VerifyIsCurrentExecutor();
 
@@ -132,16 +187,57 @@ DelayedOperation AsyncQueue::EnqueueAfterDelay(Milliseconds delay,
   }
 
   auto tag = static_cast<Executor::Tag>(timer_id);
-  return executor_->Schedule(delay, tag, Wrap(operation));
+  return executor_->Schedule(delay, tag, Wrap(label, operation, delay));
 }
 
-AsyncQueue::Operation AsyncQueue::Wrap(const Operation& operation) {
-  // Decorator pattern: wrap `operation` into a call to `ExecuteBlocking` to
+AsyncQueue::Operation AsyncQueue::Wrap(const char* label,
+                                       const Operation& operation,
+                                       Milliseconds delay) {
+  // Decorator pattern: wrap `operation` into a call to `RunOperation` to
   // ensure that it doesn't spawn any nested operations.
 
   // The Executor guarantees that this operation will either execute before
   // `Dispose` completes or not at all.
-  return [this, operation] { this->ExecuteBlocking(operation); };
+  AsyncQueueStats* stats = stats_.load(std::memory_order_acquire);
+  if (!stats) {
+    return [this, operation] { this->RunOperation(operation); };
+  }
+
+  // Delayed operations only count towards the depth of the queue once they're
+  // due, which the queue can't observe, so only immediate ones are counted.
+  bool counted = delay == Milliseconds(0);
+  if (counted) {
+    stats->RecordEnqueued();
+  }
+
+  auto due = StatsClock::now() + delay;
+  return [this, stats, label, operation, counted, due] {
+    auto start = StatsClock::now();
+    if (counted) {
+      stats->RecordDequeued();
+    }
+
+    this->RunOperation(operation);
+
+    stats->RecordOperation(label, ToStatsDuration(start - due),
+                           ToStatsDuration(StatsClock::now() - start));
+  };
+}
+
+void AsyncQueue::EnableInstrumentation() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (owned_stats_) return;
+
+  owned_stats_ = absl::make_unique<AsyncQueueStats>();
+  stats_.store(owned_stats_.get(), std::memory_order_release);
+}
+
+AsyncQueueStats::Snapshot AsyncQueue::GetStatsSnapshot() const {
+  AsyncQueueStats* stats = stats_.load(std::memory_order_acquire);
+  if (!stats) {
+    return {};
+  }
+  return stats->GetSnapshot();
 }
 
 void AsyncQueue::VerifySequentialOrder() const {
@@ -157,7 +253,7 @@ void AsyncQueue::VerifySequentialOrder() const {
 
 void AsyncQueue::EnqueueBlocking(const Operation& operation) {
   VerifySequentialOrder();
-  executor_->ExecuteBlocking(Wrap(operation));
+  executor_->ExecuteBlocking(Wrap(nullptr, operation));
 }
 
 bool AsyncQueue::IsScheduled(const TimerId timer_id) const {
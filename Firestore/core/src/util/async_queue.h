@@ -24,6 +24,7 @@
 #include <mutex>  // NOLINT(build/c++11)
 #include <vector>
 
+#include "Firestore/core/src/util/async_queue_stats.h"
 #include "Firestore/core/src/util/executor.h"
 
 namespace firebase {
@@ -64,6 +65,24 @@ enum class TimerId {
    */
   GarbageCollectionDelay,
 
+  /**
+   * A timer used to periodically backfill field index entries for documents
+   * that were cached before the index was configured.
+   */
+  IndexBackfill,
+
+  /**
+   * A timer used in `RemoteStore` to apply watch snapshots that are being held
+   * back so that they can be applied together.
+   */
+  WatchSnapshotCoalescing,
+
+  /**
+   * A timer used in `RemoteStore` to give up on a resumed write stream that
+   * doesn't respond to the writes that were sent before it was resumed.
+   */
+  WriteStreamResumeTimeout,
+
   /**
    * A timer used to retry transactions. Since there can be multiple concurrent
    * transactions, multiple of these may be in the queue at a given time.
@@ -84,6 +103,10 @@ enum class TimerId {
 // invoked on the queue or not; check "preconditions" section in comments on
 // each method.
 //
+// Each method that puts an operation on the queue can be given a static label,
+// such as "LocalStore::ApplyRemoteEvent", which identifies the operation in
+// the statistics recorded once `EnableInstrumentation` has been called.
+//
 // A significant portion of `AsyncQueue` interface only exists for test purposes
 // and must *not* be used in regular code.
 class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
@@ -148,6 +171,7 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   //     operation was not enqueued because the `AsyncQueue` has already entered
   //     restricted mode or been disposed.
   bool Enqueue(const Operation& operation);
+  bool Enqueue(const char* label, const Operation& operation);
 
   // Like `Enqueue`, but it will proceed scheduling the requested operation
   // regardless of whether the queue is in restricted mode or not.
@@ -156,9 +180,12 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   //     operation was not enqueued because the `AsyncQueue` has already been
   //     disposed.
   bool EnqueueEvenWhileRestricted(const Operation& operation);
+  bool EnqueueEvenWhileRestricted(const char* label,
+                                  const Operation& operation);
 
   // Like `Enqueue`, but without applying any prerequisite checks.
   bool EnqueueRelaxed(const Operation& operation);
+  bool EnqueueRelaxed(const char* label, const Operation& operation);
 
   // Returns true if the queue is still in the main kRunning mode (i.e. not
   // restricted or disposed).
@@ -179,6 +206,10 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   DelayedOperation EnqueueAfterDelay(Milliseconds delay,
                                      TimerId timer_id,
                                      const Operation& operation);
+  DelayedOperation EnqueueAfterDelay(Milliseconds delay,
+                                     TimerId timer_id,
+                                     const char* label,
+                                     const Operation& operation);
 
   // Direct execution
 
@@ -194,6 +225,18 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   // Precondition: `ExecuteBlocking` is being invoked asynchronously on the
   // queue.
   void ExecuteBlocking(const Operation& operation);
+  void ExecuteBlocking(const char* label, const Operation& operation);
+
+  // Instrumentation
+
+  // Starts recording the wait and run times of operations, and the number of
+  // operations waiting to start. Operations that were enqueued before the
+  // call are not recorded. Calling it more than once has no further effect.
+  void EnableInstrumentation();
+
+  // Returns the statistics recorded since `EnableInstrumentation` was called,
+  // or empty statistics if instrumentation is not enabled.
+  AsyncQueueStats::Snapshot GetStatsSnapshot() const;
 
   // Returns the underlying platform-dependent executor.
   Executor* executor() {
@@ -226,7 +269,15 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
  private:
   explicit AsyncQueue(std::unique_ptr<Executor> executor);
 
-  Operation Wrap(const Operation& operation);
+  using StatsClock = std::chrono::steady_clock;
+
+  Operation Wrap(const char* label,
+                 const Operation& operation,
+                 Milliseconds delay = Milliseconds(0));
+
+  // Runs `operation` with the checks of `ExecuteBlocking`, but without
+  // recording it.
+  void RunOperation(const Operation& operation);
 
   // Asserts that the current invocation happens asynchronously on the queue.
   void VerifyIsCurrentExecutor() const;
@@ -239,6 +290,11 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   Mode mode_ = Mode::kRunning;
 
   std::vector<TimerId> timer_ids_to_skip_;
+
+  // Created by `EnableInstrumentation` and owned by `owned_stats_`. Read
+  // without holding `mutex_`.
+  std::atomic<AsyncQueueStats*> stats_{nullptr};
+  std::unique_ptr<AsyncQueueStats> owned_stats_;
 };
 
 }  // namespace util
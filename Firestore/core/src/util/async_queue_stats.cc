@@ -0,0 +1,235 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/async_queue_stats.h"
+
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include "absl/strings/str_format.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+size_t BucketFor(int64_t micros) {
+  size_t bucket = 0;
+  while (micros > 0 && bucket < LatencyHistogram::kBucketCount - 1) {
+    micros >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+void UpdateMax(std::atomic<int64_t>* max, int64_t value) {
+  int64_t current = max->load(std::memory_order_relaxed);
+  while (value > current &&
+         !max->compare_exchange_weak(current, value,
+                                     std::memory_order_relaxed)) {
+  }
+}
+
+void Merge(LatencyHistogram::Snapshot* into,
+           const LatencyHistogram::Snapshot& from) {
+  for (size_t i = 0; i < LatencyHistogram::kBucketCount; ++i) {
+    into->buckets[i] += from.buckets[i];
+  }
+  into->count += from.count;
+  into->total += from.total;
+  into->max = std::max(into->max, from.max);
+}
+
+std::string FormatMillis(LatencyHistogram::Duration duration) {
+  return absl::StrFormat("%.3f", duration.count() / 1000.0);
+}
+
+}  // namespace
+
+constexpr size_t LatencyHistogram::kBucketCount;
+constexpr size_t AsyncQueueStats::kMaxLabels;
+constexpr const char* AsyncQueueStats::kUnlabeled;
+constexpr const char* AsyncQueueStats::kOverflowLabel;
+
+// MARK: - LatencyHistogram
+
+void LatencyHistogram::Record(Duration duration) {
+  int64_t micros = std::max<int64_t>(duration.count(), 0);
+
+  buckets_[BucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_micros_.fetch_add(micros, std::memory_order_relaxed);
+  UpdateMax(&max_micros_, micros);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const {
+  // The counts are read one by one while other threads may be recording, so
+  // the snapshot is only consistent up to the recordings in progress.
+  Snapshot result;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  result.count = count_.load(std::memory_order_relaxed);
+  result.total = Duration(total_micros_.load(std::memory_order_relaxed));
+  result.max = Duration(max_micros_.load(std::memory_order_relaxed));
+  return result;
+}
+
+LatencyHistogram::Duration LatencyHistogram::BucketLimit(size_t bucket) {
+  return Duration(int64_t{1} << bucket);
+}
+
+LatencyHistogram::Duration LatencyHistogram::Snapshot::Percentile(
+    double percentile) const {
+  uint64_t total_count = 0;
+  for (uint64_t bucket_count : buckets) {
+    total_count += bucket_count;
+  }
+  if (total_count == 0) {
+    return Duration(0);
+  }
+
+  auto rank = static_cast<uint64_t>(percentile / 100.0 * total_count);
+  rank = std::min(std::max<uint64_t>(rank, 1), total_count);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      // The last bucket is unbounded, and no recorded duration exceeds `max`.
+      return i == kBucketCount - 1 ? max : std::min(BucketLimit(i), max);
+    }
+  }
+  return max;
+}
+
+LatencyHistogram::Duration LatencyHistogram::Snapshot::Mean() const {
+  if (count == 0) {
+    return Duration(0);
+  }
+  return Duration(total.count() / static_cast<int64_t>(count));
+}
+
+// MARK: - AsyncQueueStats
+
+AsyncQueueStats::AsyncQueueStats() : slots_(kMaxLabels + 1) {
+  slots_.back().label = kOverflowLabel;
+}
+
+void AsyncQueueStats::RecordEnqueued() {
+  int64_t depth = depth_.fetch_add(1, std::memory_order_relaxed) + 1;
+  UpdateMax(&max_depth_, depth);
+}
+
+void AsyncQueueStats::RecordDequeued() {
+  depth_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void AsyncQueueStats::RecordAllDiscarded() {
+  depth_.store(0, std::memory_order_relaxed);
+}
+
+void AsyncQueueStats::RecordOperation(const char* label,
+                                      Duration wait,
+                                      Duration run) {
+  Slot& slot = FindSlot(label ? label : kUnlabeled);
+  slot.wait.Record(wait);
+  slot.run.Record(run);
+}
+
+AsyncQueueStats::Slot& AsyncQueueStats::FindSlot(const char* label) {
+  size_t start = std::hash<const char*>()(label) % kMaxLabels;
+  for (size_t i = 0; i < kMaxLabels; ++i) {
+    Slot& slot = slots_[(start + i) % kMaxLabels];
+
+    const char* existing = slot.label.load(std::memory_order_acquire);
+    if (existing == nullptr) {
+      // Claim the empty slot. If another thread claims it first, `existing`
+      // is updated to its label.
+      if (slot.label.compare_exchange_strong(existing, label,
+                                             std::memory_order_acq_rel)) {
+        return slot;
+      }
+    }
+    if (existing == label) {
+      return slot;
+    }
+  }
+  return slots_.back();
+}
+
+AsyncQueueStats::Snapshot AsyncQueueStats::GetSnapshot() const {
+  Snapshot result;
+
+  // The same label text can have several addresses, for instance if it's
+  // spelled out in several translation units.
+  std::unordered_map<std::string, size_t> index_by_label;
+  for (const Slot& slot : slots_) {
+    const char* label = slot.label.load(std::memory_order_acquire);
+    if (label == nullptr) {
+      continue;
+    }
+
+    LatencyHistogram::Snapshot run = slot.run.GetSnapshot();
+    if (run.count == 0) {
+      continue;
+    }
+    LatencyHistogram::Snapshot wait = slot.wait.GetSnapshot();
+
+    auto inserted = index_by_label.emplace(label, result.operations.size());
+    if (inserted.second) {
+      result.operations.push_back({label, wait, run});
+    } else {
+      OperationSnapshot& existing = result.operations[inserted.first->second];
+      Merge(&existing.wait, wait);
+      Merge(&existing.run, run);
+    }
+  }
+
+  std::sort(result.operations.begin(), result.operations.end(),
+            [](const OperationSnapshot& lhs, const OperationSnapshot& rhs) {
+              return lhs.run.total > rhs.run.total;
+            });
+
+  result.depth = depth_.load(std::memory_order_relaxed);
+  result.max_depth = max_depth_.load(std::memory_order_relaxed);
+  return result;
+}
+
+std::string AsyncQueueStats::Snapshot::ToString() const {
+  std::string result = absl::StrFormat(
+      "AsyncQueue depth: %d (max %d)\n"
+      "%-40s %8s %10s %10s %10s %10s %10s\n",
+      depth, max_depth, "operation (ms)", "count", "wait p50", "wait p99",
+      "run p50", "run p99", "run total");
+
+  for (const OperationSnapshot& operation : operations) {
+    absl::StrAppendFormat(
+        &result, "%-40s %8d %10s %10s %10s %10s %10s\n", operation.label,
+        operation.run.count, FormatMillis(operation.wait.Percentile(50)),
+        FormatMillis(operation.wait.Percentile(99)),
+        FormatMillis(operation.run.Percentile(50)),
+        FormatMillis(operation.run.Percentile(99)),
+        FormatMillis(operation.run.total));
+  }
+  return result;
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_UTIL_ASYNC_QUEUE_STATS_H_
+#define FIRESTORE_CORE_SRC_UTIL_ASYNC_QUEUE_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+/**
+ * A histogram of durations with exponentially sized buckets, which can be
+ * recorded into from any thread without locking.
+ *
+ * Bucket 0 counts durations under 1 microsecond, and bucket `i` counts
+ * durations in `[2^(i-1), 2^i)` microseconds. The last bucket also counts all
+ * longer durations.
+ */
+class LatencyHistogram {
+ public:
+  using Duration = std::chrono::microseconds;
+
+  static constexpr size_t kBucketCount = 32;
+
+  /** A copy of the counts of a histogram at some point in time. */
+  struct Snapshot {
+    std::array<uint64_t, kBucketCount> buckets{};
+    uint64_t count = 0;
+    Duration total{0};
+    Duration max{0};
+
+    /**
+     * Returns an upper bound of the given percentile (between 0 and 100) of
+     * the recorded durations, which is exact up to the bucket size.
+     */
+    Duration Percentile(double percentile) const;
+
+    Duration Mean() const;
+  };
+
+  void Record(Duration duration);
+
+  Snapshot GetSnapshot() const;
+
+  /** Returns the upper bound of durations counted in the given bucket. */
+  static Duration BucketLimit(size_t bucket);
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<int64_t> total_micros_{0};
+  std::atomic<int64_t> max_micros_{0};
+};
+
+/**
+ * Statistics about the operations run by an `AsyncQueue`, grouped by the
+ * static labels given when the operations are enqueued.
+ *
+ * For each label, it records the time operations spent waiting between being
+ * enqueued (or becoming due, for delayed operations) and starting, and the
+ * time they spent running. It also tracks the number of operations that are
+ * waiting to start.
+ *
+ * Recording never blocks. Labels are told apart by address, which works
+ * because they are string literals; operations under the same label text are
+ * merged in snapshots. Once `kMaxLabels` labels have been seen, operations
+ * under new labels are recorded under `kOverflowLabel`.
+ */
+class AsyncQueueStats {
+ public:
+  using Duration = LatencyHistogram::Duration;
+
+  static constexpr size_t kMaxLabels = 128;
+  static constexpr const char* kUnlabeled = "(unlabeled)";
+  static constexpr const char* kOverflowLabel = "(other)";
+
+  struct OperationSnapshot {
+    std::string label;
+    LatencyHistogram::Snapshot wait;
+    LatencyHistogram::Snapshot run;
+  };
+
+  struct Snapshot {
+    /** Operations by label, in descending order of total run time. */
+    std::vector<OperationSnapshot> operations;
+
+    /** The number of operations that were waiting to start. */
+    int64_t depth = 0;
+
+    /** The largest number of operations that were ever waiting to start. */
+    int64_t max_depth = 0;
+
+    /** Returns a human-readable table, suitable for logging. */
+    std::string ToString() const;
+  };
+
+  AsyncQueueStats();
+
+  /** Records that an operation was added to the queue. */
+  void RecordEnqueued();
+
+  /** Records that an operation was removed from the queue to be run. */
+  void RecordDequeued();
+
+  /** Records that all operations waiting to start were discarded. */
+  void RecordAllDiscarded();
+
+  /** Records an operation that finished running. */
+  void RecordOperation(const char* label, Duration wait, Duration run);
+
+  Snapshot GetSnapshot() const;
+
+ private:
+  struct Slot {
+    std::atomic<const char*> label{nullptr};
+    LatencyHistogram wait;
+    LatencyHistogram run;
+  };
+
+  Slot& FindSlot(const char* label);
+
+  // Open addressing over label addresses. The extra last slot is the overflow
+  // slot.
+  std::vector<Slot> slots_;
+
+  std::atomic<int64_t> depth_{0};
+  std::atomic<int64_t> max_depth_{0};
+};
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_UTIL_ASYNC_QUEUE_STATS_H_
@@ -21,6 +21,7 @@
 #include <sstream>
 
 #include "Firestore/core/src/util/config.h"
+#include "Firestore/core/src/util/executor_work_stealing.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/schedule.h"
 #include "Firestore/core/src/util/task.h"
@@ -145,8 +146,7 @@ void ExecutorStd::Cancel(const Id operation_id) {
     std::lock_guard<std::mutex> lock(mutex_);
     if (!state_) return;
 
-    removed = state_->schedule_.RemoveIf(
-        [operation_id](const Task& t) { return t.id() == operation_id; });
+    removed = state_->schedule_.RemoveById(operation_id);
   }
 
   if (removed) {
@@ -229,8 +229,7 @@ bool ExecutorStd::IsTagScheduled(const Tag tag) const {
 }
 
 bool ExecutorStd::IsIdScheduled(const Id id) const {
-  return state_->schedule_.Contains(
-      [&id](const Task& t) { return t.id() == id; });
+  return state_->schedule_.ContainsId(id);
 }
 
 Task* ExecutorStd::PopFromSchedule() {
@@ -249,7 +248,7 @@ std::unique_ptr<Executor> Executor::CreateSerial(const char*) {
 }
 
 std::unique_ptr<Executor> Executor::CreateConcurrent(const char*, int threads) {
-  return absl::make_unique<ExecutorStd>(threads);
+  return absl::make_unique<ExecutorWorkStealing>(threads);
 }
 
 #endif  // !HAVE_LIBDISPATCH
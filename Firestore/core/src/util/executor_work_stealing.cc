@@ -0,0 +1,468 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/executor_work_stealing.h"
+
+#include <atomic>
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <future>  // NOLINT(build/c++11)
+#include <sstream>
+#include <utility>
+
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/schedule.h"
+#include "Firestore/core/src/util/task.h"
+#include "absl/memory/memory.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+// The only guarantee is that different `thread_id`s will produce different
+// values.
+std::string ThreadIdToString(const std::thread::id thread_id) {
+  std::ostringstream stream;
+  stream << thread_id;
+  return stream.str();
+}
+
+// Wraps a due delayed task so that it can be queued like an immediate
+// operation. The wrapper owns the reference to the task that it was given, and
+// releases it even if the wrapper is destroyed without having been run.
+Executor::Operation RunTaskOperation(Task* task) {
+  std::shared_ptr<Task> owned(task, [](Task* t) { t->Release(); });
+  return [owned] {
+    // `ExecuteAndRelease` consumes a reference of its own.
+    owned->Retain();
+    owned->ExecuteAndRelease();
+  };
+}
+
+}  // namespace
+
+class ExecutorWorkStealing::SharedState {
+ public:
+  explicit SharedState(size_t workers) {
+    for (size_t i = 0; i < workers; ++i) {
+      queues_.push_back(absl::make_unique<WorkQueue>());
+    }
+  }
+
+  size_t NextQueueIndex() {
+    return next_queue_.fetch_add(1, std::memory_order_relaxed) %
+           queues_.size();
+  }
+
+  // Adds `operation` to the back of the queue with the given index. Once the
+  // state has been shut down, the operation is dropped instead.
+  void Push(size_t index, Operation&& operation) {
+    {
+      WorkQueue& queue = *queues_[index];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (shutdown_) {
+        return;
+      }
+      queue.operations.push_back(std::move(operation));
+    }
+
+    // Pairs with the check of `pending_` in `Take`: either a worker that is
+    // about to sleep sees the new operation, or it is counted in
+    // `idle_workers_` here and gets woken up.
+    pending_.fetch_add(1);
+    if (idle_workers_.load() > 0) {
+      std::lock_guard<std::mutex> lock(idle_mutex_);
+      wake_.notify_one();
+    }
+  }
+
+  // Takes the next operation for the worker with the given index, preferring
+  // its own queue, and blocks while there is none. Returns false once the
+  // state has been shut down.
+  bool Take(size_t index, Operation* operation) {
+    for (;;) {
+      if (shutdown_) {
+        return false;
+      }
+      if (TryPop(index, operation) || TrySteal(index, operation)) {
+        pending_.fetch_sub(1);
+        return true;
+      }
+
+      std::unique_lock<std::mutex> lock(idle_mutex_);
+      idle_workers_.fetch_add(1);
+      wake_.wait(lock, [this] { return pending_.load() > 0 || shutdown_; });
+      idle_workers_.fetch_sub(1);
+    }
+  }
+
+  // Drops all queued operations and stops the workers and the timer thread
+  // once they finish what they're running.
+  void Shutdown() {
+    shutdown_ = true;
+
+    for (const auto& queue : queues_) {
+      // Destroy the operations without holding the lock, in case one of their
+      // destructors tries to submit another operation.
+      std::deque<Operation> dropped;
+      {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        dropped.swap(queue->operations);
+      }
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(idle_mutex_);
+      wake_.notify_all();
+    }
+
+    timers_.Clear();
+    timers_.Push(Task::Create(nullptr, Executor::TimePoint{}, kShutdownTag, 0,
+                              [] {}));
+  }
+
+  // Delayed operations that haven't become due yet. Only delayed operations
+  // (and the shutdown marker) are ever put on this schedule.
+  class Schedule timers_;
+
+ private:
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Operation> operations;
+  };
+
+  // The owner of a queue takes operations from the front, in the order they
+  // were submitted.
+  bool TryPop(size_t index, Operation* operation) {
+    WorkQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.operations.empty()) {
+      return false;
+    }
+    *operation = std::move(queue.operations.front());
+    queue.operations.pop_front();
+    return true;
+  }
+
+  // Other workers take operations from the back, which keeps them away from
+  // the end that the owner is working on.
+  bool TrySteal(size_t index, Operation* operation) {
+    for (size_t i = 1; i < queues_.size(); ++i) {
+      WorkQueue& queue = *queues_[(index + i) % queues_.size()];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.operations.empty()) {
+        *operation = std::move(queue.operations.back());
+        queue.operations.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::atomic<size_t> next_queue_{0};
+  std::atomic<bool> shutdown_{false};
+
+  // The number of operations in all queues.
+  std::atomic<int> pending_{0};
+
+  // Workers without anything to do wait on `wake_`.
+  std::atomic<int> idle_workers_{0};
+  std::mutex idle_mutex_;
+  std::condition_variable wake_;
+};
+
+// MARK: - ExecutorWorkStealing
+
+ExecutorWorkStealing::ExecutorWorkStealing(int threads)
+    : state_(std::make_shared<SharedState>(threads)) {
+  HARD_ASSERT(threads > 0);
+
+  for (int i = 0; i < threads; ++i) {
+    worker_thread_pool_.emplace_back(&ExecutorWorkStealing::WorkerThread,
+                                     state_, static_cast<size_t>(i));
+  }
+  timer_thread_ = std::thread(&ExecutorWorkStealing::TimerThread, state_);
+}
+
+ExecutorWorkStealing::~ExecutorWorkStealing() {
+  Dispose();
+}
+
+void ExecutorWorkStealing::Dispose() {
+  std::unordered_map<Id, Task*> local_scheduled;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Do nothing if already disposed.
+    if (disposed_) {
+      return;
+    }
+    disposed_ = true;
+
+    // Transfer the executor's references to the delayed tasks, so that
+    // concurrent calls to `OnCompletion` or `Cancel` can't find them.
+    local_scheduled.swap(scheduled_);
+  }
+
+  state_->Shutdown();
+
+  // Cancelling a task that is currently running waits for it to complete,
+  // unless it's running on this thread.
+  for (const auto& entry : local_scheduled) {
+    entry.second->Cancel();
+    entry.second->Release();
+  }
+
+  // Join the threads while not holding the lock to avoid deadlocks where an
+  // operation tries to access the executor.
+  for (std::thread& thread : worker_thread_pool_) {
+    // If the current thread is running this destructor, we can't join the
+    // thread. Instead detach it and rely on WorkerThread to exit cleanly.
+    if (std::this_thread::get_id() == thread.get_id()) {
+      thread.detach();
+    } else {
+      thread.join();
+    }
+  }
+  timer_thread_.join();
+}
+
+void ExecutorWorkStealing::Execute(Operation&& operation) {
+  // Operations submitted by a worker stay on its own queue, which keeps related
+  // work on the same thread unless other workers run out of work.
+  int worker = CurrentWorkerIndex();
+  size_t index = worker >= 0 ? static_cast<size_t>(worker)
+                             : state_->NextQueueIndex();
+  state_->Push(index, std::move(operation));
+}
+
+void ExecutorWorkStealing::ExecuteBlocking(Operation&& operation) {
+  std::promise<void> signal_finished;
+  Execute([&] {
+    operation();
+    signal_finished.set_value();
+  });
+  signal_finished.get_future().wait();
+}
+
+DelayedOperation ExecutorWorkStealing::Schedule(const Milliseconds delay,
+                                                Tag tag,
+                                                Operation&& operation) {
+  // While negative delay can be interpreted as a request for immediate
+  // execution, supporting it would provide a hacky way to modify FIFO ordering
+  // of immediate operations.
+  HARD_ASSERT(delay.count() >= 0, "Schedule: delay cannot be negative");
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (disposed_) {
+    return {};
+  }
+
+  const auto id = NextIdLocked();
+  Task* task =
+      Task::Create(this, MakeTargetTime(delay), tag, id, std::move(operation));
+
+  task->Retain();  // For the executor's ownership.
+  scheduled_[id] = task;
+  state_->timers_.Push(task);
+  return DelayedOperation(this, id);
+}
+
+void ExecutorWorkStealing::OnCompletion(Task* task) {
+  bool should_release = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // No need to check `disposed_`: in that case `scheduled_` would have been
+    // cleared.
+    auto found = scheduled_.find(task->id());
+    if (found != scheduled_.end() && found->second == task) {
+      should_release = true;
+      scheduled_.erase(found);
+    }
+  }
+
+  // Avoid calling potentially locking methods on the task while holding the
+  // executor's lock.
+  if (should_release) {
+    task->Release();
+  }
+}
+
+void ExecutorWorkStealing::Cancel(const Id operation_id) {
+  Task* found_task = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Removing the task from `scheduled_` transfers the executor's ownership
+    // of it to this method. If the task is missing, it has already run or been
+    // cancelled, and cancelling it again is a no-op.
+    auto found = scheduled_.find(operation_id);
+    if (found != scheduled_.end()) {
+      found_task = found->second;
+      scheduled_.erase(found);
+    }
+  }
+
+  if (!found_task) {
+    return;
+  }
+
+  // The task may have been handed to a worker already, in which case this
+  // prevents it from running once the worker gets to it.
+  found_task->Cancel();
+
+  Task* removed = state_->timers_.RemoveById(operation_id);
+  if (removed) {
+    HARD_ASSERT(removed == found_task);
+    // Release the timer thread's ownership.
+    removed->Release();
+  }
+
+  // Release this method's ownership.
+  found_task->Release();
+}
+
+int ExecutorWorkStealing::CurrentWorkerIndex() const {
+  auto current_id = std::this_thread::get_id();
+  for (size_t i = 0; i < worker_thread_pool_.size(); ++i) {
+    if (worker_thread_pool_[i].get_id() == current_id) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+void ExecutorWorkStealing::WorkerThread(std::shared_ptr<SharedState> state,
+                                        size_t index) {
+  Operation operation;
+  while (state->Take(index, &operation)) {
+    operation();
+
+    // Destroy the operation before blocking for the next one, so that whatever
+    // it captured is released promptly.
+    operation = {};
+  }
+}
+
+void ExecutorWorkStealing::TimerThread(std::shared_ptr<SharedState> state) {
+  for (;;) {
+    Task* task = state->timers_.PopBlocking();
+    if (task->tag() == kShutdownTag) {
+      task->ExecuteAndRelease();
+      break;
+    }
+
+    state->Push(state->NextQueueIndex(), RunTaskOperation(task));
+  }
+}
+
+ExecutorWorkStealing::Id ExecutorWorkStealing::NextIdLocked() {
+  // The wrap around after ~4 billion operations is explicitly ignored, see
+  // `ExecutorStd::NextIdLocked`.
+  return current_id_++;
+}
+
+bool ExecutorWorkStealing::IsCurrentExecutor() const {
+  return CurrentWorkerIndex() >= 0;
+}
+
+std::string ExecutorWorkStealing::CurrentExecutorName() const {
+  if (IsCurrentExecutor()) {
+    return Name();
+  } else {
+    return ThreadIdToString(std::this_thread::get_id());
+  }
+}
+
+std::string ExecutorWorkStealing::Name() const {
+  return ThreadIdToString(worker_thread_pool_.front().get_id());
+}
+
+bool ExecutorWorkStealing::IsTagScheduled(const Tag tag) const {
+  std::vector<Task*> matches;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : scheduled_) {
+      if (entry.second->tag() == tag) {
+        // Retain local references to prevent the task from deleting itself
+        // before it can be examined outside the executor mutex.
+        entry.second->Retain();
+        matches.push_back(entry.second);
+      }
+    }
+  }
+
+  // Tasks that are currently running have to report their completion, which
+  // requires the executor mutex, so they can only be awaited without holding
+  // it. Only tasks that haven't started are considered scheduled.
+  bool tag_scheduled = false;
+  for (Task* task : matches) {
+    // Do not break out of the loop early: every task must be released.
+    if (!tag_scheduled) {
+      tag_scheduled = !task->AwaitIfRunning();
+    }
+    task->Release();
+  }
+  return tag_scheduled;
+}
+
+bool ExecutorWorkStealing::IsIdScheduled(const Id id) const {
+  Task* found_task = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = scheduled_.find(id);
+    if (found != scheduled_.end()) {
+      found_task = found->second;
+      found_task->Retain();
+    }
+  }
+
+  bool id_scheduled = false;
+  if (found_task) {
+    id_scheduled = !found_task->AwaitIfRunning();
+    found_task->Release();
+  }
+  return id_scheduled;
+}
+
+Task* ExecutorWorkStealing::PopFromSchedule() {
+  // Tasks that have already been handed to a worker are about to run, and are
+  // left alone.
+  Task* task = state_->timers_.RemoveIf(
+      [](const Task& t) { return t.tag() != kShutdownTag; });
+  if (!task) {
+    return nullptr;
+  }
+
+  bool should_release = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    should_release = scheduled_.erase(task->id()) > 0;
+  }
+
+  // The caller takes over the timer thread's ownership; the executor's own
+  // reference is released.
+  if (should_release) {
+    task->Release();
+  }
+  return task;
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_UTIL_EXECUTOR_WORK_STEALING_H_
+#define FIRESTORE_CORE_SRC_UTIL_EXECUTOR_WORK_STEALING_H_
+
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <unordered_map>
+#include <vector>
+
+#include "Firestore/core/src/util/executor.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+class Task;
+
+// A concurrent executor that runs operations on a pool of threads, using C++11
+// standard library functionality.
+//
+// Each worker thread has its own queue of operations. Operations submitted by a
+// worker go to its own queue, others are spread across the queues in turn, and
+// a worker whose queue is empty takes operations from the other queues. Unlike
+// `ExecutorStd`, there is no lock that all submissions and workers contend on,
+// and immediate operations are queued without allocating a `Task`.
+//
+// Delayed operations are kept by a dedicated timer thread, which hands them to
+// the workers once they're due.
+//
+// Operations submitted to the same queue start in FIFO order, but operations
+// may run out of order once another worker takes them. Use `ExecutorStd` when
+// operations have to run sequentially.
+class ExecutorWorkStealing : public Executor {
+ public:
+  static constexpr Tag kShutdownTag = -2;
+
+  explicit ExecutorWorkStealing(int threads);
+  ~ExecutorWorkStealing();
+
+  void Dispose() override;
+
+  void Execute(Operation&& operation) override;
+  void ExecuteBlocking(Operation&& operation) override;
+
+  DelayedOperation Schedule(Milliseconds delay,
+                            Tag tag,
+                            Operation&& operation) override;
+
+  bool IsCurrentExecutor() const override;
+  std::string CurrentExecutorName() const override;
+  std::string Name() const override;
+
+  bool IsTagScheduled(Tag tag) const override;
+  bool IsIdScheduled(Id id) const override;
+  Task* PopFromSchedule() override;
+
+ private:
+  class SharedState;
+
+  void OnCompletion(Task* task) override;
+  void Cancel(Id operation_id) override;
+
+  // Returns the index of the worker running on the current thread, or -1 if
+  // the current thread is not one of this executor's workers.
+  int CurrentWorkerIndex() const;
+
+  static void WorkerThread(std::shared_ptr<SharedState> state, size_t index);
+  static void TimerThread(std::shared_ptr<SharedState> state);
+
+  Id NextIdLocked();
+
+  // A mutex protecting the delayed operations below. Immediate operations
+  // never acquire it.
+  mutable std::mutex mutex_;
+
+  // Delayed operations that have neither run nor been cancelled, by their Id.
+  // The executor holds a reference to each of these tasks, in addition to the
+  // one held by the timer thread or the worker queue the task is on.
+  std::unordered_map<Id, Task*> scheduled_;
+
+  Id current_id_ = 0;
+  bool disposed_ = false;
+
+  std::vector<std::thread> worker_thread_pool_;
+  std::thread timer_thread_;
+
+  // State shared with the worker and timer threads, which outlives the
+  // executor if it is destroyed by one of its own operations.
+  std::shared_ptr<SharedState> state_;
+};
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_UTIL_EXECUTOR_WORK_STEALING_H_
@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/util/schedule.h"
 
+#include <iterator>
+
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/task.h"
 #include "absl/memory/memory.h"
@@ -31,22 +33,41 @@ Schedule::~Schedule() {
 void Schedule::Clear() {
   std::unique_lock<std::mutex> lock{mutex_};
 
-  for (Task* task : scheduled_) {
-    task->Release();
+  for (const Entry& entry : immediate_) {
+    entry.task->Release();
+  }
+  for (const Entry& entry : delayed_) {
+    entry.task->Release();
   }
 
-  scheduled_.clear();
+  immediate_.clear();
+  delayed_.clear();
+  delayed_by_id_.clear();
 }
 
 void Schedule::Push(Task* task) {
-  InsertPreservingOrder(task);
+  std::lock_guard<std::mutex> lock{mutex_};
+
+  Entry entry{task->target_time(), next_sequence_++, task};
+  if (entry.target_time == TimePoint{}) {
+    // Immediate entries share the same target time, so appending preserves
+    // the order.
+    immediate_.push_back(entry);
+  } else {
+    // Entries with a later sequence always come after existing entries
+    // scheduled for the same time, which preserves FIFO order.
+    auto inserted = delayed_.insert(delayed_.end(), entry);
+    delayed_by_id_.emplace(task->id(), inserted);
+  }
+
+  cv_.notify_one();
 }
 
 Task* Schedule::PopIfDue() {
   std::lock_guard<std::mutex> lock{mutex_};
 
   if (HasDueLocked()) {
-    return ExtractLocked(scheduled_.begin());
+    return ExtractFrontLocked();
   }
   return nullptr;
 }
@@ -55,7 +76,7 @@ Task* Schedule::PopBlocking() {
   std::unique_lock<std::mutex> lock{mutex_};
 
   while (true) {
-    cv_.wait(lock, [this] { return !scheduled_.empty(); });
+    cv_.wait(lock, [this] { return FrontLocked() != nullptr; });
 
     // To minimize busy waiting, sleep until either the nearest entry in the
     // future either changes, or else becomes due.
@@ -64,9 +85,10 @@ Task* Schedule::PopBlocking() {
     // that's at least as fine-grained as the clock on which `wait_until` is
     // parametrized.
     const auto until = std::chrono::time_point_cast<Clock::duration>(
-        scheduled_.front()->target_time());
+        FrontLocked()->target_time);
     cv_.wait_until(lock, until, [this, until] {
-      return scheduled_.empty() || scheduled_.front()->target_time() != until;
+      const Entry* front = FrontLocked();
+      return front == nullptr || front->target_time != until;
     });
 
     // There are 3 possibilities why `wait_until` has returned:
@@ -81,48 +103,100 @@ Task* Schedule::PopBlocking() {
     //   to #2.
 
     if (HasDueLocked()) {
-      return ExtractLocked(scheduled_.begin());
+      return ExtractFrontLocked();
     }
   }
 }
 
 bool Schedule::empty() const {
   std::lock_guard<std::mutex> lock{mutex_};
-  return scheduled_.empty();
+  return immediate_.empty() && delayed_.empty();
 }
 
 size_t Schedule::size() const {
   std::lock_guard<std::mutex> lock{mutex_};
-  return scheduled_.size();
+  return immediate_.size() + delayed_.size();
 }
 
-void Schedule::InsertPreservingOrder(Task* new_entry) {
+Task* Schedule::RemoveById(Executor::Id id) {
   std::lock_guard<std::mutex> lock{mutex_};
 
-  const auto insertion_point =
-      std::upper_bound(scheduled_.begin(), scheduled_.end(), new_entry,
-                       [](Task* lhs, Task* rhs) {
-                         return lhs->target_time() < rhs->target_time();
-                       });
-  scheduled_.insert(insertion_point, new_entry);
+  auto range = delayed_by_id_.equal_range(id);
+  if (range.first == range.second) {
+    return nullptr;
+  }
+
+  // Ids are unique in practice, but nothing prevents a caller from reusing
+  // them.
+  DelayedQueue::iterator most_due = range.first->second;
+  for (auto iter = std::next(range.first); iter != range.second; ++iter) {
+    if (*iter->second < *most_due) {
+      most_due = iter->second;
+    }
+  }
+  return ExtractLocked(most_due);
+}
+
+bool Schedule::ContainsId(Executor::Id id) const {
+  std::lock_guard<std::mutex> lock{mutex_};
+  return delayed_by_id_.find(id) != delayed_by_id_.end();
+}
 
-  cv_.notify_one();
+// This function expects the mutex to be already locked.
+const Schedule::Entry* Schedule::FrontLocked() const {
+  if (immediate_.empty()) {
+    return delayed_.empty() ? nullptr : &*delayed_.begin();
+  }
+  if (delayed_.empty() || immediate_.front() < *delayed_.begin()) {
+    return &immediate_.front();
+  }
+  return &*delayed_.begin();
 }
 
 // This function expects the mutex to be already locked.
 bool Schedule::HasDueLocked() const {
   namespace chr = std::chrono;
   const auto now = chr::time_point_cast<Duration>(Clock::now());
-  return !scheduled_.empty() && now >= scheduled_.front()->target_time();
+  const Entry* front = FrontLocked();
+  return front != nullptr && now >= front->target_time;
+}
+
+// This function expects the mutex to be already locked.
+Task* Schedule::ExtractFrontLocked() {
+  const Entry* front = FrontLocked();
+  HARD_ASSERT(front != nullptr, "Trying to pop an entry from an empty queue.");
+
+  if (!immediate_.empty() && front == &immediate_.front()) {
+    return ExtractLocked(immediate_.begin());
+  }
+  return ExtractLocked(delayed_.begin());
 }
 
 // This function expects the mutex to be already locked.
-Task* Schedule::ExtractLocked(const Iterator where) {
-  HARD_ASSERT(!scheduled_.empty(),
+Task* Schedule::ExtractLocked(ImmediateQueue::iterator where) {
+  HARD_ASSERT(!immediate_.empty(),
               "Trying to pop an entry from an empty queue.");
 
-  Task* result = *where;
-  scheduled_.erase(where);
+  Task* result = where->task;
+  immediate_.erase(where);
+  cv_.notify_one();
+
+  return result;
+}
+
+// This function expects the mutex to be already locked.
+Task* Schedule::ExtractLocked(DelayedQueue::iterator where) {
+  HARD_ASSERT(!delayed_.empty(), "Trying to pop an entry from an empty queue.");
+
+  Task* result = where->task;
+  auto range = delayed_by_id_.equal_range(result->id());
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    if (iter->second == where) {
+      delayed_by_id_.erase(iter);
+      break;
+    }
+  }
+  delayed_.erase(where);
   cv_.notify_one();
 
   return result;
@@ -17,11 +17,12 @@
 #ifndef FIRESTORE_CORE_SRC_UTIL_SCHEDULE_H_
 #define FIRESTORE_CORE_SRC_UTIL_SCHEDULE_H_
 
-#include <algorithm>
 #include <condition_variable>  // NOLINT(build/c++11)
+#include <cstdint>
 #include <deque>
 #include <mutex>  // NOLINT(build/c++11)
-#include <vector>
+#include <set>
+#include <unordered_map>
 
 #include "Firestore/core/src/util/executor.h"
 
@@ -42,10 +43,15 @@ class Task;
 // The details of time management are completely concealed within the class.
 // Once an entry is scheduled, there is no way to reschedule or even retrieve
 // the time.
+//
+// Immediate entries are kept in a FIFO queue, while delayed entries are kept
+// in a sorted tree indexed by their id, so that pushing, popping and removing
+// an entry by id take O(log n) time.
 class Schedule {
   // Internal invariants:
-  // - entries are always in sorted order, leftmost entry is always the most
-  //   due;
+  // - `immediate_` and `delayed_` are both in sorted order, and the most due
+  //   entry is the smaller of their leftmost entries;
+  // - each entry of `delayed_` has exactly one entry in `delayed_by_id_`;
   // - each operation modifying the queue notifies the condition variable `cv_`.
  public:
   using Duration = Executor::Milliseconds;
@@ -82,45 +88,101 @@ class Schedule {
   //
   // Note that this function doesn't take into account whether the removed entry
   // is past its due time.
+  //
+  // This function takes linear time; prefer `RemoveById` where possible.
   template <typename Pred>
   Task* RemoveIf(const Pred pred) {
     std::lock_guard<std::mutex> lock{mutex_};
 
-    for (auto iter = scheduled_.begin(), end = scheduled_.end(); iter != end;
-         ++iter) {
-      Task* task = *iter;
-      if (pred(*task)) {
-        return ExtractLocked(iter);
+    auto immediate = immediate_.begin();
+    auto delayed = delayed_.begin();
+    while (immediate != immediate_.end() || delayed != delayed_.end()) {
+      if (delayed == delayed_.end() ||
+          (immediate != immediate_.end() && *immediate < *delayed)) {
+        if (pred(*immediate->task)) {
+          return ExtractLocked(immediate);
+        }
+        ++immediate;
+      } else {
+        if (pred(*delayed->task)) {
+          return ExtractLocked(delayed);
+        }
+        ++delayed;
       }
     }
     return nullptr;
   }
 
+  // Removes the delayed entry with the given id from the queue and returns it.
+  // If no such entry exists, returns `nullptr`. If several entries have the
+  // same id, the most due one is removed.
+  //
+  // Immediate entries, which are scheduled for the zero time point, can't be
+  // removed by id. Executors never hand out the ids of immediate operations,
+  // so there is nothing that could cancel them.
+  Task* RemoveById(Executor::Id id);
+
+  // Checks whether the queue contains a delayed entry with the given id.
+  bool ContainsId(Executor::Id id) const;
+
   // Checks whether the queue contains an entry satisfying the given predicate.
   template <typename Pred>
   bool Contains(const Pred pred) const {
     std::lock_guard<std::mutex> lock{mutex_};
-    return std::any_of(scheduled_.begin(), scheduled_.end(),
-                       [&pred](Task* t) { return pred(*t); });
+    for (const Entry& entry : immediate_) {
+      if (pred(*entry.task)) {
+        return true;
+      }
+    }
+    for (const Entry& entry : delayed_) {
+      if (pred(*entry.task)) {
+        return true;
+      }
+    }
+    return false;
   }
 
  private:
-  // All removals are on the front, but most insertions are expected to be on
-  // the back.
-  using Container = std::deque<Task*>;
-  using Iterator = typename Container::iterator;
+  struct Entry {
+    TimePoint target_time;
+    // Breaks ties between entries scheduled for the same time, in the order
+    // they were pushed.
+    uint64_t sequence;
+    Task* task;
+
+    bool operator<(const Entry& rhs) const {
+      if (target_time != rhs.target_time) {
+        return target_time < rhs.target_time;
+      }
+      return sequence < rhs.sequence;
+    }
+  };
+
+  // Immediate entries all have the zero time point as their target time, so
+  // they're only ever appended to the back and removed from the front.
+  using ImmediateQueue = std::deque<Entry>;
+  using DelayedQueue = std::set<Entry>;
+  using DelayedIndex =
+      std::unordered_multimap<Executor::Id, DelayedQueue::iterator>;
 
-  void InsertPreservingOrder(Task* new_entry);
+  // This function expects the mutex to be already locked. Returns `nullptr` if
+  // the schedule is empty.
+  const Entry* FrontLocked() const;
 
   // This function expects the mutex to be already locked.
   bool HasDueLocked() const;
 
-  // This function expects the mutex to be already locked.
-  Task* ExtractLocked(const Iterator where);
+  // These functions expect the mutex to be already locked.
+  Task* ExtractFrontLocked();
+  Task* ExtractLocked(ImmediateQueue::iterator where);
+  Task* ExtractLocked(DelayedQueue::iterator where);
 
   mutable std::mutex mutex_;
   std::condition_variable cv_;
-  Container scheduled_;
+  ImmediateQueue immediate_;
+  DelayedQueue delayed_;
+  DelayedIndex delayed_by_id_;
+  uint64_t next_sequence_ = 0;
 };
 
 }  // namespace util
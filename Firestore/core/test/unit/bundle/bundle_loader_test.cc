@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "Firestore/core/src/bundle/bundle_callback.h"
+#include "Firestore/core/src/bundle/bundle_load_checkpoint.h"
 #include "Firestore/core/src/bundle/bundle_reader.h"
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/core/query.h"
@@ -63,6 +64,17 @@ class BundleLoaderTest : public ::testing::Test {
       return DocumentMap{};
     }
 
+    model::DocumentMap ApplyBundledDocumentChunk(
+        const model::MutableDocumentMap& documents,
+        const BundleLoadCheckpoint& checkpoint) override {
+      for (const auto& entry : documents) {
+        parent_.last_documents_ = parent_.last_documents_.insert(entry.first);
+      }
+      parent_.chunk_sizes_.push_back(documents.size());
+      parent_.last_checkpoint_ = checkpoint;
+      return DocumentMap{};
+    }
+
     void SaveNamedQuery(const NamedQuery& query,
                         const model::DocumentKeySet& keys) override {
       parent_.last_queries_.insert({query.query_name(), keys});
@@ -99,11 +111,40 @@ class BundleLoaderTest : public ::testing::Test {
     return BundleMetadata("bundle-1", 1, create_time_, documents, 10);
   }
 
+  /**
+   * Adds only the metadata of a document that exists and matches the given
+   * queries, as read when the document itself is skipped.
+   */
+  static BundleLoader::AddElementResult AddDocumentMetadata(
+      BundleLoader& loader,
+      const std::string& path,
+      std::vector<std::string> queries = {}) {
+    return loader.AddElement(
+        absl::make_unique<BundledDocumentMetadata>(
+            testutil::Key(path), model::SnapshotVersion::None(),
+            /*exists=*/true, std::move(queries)),
+        /*byte_size=*/1);
+  }
+
+  /** Adds a document that exists and matches the given queries. */
+  static BundleLoader::AddElementResult AddDocument(
+      BundleLoader& loader,
+      const std::string& path,
+      std::vector<std::string> queries = {}) {
+    auto result = AddDocumentMetadata(loader, path, std::move(queries));
+    EXPECT_OK(result);
+    return loader.AddElement(
+        absl::make_unique<BundleDocument>(testutil::Doc(path, 1)),
+        /*byte_size=*/1);
+  }
+
  protected:
   std::unique_ptr<BundleCallback> callback_ = nullptr;
   DocumentKeySet last_documents_;
   std::unordered_map<std::string, DocumentKeySet> last_queries_;
   std::unordered_map<std::string, BundleMetadata> last_bundles_;
+  std::vector<size_t> chunk_sizes_;
+  absl::optional<BundleLoadCheckpoint> last_checkpoint_;
   model::SnapshotVersion create_time_ =
       model::SnapshotVersion(Timestamp::Now());
 };
@@ -250,6 +291,64 @@ TEST_F(BundleLoaderTest, VerifiesDocumentCount) {
   EXPECT_NOT_OK(loader.ApplyChanges());
 }
 
+TEST_F(BundleLoaderTest, CommitsDocumentsInChunks) {
+  BundleLoader loader(callback_.get(), CreateMetadata(3),
+                      /*documents_per_chunk=*/2, absl::nullopt);
+
+  BundleLoader::AddElementResult result = AddDocument(loader, "coll/doc1");
+  EXPECT_OK(result);
+  EXPECT_EQ(result.ValueOrDie(), absl::nullopt);
+  EXPECT_TRUE(chunk_sizes_.empty());
+
+  result = AddDocument(loader, "coll/doc2");
+  EXPECT_OK(result);
+  AssertProgress(result.ValueOrDie(), /*documents_loaded=*/2,
+                 /*total_documents=*/3, /*bytes_loaded*/ 4, /*total_bytes*/ 10,
+                 LoadBundleTaskState::kInProgress);
+  EXPECT_EQ(chunk_sizes_, std::vector<size_t>{2});
+  EXPECT_EQ(last_checkpoint_,
+            BundleLoadCheckpoint("bundle-1", create_time_, 2, 4));
+
+  result = AddDocument(loader, "coll/doc3");
+  EXPECT_OK(result);
+  EXPECT_EQ(result.ValueOrDie(), absl::nullopt);
+
+  EXPECT_OK(loader.ApplyChanges());
+  EXPECT_EQ(chunk_sizes_, (std::vector<size_t>{2, 1}));
+  EXPECT_EQ(last_documents_,
+            DocumentKeySet({testutil::Key("coll/doc1"),
+                            testutil::Key("coll/doc2"),
+                            testutil::Key("coll/doc3")}));
+  EXPECT_EQ(last_bundles_["bundle-1"], CreateMetadata(3));
+}
+
+TEST_F(BundleLoaderTest, ResumesFromCheckpoint) {
+  BundleLoader loader(
+      callback_.get(), CreateMetadata(3), /*documents_per_chunk=*/2,
+      BundleLoadCheckpoint("bundle-1", create_time_, 2, 4));
+
+  // The reader skips the documents before the checkpoint, and only their
+  // metadata is added. They are not committed again.
+  EXPECT_OK(AddDocumentMetadata(loader, "coll/doc1", {"query-1"}));
+  EXPECT_OK(AddDocumentMetadata(loader, "coll/doc2"));
+  EXPECT_OK(AddDocument(loader, "coll/doc3", {"query-1"}));
+  EXPECT_OK(loader.AddElement(
+      absl::make_unique<NamedQuery>(
+          "query-1",
+          BundledQuery(testutil::Query("coll").ToTarget(), LimitType::First),
+          create_time_),
+      /*byte_size=*/4));
+  EXPECT_OK(loader.ApplyChanges());
+
+  EXPECT_EQ(chunk_sizes_, std::vector<size_t>{1});
+  EXPECT_EQ(last_documents_, DocumentKeySet{testutil::Key("coll/doc3")});
+
+  // The named query still matches the documents before the checkpoint.
+  EXPECT_EQ(last_queries_["query-1"],
+            DocumentKeySet({testutil::Key("coll/doc1"),
+                            testutil::Key("coll/doc3")}));
+}
+
 }  //  namespace
 }  //  namespace bundle
 }  //  namespace firestore
@@ -441,6 +441,34 @@ TEST_F(BundleReaderTest, ReadsWithoutNamedQuery) {
       *static_cast<BundleDocument*>(elements[1].get()), Document1());
 }
 
+TEST_F(BundleReaderTest, SkipsDocumentsBeforeOffset) {
+  std::string metadata1 = AddDocumentMetadata(DocumentMetadata1());
+  std::string document1 = AddDocument(Document1());
+  AddDocumentMetadata(DocumentMetadata2());
+  AddDocument(Document2());
+
+  const auto& bundle =
+      BuildBundle("bundle-1", testutil::Version(6000004000), 2);
+  BundleReader reader(bundle_serializer, ToByteStream(bundle));
+  reader.SkipDocumentsUntil(static_cast<int64_t>(
+      std::to_string(metadata1.size()).size() + metadata1.size() +
+      std::to_string(document1.size()).size() + document1.size()));
+
+  std::vector<std::unique_ptr<BundleElement>> elements =
+      VerifyFullBundleParsed(reader, "bundle-1", testutil::Version(6000004000));
+
+  // The metadata of the skipped document is still read.
+  EXPECT_EQ(elements.size(), 3);
+  VerifyDocumentMetadataEquals(
+      *static_cast<BundledDocumentMetadata*>(elements[0].get()),
+      DocumentMetadata1());
+  VerifyDocumentMetadataEquals(
+      *static_cast<BundledDocumentMetadata*>(elements[1].get()),
+      DocumentMetadata2());
+  VerifyDocumentEncodesToOriginal(
+      *static_cast<BundleDocument*>(elements[2].get()), Document2());
+}
+
 TEST_F(BundleReaderTest, ReadsWithDeletedDocument) {
   AddDocumentMetadata(DeletedDocumentMetadata());
   AddDocumentMetadata(DocumentMetadata2());
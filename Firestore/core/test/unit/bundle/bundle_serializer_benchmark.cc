@@ -0,0 +1,144 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "Firestore/core/src/bundle/bundle_serializer.h"
+#include "Firestore/core/src/bundle/json_pull_parser.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "benchmark/benchmark.h"
+
+namespace {
+
+std::atomic<int64_t> allocations{0};
+
+}  // namespace
+
+// Counts heap allocations, so that the decoders can be compared by how much
+// garbage they create as well as by throughput.
+void* operator new(size_t size) {
+  ++allocations;
+  void* result = std::malloc(size == 0 ? 1 : size);
+  if (!result) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+using firebase::firestore::bundle::BundleDocument;
+using firebase::firestore::bundle::BundleSerializer;
+using firebase::firestore::bundle::JsonPullParser;
+using firebase::firestore::bundle::JsonReader;
+using firebase::firestore::model::DatabaseId;
+using firebase::firestore::remote::Serializer;
+
+/**
+ * Builds the JSON of a bundled document with `field_count` fields of mixed
+ * types, similar to what the bundle builders produce.
+ */
+std::string SyntheticDocument(int64_t field_count) {
+  std::string fields;
+  for (int64_t i = 0; i < field_count; ++i) {
+    if (i > 0) {
+      fields += ",";
+    }
+    std::string name = "\"field" + std::to_string(i) + "\":";
+    switch (i % 4) {
+      case 0:
+        fields += name + R"({"stringValue":"some text for )" +
+                  std::to_string(i) + "\"}";
+        break;
+      case 1:
+        fields += name + R"({"integerValue":")" + std::to_string(i * 7919) +
+                  "\"}";
+        break;
+      case 2:
+        fields += name + R"({"timestampValue":"2022-03-04T05:06:07.123Z"})";
+        break;
+      default:
+        fields += name + R"({"mapValue":{"fields":{"nested":)" +
+                  R"({"arrayValue":{"values":[{"doubleValue":1.5},)" +
+                  R"({"booleanValue":true},{"nullValue":null}]}}}}})";
+        break;
+    }
+  }
+
+  return R"({"name":"projects/p/databases/default/documents/coll/doc",)"
+         R"("updateTime":"2022-03-04T05:06:07.123456Z","fields":{)" +
+         fields + "}}";
+}
+
+void ReportCounters(benchmark::State& state,
+                    int64_t bytes,
+                    int64_t allocations_before) {
+  state.SetBytesProcessed(state.iterations() * bytes);
+  state.counters["allocs_per_doc"] = benchmark::Counter(
+      static_cast<double>(allocations - allocations_before) /
+      static_cast<double>(state.iterations()));
+}
+
+void BM_DecodeDocumentFromTree(benchmark::State& state) {
+  BundleSerializer serializer{Serializer(DatabaseId("p", "default"))};
+  std::string json = SyntheticDocument(state.range(0));
+
+  int64_t allocations_before = allocations;
+  for (auto _ : state) {
+    JsonReader reader;
+    auto tree = nlohmann::json::parse(json, /*callback=*/nullptr,
+                                      /*allow_exceptions=*/false);
+    BundleDocument document = serializer.DecodeDocument(reader, tree);
+    HARD_ASSERT(reader.ok(), "Failed to decode synthetic document");
+    benchmark::DoNotOptimize(document);
+  }
+  ReportCounters(state, static_cast<int64_t>(json.size()),
+                 allocations_before);
+}
+BENCHMARK(BM_DecodeDocumentFromTree)->Arg(4)->Arg(64)->Arg(1024);
+
+void BM_DecodeDocumentWithPullParser(benchmark::State& state) {
+  BundleSerializer serializer{Serializer(DatabaseId("p", "default"))};
+  std::string json = SyntheticDocument(state.range(0));
+
+  int64_t allocations_before = allocations;
+  for (auto _ : state) {
+    JsonReader reader;
+    JsonPullParser parser(json, &reader);
+    BundleDocument document = serializer.DecodeDocument(parser);
+    HARD_ASSERT(reader.ok(), "Failed to decode synthetic document");
+    benchmark::DoNotOptimize(document);
+  }
+  ReportCounters(state, static_cast<int64_t>(json.size()),
+                 allocations_before);
+}
+BENCHMARK(BM_DecodeDocumentWithPullParser)->Arg(4)->Arg(64)->Arg(1024);
+
+}  // namespace
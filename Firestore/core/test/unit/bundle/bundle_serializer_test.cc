@@ -19,6 +19,7 @@
 #include "Firestore/Protos/cpp/firestore/bundle.pb.h"
 #include "Firestore/Protos/cpp/firestore/local/maybe_document.pb.h"
 #include "Firestore/Protos/cpp/google/firestore/v1/document.pb.h"
+#include "Firestore/core/src/bundle/json_pull_parser.h"
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/core/target.h"
@@ -135,11 +136,20 @@ class BundleSerializerTest : public ::testing::Test {
     VerifyJsonStringDecodeFails(std::move(json_string));
   }
 
+  // Decodes with both the JSON tree and the pull parser, and verifies that
+  // they agree.
   BundleDocument VerifyJsonStringDecodes(std::string json_string) {
     JsonReader reader;
     BundleDocument actual =
         bundle_serializer.DecodeDocument(reader, Parse(json_string));
     EXPECT_OK(reader.status());
+
+    JsonReader pull_reader;
+    JsonPullParser parser(json_string, &pull_reader);
+    BundleDocument pulled = bundle_serializer.DecodeDocument(parser);
+    parser.ReadEnd();
+    EXPECT_OK(pull_reader.status());
+    EXPECT_EQ(actual.document(), pulled.document());
     return actual;
   }
 
@@ -148,6 +158,11 @@ class BundleSerializerTest : public ::testing::Test {
     BundleDocument actual =
         bundle_serializer.DecodeDocument(reader, Parse(json_string));
     EXPECT_NOT_OK(reader.status());
+
+    JsonReader pull_reader;
+    JsonPullParser parser(json_string, &pull_reader);
+    bundle_serializer.DecodeDocument(parser);
+    EXPECT_NOT_OK(pull_reader.status());
   }
 
   // 1. Take a `Query` object, put it in a `NamedQuery` and encode it to byte
@@ -327,6 +342,28 @@ TEST_F(BundleSerializerTest, DecodesInvalidJsonFails) {
   VerifyJsonStringDecodeFails(json_copy);
 }
 
+TEST_F(BundleSerializerTest, DecodesValuesNestedTooDeeplyFails) {
+  ProtoValue value;
+  value.set_integer_value(12345);
+  ProtoDocument document = TestDocument(value);
+
+  std::string json_string;
+  MessageToJsonString(document, &json_string);
+
+  // Each map adds three levels of JSON nesting.
+  std::string nested = R"({"integerValue":"12345"})";
+  for (size_t i = 0; i != JsonPullParser::kMaxDepth; ++i) {
+    nested = R"({"mapValue":{"fields":{"a":)" + nested + "}}}";
+  }
+  auto json_copy =
+      ReplacedCopy(json_string, R"({"integerValue":"12345"})", nested);
+
+  JsonReader reader;
+  JsonPullParser parser(json_copy, &reader);
+  bundle_serializer.DecodeDocument(parser);
+  EXPECT_NOT_OK(reader.status());
+}
+
 TEST_F(BundleSerializerTest, DecodesNullValue) {
   ProtoValue value;
   value.set_null_value(google::protobuf::NULL_VALUE);
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/bundle/json_pull_parser.h"
+
+#include <string>
+
+#include "Firestore/core/src/util/read_context.h"
+#include "Firestore/core/test/unit/testutil/status_testing.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace bundle {
+namespace {
+
+using Type = JsonPullParser::Type;
+using util::ReadContext;
+
+TEST(JsonPullParserTest, ReadsNestedValues) {
+  ReadContext context;
+  JsonPullParser parser(
+      R"( {"a": [1, -2.5e3, "x"], "b": {"c": true, "d": null}} )", &context);
+
+  std::string name;
+  std::string s;
+  absl::string_view number;
+  bool b = false;
+
+  ASSERT_TRUE(parser.ReadBeginObject());
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  EXPECT_EQ(name, "a");
+  ASSERT_TRUE(parser.ReadBeginArray());
+  ASSERT_TRUE(parser.HasNextElement());
+  ASSERT_TRUE(parser.ReadNumber(&number));
+  EXPECT_EQ(number, "1");
+  ASSERT_TRUE(parser.HasNextElement());
+  ASSERT_TRUE(parser.ReadNumber(&number));
+  EXPECT_EQ(number, "-2.5e3");
+  ASSERT_TRUE(parser.HasNextElement());
+  ASSERT_TRUE(parser.ReadString(&s));
+  EXPECT_EQ(s, "x");
+  EXPECT_FALSE(parser.HasNextElement());
+
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  EXPECT_EQ(name, "b");
+  EXPECT_EQ(parser.PeekType(), Type::Object);
+  ASSERT_TRUE(parser.ReadBeginObject());
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  ASSERT_TRUE(parser.ReadBool(&b));
+  EXPECT_TRUE(b);
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  EXPECT_EQ(name, "d");
+  ASSERT_TRUE(parser.ReadNull());
+  EXPECT_FALSE(parser.ReadMemberName(&name));
+
+  EXPECT_FALSE(parser.ReadMemberName(&name));
+  EXPECT_TRUE(parser.ReadEnd());
+  EXPECT_OK(context.status());
+}
+
+TEST(JsonPullParserTest, ReadsEmptyContainers) {
+  ReadContext context;
+  JsonPullParser parser(R"({"a": {}, "b": []})", &context);
+
+  std::string name;
+  ASSERT_TRUE(parser.ReadBeginObject());
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  ASSERT_TRUE(parser.ReadBeginObject());
+  EXPECT_FALSE(parser.ReadMemberName(&name));
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  ASSERT_TRUE(parser.ReadBeginArray());
+  EXPECT_FALSE(parser.HasNextElement());
+  EXPECT_FALSE(parser.ReadMemberName(&name));
+  EXPECT_TRUE(parser.ReadEnd());
+}
+
+TEST(JsonPullParserTest, DecodesEscapes) {
+  ReadContext context;
+  JsonPullParser parser(R"("a\"\\\/\n\u00e9\u20AC\ud83d\ude00")", &context);
+
+  std::string s;
+  ASSERT_TRUE(parser.ReadString(&s));
+  EXPECT_EQ(s, "a\"\\/\n\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+  EXPECT_TRUE(parser.ReadEnd());
+}
+
+TEST(JsonPullParserTest, SkipsValues) {
+  ReadContext context;
+  JsonPullParser parser(
+      R"({"skip": {"a": [1, {"b": "}"}], "c": false}, "keep": 7})", &context);
+
+  std::string name;
+  absl::string_view number;
+  ASSERT_TRUE(parser.ReadBeginObject());
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  parser.SkipValue();
+  ASSERT_TRUE(parser.ReadMemberName(&name));
+  EXPECT_EQ(name, "keep");
+  ASSERT_TRUE(parser.ReadNumber(&number));
+  EXPECT_EQ(number, "7");
+  EXPECT_FALSE(parser.ReadMemberName(&name));
+  EXPECT_OK(context.status());
+}
+
+TEST(JsonPullParserTest, FailsOnMalformedInput) {
+  for (const char* input :
+       {"", "{", R"({"a" 1})", R"({"a": 1,})", "[1,]", "[1 2]", "01", "1.",
+        "-", "1e", R"("unterminated)", R"("\x")", R"("\ud83d")", "tru",
+        "{} {}"}) {
+    ReadContext context;
+    JsonPullParser parser(input, &context);
+    parser.SkipValue();
+    parser.ReadEnd();
+    EXPECT_NOT_OK(context.status()) << input;
+  }
+}
+
+TEST(JsonPullParserTest, FailsOnInputNestedTooDeeply) {
+  size_t depth = JsonPullParser::kMaxDepth;
+  std::string nested = std::string(depth, '[') + std::string(depth, ']');
+  {
+    ReadContext context;
+    JsonPullParser parser(nested, &context);
+    parser.SkipValue();
+    EXPECT_TRUE(parser.ReadEnd());
+    EXPECT_OK(context.status());
+  }
+
+  ReadContext context;
+  JsonPullParser parser("{\"a\": " + nested + "}", &context);
+  parser.SkipValue();
+  EXPECT_NOT_OK(context.status());
+}
+
+TEST(JsonPullParserTest, StopsAfterFailure) {
+  ReadContext context;
+  JsonPullParser parser(R"(["a", "b"])", &context);
+
+  std::string s;
+  EXPECT_FALSE(parser.ReadBeginObject());
+  EXPECT_NOT_OK(context.status());
+  EXPECT_FALSE(parser.ReadBeginArray());
+  EXPECT_FALSE(parser.ReadString(&s));
+  EXPECT_EQ(parser.PeekType(), Type::Invalid);
+}
+
+}  // namespace
+}  // namespace bundle
+}  // namespace firestore
+}  // namespace firebase
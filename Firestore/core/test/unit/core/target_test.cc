@@ -17,6 +17,7 @@
 #include "Firestore/core/src/core/target.h"
 
 #include <cmath>
+#include <vector>
 
 #include "Firestore/core/src/core/bound.h"
 #include "Firestore/core/src/core/query.h"
@@ -39,6 +40,7 @@ using core::Bound;
 using firebase::firestore::util::ComparisonResult;
 using model::CanonicalId;
 using model::DocumentComparator;
+using model::DocumentKey;
 using model::Equals;
 using model::FieldIndex;
 using model::FieldPath;
@@ -55,6 +57,7 @@ using testutil::DbId;
 using testutil::Doc;
 using testutil::Field;
 using testutil::Filter;
+using testutil::Key;
 using testutil::MakeFieldIndex;
 using testutil::Map;
 using testutil::OrderBy;
@@ -345,6 +348,32 @@ TEST(TargetTest, EndBeforeDoesNotChangeBoundIfNotApplicable) {
   VerifyBound(upper_bound, true, {*Value("a1"), *Value("b1")});
 }
 
+TEST(TargetTest, TargetForSingleDocumentIsDocumentQuery) {
+  Target target = Target::ForDocuments({Key("c/a")});
+
+  EXPECT_EQ(target, Query("c/a").ToTarget());
+  EXPECT_TRUE(target.IsDocumentQuery());
+  EXPECT_TRUE(target.IsDocumentsTarget());
+  EXPECT_EQ(target.GetDocumentKeys(), std::vector<DocumentKey>{Key("c/a")});
+}
+
+TEST(TargetTest, TargetForSeveralDocuments) {
+  Target target = Target::ForDocuments({Key("c/a"), Key("d/b")});
+
+  EXPECT_FALSE(target.IsDocumentQuery());
+  EXPECT_TRUE(target.IsDocumentsTarget());
+  EXPECT_EQ(target.GetDocumentKeys(),
+            (std::vector<DocumentKey>{Key("c/a"), Key("d/b")}));
+
+  Target same = Target::ForDocuments({Key("c/a"), Key("d/b")});
+  Target other = Target::ForDocuments({Key("c/a"), Key("d/c")});
+  EXPECT_EQ(target, same);
+  EXPECT_EQ(target.CanonicalId(), same.CanonicalId());
+  EXPECT_NE(target, other);
+  EXPECT_NE(target.CanonicalId(), other.CanonicalId());
+  EXPECT_FALSE(Query("c").ToTarget().IsDocumentsTarget());
+}
+
 TEST(TargetTest, PartialIndexMatchQueryBound) {
   Target target = Query("c")
                       .AddingFilter(Filter("a", "==", "a"))
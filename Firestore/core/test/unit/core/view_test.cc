@@ -154,6 +154,30 @@ TEST(ViewTest, ReturnsNilIfThereAreNoChanges) {
   ASSERT_FALSE(snapshot.has_value());
 }
 
+TEST(ViewTest, UnchangedDocumentsMatchesComputingNoChanges) {
+  Query query = QueryForMessages().WithLimitToFirst(2);
+  View view(query, DocumentKeySet{});
+
+  Document doc1 = Doc("rooms/eros/messages/1", 0, Map("text", "msg1"));
+  Document doc2 = Doc("rooms/eros/messages/2", 0, Map("text", "msg2"))
+                      .SetHasLocalMutations();
+  ApplyChanges(&view, {doc1, doc2}, absl::nullopt);
+
+  ViewDocumentChanges expected = view.ComputeDocumentChanges(DocUpdates({}));
+  ViewDocumentChanges actual = view.UnchangedDocuments();
+  ASSERT_EQ(actual.document_set(), expected.document_set());
+  ASSERT_EQ(actual.mutated_keys(), expected.mutated_keys());
+  ASSERT_TRUE(actual.change_set().GetChanges().empty());
+  ASSERT_FALSE(actual.needs_refill());
+
+  absl::optional<ViewSnapshot> snapshot =
+      view.ApplyChanges(actual, AckTarget({doc1, doc2})).snapshot();
+  ASSERT_TRUE(snapshot.has_value());
+  ASSERT_THAT(snapshot->documents(), ElementsAre(doc1, doc2));
+  ASSERT_TRUE(snapshot->document_changes().empty());
+  ASSERT_TRUE(snapshot->sync_state_changed());
+}
+
 TEST(ViewTest, DoesNotReturnNilForFirstChanges) {
   Query query = QueryForMessages();
   View view(query, DocumentKeySet{});
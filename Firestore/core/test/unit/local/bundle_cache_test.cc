@@ -19,6 +19,7 @@
 #include <set>
 #include <utility>
 
+#include "Firestore/core/src/bundle/bundle_load_checkpoint.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/bundled_query.h"
 #include "Firestore/core/src/bundle/named_query.h"
@@ -46,6 +47,7 @@ BundleCacheTest::BundleCacheTest() : BundleCacheTest(GetParam()()) {
 namespace {
 
 using bundle::BundledQuery;
+using bundle::BundleLoadCheckpoint;
 using bundle::BundleMetadata;
 using bundle::NamedQuery;
 using core::Query;
@@ -153,6 +155,25 @@ TEST_P(BundleCacheTest, ReturnsSavedCollectionGroupQueries) {
   });
 }
 
+TEST_P(BundleCacheTest, ReturnsSavedBundleLoadCheckpoint) {
+  persistence_->Run("test_returns_saved_bundle_load_checkpoint", [&] {
+    EXPECT_EQ(cache_->GetBundleLoadCheckpoint("bundle-1"), absl::nullopt);
+
+    SnapshotVersion create_time(Timestamp::Now());
+    cache_->SaveBundleLoadCheckpoint(
+        BundleLoadCheckpoint("bundle-1", create_time, 10, 1000));
+    cache_->SaveBundleLoadCheckpoint(
+        BundleLoadCheckpoint("bundle-1", create_time, 20, 2000));
+
+    EXPECT_EQ(cache_->GetBundleLoadCheckpoint("bundle-1"),
+              BundleLoadCheckpoint("bundle-1", create_time, 20, 2000));
+    EXPECT_EQ(cache_->GetBundleLoadCheckpoint("bundle-2"), absl::nullopt);
+
+    cache_->RemoveBundleLoadCheckpoint("bundle-1");
+    EXPECT_EQ(cache_->GetBundleLoadCheckpoint("bundle-1"), absl::nullopt);
+  });
+}
+
 }  // namespace
 }  // namespace local
 }  // namespace firestore
@@ -188,6 +188,18 @@ model::MutableDocumentMap WrappedRemoteDocumentCache::GetAll(
   return result;
 }
 
+model::MutableDocumentMap
+WrappedRemoteDocumentCache::GetDocumentsMatchingQuery(
+    const core::Query& query,
+    const model::IndexOffset& offset,
+    const model::OverlayByDocumentKeyMap& mutated_docs,
+    QueryContext* context) {
+  auto result =
+      subject_->GetDocumentsMatchingQuery(query, offset, mutated_docs, context);
+  query_engine_->documents_read_by_query_ += result.size();
+  return result;
+}
+
 // MARK: - WrappedDocumentOverlayCache
 
 absl::optional<model::Overlay> WrappedDocumentOverlayCache::GetOverlay(
@@ -185,6 +185,24 @@ class WrappedRemoteDocumentCache : public RemoteDocumentCache {
   model::MutableDocumentMap GetAll(const model::ResourcePath& path,
                                    const model::IndexOffset& offset) override;
 
+  model::MutableDocumentMap GetDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      const model::OverlayByDocumentKeyMap& mutated_docs,
+      QueryContext* context) override;
+
+  size_t EstimateCollectionSize(const model::ResourcePath& path,
+                                size_t max_count) const override {
+    // Only keys are read, so the estimate is not counted as documents read.
+    return subject_->EstimateCollectionSize(path, max_count);
+  }
+
+  size_t EstimateChangedDocuments(const model::ResourcePath& path,
+                                  const model::IndexOffset& offset,
+                                  size_t max_count) const override {
+    return subject_->EstimateChangedDocuments(path, offset, max_count);
+  }
+
   void SetIndexManager(IndexManager* manager) override {
     index_manager_ = NOT_NULL(manager);
   }
@@ -0,0 +1,198 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/index_backfiller.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/index_manager.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "absl/memory/memory.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using credentials::User;
+using model::DocumentKey;
+using model::IndexOffset;
+using testutil::Doc;
+using testutil::Filter;
+using testutil::Key;
+using testutil::MakeFieldIndex;
+using testutil::Map;
+using testutil::Query;
+using testutil::Version;
+
+class LevelDbIndexBackfillerTest : public ::testing::Test {
+ public:
+  LevelDbIndexBackfillerTest()
+      : persistence_{LevelDbPersistenceForTesting()},
+        backfiller_{/* max_documents_to_process= */ 10} {
+    User user = User::Unauthenticated();
+    index_manager_ = persistence_->GetIndexManager(user);
+    remote_document_cache_ = persistence_->remote_document_cache();
+    remote_document_cache_->SetIndexManager(index_manager_);
+    local_documents_ = absl::make_unique<LocalDocumentsView>(
+        remote_document_cache_,
+        persistence_->GetMutationQueue(user, index_manager_),
+        persistence_->GetDocumentOverlayCache(user), index_manager_);
+    persistence_->Run("Start IndexManager", [&] { index_manager_->Start(); });
+  }
+
+ protected:
+  void AddFieldIndex(const std::string& collection_group,
+                     const std::string& field) {
+    persistence_->Run("AddFieldIndex", [&] {
+      index_manager_->AddFieldIndex(
+          MakeFieldIndex(collection_group, field, model::Segment::kAscending));
+    });
+  }
+
+  void AddDoc(const std::string& path,
+              int read_time,
+              const std::string& field) {
+    persistence_->Run("AddDoc", [&] {
+      remote_document_cache_->Add(Doc(path, 10, Map(field, 1)),
+                                  Version(read_time));
+    });
+  }
+
+  IndexBackfillerResults Backfill() {
+    return persistence_->Run("Backfill", [&] {
+      return backfiller_.WriteIndexEntries(index_manager_,
+                                           local_documents_.get());
+    });
+  }
+
+  void VerifyQueryResults(const std::string& collection_group,
+                          const std::vector<std::string>& expected_keys) {
+    persistence_->Run("VerifyQueryResults", [&] {
+      core::Target target = Query(collection_group)
+                                .AddingFilter(Filter("foo", "==", 1))
+                                .ToTarget();
+      auto actual = index_manager_->GetDocumentsMatchingTarget(target);
+      ASSERT_TRUE(actual.has_value());
+      std::vector<DocumentKey> expected;
+      for (const std::string& key : expected_keys) {
+        expected.push_back(Key(key));
+      }
+      EXPECT_EQ(expected, *actual);
+    });
+  }
+
+  void VerifyMinOffset(const std::string& collection_group,
+                       int read_time,
+                       const std::string& document_key) {
+    persistence_->Run("VerifyMinOffset", [&] {
+      IndexOffset offset = index_manager_->GetMinOffset(collection_group);
+      EXPECT_EQ(Version(read_time), offset.read_time());
+      EXPECT_EQ(Key(document_key), offset.document_key());
+    });
+  }
+
+  std::unique_ptr<Persistence> persistence_;
+  IndexManager* index_manager_ = nullptr;
+  RemoteDocumentCache* remote_document_cache_ = nullptr;
+  std::unique_ptr<LocalDocumentsView> local_documents_;
+  IndexBackfiller backfiller_;
+};
+
+TEST_F(LevelDbIndexBackfillerTest, DoesNotRunWithoutIndexes) {
+  AddDoc("coll1/docA", 10, "foo");
+
+  IndexBackfillerResults results = Backfill();
+  EXPECT_FALSE(results.did_run);
+  EXPECT_EQ(0u, results.documents_processed);
+}
+
+TEST_F(LevelDbIndexBackfillerTest, WritesLatestReadTimeToFieldIndexes) {
+  AddFieldIndex("coll1", "foo");
+  AddFieldIndex("coll2", "bar");
+  AddDoc("coll1/docA", 10, "foo");
+  AddDoc("coll2/docA", 20, "bar");
+
+  IndexBackfillerResults results = Backfill();
+  EXPECT_TRUE(results.did_run);
+  EXPECT_EQ(2u, results.collection_groups_processed);
+  EXPECT_EQ(2u, results.documents_processed);
+
+  VerifyMinOffset("coll1", 10, "coll1/docA");
+  VerifyMinOffset("coll2", 20, "coll2/docA");
+  VerifyQueryResults("coll1", {"coll1/docA"});
+}
+
+TEST_F(LevelDbIndexBackfillerTest, IndexesDocumentsAcrossParents) {
+  AddFieldIndex("coll", "foo");
+  AddDoc("a/1/coll/docA", 10, "foo");
+  AddDoc("coll/docB", 20, "foo");
+  AddDoc("b/2/coll/docC", 30, "foo");
+
+  IndexBackfillerResults results = Backfill();
+  EXPECT_EQ(3u, results.documents_processed);
+
+  VerifyMinOffset("coll", 30, "b/2/coll/docC");
+}
+
+TEST_F(LevelDbIndexBackfillerTest, ResumesFromOffsetWithinDocumentBudget) {
+  backfiller_.set_max_documents_to_process(2);
+  AddFieldIndex("coll", "foo");
+  AddDoc("coll/docA", 10, "foo");
+  AddDoc("coll/docB", 20, "foo");
+  AddDoc("coll/docC", 30, "foo");
+
+  IndexBackfillerResults results = Backfill();
+  EXPECT_EQ(2u, results.documents_processed);
+  VerifyMinOffset("coll", 20, "coll/docB");
+  VerifyQueryResults("coll", {"coll/docA", "coll/docB"});
+
+  results = Backfill();
+  EXPECT_EQ(1u, results.documents_processed);
+  VerifyMinOffset("coll", 30, "coll/docC");
+  VerifyQueryResults("coll", {"coll/docA", "coll/docB", "coll/docC"});
+
+  EXPECT_EQ(3u, backfiller_.total_documents_processed());
+}
+
+TEST_F(LevelDbIndexBackfillerTest, DoesNotProcessSameCollectionGroupTwice) {
+  AddFieldIndex("coll", "foo");
+  AddDoc("coll/docA", 10, "foo");
+
+  IndexBackfillerResults results = Backfill();
+  EXPECT_EQ(1u, results.collection_groups_processed);
+  EXPECT_EQ(1u, results.documents_processed);
+
+  // Nothing is left to index, but the collection group is still visited.
+  results = Backfill();
+  EXPECT_TRUE(results.did_run);
+  EXPECT_EQ(0u, results.documents_processed);
+}
+
+}  // namespace
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
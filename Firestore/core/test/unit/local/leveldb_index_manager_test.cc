@@ -731,6 +731,47 @@ TEST_F(LevelDbIndexManagerTest, ArrayContainsAnyFilter) {
   });
 }
 
+TEST_F(LevelDbIndexManagerTest, EstimatesDocumentsMatchingTarget) {
+  persistence->Run("TestEstimatesDocumentsMatchingTarget", [&]() {
+    index_manager->Start();
+    SetUpSingleValueFilter();
+
+    auto query = Query("coll").AddingFilter(Filter("count", ">", 1));
+    EXPECT_EQ(2u, index_manager->EstimateDocumentsMatchingTarget(
+                      query.ToTarget(), /* max_count= */ 10));
+    EXPECT_EQ(1u, index_manager->EstimateDocumentsMatchingTarget(
+                      query.ToTarget(), /* max_count= */ 1));
+
+    // Each matching array element is an index entry of its own.
+    auto array_query = Query("coll").AddingFilter(
+        Filter("values", "array-contains-any", Array(1, 2)));
+    EXPECT_FALSE(index_manager
+                     ->EstimateDocumentsMatchingTarget(array_query.ToTarget(),
+                                                       /* max_count= */ 10)
+                     .has_value());
+    SetUpArrayValueFilter();
+    EXPECT_EQ(2u, index_manager->EstimateDocumentsMatchingTarget(
+                      array_query.ToTarget(), /* max_count= */ 10));
+  });
+}
+
+TEST_F(LevelDbIndexManagerTest, MaintainsIndexEntryCount) {
+  persistence->Run("TestMaintainsIndexEntryCount", [&]() {
+    index_manager->Start();
+    auto* leveldb_index_manager =
+        static_cast<LevelDbIndexManager*>(index_manager);
+    SetUpArrayValueFilter();
+    FieldIndex index = index_manager->GetFieldIndexes("coll")[0];
+    EXPECT_EQ(9, leveldb_index_manager->GetIndexEntryCount(index));
+
+    AddDoc("coll/arr1", Map("values", Array(1)));
+    EXPECT_EQ(7, leveldb_index_manager->GetIndexEntryCount(index));
+
+    AddDoc("coll/arr1", Map());
+    EXPECT_EQ(6, leveldb_index_manager->GetIndexEntryCount(index));
+  });
+}
+
 TEST_F(LevelDbIndexManagerTest, ArrayContainsDoesNotMatchNonArray) {
   persistence->Run("TestArrayContainsDoesNotMatchNonArray", [&]() {
     index_manager->Start();
@@ -427,6 +427,50 @@ TEST(RemoteDocumentReadTimeKeyTest, Description) {
       RemoteDocumentReadTimeKey("coll", 1000001, "doc"));
 }
 
+TEST(RemoteDocumentReadTimeIndexKeyTest, Prefixing) {
+  auto table_key = LevelDbRemoteDocumentReadTimeIndexKey::KeyPrefix();
+
+  ASSERT_TRUE(absl::StartsWith(
+      LevelDbRemoteDocumentReadTimeIndexKey::Key(testutil::Key("foo/bar")),
+      table_key));
+}
+
+TEST(RemoteDocumentReadTimeIndexKeyTest, EncodeDecodeCycle) {
+  LevelDbRemoteDocumentReadTimeIndexKey key;
+
+  std::vector<std::string> paths{"foo/bar", "foo/bar2", "foo/bar/baz/quux"};
+  for (auto&& path : paths) {
+    auto encoded =
+        LevelDbRemoteDocumentReadTimeIndexKey::Key(testutil::Key(path));
+    bool ok = key.Decode(encoded);
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(testutil::Key(path), key.document_key());
+  }
+}
+
+TEST(RemoteDocumentReadTimeIndexKeyTest, EncodeDecodeValueCycle) {
+  std::string read_time_key;
+  int64_t document_size = 0;
+
+  std::vector<std::string> keys{
+      "", LevelDbRemoteDocumentReadTimeKey::Key(testutil::Resource("foo"),
+                                                testutil::Version(1), "bar")};
+  for (auto&& key : keys) {
+    auto encoded = LevelDbRemoteDocumentReadTimeIndexKey::EncodeValue(key, 42);
+    bool ok = LevelDbRemoteDocumentReadTimeIndexKey::DecodeValue(
+        encoded, &read_time_key, &document_size);
+    ASSERT_TRUE(ok);
+    ASSERT_EQ(key, read_time_key);
+    ASSERT_EQ(42, document_size);
+  }
+}
+
+TEST(RemoteDocumentReadTimeIndexKeyTest, Description) {
+  AssertExpectedKeyDescription(
+      "[remote_document_read_time_index: path=foo/bar]",
+      LevelDbRemoteDocumentReadTimeIndexKey::Key(testutil::Key("foo/bar")));
+}
+
 TEST(BundleKeyTest, Prefixing) {
   auto table_key = LevelDbBundleKey::KeyPrefix();
 
@@ -25,6 +25,7 @@
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/leveldb_key.h"
+#include "Firestore/core/src/local/leveldb_statistics.h"
 #include "Firestore/core/src/local/leveldb_target_cache.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/nanopb/message.h"
@@ -53,6 +54,7 @@ using nanopb::Message;
 using testutil::Filter;
 using testutil::Key;
 using testutil::Query;
+using testutil::Version;
 using util::OrderedCode;
 using util::Path;
 
@@ -548,6 +550,137 @@ TEST_F(LevelDbMigrationsTest, SetsOverlayMigrationFlag) {
   ASSERT_TRUE(status.ok());
 }
 
+TEST_F(LevelDbMigrationsTest, ComputesStatistics) {
+  LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write documents and entries");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/a")), "abc");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/b")), "de");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/a/sub/c")), "f");
+    transaction.Put(LevelDbRemoteDocumentReadTimeKey::Key(
+                        testutil::Resource("coll"), Version(1), "a"),
+                    "");
+    transaction.Put(LevelDbRemoteDocumentReadTimeKey::Key(
+                        testutil::Resource("coll"), Version(2), "b"),
+                    "");
+    transaction.Put(
+        LevelDbIndexEntryKey::Key(1, "user", "", "x", "ordered", "coll/a"),
+        "");
+    transaction.Put(
+        LevelDbIndexEntryKey::Key(1, "user", "", "y", "ordered", "coll/b"),
+        "");
+    transaction.Put(
+        LevelDbIndexEntryKey::Key(2, "user", "", "x", "ordered", "coll/a"),
+        "");
+    transaction.Commit();
+  }
+
+  LevelDbMigrations::RunMigrations(db_.get(), 9, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Verify");
+
+    CollectionStatistics coll =
+        ReadCollectionStatistics(&transaction, testutil::Resource("coll"));
+    EXPECT_EQ(2, coll.document_count);
+    EXPECT_EQ(5, coll.byte_size);
+    EXPECT_EQ(Version(2), coll.last_read_time);
+
+    CollectionStatistics sub = ReadCollectionStatistics(
+        &transaction, testutil::Resource("coll/a/sub"));
+    EXPECT_EQ(1, sub.document_count);
+    EXPECT_EQ(1, sub.byte_size);
+
+    EXPECT_EQ(2, ReadIndexEntryCount(&transaction, 1, "user"));
+    EXPECT_EQ(1, ReadIndexEntryCount(&transaction, 2, "user"));
+    EXPECT_EQ(0, ReadIndexEntryCount(&transaction, 1, "other-user"));
+  }
+}
+
+TEST_F(LevelDbMigrationsTest, ComputesCacheByteSize) {
+  LevelDbMigrations::RunMigrations(db_.get(), 8, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Write cached data");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/a")), "abc");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/a/sub/b")), "de");
+    transaction.Put(LevelDbTargetKey::Key(1), "fghi");
+    transaction.Put(LevelDbMutationKey::Key("user", 1), "jklmn");
+    transaction.Commit();
+  }
+
+  LevelDbMigrations::RunMigrations(db_.get(), 10, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Verify");
+    EXPECT_EQ(14, ReadCacheByteSize(&transaction));
+  }
+}
+
+TEST_F(LevelDbMigrationsTest, BuildsReadTimeIndex) {
+  LevelDbMigrations::RunMigrations(db_.get(), 10, *serializer_);
+  auto read_time_key = [](const char* document_id, int version) {
+    return LevelDbRemoteDocumentReadTimeKey::Key(testutil::Resource("coll"),
+                                                 Version(version), document_id);
+  };
+  {
+    LevelDbTransaction transaction(db_.get(), "Write documents and read times");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/a")), "abc");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/b")), "de");
+    transaction.Put(LevelDbRemoteDocumentKey::Key(Key("coll/d")), "f");
+    // "coll/a" was re-added, and "coll/c" was removed, before the index was
+    // maintained. "coll/d" has no read time row.
+    transaction.Put(read_time_key("a", 1), "");
+    transaction.Put(read_time_key("a", 3), "");
+    transaction.Put(read_time_key("b", 2), "");
+    transaction.Put(read_time_key("c", 1), "");
+    transaction.Commit();
+  }
+
+  LevelDbMigrations::RunMigrations(db_.get(), 11, *serializer_);
+  {
+    LevelDbTransaction transaction(db_.get(), "Verify");
+    std::string value;
+    std::string indexed_key;
+    int64_t document_size = 0;
+
+    ASSERT_TRUE(
+        transaction
+            .Get(LevelDbRemoteDocumentReadTimeIndexKey::Key(Key("coll/a")),
+                 &value)
+            .ok());
+    ASSERT_TRUE(LevelDbRemoteDocumentReadTimeIndexKey::DecodeValue(
+        value, &indexed_key, &document_size));
+    EXPECT_EQ(read_time_key("a", 3), indexed_key);
+    EXPECT_EQ(3, document_size);
+    ASSERT_TRUE(
+        transaction
+            .Get(LevelDbRemoteDocumentReadTimeIndexKey::Key(Key("coll/b")),
+                 &value)
+            .ok());
+    ASSERT_TRUE(LevelDbRemoteDocumentReadTimeIndexKey::DecodeValue(
+        value, &indexed_key, &document_size));
+    EXPECT_EQ(read_time_key("b", 2), indexed_key);
+    EXPECT_EQ(2, document_size);
+    ASSERT_TRUE(
+        transaction
+            .Get(LevelDbRemoteDocumentReadTimeIndexKey::Key(Key("coll/d")),
+                 &value)
+            .ok());
+    ASSERT_TRUE(LevelDbRemoteDocumentReadTimeIndexKey::DecodeValue(
+        value, &indexed_key, &document_size));
+    EXPECT_EQ("", indexed_key);
+    EXPECT_EQ(1, document_size);
+    EXPECT_TRUE(
+        transaction
+            .Get(LevelDbRemoteDocumentReadTimeIndexKey::Key(Key("coll/c")),
+                 &value)
+            .IsNotFound());
+
+    EXPECT_TRUE(transaction.Get(read_time_key("a", 1), &value).IsNotFound());
+    EXPECT_TRUE(transaction.Get(read_time_key("a", 3), &value).ok());
+    EXPECT_TRUE(transaction.Get(read_time_key("b", 2), &value).ok());
+    EXPECT_TRUE(transaction.Get(read_time_key("c", 1), &value).IsNotFound());
+  }
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/leveldb_opener.h"
 
+#include "Firestore/core/src/api/settings.h"
 #include "Firestore/core/src/core/database_info.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_serializer.h"
@@ -31,6 +32,7 @@
 #include "absl/strings/str_cat.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "leveldb/db.h"
 
 namespace firebase {
 namespace firestore {
@@ -214,6 +216,40 @@ TEST(LevelDbOpenerTest, WorksWithoutLegacyData) {
   ASSERT_THAT(other_fs.IsDirectory(data_dir), IsOk());
 }
 
+TEST(LevelDbOpenerTest, CanReopenWithDifferentParams) {
+  TestTempDir root_dir;
+  OtherFilesystem other_fs(root_dir.path());
+  LevelDbOpener opener(FakeDatabaseInfo(), &other_fs);
+
+  {
+    auto created = opener.Create(LruParams::Disabled());
+    ASSERT_OK(created.status());
+    auto persistence = std::move(created).ValueOrDie();
+    leveldb::Status status =
+        persistence->ptr()->Put(leveldb::WriteOptions(), "key", "value");
+    ASSERT_TRUE(status.ok());
+    persistence->Shutdown();
+  }
+
+  api::Settings settings;
+  settings.set_leveldb_block_cache_size_bytes(64 * 1024);
+  settings.set_leveldb_bloom_filter_bits_per_key(0);
+  settings.set_leveldb_write_buffer_size_bytes(1024 * 1024);
+  settings.set_leveldb_max_file_size_bytes(1024 * 1024);
+  settings.set_leveldb_compression_enabled(false);
+
+  auto created = opener.Create(LruParams::Disabled(),
+                               LevelDbParams::FromSettings(settings));
+  ASSERT_OK(created.status());
+  auto persistence = std::move(created).ValueOrDie();
+  std::string value;
+  leveldb::Status status =
+      persistence->ptr()->Get(leveldb::ReadOptions(), "key", &value);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(value, "value");
+  persistence->Shutdown();
+}
+
 class MockFilesystem : public Filesystem {
  public:
   MOCK_METHOD1(AppDataDir, StatusOr<Path>(absl::string_view));
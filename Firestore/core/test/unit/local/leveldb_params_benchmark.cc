@@ -0,0 +1,189 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "Firestore/core/src/local/leveldb_key.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/lru_garbage_collector.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/util/filesystem.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/path.h"
+#include "Firestore/core/src/util/secure_random.h"
+#include "Firestore/core/test/unit/local/persistence_testing.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "leveldb/db.h"
+#include "leveldb/write_batch.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+using model::DocumentKey;
+using util::Filesystem;
+using util::Path;
+using util::SecureRandom;
+
+// About 1 GB of remote documents.
+constexpr int kDocumentCount = 1024 * 1024;
+constexpr int kDocumentSize = 1024;
+constexpr int kDocumentsPerBatch = 1024;
+constexpr int kScanLength = 100;
+
+std::string RemoteDocumentKey(int i) {
+  return LevelDbRemoteDocumentKey::Key(
+      DocumentKey::FromPathString(absl::StrCat("coll/doc", i)));
+}
+
+/** Returns a document that compresses to about half its size. */
+std::string DocumentContents(SecureRandom* random) {
+  std::string result(kDocumentSize, 'x');
+  for (int i = 0; i < kDocumentSize; i += 2) {
+    result[i] = static_cast<char>(random->Uniform(256));
+  }
+  return result;
+}
+
+/**
+ * Opens a database tuned with the block cache size in MB, bloom filter bits
+ * per key and compression given by the benchmark's arguments.
+ *
+ * Filters and compression only apply to the tables they are written with, so
+ * each combination of them is populated in a directory of its own. The
+ * directories are kept across runs, since populating them is slow. Documents
+ * are written in order, so the last one marks a completely populated
+ * database.
+ */
+std::unique_ptr<LevelDbPersistence> OpenTunedDatabase(
+    const benchmark::State& state) {
+  LevelDbParams params = LevelDbParams::Default();
+  params.block_cache_size_bytes = state.range(0) * 1024 * 1024;
+  params.bloom_filter_bits_per_key = static_cast<int>(state.range(1));
+  params.compression_enabled = state.range(2) != 0;
+
+  auto* fs = Filesystem::Default();
+  Path dir = fs->TempDir().AppendUtf8(
+      absl::StrCat("LevelDbParamsBenchmark_", kDocumentCount, "_",
+                   params.bloom_filter_bits_per_key, "_",
+                   params.compression_enabled));
+
+  auto created = LevelDbPersistence::Create(dir, MakeLocalSerializer(),
+                                            LruParams::Disabled(), params);
+  HARD_ASSERT(created.ok(), "Failed to open LevelDB: %s",
+              created.status().ToString());
+  std::unique_ptr<LevelDbPersistence> persistence =
+      std::move(created).ValueOrDie();
+
+  std::string last_document;
+  leveldb::Status found = persistence->ptr()->Get(
+      StandardReadOptions(), RemoteDocumentKey(kDocumentCount - 1),
+      &last_document);
+  if (!found.ok()) {
+    SecureRandom random;
+    for (int i = 0; i < kDocumentCount; i += kDocumentsPerBatch) {
+      leveldb::WriteBatch batch;
+      for (int j = i; j < i + kDocumentsPerBatch; ++j) {
+        batch.Put(RemoteDocumentKey(j), DocumentContents(&random));
+      }
+      leveldb::Status status =
+          persistence->ptr()->Write(leveldb::WriteOptions(), &batch);
+      HARD_ASSERT(status.ok(), "Failed to populate LevelDB: %s",
+                  status.ToString());
+    }
+    persistence->ptr()->CompactRange(nullptr, nullptr);
+  }
+
+  return persistence;
+}
+
+void BM_PointLookup(benchmark::State& state) {
+  std::unique_ptr<LevelDbPersistence> persistence = OpenTunedDatabase(state);
+  leveldb::DB* db = persistence->ptr();
+  SecureRandom random;
+  std::string value;
+
+  for (auto _ : state) {
+    std::string key = RemoteDocumentKey(
+        static_cast<int>(random.Uniform(kDocumentCount)));
+    leveldb::Status status = db->Get(StandardReadOptions(), key, &value);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetItemsProcessed(state.iterations());
+  persistence->Shutdown();
+}
+
+void BM_MissingPointLookup(benchmark::State& state) {
+  std::unique_ptr<LevelDbPersistence> persistence = OpenTunedDatabase(state);
+  leveldb::DB* db = persistence->ptr();
+  SecureRandom random;
+  std::string value;
+
+  for (auto _ : state) {
+    // Interleaves with the existing keys, which defeats the key ranges of the
+    // tables, and so only a bloom filter avoids reading a block.
+    std::string key =
+        RemoteDocumentKey(static_cast<int>(random.Uniform(kDocumentCount))) +
+        "_missing";
+    leveldb::Status status = db->Get(StandardReadOptions(), key, &value);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetItemsProcessed(state.iterations());
+  persistence->Shutdown();
+}
+
+void BM_Scan(benchmark::State& state) {
+  std::unique_ptr<LevelDbPersistence> persistence = OpenTunedDatabase(state);
+  leveldb::DB* db = persistence->ptr();
+  SecureRandom random;
+  int64_t bytes = 0;
+
+  for (auto _ : state) {
+    std::unique_ptr<leveldb::Iterator> it(
+        db->NewIterator(StandardReadOptions()));
+    it->Seek(RemoteDocumentKey(
+        static_cast<int>(random.Uniform(kDocumentCount))));
+    for (int i = 0; i < kScanLength && it->Valid(); ++i, it->Next()) {
+      bytes += static_cast<int64_t>(it->value().size());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kScanLength);
+  state.SetBytesProcessed(bytes);
+  persistence->Shutdown();
+}
+
+// Arguments: block cache MB, bloom filter bits per key, compression.
+void TuningArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"cache_mb", "bloom_bits", "snappy"})
+      ->Args({8, 0, 1})
+      ->Args({8, 10, 1})
+      ->Args({64, 10, 1})
+      ->Args({256, 10, 1})
+      ->Args({256, 10, 0});
+}
+
+BENCHMARK(BM_PointLookup)->Apply(TuningArguments);
+BENCHMARK(BM_MissingPointLookup)->Apply(TuningArguments);
+BENCHMARK(BM_Scan)->Apply(TuningArguments);
+
+}  // namespace
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/leveldb_persistence.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/api/settings.h"
+#include "gtest/gtest.h"
+#include "leveldb/cache.h"
+#include "leveldb/filter_policy.h"
+#include "leveldb/options.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+/** Returns the size of the filter that `policy` creates for 100 keys. */
+size_t FilterSize(const leveldb::FilterPolicy& policy) {
+  std::vector<std::string> storage;
+  for (int i = 0; i < 100; ++i) {
+    storage.push_back("key" + std::to_string(i));
+  }
+  std::vector<leveldb::Slice> keys(storage.begin(), storage.end());
+
+  std::string filter;
+  policy.CreateFilter(keys.data(), static_cast<int>(keys.size()), &filter);
+  return filter.size();
+}
+
+LevelDbParams Params(int64_t block_cache_size_bytes,
+                     int bloom_filter_bits_per_key) {
+  LevelDbParams params = LevelDbParams::Default();
+  params.block_cache_size_bytes = block_cache_size_bytes;
+  params.bloom_filter_bits_per_key = bloom_filter_bits_per_key;
+  return params;
+}
+
+}  // namespace
+
+TEST(LevelDbPersistenceTest, OptionsUseBlockCacheFromParams) {
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy;
+  std::unique_ptr<leveldb::Cache> block_cache;
+  leveldb::Options options =
+      LevelDbOptions(Params(1024 * 1024, 0), &filter_policy, &block_cache);
+
+  ASSERT_NE(block_cache, nullptr);
+  EXPECT_EQ(options.block_cache, block_cache.get());
+}
+
+TEST(LevelDbPersistenceTest, OptionsUseBloomFilterFromParams) {
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy;
+  std::unique_ptr<leveldb::Cache> block_cache;
+  leveldb::Options options =
+      LevelDbOptions(Params(0, 10), &filter_policy, &block_cache);
+
+  ASSERT_NE(filter_policy, nullptr);
+  EXPECT_EQ(options.filter_policy, filter_policy.get());
+  EXPECT_STREQ(options.filter_policy->Name(), "leveldb.BuiltinBloomFilter2");
+
+  // More bits per key make each table's filter larger.
+  std::unique_ptr<const leveldb::FilterPolicy> larger_filter_policy;
+  LevelDbOptions(Params(0, 20), &larger_filter_policy, &block_cache);
+  ASSERT_NE(larger_filter_policy, nullptr);
+  EXPECT_GT(FilterSize(*larger_filter_policy), FilterSize(*filter_policy));
+}
+
+TEST(LevelDbPersistenceTest, OptionsKeepLevelDbDefaultsForDisabledParams) {
+  LevelDbParams params = Params(0, 0);
+  params.write_buffer_size_bytes = 0;
+  params.max_file_size_bytes = 0;
+
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy;
+  std::unique_ptr<leveldb::Cache> block_cache;
+  leveldb::Options options =
+      LevelDbOptions(params, &filter_policy, &block_cache);
+
+  leveldb::Options defaults;
+  EXPECT_EQ(filter_policy, nullptr);
+  EXPECT_EQ(block_cache, nullptr);
+  EXPECT_EQ(options.filter_policy, nullptr);
+  EXPECT_EQ(options.block_cache, nullptr);
+  EXPECT_EQ(options.write_buffer_size, defaults.write_buffer_size);
+  EXPECT_EQ(options.max_file_size, defaults.max_file_size);
+  EXPECT_TRUE(options.create_if_missing);
+}
+
+TEST(LevelDbPersistenceTest, OptionsUseTableSettings) {
+  api::Settings settings;
+  settings.set_leveldb_write_buffer_size_bytes(2 * 1024 * 1024);
+  settings.set_leveldb_max_file_size_bytes(4 * 1024 * 1024);
+  settings.set_leveldb_compression_enabled(false);
+
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy;
+  std::unique_ptr<leveldb::Cache> block_cache;
+  leveldb::Options options = LevelDbOptions(
+      LevelDbParams::FromSettings(settings), &filter_policy, &block_cache);
+
+  EXPECT_EQ(options.write_buffer_size, 2u * 1024 * 1024);
+  EXPECT_EQ(options.max_file_size, 4u * 1024 * 1024);
+  EXPECT_EQ(options.compression, leveldb::kNoCompression);
+}
+
+TEST(LevelDbPersistenceTest, DefaultParamsUseBloomFilter) {
+  std::unique_ptr<const leveldb::FilterPolicy> filter_policy;
+  std::unique_ptr<leveldb::Cache> block_cache;
+  leveldb::Options options =
+      LevelDbOptions(LevelDbParams::Default(), &filter_policy, &block_cache);
+
+  ASSERT_NE(filter_policy, nullptr);
+  EXPECT_EQ(options.filter_policy, filter_policy.get());
+  EXPECT_EQ(options.compression, leveldb::kSnappyCompression);
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -96,6 +96,48 @@ TEST_F(LevelDbQueryEngineTest, CombinesIndexedWithNonIndexedResults) {
   });
 }
 
+TEST_F(LevelDbQueryEngineTest, ExplainCountsDocumentsChangedSinceTheIndex) {
+  persistence_->Run("ExplainCountsDocumentsChangedSinceTheIndex", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+
+    auto doc1 = Doc("coll/a", 1, Map("foo", true));
+    auto doc2 = Doc("coll/b", 2, Map("foo", true));
+    auto doc3 = Doc("coll/c", 3, Map("foo", true));
+
+    index_manager_->AddFieldIndex(
+        MakeFieldIndex("coll", "foo", model::Segment::kAscending));
+
+    AddDocuments({doc1, doc2});
+
+    DocumentMap doc_map;
+    doc_map = doc_map.insert(doc1.key(), doc1);
+    doc_map = doc_map.insert(doc2.key(), doc2);
+    index_manager_->UpdateIndexEntries(doc_map);
+    index_manager_->UpdateCollectionGroup(
+        "coll", model::IndexOffset::FromDocument(doc2));
+
+    AddDocuments({doc3});
+
+    core::Query query = Query("coll").AddingFilter(Filter("foo", "==", true));
+
+    local_documents_view_.ExpectFullCollectionScan(false);
+    QueryExplanation explanation =
+        query_engine_.Explain(query, SnapshotVersion::None(),
+                              model::DocumentKeySet{});
+
+    // The index plan also reads the document that has not been indexed yet.
+    EXPECT_EQ(QueryPlan::Strategy::Index, explanation.chosen_plan.strategy);
+    EXPECT_EQ(3u, explanation.chosen_plan.estimated_documents);
+    ASSERT_EQ(2u, explanation.candidate_plans.size());
+    EXPECT_EQ(QueryPlan::Strategy::FullCollectionScan,
+              explanation.candidate_plans[1].strategy);
+    EXPECT_EQ(3u, explanation.candidate_plans[1].estimated_documents);
+    EXPECT_EQ(3u, explanation.documents_read);
+    EXPECT_EQ(3u, explanation.documents_returned);
+  });
+}
+
 TEST_F(LevelDbQueryEngineTest, UsesPartialIndexForLimitQueries) {
   persistence_->Run("UsesPartialIndexForLimitQueries", [&] {
     mutation_queue_->Start();
@@ -18,11 +18,16 @@
 #include <memory>
 #include <string>
 
+#include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_remote_document_cache.h"
+#include "Firestore/core/src/local/leveldb_statistics.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/util/ordered_code.h"
+#include "Firestore/core/src/util/path.h"
 #include "Firestore/core/test/unit/local/persistence_testing.h"
 #include "Firestore/core/test/unit/local/remote_document_cache_test.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
 #include "absl/memory/memory.h"
 #include "leveldb/db.h"
 
@@ -32,6 +37,11 @@ namespace local {
 namespace {
 
 using leveldb::WriteOptions;
+using testutil::Doc;
+using testutil::Key;
+using testutil::Map;
+using testutil::Resource;
+using testutil::Version;
 using util::OrderedCode;
 
 // A dummy document value, useful for testing code that's known to examine only
@@ -84,6 +94,107 @@ INSTANTIATE_TEST_SUITE_P(LevelDbRemoteDocumentCacheTest,
                          RemoteDocumentCacheTest,
                          testing::Values(PersistenceFactory));
 
+TEST(LevelDbRemoteDocumentCacheTest, MaintainsCollectionStatistics) {
+  std::unique_ptr<LevelDbPersistence> persistence =
+      LevelDbPersistenceForTesting();
+  LevelDbRemoteDocumentCache* cache = persistence->remote_document_cache();
+  cache->SetIndexManager(
+      persistence->GetIndexManager(credentials::User::Unauthenticated()));
+
+  persistence->Run("MaintainsCollectionStatistics", [&] {
+    cache->Add(Doc("coll/a", 1, Map("a", 1)), Version(10));
+    cache->Add(Doc("coll/b", 1, Map("b", 1)), Version(20));
+    CollectionStatistics statistics =
+        cache->GetCollectionStatistics(Resource("coll"));
+    EXPECT_EQ(2, statistics.document_count);
+    EXPECT_GT(statistics.byte_size, 0);
+    EXPECT_EQ(Version(20), statistics.last_read_time);
+
+    // Replacing a document only changes its size.
+    int64_t byte_size = statistics.byte_size;
+    cache->Add(Doc("coll/a", 2, Map("a", "a longer value")), Version(15));
+    statistics = cache->GetCollectionStatistics(Resource("coll"));
+    EXPECT_EQ(2, statistics.document_count);
+    EXPECT_GT(statistics.byte_size, byte_size);
+    EXPECT_EQ(Version(20), statistics.last_read_time);
+
+    cache->Remove(Key("coll/a"));
+    cache->Remove(Key("coll/missing"));
+    statistics = cache->GetCollectionStatistics(Resource("coll"));
+    EXPECT_EQ(1, statistics.document_count);
+    EXPECT_LT(statistics.byte_size, byte_size);
+
+    cache->Remove(Key("coll/b"));
+    EXPECT_EQ(CollectionStatistics{},
+              cache->GetCollectionStatistics(Resource("coll")));
+  });
+}
+
+TEST(LevelDbRemoteDocumentCacheTest, WritesCollectionStatisticsOnCommit) {
+  std::unique_ptr<LevelDbPersistence> persistence =
+      LevelDbPersistenceForTesting();
+  LevelDbRemoteDocumentCache* cache = persistence->remote_document_cache();
+  cache->SetIndexManager(
+      persistence->GetIndexManager(credentials::User::Unauthenticated()));
+
+  CollectionStatistics statistics;
+  persistence->Run("Add documents", [&] {
+    cache->Add(Doc("coll/a", 1, Map("a", 1)), Version(10));
+    cache->Add(Doc("coll/a", 2, Map("a", 2)), Version(20));
+    cache->Add(Doc("coll/b", 1, Map("b", 1)), Version(15));
+    statistics = cache->GetCollectionStatistics(Resource("coll"));
+  });
+
+  persistence->Run("Verify and remove", [&] {
+    EXPECT_EQ(statistics, ReadCollectionStatistics(
+                              persistence->current_transaction(),
+                              Resource("coll")));
+    EXPECT_EQ(2, statistics.document_count);
+    EXPECT_EQ(Version(20), statistics.last_read_time);
+
+    cache->Remove(Key("coll/a"));
+  });
+
+  persistence->Run("Verify", [&] {
+    CollectionStatistics stored = ReadCollectionStatistics(
+        persistence->current_transaction(), Resource("coll"));
+    EXPECT_EQ(1, stored.document_count);
+    EXPECT_EQ(cache->GetCollectionStatistics(Resource("coll")), stored);
+  });
+}
+
+TEST(LevelDbRemoteDocumentCacheTest, MaintainsCacheByteSize) {
+  util::Path dir = LevelDbDir();
+  std::unique_ptr<LevelDbPersistence> persistence =
+      LevelDbPersistenceForTesting(dir);
+  LevelDbRemoteDocumentCache* cache = persistence->remote_document_cache();
+  cache->SetIndexManager(
+      persistence->GetIndexManager(credentials::User::Unauthenticated()));
+  ASSERT_EQ(0, persistence->CalculateByteSize().ValueOrDie());
+
+  int64_t byte_size = 0;
+  persistence->Run("MaintainsCacheByteSize", [&] {
+    cache->Add(Doc("coll/a", 1, Map("a", 1)), Version(10));
+    cache->Add(Doc("other/b", 1, Map("b", 1)), Version(20));
+    byte_size = cache->GetCollectionStatistics(Resource("coll")).byte_size +
+                cache->GetCollectionStatistics(Resource("other")).byte_size;
+    EXPECT_EQ(byte_size, persistence->CalculateByteSize().ValueOrDie());
+  });
+  persistence->Shutdown();
+  persistence.reset();
+
+  // The size is read back from the database when it is reopened.
+  persistence = LevelDbPersistenceForTesting(dir);
+  cache = persistence->remote_document_cache();
+  ASSERT_EQ(byte_size, persistence->CalculateByteSize().ValueOrDie());
+
+  persistence->Run("MaintainsCacheByteSize", [&] {
+    cache->Remove(Key("coll/a"));
+    cache->Remove(Key("other/b"));
+  });
+  ASSERT_EQ(0, persistence->CalculateByteSize().ValueOrDie());
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
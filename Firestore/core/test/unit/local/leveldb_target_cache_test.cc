@@ -109,6 +109,44 @@ TEST_F(LevelDbTargetCacheTest, MetadataPersistedAcrossRestarts) {
   db2.reset();
 }
 
+TEST_F(LevelDbTargetCacheTest, CacheSizeTracksTargetsAcrossRestarts) {
+  persistence_->Shutdown();
+  persistence_.reset();
+
+  Path dir = LevelDbDir();
+
+  auto db1 = LevelDbPersistenceForTesting(dir);
+  LevelDbTargetCache* target_cache = db1->target_cache();
+  Query query = testutil::Query("some/path");
+  TargetData target_data(query.ToTarget(), 1, 10, QueryPurpose::Listen);
+
+  db1->Run("add target data", [&] { target_cache->AddTarget(target_data); });
+  int64_t byte_size = db1->CalculateByteSize().ValueOrDie();
+  ASSERT_GT(byte_size, 0);
+
+  db1->Shutdown();
+  db1.reset();
+
+  // Updates and removals after a restart are measured against the sizes of
+  // the targets that were already stored.
+  auto db2 = LevelDbPersistenceForTesting(dir);
+  LevelDbTargetCache* target_cache2 = db2->target_cache();
+  ASSERT_EQ(byte_size, db2->CalculateByteSize().ValueOrDie());
+
+  TargetData updated = target_data.WithResumeToken(
+      testutil::ResumeToken(1000), testutil::Version(1000));
+  db2->Run("update target data",
+           [&] { target_cache2->UpdateTarget(updated); });
+  ASSERT_GT(db2->CalculateByteSize().ValueOrDie(), byte_size);
+
+  db2->Run("remove target data",
+           [&] { target_cache2->RemoveTarget(updated); });
+  ASSERT_EQ(0, db2->CalculateByteSize().ValueOrDie());
+
+  db2->Shutdown();
+  db2.reset();
+}
+
 TEST_F(LevelDbTargetCacheTest, RemoveMatchingKeysForTargetID) {
   persistence_->Run("test_remove_matching_keys_for_target_id", [&]() {
     DocumentKey key1 = testutil::Key("foo/bar");
@@ -196,6 +196,90 @@ TEST_F(LevelDbTransactionTest, MutateDeleted) {
   ASSERT_TRUE(status.IsNotFound());
 }
 
+TEST_F(LevelDbTransactionTest, OverwritesPendingChanges) {
+  Status status = db_->Put(LevelDbTransaction::DefaultWriteOptions(),
+                           "key_0", "value_0");
+  ASSERT_TRUE(status.ok());
+
+  std::string value;
+  LevelDbTransaction transaction(db_.get(), "OverwritesPendingChanges");
+  // Values larger than the arena blocks are stored separately.
+  std::string large_value(100 * 1024, 'x');
+  transaction.Put("key_0", "new_value_0");
+  transaction.Put("key_0", large_value);
+  transaction.Put("key_1", "value_1");
+  transaction.Delete("key_1");
+  transaction.Put("key_2", "value_2");
+  transaction.Delete("key_2");
+  transaction.Put("key_2", "new_value_2");
+  ASSERT_EQ(transaction.changed_keys(), 3u);
+
+  status = transaction.Get("key_0", &value);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(value, large_value);
+  status = transaction.Get("key_1", &value);
+  ASSERT_TRUE(status.IsNotFound());
+
+  LevelDbTransaction::Iterator iter(&transaction);
+  iter.Seek("");
+  ASSERT_EQ(iter.key(), "key_0");
+  ASSERT_EQ(iter.value(), large_value);
+  iter.Next();
+  ASSERT_EQ(iter.key(), "key_2");
+  ASSERT_EQ(iter.value(), "new_value_2");
+  iter.Next();
+  ASSERT_FALSE(iter.Valid());
+
+  transaction.Commit();
+
+  const ReadOptions& read_options = LevelDbTransaction::DefaultReadOptions();
+  status = db_->Get(read_options, "key_0", &value);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(large_value, value);
+
+  status = db_->Get(read_options, "key_1", &value);
+  ASSERT_TRUE(status.IsNotFound());
+
+  status = db_->Get(read_options, "key_2", &value);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ("new_value_2", value);
+}
+
+TEST_F(LevelDbTransactionTest, RewritesValuesOfTheSameKey) {
+  std::string value;
+  LevelDbTransaction transaction(db_.get(), "RewritesValuesOfTheSameKey");
+  // Shorter values are written over the previous ones.
+  transaction.Put("key_0", "a_long_value");
+  transaction.Put("key_0", "short");
+  ASSERT_TRUE(transaction.Get("key_0", &value).ok());
+  ASSERT_EQ("short", value);
+
+  transaction.Put("key_0", "");
+  ASSERT_TRUE(transaction.Get("key_0", &value).ok());
+  ASSERT_EQ("", value);
+
+  transaction.Delete("key_0");
+  ASSERT_TRUE(transaction.Get("key_0", &value).IsNotFound());
+
+  transaction.Put("key_0", "value");
+  transaction.Put("key_0", "an_even_longer_value");
+  ASSERT_TRUE(transaction.Get("key_0", &value).ok());
+  ASSERT_EQ("an_even_longer_value", value);
+
+  LevelDbTransaction::Iterator iter(&transaction);
+  iter.Seek("");
+  ASSERT_EQ(iter.key(), "key_0");
+  ASSERT_EQ(iter.value(), "an_even_longer_value");
+
+  transaction.Put("key_0", "final");
+  transaction.Commit();
+
+  Status status = db_->Get(LevelDbTransaction::DefaultReadOptions(), "key_0",
+                           &value);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ("final", value);
+}
+
 TEST_F(LevelDbTransactionTest, ProtobufSupport) {
   LevelDbTransaction transaction(db_.get(), "ProtobufSupport");
 
@@ -290,6 +374,37 @@ TEST_F(LevelDbTransactionTest, DeletingAheadOfAnIterator) {
   ASSERT_FALSE(it->Valid());
 }
 
+TEST_F(LevelDbTransactionTest, ReadOnlyTransactionReadsSnapshot) {
+  const WriteOptions& write_options = LevelDbTransaction::DefaultWriteOptions();
+  ASSERT_TRUE(db_->Put(write_options, "key_1", "value_1").ok());
+
+  std::unique_ptr<LevelDbTransaction> transaction =
+      LevelDbTransaction::ReadOnly(db_.get(), "ReadOnlyTransaction");
+  ASSERT_TRUE(transaction->read_only());
+
+  // Writes made after the transaction was created are not visible to it.
+  ASSERT_TRUE(db_->Put(write_options, "key_1", "updated").ok());
+  ASSERT_TRUE(db_->Put(write_options, "key_2", "value_2").ok());
+
+  std::string value;
+  Status status = transaction->Get("key_1", &value);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ("value_1", value);
+  ASSERT_TRUE(transaction->Get("key_2", &value).IsNotFound());
+
+  auto it = transaction->NewIterator();
+  it->Seek("");
+  ASSERT_TRUE(it->Valid());
+  ASSERT_EQ("key_1", it->key());
+  ASSERT_EQ("value_1", it->value());
+  it->Next();
+  ASSERT_FALSE(it->Valid());
+
+  transaction->Commit();
+  ASSERT_TRUE(db_->Get(ReadOptions(), "key_1", &value).ok());
+  ASSERT_EQ("updated", value);
+}
+
 TEST_F(LevelDbTransactionTest, ToString) {
   std::string key = LevelDbMutationKey::Key("user1", 42);
   Message<firestore_client_WriteBatch> message;
@@ -16,6 +16,9 @@
 
 #include "Firestore/core/src/local/local_serializer.h"
 
+#include <memory>
+#include <string>
+
 #include "Firestore/Protos/cpp/firestore/bundle.pb.h"
 #include "Firestore/Protos/cpp/firestore/local/maybe_document.pb.h"
 #include "Firestore/Protos/cpp/firestore/local/mutation.pb.h"
@@ -262,6 +265,14 @@ class LocalSerializerTest : public ::testing::Test {
     auto actual_model = serializer.DecodeMaybeDocument(&reader, *message);
     EXPECT_OK(reader.status());
     EXPECT_EQ(model, actual_model);
+
+    // Decoding lazily must produce the same document.
+    StringReader lazy_reader;
+    auto lazy_model = serializer.DecodeMaybeDocumentLazily(
+        &lazy_reader,
+        std::make_shared<const std::string>(nanopb::MakeStringView(bytes)));
+    EXPECT_OK(lazy_reader.status());
+    EXPECT_EQ(model, lazy_model);
   }
 
   ByteString EncodeMaybeDocument(local::LocalSerializer* localSerializer,
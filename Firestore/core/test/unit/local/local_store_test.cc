@@ -24,9 +24,11 @@
 #include "Firestore/core/src/bundle/named_query.h"
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/local/index_backfiller.h"
 #include "Firestore/core/src/local/local_view_changes.h"
 #include "Firestore/core/src/local/local_write_result.h"
 #include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_engine.h"
 #include "Firestore/core/src/local/query_result.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/delete_mutation.h"
@@ -1170,10 +1172,11 @@ TEST_P(LocalStoreTest, UsesTargetMappingToExecuteQueries) {
   AcknowledgeMutationWithVersion(10);
   AcknowledgeMutationWithVersion(10);
 
-  // Execute the query, but note that we read all existing documents from the
-  // RemoteDocumentCache since we do not yet have target mapping.
+  // Execute the query, but note that we scan all existing documents in the
+  // RemoteDocumentCache since we do not yet have target mapping. Only the two
+  // documents that match the query are returned by the scan.
   ExecuteQuery(query);
-  FSTAssertRemoteDocumentsRead(/* by_key */ 0, /* by_query= */ 3);
+  FSTAssertRemoteDocumentsRead(/* by_key */ 0, /* by_query= */ 2);
 
   // Issue a RemoteEvent to persist the target mapping.
   ApplyRemoteEvent(AddedRemoteEvent({Doc("foo/a", 10, Map("matches", true)),
@@ -1189,6 +1192,48 @@ TEST_P(LocalStoreTest, UsesTargetMappingToExecuteQueries) {
   FSTAssertQueryReturned("foo/a", "foo/b");
 }
 
+TEST_P(LocalStoreTest, ExplainsQueries) {
+  if (IsGcEager()) return;
+
+  core::Query query =
+      Query("foo").AddingFilter(testutil::Filter("matches", "==", true));
+  TargetId target_id = AllocateQuery(query);
+
+  WriteMutation(testutil::SetMutation("foo/a", Map("matches", true)));
+  WriteMutation(testutil::SetMutation("foo/b", Map("matches", true)));
+  WriteMutation(testutil::SetMutation("foo/ignored", Map("matches", false)));
+  AcknowledgeMutationWithVersion(10);
+  AcknowledgeMutationWithVersion(10);
+  AcknowledgeMutationWithVersion(10);
+
+  // Without a target mapping, the scan also reads the document that does not
+  // match the query.
+  QueryExplanation explanation =
+      local_store_.ExplainQuery(query, /* use_previous_results= */ true);
+  EXPECT_EQ(QueryPlan::Strategy::FullCollectionScan,
+            explanation.chosen_plan.strategy);
+  EXPECT_EQ(3u, explanation.documents_read);
+  EXPECT_EQ(2u, explanation.documents_returned);
+
+  ApplyRemoteEvent(AddedRemoteEvent({Doc("foo/a", 10, Map("matches", true)),
+                                     Doc("foo/b", 10, Map("matches", true))},
+                                    {target_id}));
+  ApplyRemoteEvent(NoChangeEvent(target_id, 10));
+  UpdateViews(target_id, /* from_cache= */ false);
+
+  explanation =
+      local_store_.ExplainQuery(query, /* use_previous_results= */ true);
+  EXPECT_EQ(QueryPlan::Strategy::RemoteKeys, explanation.chosen_plan.strategy);
+  EXPECT_EQ(2u, explanation.documents_read);
+  EXPECT_EQ(2u, explanation.documents_returned);
+
+  explanation =
+      local_store_.ExplainQuery(query, /* use_previous_results= */ false);
+  EXPECT_EQ(QueryPlan::Strategy::FullCollectionScan,
+            explanation.chosen_plan.strategy);
+  EXPECT_EQ(3u, explanation.documents_read);
+}
+
 TEST_P(LocalStoreTest, IgnoresTargetMappingAfterExistenceFilterMismatch) {
   if (IsGcEager()) return;
 
@@ -1708,6 +1753,25 @@ TEST_P(LocalStoreTest, OnlyPersistsUpdatesForDocumentsWhenVersionChanges) {
   FSTAssertChanged(Doc("foo/baz", 2, Map("val", "new")));
 }
 
+TEST_P(LocalStoreTest, BackfillWithoutFieldIndexesDoesNotStartATransaction) {
+  auto current_sequence_number = [&] {
+    return persistence_->Run("current_sequence_number", [&] {
+      return persistence_->current_sequence_number();
+    });
+  };
+
+  ListenSequenceNumber before = current_sequence_number();
+  IndexBackfiller backfiller;
+  IndexBackfillerResults results = local_store_.Backfill(&backfiller);
+  ListenSequenceNumber after = current_sequence_number();
+
+  EXPECT_FALSE(results.did_run);
+  if (!IsGcEager()) {
+    // Only the transaction that reads `after` takes a new sequence number.
+    EXPECT_EQ(before + 1, after);
+  }
+}
+
 TEST_P(LocalStoreTest, CanHandleBatchAckWhenPendingBatchesHaveOtherDocs) {
   // Prepare two batches, the first one will get rejected by the backend.
   // When the first batch is rejected, overlay is recalculated with only the
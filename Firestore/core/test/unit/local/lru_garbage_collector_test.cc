@@ -16,6 +16,7 @@
 
 #include "Firestore/core/test/unit/local/lru_garbage_collector_test.h"
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -762,10 +763,118 @@ TEST_P(LruGarbageCollectorTest, GCRan) {
   // targets, that should be 10 targets with 10 documents each, for a total of
   // 100 documents.
   ASSERT_TRUE(results.did_run);
+  ASSERT_EQ(10, results.sequence_numbers_collected);
   ASSERT_EQ(10, results.targets_removed);
   ASSERT_EQ(100, results.documents_removed);
 }
 
+TEST_P(LruGarbageCollectorTest, GCCollectsAtMostMaximumSequenceNumbers) {
+  LruParams params = LruParams::Default();
+  params.min_bytes_threshold = 100;
+  params.maximum_sequence_numbers_to_collect = 5;
+  NewTestResources(params);
+
+  for (int i = 0; i < 100; i++) {
+    persistence_->Run("Add a target and some documents", [&] {
+      TargetData target_data = AddNextQueryInTransaction();
+      for (int j = 0; j < 10; j++) {
+        MutableDocument doc = CacheADocumentInTransaction();
+        AddDocument(doc.key(), target_data.target_id());
+      }
+    });
+  }
+
+  LruResults results =
+      persistence_->Run("GC", [&] { return gc_->Collect({}); });
+
+  // 10% of the sequence numbers would be 10, but only the 5 least recently
+  // used are collected.
+  ASSERT_TRUE(results.did_run);
+  ASSERT_EQ(5, results.sequence_numbers_collected);
+  ASSERT_EQ(5, results.targets_removed);
+  ASSERT_EQ(50, results.documents_removed);
+  ASSERT_GE(results.find_upper_bound_duration.count(), 0);
+}
+
+TEST_P(LruGarbageCollectorTest, GCRemovesDocumentsInBatches) {
+  LruParams params = LruParams::Default();
+  params.min_bytes_threshold = 100;
+  params.documents_per_removal_batch = 30;
+  params.removal_time_budget = std::chrono::hours(1);
+  NewTestResources(params);
+
+  for (int i = 0; i < 100; i++) {
+    persistence_->Run("Add a target and some documents", [&] {
+      TargetData target_data = AddNextQueryInTransaction();
+      for (int j = 0; j < 10; j++) {
+        MutableDocument doc = CacheADocumentInTransaction();
+        AddDocument(doc.key(), target_data.target_id());
+      }
+    });
+  }
+
+  // Only the first batch is removed along with the targets.
+  LruResults results =
+      persistence_->Run("GC", [&] { return gc_->Collect({}); });
+  ASSERT_EQ(10, results.targets_removed);
+  ASSERT_EQ(30, results.documents_removed);
+  ASSERT_TRUE(gc_->removal_pending());
+
+  // The remaining 70 documents take three more batches.
+  int batches = 1;
+  bool remove_next_batch = true;
+  while (remove_next_batch) {
+    remove_next_batch = persistence_->Run(
+        "GC batch", [&] { return gc_->RemoveNextBatch(&results); });
+    batches++;
+  }
+  ASSERT_EQ(4, batches);
+  ASSERT_EQ(100, results.documents_removed);
+  ASSERT_FALSE(gc_->removal_pending());
+}
+
+TEST_P(LruGarbageCollectorTest, GCResumesRemovalAfterTimeBudget) {
+  LruParams params = LruParams::Default();
+  params.min_bytes_threshold = 100;
+  params.documents_per_removal_batch = 30;
+  params.removal_time_budget = std::chrono::milliseconds(0);
+  NewTestResources(params);
+
+  for (int i = 0; i < 100; i++) {
+    persistence_->Run("Add a target and some documents", [&] {
+      TargetData target_data = AddNextQueryInTransaction();
+      for (int j = 0; j < 10; j++) {
+        MutableDocument doc = CacheADocumentInTransaction();
+        AddDocument(doc.key(), target_data.target_id());
+      }
+    });
+  }
+
+  LruResults results =
+      persistence_->Run("GC", [&] { return gc_->Collect({}); });
+  ASSERT_EQ(10, results.sequence_numbers_collected);
+  ASSERT_EQ(30, results.documents_removed);
+
+  // The budget is used up, so no further batch is removed.
+  ASSERT_FALSE(persistence_->Run(
+      "GC batch", [&] { return gc_->RemoveNextBatch(&results); }));
+  ASSERT_EQ(30, results.documents_removed);
+  ASSERT_TRUE(gc_->removal_pending());
+
+  // The next collections resume the removal with the same upper bound.
+  int documents_removed = results.documents_removed;
+  for (int expected : {30, 30, 10}) {
+    results = persistence_->Run("GC", [&] { return gc_->Collect({}); });
+    ASSERT_TRUE(results.did_run);
+    ASSERT_EQ(0, results.sequence_numbers_collected);
+    ASSERT_EQ(0, results.targets_removed);
+    ASSERT_EQ(expected, results.documents_removed);
+    documents_removed += results.documents_removed;
+  }
+  ASSERT_EQ(100, documents_removed);
+  ASSERT_FALSE(gc_->removal_pending());
+}
+
 }  // namespace local
 }  // namespace firestore
 }  // namespace firebase
@@ -36,6 +36,7 @@
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/model/object_value.h"
 #include "Firestore/core/src/model/precondition.h"
+#include "Firestore/core/src/model/set_mutation.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
 
@@ -102,13 +103,18 @@ const SnapshotVersion kMissingLastLimboFreeSnapshot = SnapshotVersion::None();
 }  // namespace
 
 DocumentMap TestLocalDocumentsView::GetDocumentsMatchingQuery(
-    const core::Query& query, const model::IndexOffset& offset) {
+    const core::Query& query,
+    const model::IndexOffset& offset,
+    QueryContext* context) {
   bool full_collection_scan = offset.read_time() == SnapshotVersion::None();
 
   EXPECT_TRUE(expect_full_collection_scan_.has_value());
   EXPECT_EQ(expect_full_collection_scan_.value(), full_collection_scan);
+  if (full_collection_scan) {
+    ++full_collection_scans_;
+  }
 
-  return LocalDocumentsView::GetDocumentsMatchingQuery(query, offset);
+  return LocalDocumentsView::GetDocumentsMatchingQuery(query, offset, context);
 }
 
 void TestLocalDocumentsView::ExpectFullCollectionScan(
@@ -254,6 +260,43 @@ TEST_P(QueryEngineTest, IncludesChangesSinceInitialResults) {
   });
 }
 
+TEST_P(QueryEngineTest, ReestimatesPlansOnceTheCollectionGrows) {
+  persistence_->Run("ReestimatesPlansOnceTheCollectionGrows", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+
+    core::Query query =
+        Query("coll").AddingFilter(Filter("matches", "==", true));
+
+    AddDocuments({kMatchingDocA, kMatchingDocB});
+    PersistQueryMapping({kMatchingDocA.key(), kMatchingDocB.key()});
+
+    ExpectOptimizedCollectionScan(
+        [&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+
+    // The estimates of the first execution are re-used while the collection
+    // keeps its size.
+    AddDocuments({kUpdatedMatchingDocB});
+    ExpectOptimizedCollectionScan(
+        [&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+
+    // Most of the collection changed since the previous results, so scanning
+    // it reads fewer documents. The collection's size is only checked once the
+    // estimates were re-used `kMaxScanEstimateReuses` times.
+    AddDocuments({Doc("coll/c", 11, Map("matches", false)),
+                  Doc("coll/d", 11, Map("matches", false)),
+                  Doc("coll/e", 11, Map("matches", false))});
+    for (size_t i = 1; i < QueryEngine::kMaxScanEstimateReuses; ++i) {
+      ExpectOptimizedCollectionScan(
+          [&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+    }
+    DocumentSet docs = ExpectFullCollectionScan<DocumentSet>(
+        [&] { return RunQuery(query, kLastLimboFreeSnapshot); });
+    EXPECT_EQ(docs, DocSet(query.Comparator(),
+                           {kMatchingDocA, kUpdatedMatchingDocB}));
+  });
+}
+
 TEST_P(QueryEngineTest,
        DoesNotUseInitialResultsWithoutLimboFreeSnapshotVersion) {
   persistence_->Run(
@@ -476,6 +519,39 @@ TEST_P(QueryEngineTest,
       });
 }
 
+TEST_P(QueryEngineTest, FullCollectionScanOnlyReturnsDocumentsWithinLimit) {
+  persistence_->Run(
+      "FullCollectionScanOnlyReturnsDocumentsWithinLimit", [&] {
+        mutation_queue_->Start();
+        index_manager_->Start();
+
+        AddDocuments({Doc("coll/a", 1, Map("order", 3)),
+                      Doc("coll/b", 1, Map("order", 1)),
+                      Doc("coll/c", 1, Map("order", 4)),
+                      Doc("coll/d", 1, Map("order", 2))});
+
+        core::Query query =
+            Query("coll").AddingOrderBy(OrderBy("order")).WithLimitToFirst(2);
+        DocumentMap docs = ExpectFullCollectionScan<DocumentMap>([&] {
+          return query_engine_.GetDocumentsMatchingQuery(
+              query, kMissingLastLimboFreeSnapshot, DocumentKeySet{});
+        });
+        EXPECT_EQ(2u, docs.size());
+        EXPECT_TRUE(docs.contains(Key("coll/b")));
+        EXPECT_TRUE(docs.contains(Key("coll/d")));
+
+        query =
+            Query("coll").AddingOrderBy(OrderBy("order")).WithLimitToLast(2);
+        docs = ExpectFullCollectionScan<DocumentMap>([&] {
+          return query_engine_.GetDocumentsMatchingQuery(
+              query, kMissingLastLimboFreeSnapshot, DocumentKeySet{});
+        });
+        EXPECT_EQ(2u, docs.size());
+        EXPECT_TRUE(docs.contains(Key("coll/a")));
+        EXPECT_TRUE(docs.contains(Key("coll/c")));
+      });
+}
+
 TEST_P(QueryEngineTest, DoesNotIncludeDocumentsDeletedByMutation) {
   persistence_->Run("DoesNotIncludeDocumentsDeletedByMutation", [&] {
     mutation_queue_->Start();
@@ -501,6 +577,126 @@ TEST_P(QueryEngineTest, DoesNotIncludeDocumentsDeletedByMutation) {
   });
 }
 
+TEST_P(QueryEngineTest, ExplainPrefersRemoteKeysForSmallerResults) {
+  persistence_->Run("ExplainPrefersRemoteKeysForSmallerResults", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+
+    core::Query query =
+        Query("coll").AddingFilter(Filter("matches", "==", true));
+
+    AddDocuments({kMatchingDocA, kMatchingDocB,
+                  Doc("coll/c", 1, Map("matches", false)),
+                  Doc("coll/d", 1, Map("matches", false))});
+    PersistQueryMapping({kMatchingDocA.key(), kMatchingDocB.key()});
+
+    local_documents_view_.ExpectFullCollectionScan(false);
+    QueryExplanation explanation = query_engine_.Explain(
+        query, kLastLimboFreeSnapshot,
+        target_cache_->GetMatchingKeys(kTestTargetId));
+
+    EXPECT_EQ(QueryPlan::Strategy::RemoteKeys,
+              explanation.chosen_plan.strategy);
+    ASSERT_EQ(2u, explanation.candidate_plans.size());
+    EXPECT_EQ(QueryPlan::Strategy::RemoteKeys,
+              explanation.candidate_plans[0].strategy);
+    EXPECT_EQ(2u, explanation.candidate_plans[0].estimated_documents);
+    EXPECT_EQ(QueryPlan::Strategy::FullCollectionScan,
+              explanation.candidate_plans[1].strategy);
+    EXPECT_EQ(4u, explanation.candidate_plans[1].estimated_documents);
+    EXPECT_EQ(2u, explanation.documents_read);
+    EXPECT_EQ(2u, explanation.documents_returned);
+  });
+}
+
+TEST_P(QueryEngineTest, ExplainPrefersFullCollectionScanForSmallerCollections) {
+  persistence_->Run(
+      "ExplainPrefersFullCollectionScanForSmallerCollections", [&] {
+        mutation_queue_->Start();
+        index_manager_->Start();
+
+        core::Query query =
+            Query("coll").AddingFilter(Filter("matches", "==", true));
+
+        // The query mapping references documents that are no longer cached.
+        AddDocuments({kMatchingDocA});
+        PersistQueryMapping({kMatchingDocA.key(), Key("coll/b"),
+                             Key("coll/c")});
+
+        local_documents_view_.ExpectFullCollectionScan(true);
+        QueryExplanation explanation = query_engine_.Explain(
+            query, kLastLimboFreeSnapshot,
+            target_cache_->GetMatchingKeys(kTestTargetId));
+
+        EXPECT_EQ(QueryPlan::Strategy::FullCollectionScan,
+                  explanation.chosen_plan.strategy);
+        EXPECT_EQ(1u, explanation.chosen_plan.estimated_documents);
+        ASSERT_EQ(2u, explanation.candidate_plans.size());
+        EXPECT_EQ(QueryPlan::Strategy::RemoteKeys,
+                  explanation.candidate_plans[1].strategy);
+        EXPECT_EQ(3u, explanation.candidate_plans[1].estimated_documents);
+        EXPECT_EQ(1u, explanation.documents_read);
+        EXPECT_EQ(1u, explanation.documents_returned);
+      });
+}
+
+TEST_P(QueryEngineTest, ExplainCountsOverlays) {
+  persistence_->Run("ExplainCountsOverlays", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+
+    core::Query query = Query("coll");
+
+    AddDocuments({kMatchingDocA});
+    AddMutation(testutil::SetMutation("coll/b", Map("matches", true)));
+
+    local_documents_view_.ExpectFullCollectionScan(true);
+    QueryExplanation explanation = query_engine_.Explain(
+        query, kMissingLastLimboFreeSnapshot, DocumentKeySet{});
+
+    EXPECT_EQ(1u, explanation.overlay_count);
+    ASSERT_EQ(1u, explanation.candidate_plans.size());
+    EXPECT_EQ(QueryPlan::Strategy::FullCollectionScan,
+              explanation.chosen_plan.strategy);
+    EXPECT_EQ(2u, explanation.chosen_plan.estimated_documents);
+    EXPECT_EQ(2u, explanation.documents_returned);
+  });
+}
+
+TEST_P(QueryEngineTest, QueriesOnTheSameCollectionShareAScan) {
+  persistence_->Run("QueriesOnTheSameCollectionShareAScan", [&] {
+    mutation_queue_->Start();
+    index_manager_->Start();
+
+    AddDocuments({Doc("coll/a", 1, Map("matches", true, "order", 3)),
+                  Doc("coll/b", 1, Map("matches", false, "order", 1)),
+                  Doc("coll/c", 1, Map("matches", true, "order", 2)),
+                  Doc("other/d", 1, Map("matches", true, "order", 1))});
+
+    std::vector<core::Query> queries = {
+        Query("coll").AddingOrderBy(OrderBy("order")).WithLimitToFirst(2),
+        Query("coll")
+            .AddingFilter(Filter("matches", "==", true))
+            .AddingOrderBy(OrderBy("order"))
+            .WithLimitToLast(1),
+        Query("other").WithLimitToFirst(1)};
+    std::vector<DocumentMap> results =
+        ExpectFullCollectionScan<std::vector<DocumentMap>>([&] {
+          return query_engine_.GetDocumentsMatchingQueries(queries);
+        });
+
+    EXPECT_EQ(2u, local_documents_view_.full_collection_scans());
+    ASSERT_EQ(3u, results.size());
+    EXPECT_EQ(2u, results[0].size());
+    EXPECT_TRUE(results[0].contains(Key("coll/b")));
+    EXPECT_TRUE(results[0].contains(Key("coll/c")));
+    EXPECT_EQ(1u, results[1].size());
+    EXPECT_TRUE(results[1].contains(Key("coll/a")));
+    EXPECT_EQ(1u, results[2].size());
+    EXPECT_TRUE(results[2].contains(Key("other/d")));
+  });
+}
+
 // TODO(orquery): Port test canPerformOrQueriesUsingFullCollectionScan
 
 }  // namespace local
@@ -54,12 +54,20 @@ class TestLocalDocumentsView : public LocalDocumentsView {
   using LocalDocumentsView::LocalDocumentsView;
 
   model::DocumentMap GetDocumentsMatchingQuery(
-      const core::Query& query, const model::IndexOffset& offset) override;
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      QueryContext* context) override;
 
   void ExpectFullCollectionScan(bool full_collection_scan);
 
+  /** Returns the number of queries that scanned their whole collection. */
+  size_t full_collection_scans() const {
+    return full_collection_scans_;
+  }
+
  private:
   absl::optional<bool> expect_full_collection_scan_;
+  size_t full_collection_scans_ = 0;
 };
 
 using FactoryFunc = std::unique_ptr<Persistence> (*)();
@@ -17,16 +17,20 @@
 #include "Firestore/core/test/unit/local/remote_document_cache_test.h"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/memory_remote_document_cache.h"
 #include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/object_value.h"
+#include "Firestore/core/src/model/overlay.h"
+#include "Firestore/core/src/model/patch_mutation.h"
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/util/string_apple.h"
@@ -60,6 +64,7 @@ using testutil::Field;
 using testutil::Key;
 using testutil::Map;
 using testutil::Query;
+using testutil::Resource;
 using testutil::Value;
 using testutil::Version;
 
@@ -246,6 +251,207 @@ TEST_P(RemoteDocumentCacheTest, DocumentsMatchingUsesReadTimeNotUpdateTime) {
       });
 }
 
+TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQueryFiltersDocuments) {
+  persistence_->Run("test_documents_matching_query_filters_documents", [&] {
+    SetTestDocument("b/1", Map("matches", true));
+    SetTestDocument("b/2", Map("matches", false));
+    SetTestDocument("b/3", Map("matches", true));
+    SetTestDocument("b/3/z/1", Map("matches", true));
+    SetTestDocument("c/1", Map("matches", true));
+
+    core::Query query =
+        Query("b").AddingFilter(testutil::Filter("matches", "==", true));
+    QueryContext context;
+    MutableDocumentMap results = cache_->GetDocumentsMatchingQuery(
+        query, model::IndexOffset::None(), model::OverlayByDocumentKeyMap(),
+        &context);
+    std::vector<MutableDocument> docs = {
+        Doc("b/1", kVersion, Map("matches", true)),
+        Doc("b/3", kVersion, Map("matches", true)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+    // Documents that don't match are read as well.
+    EXPECT_EQ(3u, context.documents_read());
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQueryIncludesMutatedDocs) {
+  persistence_->Run("test_documents_matching_query_includes_mutations", [&] {
+    SetTestDocument("b/1", Map("matches", true));
+    SetTestDocument("b/2", Map("matches", false));
+    SetTestDocument("b/3", Map("matches", false));
+
+    core::Query query =
+        Query("b").AddingFilter(testutil::Filter("matches", "==", true));
+    model::OverlayByDocumentKeyMap mutated_docs;
+    model::Mutation mutation =
+        testutil::PatchMutation("b/2", Map("matches", true));
+    mutated_docs.emplace(Key("b/2"), model::Overlay(1, std::move(mutation)));
+    MutableDocumentMap results = cache_->GetDocumentsMatchingQuery(
+        query, model::IndexOffset::None(), mutated_docs,
+        /* context= */ nullptr);
+    std::vector<MutableDocument> docs = {
+        Doc("b/1", kVersion, Map("matches", true)),
+        Doc("b/2", kVersion, Map("matches", false)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, DocumentsMatchingQuerySinceReadTimeFilters) {
+  persistence_->Run(
+      "test_documents_matching_query_since_read_time_filters", [&] {
+        SetTestDocument("b/old", Map("matches", true), /* updateTime= */ 1,
+                        /* readTime= */ 11);
+        SetTestDocument("b/miss", Map("matches", false), /* updateTime= */ 2,
+                        /* readTime= */ 12);
+        SetTestDocument("b/new", Map("matches", true), /* updateTime= */ 3,
+                        /* readTime= */ 13);
+
+        core::Query query =
+            Query("b").AddingFilter(testutil::Filter("matches", "==", true));
+        QueryContext context;
+        MutableDocumentMap results = cache_->GetDocumentsMatchingQuery(
+            query, model::IndexOffset::CreateSuccessor(Version(11)),
+            model::OverlayByDocumentKeyMap(), &context);
+        std::vector<MutableDocument> docs = {
+            Doc("b/new", 3, Map("matches", true)),
+        };
+        EXPECT_THAT(results, HasExactlyDocs(docs));
+        EXPECT_EQ(2u, context.documents_read());
+      });
+}
+
+TEST_P(RemoteDocumentCacheTest, CollectionGroupScanAcrossParents) {
+  persistence_->Run("test_collection_group_scan_across_parents", [&] {
+    SetTestDocument("a/1/b/1", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("a/2/b/2", /* updateTime= */ 1, /* readTime= */ 12);
+    SetTestDocument("b/3", /* updateTime= */ 1, /* readTime= */ 13);
+    SetTestDocument("a/3/c/1", /* updateTime= */ 1, /* readTime= */ 14);
+
+    MutableDocumentMap results =
+        cache_->GetAll("b", model::IndexOffset::None(), 10);
+    std::vector<MutableDocument> docs = {
+        Doc("a/1/b/1", 1, Map("a", 1, "b", 2)),
+        Doc("a/2/b/2", 1, Map("a", 1, "b", 2)),
+        Doc("b/3", 1, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, CollectionGroupScanIsOrderedByReadTime) {
+  persistence_->Run("test_collection_group_scan_is_ordered_by_read_time", [&] {
+    SetTestDocument("a/1/b/z", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("a/2/b/y", /* updateTime= */ 1, /* readTime= */ 14);
+    SetTestDocument("b/x", /* updateTime= */ 1, /* readTime= */ 12);
+    SetTestDocument("a/1/b/w", /* updateTime= */ 1, /* readTime= */ 13);
+
+    MutableDocumentMap results =
+        cache_->GetAll("b", model::IndexOffset::None(), 2);
+    std::vector<MutableDocument> docs = {
+        Doc("a/1/b/z", 1, Map("a", 1, "b", 2)),
+        Doc("b/x", 1, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+    for (const auto& kv : results) {
+      EXPECT_NE(kv.second.read_time(), SnapshotVersion::None());
+    }
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, CollectionGroupScanResumesFromOffset) {
+  persistence_->Run("test_collection_group_scan_resumes_from_offset", [&] {
+    SetTestDocument("a/1/b/1", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("a/2/b/2", /* updateTime= */ 1, /* readTime= */ 12);
+    SetTestDocument("b/3", /* updateTime= */ 1, /* readTime= */ 12);
+    SetTestDocument("b/4", /* updateTime= */ 1, /* readTime= */ 13);
+
+    model::IndexOffset offset(Version(12), Key("a/2/b/2"),
+                              model::IndexOffset::InitialLargestBatchId());
+    MutableDocumentMap results = cache_->GetAll("b", offset, 10);
+    std::vector<MutableDocument> docs = {
+        Doc("b/3", 1, Map("a", 1, "b", 2)),
+        Doc("b/4", 1, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, CollectionGroupScanSkipsPreviousReadTimes) {
+  persistence_->Run("test_scan_skips_previous_read_times", [&] {
+    SetTestDocument("b/1", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("b/2", /* updateTime= */ 1, /* readTime= */ 12);
+    SetTestDocument("b/1", /* updateTime= */ 2, /* readTime= */ 13);
+
+    MutableDocumentMap results =
+        cache_->GetAll("b", model::IndexOffset::None(), 1);
+    std::vector<MutableDocument> docs = {
+        Doc("b/2", 1, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+
+    results = cache_->GetAll("b", model::IndexOffset::None(), 2);
+    ASSERT_EQ(2u, results.size());
+    EXPECT_EQ(Version(13), results.get(Key("b/1"))->read_time());
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, CollectionGroupScanSkipsRemovedDocuments) {
+  persistence_->Run("test_scan_skips_removed_documents", [&] {
+    SetTestDocument("b/1", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("b/2", /* updateTime= */ 1, /* readTime= */ 12);
+    cache_->Remove(Key("b/1"));
+
+    MutableDocumentMap results =
+        cache_->GetAll("b", model::IndexOffset::None(), 1);
+    std::vector<MutableDocument> docs = {
+        Doc("b/2", 1, Map("a", 1, "b", 2)),
+    };
+    EXPECT_THAT(results, HasExactlyDocs(docs));
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, EstimatesCollectionSize) {
+  persistence_->Run("test_estimates_collection_size", [&] {
+    SetTestDocument("a/1");
+    SetTestDocument("a/2");
+    SetTestDocument("a/3");
+    SetTestDocument("a/1/b/1");
+    SetTestDocument("c/1");
+
+    // Updating a document does not change the estimate.
+    SetTestDocument("a/2", /* updateTime= */ 43, /* readTime= */ 43);
+    cache_->Remove(Key("a/3"));
+
+    EXPECT_EQ(2u, cache_->EstimateCollectionSize(Resource("a"), 10));
+    EXPECT_EQ(1u, cache_->EstimateCollectionSize(Resource("a"), 1));
+    EXPECT_EQ(1u, cache_->EstimateCollectionSize(Resource("a/1/b"), 10));
+    EXPECT_EQ(0u, cache_->EstimateCollectionSize(Resource("d"), 10));
+  });
+}
+
+TEST_P(RemoteDocumentCacheTest, EstimatesChangedDocuments) {
+  persistence_->Run("test_estimates_changed_documents", [&] {
+    SetTestDocument("a/1", /* updateTime= */ 1, /* readTime= */ 11);
+    SetTestDocument("a/2", /* updateTime= */ 1, /* readTime= */ 12);
+    SetTestDocument("a/3", /* updateTime= */ 1, /* readTime= */ 13);
+    SetTestDocument("a/1/b/1", /* updateTime= */ 1, /* readTime= */ 14);
+
+    auto since = model::IndexOffset::CreateSuccessor(Version(11));
+    EXPECT_EQ(2u, cache_->EstimateChangedDocuments(Resource("a"), since, 10));
+    EXPECT_EQ(1u, cache_->EstimateChangedDocuments(Resource("a"), since, 1));
+    EXPECT_EQ(1u, cache_->EstimateChangedDocuments(
+                      Resource("a"),
+                      model::IndexOffset(Version(12), Key("a/2"), -1), 10));
+    EXPECT_EQ(3u, cache_->EstimateChangedDocuments(
+                      Resource("a"), model::IndexOffset::None(), 10));
+    EXPECT_EQ(0u, cache_->EstimateChangedDocuments(
+                      Resource("a"),
+                      model::IndexOffset::CreateSuccessor(Version(13)), 10));
+  });
+}
+
 TEST_P(RemoteDocumentCacheTest, DoesNotApplyDocumentModificationsToCache) {
   // This test verifies that the MemoryMutationCache returns copies of all
   // data to ensure that the documents in the cache cannot be modified.
@@ -16,7 +16,11 @@
 
 #include "Firestore/core/src/model/object_value.h"
 
+#include <memory>
+#include <string>
+
 #include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
 #include "gtest/gtest.h"
@@ -31,13 +35,30 @@ const char kBarString[] = "bar";
 namespace {
 
 using absl::nullopt;
+using nanopb::MakeStdString;
+using nanopb::Message;
 using testutil::DbId;
 using testutil::Field;
+using testutil::Key;
 using testutil::Map;
 using testutil::Value;
 using testutil::WrapObject;
 
 class ObjectValueTest : public ::testing::Test {
+ protected:
+  /** Returns an ObjectValue that decodes `value` from its encoded form. */
+  ObjectValue EncodeLazily(const ObjectValue& value) {
+    auto encoded = std::make_shared<const std::string>(Encode(value));
+    return ObjectValue::FromEncodedDocument(encoded, *encoded);
+  }
+
+  /** Returns the encoded Document proto with the fields of `value`. */
+  std::string Encode(const ObjectValue& value) {
+    Message<google_firestore_v1_Document> document{
+        serializer.EncodeDocument(Key("coll/doc"), value)};
+    return MakeStdString(document);
+  }
+
  private:
   remote::Serializer serializer{DbId()};
 };
@@ -335,6 +356,78 @@ TEST_F(ObjectValueTest, DoesNotRequireSortedInserts) {
   EXPECT_EQ(*Value(2), *object_value.Get(Field("nested.nested.c")));
 }
 
+TEST_F(ObjectValueTest, LazyValueExtractsFieldsWithoutFullDecode) {
+  ObjectValue value = EncodeLazily(
+      WrapObject("foo", Map("a", 1, "b", true), "bar", Map("c", "string")));
+
+  EXPECT_EQ(*Value(1), *value.Get(Field("foo.a")));
+  EXPECT_EQ(*Value(true), *value.Get(Field("foo.b")));
+  EXPECT_EQ(nullopt, value.Get(Field("foo.c")));
+  EXPECT_EQ(nullopt, value.Get(Field("baz")));
+  EXPECT_TRUE(value.is_lazy());
+
+  EXPECT_EQ(*Value("string"), *value.Get(Field("bar.c")));
+  EXPECT_TRUE(value.is_lazy());
+}
+
+TEST_F(ObjectValueTest, LazyValueDecodesAllFieldsOnFullRead) {
+  ObjectValue expected =
+      WrapObject("c", 2, "a", Map("nested", 1), "emptymap", Map());
+  ObjectValue value = EncodeLazily(expected);
+
+  EXPECT_EQ(expected.ToFieldMask(), value.ToFieldMask());
+  EXPECT_FALSE(value.is_lazy());
+  EXPECT_EQ(expected, value);
+  EXPECT_EQ(*Value(1), *value.Get(Field("a.nested")));
+}
+
+TEST_F(ObjectValueTest, LazyValueKeepsExtractedFieldsWhenDecodingAll) {
+  ObjectValue value = EncodeLazily(WrapObject("a", Map("b", 1), "c", 2));
+
+  google_firestore_v1_Value nested = *value.Get(Field("a"));
+  EXPECT_EQ(WrapObject("a", Map("b", 1), "c", 2), value);
+  EXPECT_FALSE(value.is_lazy());
+
+  // The extracted field was moved into the decoded value, not freed.
+  EXPECT_EQ(*Map("b", 1), nested);
+  EXPECT_EQ(*Value(1), *value.Get(Field("a.b")));
+}
+
+TEST_F(ObjectValueTest, LazyValueUsesLastOfRepeatedFields) {
+  // Concatenated protos merge, so the second document's `a` repeats the key.
+  auto encoded = std::make_shared<const std::string>(
+      Encode(WrapObject("a", 1, "b", 2)) + Encode(WrapObject("a", 3)));
+
+  ObjectValue value = ObjectValue::FromEncodedDocument(encoded, *encoded);
+  EXPECT_EQ(*Value(3), *value.Get(Field("a")));
+  EXPECT_EQ(*Value(2), *value.Get(Field("b")));
+
+  ObjectValue other = ObjectValue::FromEncodedDocument(encoded, *encoded);
+  EXPECT_EQ(WrapObject("a", 3, "b", 2), other);
+}
+
+TEST_F(ObjectValueTest, LazyValueCopiesShareEncodedBytes) {
+  ObjectValue expected = WrapObject("a", 1);
+  ObjectValue value = EncodeLazily(expected);
+
+  ObjectValue copy{value};
+  EXPECT_TRUE(copy.is_lazy());
+  EXPECT_EQ(value, copy);
+
+  EXPECT_EQ(*Value(1), *value.Get(Field("a")));
+  EXPECT_EQ(expected, copy);
+}
+
+TEST_F(ObjectValueTest, LazyValueCanBeModified) {
+  ObjectValue value = EncodeLazily(WrapObject("a", 1, "b", Map("c", 2)));
+  EXPECT_EQ(*Value(2), *value.Get(Field("b.c")));
+
+  value.Set(Field("b.d"), Value(3));
+  value.Delete(Field("a"));
+  EXPECT_FALSE(value.is_lazy());
+  EXPECT_EQ(WrapObject("b", Map("c", 2, "d", 3)), value);
+}
+
 }  // namespace
 
 }  // namespace model
@@ -17,6 +17,7 @@
 #include "Firestore/core/src/nanopb/message.h"
 
 #include <cstdint>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -81,6 +82,27 @@ TEST_F(MessageTest, Move) {
 }
 #endif  // !__clang_analyzer__
 
+TEST_F(MessageTest, ParsesAcrossSlices) {
+  grpc::ByteBuffer buffer = GoodProto();
+
+  // Splits the serialized proto into single-byte slices, such that every field
+  // spans slice boundaries.
+  std::vector<grpc::Slice> slices;
+  ASSERT_TRUE(buffer.Dump(&slices).ok());
+  std::vector<grpc::Slice> split;
+  for (const auto& slice : slices) {
+    for (size_t i = 0; i != slice.size(); ++i) {
+      split.emplace_back(slice.begin() + i, 1);
+    }
+  }
+
+  ByteBufferReader reader{grpc::ByteBuffer{split.data(), split.size()}};
+  auto message = TestMessage::TryParse(&reader);
+  ASSERT_OK(reader.status());
+  EXPECT_EQ(MakeString(message->stream_id), "stream_id");
+  EXPECT_EQ(MakeString(message->stream_token), "stream_token");
+}
+
 TEST_F(MessageTest, ParseFailure) {
   ByteBufferReader reader{BadProto()};
   auto message = TestMessage::TryParse(&reader);
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/bloom_filter.h"
+
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/util/statusor.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using util::StatusOr;
+
+constexpr const char* kDocumentPrefix = "projects/p/databases/d/documents/";
+
+std::string DocumentName(const std::string& path) {
+  return kDocumentPrefix + path;
+}
+
+// A filter over the names of "coll/a" and "coll/b", 60 bits and 3 hashes each,
+// as the backend would build it.
+BloomFilter TwoDocumentFilter() {
+  StatusOr<BloomFilter> filter = BloomFilter::Create(
+      {0x04, 0x04, 0x44, 0x00, 0x20, 0x00, 0x08, 0x00}, 4, 3);
+  EXPECT_TRUE(filter.ok());
+  return filter.ValueOrDie();
+}
+
+TEST(BloomFilterTest, ContainsAddedEntries) {
+  BloomFilter filter = TwoDocumentFilter();
+  EXPECT_EQ(filter.bit_count(), 60);
+  EXPECT_EQ(filter.hash_count(), 3);
+
+  EXPECT_TRUE(filter.MightContain(DocumentName("coll/a")));
+  EXPECT_TRUE(filter.MightContain(DocumentName("coll/b")));
+}
+
+TEST(BloomFilterTest, ExcludesEntriesWithAnUnsetBit) {
+  BloomFilter filter = TwoDocumentFilter();
+
+  EXPECT_FALSE(filter.MightContain(DocumentName("coll/c")));
+  EXPECT_FALSE(filter.MightContain(DocumentName("coll/d")));
+  EXPECT_FALSE(filter.MightContain(""));
+}
+
+TEST(BloomFilterTest, FullFilterContainsEverything) {
+  StatusOr<BloomFilter> filter =
+      BloomFilter::Create(std::vector<uint8_t>(4, 0xff), 7, 5);
+  ASSERT_TRUE(filter.ok());
+
+  EXPECT_TRUE(filter.ValueOrDie().MightContain(DocumentName("coll/c")));
+  EXPECT_TRUE(filter.ValueOrDie().MightContain(""));
+}
+
+TEST(BloomFilterTest, EmptyFilterContainsNothing) {
+  StatusOr<BloomFilter> filter = BloomFilter::Create({}, 0, 0);
+  ASSERT_TRUE(filter.ok());
+
+  EXPECT_EQ(filter.ValueOrDie().bit_count(), 0);
+  EXPECT_FALSE(filter.ValueOrDie().MightContain(DocumentName("coll/a")));
+  EXPECT_FALSE(filter.ValueOrDie().MightContain(""));
+}
+
+TEST(BloomFilterTest, RejectsInvalidParameters) {
+  EXPECT_FALSE(BloomFilter::Create({0xff}, -1, 1).ok());
+  EXPECT_FALSE(BloomFilter::Create({0xff}, 8, 1).ok());
+  EXPECT_FALSE(BloomFilter::Create({0xff}, 0, -1).ok());
+  EXPECT_FALSE(BloomFilter::Create({0xff}, 0, 0).ok());
+  EXPECT_FALSE(BloomFilter::Create({}, 1, 0).ok());
+  EXPECT_FALSE(BloomFilter::Create({}, 0, 1).ok());
+}
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
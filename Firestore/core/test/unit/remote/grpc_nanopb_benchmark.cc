@@ -0,0 +1,130 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "Firestore/Protos/cpp/google/firestore/v1/firestore.pb.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/remote/grpc_nanopb.h"
+#include "Firestore/core/src/remote/remote_objc_bridge.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "absl/strings/str_cat.h"
+#include "benchmark/benchmark.h"
+#include "grpcpp/impl/codegen/grpc_library.h"
+#include "grpcpp/support/byte_buffer.h"
+
+namespace {
+
+std::atomic<int64_t> allocated_bytes{0};
+
+}  // namespace
+
+// Counts the bytes allocated on the heap, which includes any copy of the
+// incoming buffer that is made before decoding.
+void* operator new(size_t size) {
+  allocated_bytes += static_cast<int64_t>(size);
+  void* result = std::malloc(size == 0 ? 1 : size);
+  if (!result) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace {
+
+namespace v1 = google::firestore::v1;
+using firebase::firestore::model::DatabaseId;
+using firebase::firestore::remote::ByteBufferReader;
+using firebase::firestore::remote::Serializer;
+using firebase::firestore::remote::WatchStreamSerializer;
+
+constexpr int kFieldSize = 100;
+
+/**
+ * Serializes a listen response carrying a document with `field_count` string
+ * fields, and splits it into slices of `slice_size` bytes the way gRPC hands
+ * over a message that arrived in several frames.
+ */
+grpc::ByteBuffer MakeListenResponse(int64_t field_count, int64_t slice_size) {
+  v1::ListenResponse response;
+  v1::DocumentChange* change = response.mutable_document_change();
+  change->add_target_ids(1);
+  v1::Document* document = change->mutable_document();
+  document->set_name("projects/p/databases/default/documents/coll/doc");
+  document->mutable_update_time()->set_seconds(1234);
+  for (int64_t i = 0; i < field_count; ++i) {
+    (*document->mutable_fields())[absl::StrCat("field", i)].set_string_value(
+        std::string(kFieldSize, 'x'));
+  }
+
+  std::string bytes = response.SerializeAsString();
+  std::vector<grpc::Slice> slices;
+  for (size_t i = 0; i < bytes.size(); i += static_cast<size_t>(slice_size)) {
+    size_t size = std::min(static_cast<size_t>(slice_size), bytes.size() - i);
+    slices.emplace_back(bytes.data() + i, size);
+  }
+  return grpc::ByteBuffer{slices.data(), slices.size()};
+}
+
+/**
+ * Decodes listen responses the same way `WatchStream::NotifyStreamResponse`
+ * does. The arguments are the number of fields in the document and the size of
+ * the slices the response is split into.
+ */
+void BM_DecodeListenResponse(benchmark::State& state) {
+  grpc::GrpcLibraryCodegen grpc_initializer;
+  WatchStreamSerializer serializer{Serializer(DatabaseId("p", "default"))};
+  grpc::ByteBuffer buffer = MakeListenResponse(state.range(0), state.range(1));
+
+  int64_t allocated_bytes_before = allocated_bytes;
+  for (auto _ : state) {
+    ByteBufferReader reader{buffer};
+    auto response = serializer.ParseResponse(&reader);
+    auto watch_change = serializer.DecodeWatchChange(&reader, *response);
+    auto version = serializer.DecodeSnapshotVersion(&reader, *response);
+    HARD_ASSERT(reader.ok(), "Failed to decode listen response");
+    benchmark::DoNotOptimize(watch_change);
+    benchmark::DoNotOptimize(version);
+  }
+
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(buffer.Length()));
+  state.counters["allocated_bytes_per_response"] = benchmark::Counter(
+      static_cast<double>(allocated_bytes - allocated_bytes_before) /
+      static_cast<double>(state.iterations()));
+}
+BENCHMARK(BM_DecodeListenResponse)
+    ->Args({10, 16 * 1024})
+    ->Args({1000, 16 * 1024})
+    ->Args({10000, 16 * 1024})
+    ->Args({10000, 1024 * 1024});
+
+}  // namespace
@@ -21,9 +21,11 @@
 #include <utility>
 #include <vector>
 
+#include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/types.h"
+#include "Firestore/core/src/remote/bloom_filter.h"
 #include "Firestore/core/src/remote/existence_filter.h"
 #include "Firestore/core/src/remote/watch_change.h"
 #include "Firestore/core/test/unit/remote/fake_target_metadata_provider.h"
@@ -35,6 +37,7 @@ namespace firebase {
 namespace firestore {
 namespace remote {
 
+using core::Target;
 using local::QueryPurpose;
 using local::TargetData;
 using model::DocumentKey;
@@ -71,6 +74,14 @@ std::unique_ptr<DocumentWatchChange> MakeDocChange(
       std::move(updated), std::move(removed), std::move(key), doc);
 }
 
+/**
+ * Returns a bloom filter that contains "coll/a" of the database of
+ * `FakeTargetMetadataProvider`, but neither "coll/b" nor "coll/c".
+ */
+BloomFilter BloomFilterWithCollA() {
+  return BloomFilter::Create({0x00, 0x15}, 0, 3).ValueOrDie();
+}
+
 std::unique_ptr<WatchTargetChange> MakeTargetChange(
     WatchTargetChangeState state, std::vector<TargetId> target_ids) {
   return absl::make_unique<WatchTargetChange>(state, std::move(target_ids));
@@ -595,6 +606,103 @@ TEST_F(RemoteEventTest, ExistenceFilterMismatchRemovesCurrentChanges) {
   ASSERT_TRUE(event.target_changes().at(1) == target_change1);
 }
 
+TEST_F(RemoteEventTest, ExistenceFilterMismatchWithBloomFilterRemovesDocs) {
+  std::unordered_map<TargetId, TargetData> target_map = ActiveQueries({1});
+  DocumentKey key_a = Key("coll/a");
+  DocumentKey key_b = Key("coll/b");
+  DocumentKey key_c = Key("coll/c");
+
+  WatchChangeAggregator aggregator =
+      CreateAggregator(target_map, no_outstanding_responses_,
+                       DocumentKeySet{key_a, key_b, key_c}, {});
+
+  // The bloom filter only contains "coll/a", so the other documents are
+  // removed from the target without resetting it.
+  ExistenceFilterWatchChange existence_filter{
+      ExistenceFilter{1, BloomFilterWithCollA()}, 1};
+  aggregator.HandleExistenceFilter(existence_filter);
+
+  RemoteEvent event = aggregator.CreateRemoteEvent(testutil::Version(3));
+
+  ASSERT_EQ(event.target_mismatches().size(), 0);
+  ASSERT_EQ(event.document_updates().size(), 0);
+  ASSERT_EQ(event.target_changes().size(), 1);
+
+  TargetChange target_change{resume_token1_, false, DocumentKeySet{},
+                             DocumentKeySet{},
+                             DocumentKeySet{key_b, key_c}};
+  ASSERT_TRUE(event.target_changes().at(1) == target_change);
+}
+
+TEST_F(RemoteEventTest, ExistenceFilterMismatchWithBloomFilterFalsePositive) {
+  std::unordered_map<TargetId, TargetData> target_map = ActiveQueries({1});
+  DocumentKey key_a = Key("coll/a");
+  DocumentKey key_b = Key("coll/b");
+
+  WatchChangeAggregator aggregator = CreateAggregator(
+      target_map, no_outstanding_responses_, DocumentKeySet{key_a, key_b}, {});
+
+  // The backend counts no documents, so "coll/a" must be a false positive of
+  // the bloom filter. The target is reset.
+  ExistenceFilterWatchChange existence_filter{
+      ExistenceFilter{0, BloomFilterWithCollA()}, 1};
+  aggregator.HandleExistenceFilter(existence_filter);
+
+  RemoteEvent event = aggregator.CreateRemoteEvent(testutil::Version(3));
+
+  ASSERT_EQ(event.target_mismatches().size(), 1);
+  ASSERT_EQ(event.target_changes().size(), 1);
+
+  TargetChange target_change{ByteString(), false, DocumentKeySet{},
+                             DocumentKeySet{}, DocumentKeySet{key_a, key_b}};
+  ASSERT_TRUE(event.target_changes().at(1) == target_change);
+}
+
+TEST_F(RemoteEventTest, ExistenceFilterMismatchWithEmptyBloomFilter) {
+  std::unordered_map<TargetId, TargetData> target_map = ActiveQueries({1});
+  DocumentKey key_a = Key("coll/a");
+  DocumentKey key_b = Key("coll/b");
+
+  WatchChangeAggregator aggregator = CreateAggregator(
+      target_map, no_outstanding_responses_, DocumentKeySet{key_a, key_b}, {});
+
+  ExistenceFilterWatchChange existence_filter{
+      ExistenceFilter{1, BloomFilter::Create({}, 0, 0).ValueOrDie()}, 1};
+  aggregator.HandleExistenceFilter(existence_filter);
+
+  RemoteEvent event = aggregator.CreateRemoteEvent(testutil::Version(3));
+
+  ASSERT_EQ(event.target_mismatches().size(), 1);
+}
+
+TEST_F(RemoteEventTest, BloomFilterDoesNotRemoveChangedDocuments) {
+  std::unordered_map<TargetId, TargetData> target_map = ActiveQueries({1});
+  DocumentKey key_a = Key("coll/a");
+  MutableDocument doc_b = Doc("coll/b", 2, Map("value", 2));
+  DocumentKey key_c = Key("coll/c");
+
+  // "coll/b" changed since the resume token, so it is not in the bloom filter
+  // of unchanged documents even though it still matches.
+  WatchChangeAggregator aggregator = CreateAggregator(
+      target_map, no_outstanding_responses_,
+      DocumentKeySet{key_a, doc_b.key(), key_c},
+      Changes(MakeDocChange({1}, {}, doc_b.key(), doc_b)));
+
+  ExistenceFilterWatchChange existence_filter{
+      ExistenceFilter{2, BloomFilterWithCollA()}, 1};
+  aggregator.HandleExistenceFilter(existence_filter);
+
+  RemoteEvent event = aggregator.CreateRemoteEvent(testutil::Version(3));
+
+  ASSERT_EQ(event.target_mismatches().size(), 0);
+  ASSERT_EQ(event.document_updates().size(), 1);
+
+  TargetChange target_change{resume_token1_, false, DocumentKeySet{},
+                             DocumentKeySet{doc_b.key()},
+                             DocumentKeySet{key_c}};
+  ASSERT_TRUE(event.target_changes().at(1) == target_change);
+}
+
 TEST_F(RemoteEventTest, DocumentUpdate) {
   std::unordered_map<TargetId, TargetData> target_map = ActiveQueries({1});
 
@@ -750,6 +858,50 @@ TEST_F(RemoteEventTest, DoesntSynthesizeDeletesForExistingDoc) {
   ASSERT_EQ(event.limbo_document_changes().size(), 0);
 }
 
+TEST_F(RemoteEventTest, SynthesizeDeletesForDocumentsTarget) {
+  DocumentKey existing_key = Key("coll/existing");
+  DocumentKey missing_key = Key("other/missing");
+  std::unordered_map<TargetId, TargetData> target_map;
+  target_map[1] =
+      TargetData(Target::ForDocuments({existing_key, missing_key}), 1, 0,
+                 QueryPurpose::LimboResolution);
+
+  auto resolve_limbo_target =
+      MakeTargetChange(WatchTargetChangeState::Current, {1});
+  RemoteEvent event = CreateRemoteEvent(
+      3, target_map, no_outstanding_responses_, DocumentKeySet{existing_key},
+      Changes(std::move(resolve_limbo_target)));
+
+  // Only the document that the target didn't return is deleted.
+  MutableDocument expected =
+      MutableDocument::NoDocument(missing_key, event.snapshot_version());
+  ASSERT_EQ(event.document_updates().size(), 1);
+  ASSERT_EQ(event.document_updates().at(missing_key), expected);
+  ASSERT_TRUE(event.limbo_document_changes().contains(missing_key));
+}
+
+TEST_F(RemoteEventTest, EmptyExistenceFilterDeletesAllDocumentsOfTarget) {
+  DocumentKey key1 = Key("coll/a");
+  DocumentKey key2 = Key("coll/b");
+  std::unordered_map<TargetId, TargetData> target_map;
+  target_map[1] = TargetData(Target::ForDocuments({key1, key2}), 1, 0,
+                             QueryPurpose::LimboResolution);
+
+  WatchChangeAggregator aggregator = CreateAggregator(
+      target_map, no_outstanding_responses_, DocumentKeySet{}, {});
+  aggregator.HandleExistenceFilter(
+      ExistenceFilterWatchChange{ExistenceFilter{0}, 1});
+
+  RemoteEvent event = aggregator.CreateRemoteEvent(testutil::Version(3));
+
+  ASSERT_EQ(event.document_updates().size(), 2);
+  ASSERT_EQ(event.document_updates().at(key1),
+            MutableDocument::NoDocument(key1, SnapshotVersion::None()));
+  ASSERT_EQ(event.document_updates().at(key2),
+            MutableDocument::NoDocument(key2, SnapshotVersion::None()));
+  ASSERT_EQ(event.target_mismatches().size(), 0);
+}
+
 TEST_F(RemoteEventTest, SeparatesDocumentUpdates) {
   std::unordered_map<TargetId, TargetData> target_map = ActiveLimboQueries({1});
 
@@ -812,6 +964,69 @@ TEST_F(RemoteEventTest, TracksLimboDocuments) {
   ASSERT_FALSE(limbo_doc_changes.contains(doc3.key()));
 }
 
+TEST_F(RemoteEventTest, CoalescesTargetChanges) {
+  DocumentKey added = Key("docs/added");
+  DocumentKey added_then_modified = Key("docs/added_then_modified");
+  DocumentKey added_then_removed = Key("docs/added_then_removed");
+  DocumentKey modified_then_removed = Key("docs/modified_then_removed");
+  DocumentKey removed_then_added = Key("docs/removed_then_added");
+
+  TargetChange earlier{
+      resume_token1_, false,
+      DocumentKeySet{added, added_then_modified, added_then_removed},
+      DocumentKeySet{modified_then_removed},
+      DocumentKeySet{removed_then_added}};
+  TargetChange later{ByteString{}, true, DocumentKeySet{removed_then_added},
+                     DocumentKeySet{added_then_modified},
+                     DocumentKeySet{added_then_removed, modified_then_removed}};
+
+  TargetChange expected{resume_token1_, true,
+                        DocumentKeySet{added, added_then_modified},
+                        DocumentKeySet{removed_then_added},
+                        DocumentKeySet{modified_then_removed}};
+  ASSERT_TRUE(TargetChange::Coalesce(earlier, later) == expected);
+}
+
+TEST_F(RemoteEventTest, CoalescesRemoteEvents) {
+  MutableDocument doc1 = Doc("docs/1", 1, Map("value", 1));
+  MutableDocument doc2 = Doc("docs/2", 1, Map("value", 2));
+  MutableDocument updated_doc1 = Doc("docs/1", 2, Map("value", 3));
+  ByteString resume_token2 = testutil::ResumeToken(8);
+
+  RemoteEvent earlier{
+      testutil::Version(1),
+      {{1, TargetChange{resume_token1_, true, DocumentKeySet{doc1.key()},
+                        DocumentKeySet{}, DocumentKeySet{}}},
+       {2, TargetChange{resume_token1_, false, DocumentKeySet{doc2.key()},
+                        DocumentKeySet{}, DocumentKeySet{}}}},
+      {},
+      {{doc1.key(), doc1}, {doc2.key(), doc2}},
+      DocumentKeySet{doc1.key(), doc2.key()}};
+  RemoteEvent later{
+      testutil::Version(2),
+      {{1, TargetChange{resume_token2, true, DocumentKeySet{},
+                        DocumentKeySet{doc1.key()}, DocumentKeySet{}}}},
+      {},
+      {{doc1.key(), updated_doc1}},
+      DocumentKeySet{}};
+
+  RemoteEvent event = RemoteEvent::Coalesce(earlier, later);
+
+  ASSERT_EQ(event.snapshot_version(), testutil::Version(2));
+  ASSERT_EQ(event.target_changes().size(), 2);
+  TargetChange target_change1{resume_token2, true, DocumentKeySet{doc1.key()},
+                              DocumentKeySet{}, DocumentKeySet{}};
+  ASSERT_TRUE(event.target_changes().at(1) == target_change1);
+  ASSERT_TRUE(event.target_changes().at(2) == earlier.target_changes().at(2));
+
+  ASSERT_EQ(event.document_updates().size(), 2);
+  ASSERT_EQ(event.document_updates().at(doc1.key()), updated_doc1);
+  ASSERT_EQ(event.document_updates().at(doc2.key()), doc2);
+
+  // doc1 was last updated by a non-limbo target.
+  ASSERT_EQ(event.limbo_document_changes(), DocumentKeySet{doc2.key()});
+}
+
 }  // namespace remote
 }  // namespace firestore
 }  // namespace firebase
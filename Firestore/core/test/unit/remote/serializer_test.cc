@@ -53,9 +53,12 @@
 #include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/model/verify_mutation.h"
 #include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/nanopb/writer.h"
+#include "Firestore/core/src/remote/bloom_filter.h"
 #include "Firestore/core/src/timestamp_internal.h"
+#include "Firestore/core/src/util/read_context.h"
 #include "Firestore/core/src/util/status.h"
 #include "Firestore/core/test/unit/nanopb/nanopb_testing.h"
 #include "Firestore/core/test/unit/testutil/status_testing.h"
@@ -101,6 +104,7 @@ using model::VerifyMutation;
 using nanopb::ByteString;
 using nanopb::ByteStringWriter;
 using nanopb::FreeNanopbMessage;
+using nanopb::MakeBytesArray;
 using nanopb::MakeSharedMessage;
 using nanopb::Message;
 using nanopb::ProtobufParse;
@@ -120,6 +124,7 @@ using testutil::Query;
 using testutil::Ref;
 using testutil::Value;
 using testutil::Version;
+using util::ReadContext;
 using util::Status;
 using util::StatusOr;
 
@@ -1122,6 +1127,19 @@ TEST_F(SerializerTest, EncodesFirstLevelKeyQueries) {
   ExpectRoundTrip(model, proto);
 }
 
+TEST_F(SerializerTest, EncodesTargetsForSeveralDocuments) {
+  TargetData model(core::Target::ForDocuments({Key("docs/1"), Key("rooms/2")}),
+                   1, 0, QueryPurpose::LimboResolution);
+
+  v1::Target proto;
+  proto.mutable_documents()->add_documents(ResourceName("docs/1"));
+  proto.mutable_documents()->add_documents(ResourceName("rooms/2"));
+  proto.set_target_id(1);
+
+  SCOPED_TRACE("EncodesTargetsForSeveralDocuments");
+  ExpectSerializationRoundTrip(model, proto);
+}
+
 TEST_F(SerializerTest, EncodesFirstLevelAncestorQueries) {
   TargetData model = CreateTargetData("messages");
 
@@ -1440,6 +1458,46 @@ TEST_F(SerializerTest, EncodesResumeTokens) {
   ExpectRoundTrip(model, proto);
 }
 
+TEST_F(SerializerTest, EncodesExpectedCountWithResumeToken) {
+  core::Query q = Query("docs");
+  TargetData model = TargetData(q.ToTarget(), 1, 0, QueryPurpose::Listen,
+                                SnapshotVersion::None(),
+                                SnapshotVersion::None(), Bytes({1, 2, 3}))
+                         .WithExpectedCount(42);
+
+  v1::Target proto;
+  proto.mutable_query()->set_parent(ResourceName(""));
+  proto.set_target_id(1);
+
+  v1::StructuredQuery::CollectionSelector from;
+  from.set_collection_id("docs");
+  *proto.mutable_query()->mutable_structured_query()->add_from() =
+      std::move(from);
+
+  v1::StructuredQuery::Order order;
+  order.mutable_field()->set_field_path(FieldPath::kDocumentKeyPath);
+  order.set_direction(v1::StructuredQuery::ASCENDING);
+  *proto.mutable_query()->mutable_structured_query()->add_order_by() =
+      std::move(order);
+
+  proto.set_resume_token("\001\002\003");
+  proto.mutable_expected_count()->set_value(42);
+
+  SCOPED_TRACE("EncodesExpectedCountWithResumeToken");
+  ExpectRoundTrip(model, proto);
+}
+
+TEST_F(SerializerTest, DoesNotEncodeExpectedCountWithoutResumeToken) {
+  TargetData model = CreateTargetData("docs/1").WithExpectedCount(42);
+
+  v1::Target proto;
+  proto.mutable_documents()->add_documents(ResourceName("docs/1"));
+  proto.set_target_id(1);
+
+  SCOPED_TRACE("DoesNotEncodeExpectedCountWithoutResumeToken");
+  ExpectRoundTrip(model, proto);
+}
+
 TEST_F(SerializerTest, EncodesListenRequestLabels) {
   core::Query q = Query("docs");
 
@@ -1619,6 +1677,43 @@ TEST_F(SerializerTest, DecodesListenResponseWithExistenceFilter) {
   ExpectDeserializationRoundTrip(model, proto);
 }
 
+TEST_F(SerializerTest, DecodesExistenceFilterWithBloomFilter) {
+  std::vector<uint8_t> bitmap{0x04, 0x04, 0x44, 0x00, 0x20, 0x00, 0x08, 0x00};
+  BloomFilter bloom_filter = BloomFilter::Create(bitmap, 4, 3).ValueOrDie();
+  ExistenceFilterWatchChange model(ExistenceFilter(2, bloom_filter), 100);
+
+  Message<google_firestore_v1_ListenResponse> proto;
+  proto->which_response_type = google_firestore_v1_ListenResponse_filter_tag;
+  proto->filter.target_id = 100;
+  proto->filter.count = 2;
+  proto->filter.has_unchanged_names = true;
+  proto->filter.unchanged_names.bits.bitmap =
+      MakeBytesArray(bitmap.data(), bitmap.size());
+  proto->filter.unchanged_names.bits.padding = 4;
+  proto->filter.unchanged_names.hash_count = 3;
+
+  ReadContext context;
+  auto actual_model = serializer.DecodeWatchChange(&context, *proto);
+  EXPECT_OK(context.status());
+  EXPECT_EQ(model, *actual_model);
+}
+
+TEST_F(SerializerTest, DropsInvalidBloomFilter) {
+  ExistenceFilterWatchChange model(ExistenceFilter(2), 100);
+
+  Message<google_firestore_v1_ListenResponse> proto;
+  proto->which_response_type = google_firestore_v1_ListenResponse_filter_tag;
+  proto->filter.target_id = 100;
+  proto->filter.count = 2;
+  proto->filter.has_unchanged_names = true;
+  proto->filter.unchanged_names.bits.padding = 1;
+
+  ReadContext context;
+  auto actual_model = serializer.DecodeWatchChange(&context, *proto);
+  EXPECT_OK(context.status());
+  EXPECT_EQ(model, *actual_model);
+}
+
 TEST_F(SerializerTest, DecodesVersion) {
   auto version = Version(123456789);
   SnapshotVersion model(version.timestamp());
@@ -22,10 +22,17 @@
 #include <utility>
 #include <vector>
 
+#include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/nanopb/byte_string.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
 #include "Firestore/core/src/remote/grpc_completion.h"
 #include "Firestore/core/src/remote/grpc_connection.h"
+#include "Firestore/core/src/remote/grpc_nanopb.h"
 #include "Firestore/core/src/remote/grpc_stream.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/remote/write_stream.h"
 #include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
 #include "Firestore/core/test/unit/remote/fake_credentials_provider.h"
@@ -49,6 +56,11 @@ using credentials::AppCheckCredentialsProvider;
 using credentials::AuthCredentialsProvider;
 using credentials::AuthToken;
 using credentials::User;
+using model::DatabaseId;
+using model::MutationResult;
+using model::SnapshotVersion;
+using nanopb::ByteString;
+using nanopb::Message;
 using util::AsyncQueue;
 using util::StringFormat;
 using util::TimerId;
@@ -143,6 +155,80 @@ class TestStream : public Stream {
   grpc::ClientContext* context_ = nullptr;
 };
 
+class TestWriteStream : public WriteStream {
+ public:
+  TestWriteStream(const std::shared_ptr<AsyncQueue>& worker_queue,
+                  GrpcStreamTester* tester,
+                  std::shared_ptr<AuthCredentialsProvider>
+                      auth_credentials_provider,
+                  std::shared_ptr<AppCheckCredentialsProvider>
+                      app_check_credentials_provider,
+                  WriteStreamCallback* callback)
+      : WriteStream{worker_queue,
+                    std::move(auth_credentials_provider),
+                    std::move(app_check_credentials_provider),
+                    Serializer{DatabaseId{"p", "d"}},
+                    /*grpc_connection=*/nullptr,
+                    callback},
+        tester_{tester} {
+  }
+
+  using WriteStream::EncodeHandshake;
+
+  grpc::ClientContext* context() {
+    return context_;
+  }
+
+ private:
+  std::unique_ptr<GrpcStream> CreateGrpcStream(GrpcConnection*,
+                                               const AuthToken&,
+                                               const std::string&) override {
+    auto result = tester_->CreateStream(this);
+    context_ = result->context();
+    return result;
+  }
+
+  GrpcStreamTester* tester_ = nullptr;
+  grpc::ClientContext* context_ = nullptr;
+};
+
+class FakeWriteStreamCallback : public WriteStreamCallback {
+ public:
+  void OnWriteStreamOpen() override {
+    observed_states_.push_back("OnWriteStreamOpen");
+  }
+
+  void OnWriteStreamHandshakeComplete() override {
+    observed_states_.push_back("OnWriteStreamHandshakeComplete");
+  }
+
+  void OnWriteStreamMutationResult(SnapshotVersion,
+                                   std::vector<MutationResult>) override {
+    observed_states_.push_back("OnWriteStreamMutationResult");
+  }
+
+  void OnWriteStreamClose(const util::Status& status) override {
+    observed_states_.push_back(absl::StrCat(
+        "OnWriteStreamClose(", GetFirestoreErrorName(status.code()), ")"));
+  }
+
+  const std::vector<std::string>& observed_states() const {
+    return observed_states_;
+  }
+
+ private:
+  std::vector<std::string> observed_states_;
+};
+
+/** Encodes a handshake response for the stream with the given ID. */
+grpc::ByteBuffer HandshakeResponse(const std::string& stream_id,
+                                   const std::string& stream_token) {
+  Message<google_firestore_v1_WriteResponse> response;
+  response->stream_id = nanopb::MakeBytesArray(stream_id);
+  response->stream_token = nanopb::MakeBytesArray(stream_token);
+  return MakeByteBuffer(response);
+}
+
 }  // namespace
 
 class StreamTest : public testing::Test {
@@ -575,6 +661,136 @@ TEST_F(StreamTest, TokenIsNotInvalidatedOnceStreamIsHealthy) {
   EXPECT_EQ(app_check_credentials->observed_states(), States({"GetToken"}));
 }
 
+class WriteStreamTest : public testing::Test {
+ public:
+  WriteStreamTest()
+      : worker_queue{testutil::AsyncQueueForTesting()},
+        connectivity_monitor{CreateNoOpConnectivityMonitor()},
+        tester{worker_queue, connectivity_monitor.get()},
+        write_stream{std::make_shared<TestWriteStream>(
+            worker_queue,
+            &tester,
+            std::make_shared<FakeCredentialsProvider<AuthToken, User>>(),
+            std::make_shared<
+                FakeCredentialsProvider<std::string, std::string>>(),
+            &callback)} {
+  }
+
+  ~WriteStreamTest() {
+    worker_queue->EnqueueBlocking([&] {
+      if (write_stream->IsStarted()) {
+        tester.KeepPollingGrpcQueue();
+        write_stream->Stop();
+      }
+    });
+    tester.Shutdown();
+  }
+
+  void StartStream() {
+    worker_queue->EnqueueBlocking([&] { write_stream->Start(); });
+    worker_queue->EnqueueBlocking([] {});
+  }
+
+  void ForceFinish(std::initializer_list<CompletionEndState> results) {
+    tester.ForceFinish(write_stream->context(), results);
+  }
+
+  std::shared_ptr<AsyncQueue> worker_queue;
+
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor;
+  GrpcStreamTester tester;
+
+  FakeWriteStreamCallback callback;
+  std::shared_ptr<TestWriteStream> write_stream;
+};
+
+TEST_F(WriteStreamTest, HandshakeStartsNewStreamWithoutStreamId) {
+  worker_queue->EnqueueBlocking([&] {
+    write_stream->set_last_stream_token(ByteString{"token"});
+
+    auto request = write_stream->EncodeHandshake();
+    EXPECT_EQ(request->stream_id, nullptr);
+    EXPECT_EQ(request->stream_token, nullptr);
+  });
+}
+
+TEST_F(WriteStreamTest, HandshakeResumesStreamWithStreamIdAndToken) {
+  worker_queue->EnqueueBlocking([&] {
+    write_stream->set_stream_id(ByteString{"stream-1"});
+
+    // Without a stream token, there is nothing to resume from.
+    auto request = write_stream->EncodeHandshake();
+    EXPECT_EQ(request->stream_id, nullptr);
+
+    write_stream->set_last_stream_token(ByteString{"token"});
+    request = write_stream->EncodeHandshake();
+    EXPECT_EQ(ByteString{request->stream_id}, ByteString{"stream-1"});
+    EXPECT_EQ(ByteString{request->stream_token}, ByteString{"token"});
+  });
+}
+
+TEST_F(WriteStreamTest, HandshakeIsResumedWhenServerKeepsStreamId) {
+  worker_queue->EnqueueBlocking([&] {
+    write_stream->set_stream_id(ByteString{"stream-1"});
+    write_stream->set_last_stream_token(ByteString{"token-1"});
+  });
+  StartStream();
+
+  ForceFinish({{Type::Read, HandshakeResponse("stream-1", "token-2")}});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_TRUE(write_stream->handshake_complete());
+    EXPECT_TRUE(write_stream->handshake_resumed());
+    EXPECT_EQ(write_stream->stream_id(), ByteString{"stream-1"});
+    EXPECT_EQ(write_stream->last_stream_token(), ByteString{"token-2"});
+  });
+}
+
+TEST_F(WriteStreamTest, HandshakeIsNotResumedWhenServerAssignsNewStreamId) {
+  worker_queue->EnqueueBlocking([&] {
+    write_stream->set_stream_id(ByteString{"stream-1"});
+    write_stream->set_last_stream_token(ByteString{"token-1"});
+  });
+  StartStream();
+
+  ForceFinish({{Type::Read, HandshakeResponse("stream-2", "token-2")}});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_TRUE(write_stream->handshake_complete());
+    EXPECT_FALSE(write_stream->handshake_resumed());
+    EXPECT_EQ(write_stream->stream_id(), ByteString{"stream-2"});
+  });
+}
+
+TEST_F(WriteStreamTest, KeepsStreamIdWhenStreamFails) {
+  StartStream();
+  ForceFinish({{Type::Read, HandshakeResponse("stream-1", "token-1")}});
+
+  ForceFinish({{Type::Read, CompletionResult::Error},
+               {Type::Finish, grpc::Status{grpc::UNAVAILABLE, ""}}});
+
+  worker_queue->EnqueueBlocking([&] {
+    EXPECT_FALSE(write_stream->handshake_complete());
+    EXPECT_FALSE(write_stream->handshake_resumed());
+    EXPECT_EQ(write_stream->stream_id(), ByteString{"stream-1"});
+    EXPECT_EQ(callback.observed_states().back(),
+              "OnWriteStreamClose(Unavailable)");
+  });
+}
+
+TEST_F(WriteStreamTest, ClearsStreamIdWhenStoppedGracefully) {
+  StartStream();
+  ForceFinish({{Type::Read, HandshakeResponse("stream-1", "token-1")}});
+
+  worker_queue->EnqueueBlocking([&] {
+    tester.KeepPollingGrpcQueue();
+    write_stream->Stop();
+
+    EXPECT_FALSE(write_stream->handshake_complete());
+    EXPECT_TRUE(write_stream->stream_id().empty());
+  });
+}
+
 }  // namespace remote
 }  // namespace firestore
 }  // namespace firebase
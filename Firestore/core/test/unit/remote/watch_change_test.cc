@@ -17,6 +17,7 @@
 #include "Firestore/core/src/remote/watch_change.h"
 
 #include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/remote/bloom_filter.h"
 #include "Firestore/core/src/remote/existence_filter.h"
 #include "Firestore/core/test/unit/testutil/testutil.h"
 #include "gtest/gtest.h"
@@ -44,9 +45,21 @@ TEST(WatchChangeTest, CanCreateExistenceFilterWatchChange) {
   ExistenceFilter filter{7};
   ExistenceFilterWatchChange change{filter, 5};
   EXPECT_EQ(change.filter().count(), 7);
+  EXPECT_FALSE(change.filter().unchanged_names().has_value());
   EXPECT_EQ(change.target_id(), 5);
 }
 
+TEST(WatchChangeTest, CanCreateExistenceFilterWatchChangeWithBloomFilter) {
+  BloomFilter bloom_filter = BloomFilter::Create({0x0f}, 4, 1).ValueOrDie();
+  ExistenceFilter filter{7, bloom_filter};
+  ExistenceFilterWatchChange change{filter, 5};
+  EXPECT_EQ(change.filter().count(), 7);
+  EXPECT_EQ(change.filter().unchanged_names(), bloom_filter);
+  EXPECT_EQ(change.target_id(), 5);
+
+  EXPECT_FALSE(change == (ExistenceFilterWatchChange{ExistenceFilter{7}, 5}));
+}
+
 TEST(WatchChangeTest, CanCreateWatchTargetChange) {
   WatchTargetChange change{WatchTargetChangeState::Reset,
                            {
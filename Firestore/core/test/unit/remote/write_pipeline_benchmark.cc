@@ -0,0 +1,337 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT(build/c++11)
+#include <deque>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "Firestore/core/src/remote/grpc_completion.h"
+#include "Firestore/core/src/remote/grpc_nanopb.h"
+#include "Firestore/core/src/remote/grpc_stream.h"
+#include "Firestore/core/src/remote/serializer.h"
+#include "Firestore/core/src/remote/write_pipeline_depth.h"
+#include "Firestore/core/src/remote/write_stream.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/test/unit/remote/create_noop_connectivity_monitor.h"
+#include "Firestore/core/test/unit/remote/fake_credentials_provider.h"
+#include "Firestore/core/test/unit/remote/grpc_stream_tester.h"
+#include "Firestore/core/test/unit/testutil/async_testing.h"
+#include "Firestore/core/test/unit/testutil/testutil.h"
+#include "benchmark/benchmark.h"
+#include "grpcpp/support/byte_buffer.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using credentials::AuthToken;
+using credentials::User;
+using model::DatabaseId;
+using model::Mutation;
+using model::MutationResult;
+using model::SnapshotVersion;
+using nanopb::Message;
+using testutil::Map;
+using util::AsyncQueue;
+
+using Micros = std::chrono::microseconds;
+using Type = GrpcCompletion::Type;
+
+// The number of queued batches sent in each run.
+constexpr int kBatchCount = 1000;
+
+/**
+ * A model of the Write service that applies one write at a time,
+ * `service_time` after it is received or after the previous write was
+ * applied. Requests and responses each take half of `round_trip` to cross the
+ * network.
+ */
+class FakeWriteService {
+ public:
+  FakeWriteService(Micros round_trip, Micros service_time)
+      : round_trip_(round_trip), service_time_(service_time) {
+  }
+
+  /** Returns when the response to a write sent at `sent` arrives. */
+  Micros Write(Micros sent) {
+    Micros received = sent + round_trip_ / 2;
+    applied_ = std::max(applied_, received) + service_time_;
+    return applied_ + round_trip_ / 2;
+  }
+
+ private:
+  Micros round_trip_;
+  Micros service_time_;
+  Micros applied_{0};
+};
+
+/** A `WriteStream` whose gRPC calls go to a `GrpcStreamTester`. */
+class BenchmarkWriteStream : public WriteStream {
+ public:
+  BenchmarkWriteStream(const std::shared_ptr<AsyncQueue>& worker_queue,
+                       GrpcStreamTester* tester,
+                       WriteStreamCallback* callback)
+      : WriteStream{
+            worker_queue,
+            std::make_shared<FakeCredentialsProvider<AuthToken, User>>(),
+            std::make_shared<
+                FakeCredentialsProvider<std::string, std::string>>(),
+            Serializer{DatabaseId{"p", "d"}},
+            /*grpc_connection=*/nullptr,
+            callback},
+        tester_{tester} {
+  }
+
+  grpc::ClientContext* context() {
+    return context_;
+  }
+
+ private:
+  std::unique_ptr<GrpcStream> CreateGrpcStream(GrpcConnection*,
+                                               const AuthToken&,
+                                               const std::string&) override {
+    auto result = tester_->CreateStream(this);
+    context_ = result->context();
+    return result;
+  }
+
+  GrpcStreamTester* tester_ = nullptr;
+  grpc::ClientContext* context_ = nullptr;
+};
+
+/**
+ * Drives a `WriteStream` the way `RemoteStore` does: sends the handshake once
+ * the stream opens, then keeps as many batches in flight as the
+ * `WritePipelineDepth` allows and refills the pipeline on each
+ * acknowledgement.
+ *
+ * The round trips the depth adapts to are taken from `FakeWriteService`, on a
+ * simulated clock that advances to the arrival of each acknowledgement.
+ */
+class PipelinedWriter : public WriteStreamCallback {
+ public:
+  PipelinedWriter(int max_depth, FakeWriteService service)
+      : depth_(max_depth), service_(service) {
+  }
+
+  void set_stream(WriteStream* stream) {
+    stream_ = stream;
+  }
+
+  /** The simulated time the last acknowledgement arrived at. */
+  Micros simulated_time() const {
+    return now_;
+  }
+
+  void OnWriteStreamOpen() override {
+    stream_->WriteHandshake();
+  }
+
+  void OnWriteStreamHandshakeComplete() override {
+    FillPipeline();
+  }
+
+  void OnWriteStreamMutationResult(SnapshotVersion,
+                                   std::vector<MutationResult>) override {
+    HARD_ASSERT(!in_flight_.empty(), "Got a write response with no writes");
+
+    now_ = in_flight_.front().second;
+    depth_.OnWriteAcknowledged(now_ - in_flight_.front().first);
+    in_flight_.pop_front();
+    FillPipeline();
+  }
+
+  void OnWriteStreamClose(const util::Status& status) override {
+    HARD_FAIL("Write stream closed unexpectedly: %s", status.ToString());
+  }
+
+ private:
+  void FillPipeline() {
+    while (sent_ < kBatchCount &&
+           in_flight_.size() < static_cast<size_t>(depth_.depth())) {
+      stream_->WriteMutations(batch_);
+      in_flight_.emplace_back(now_, service_.Write(now_));
+      ++sent_;
+    }
+  }
+
+  WritePipelineDepth depth_;
+  FakeWriteService service_;
+  WriteStream* stream_ = nullptr;
+
+  std::vector<Mutation> batch_{testutil::SetMutation("docs/1", Map("a", 1))};
+  // The send and response times of the writes in flight, in order.
+  std::deque<std::pair<Micros, Micros>> in_flight_;
+  Micros now_{0};
+  int sent_ = 0;
+};
+
+/**
+ * Completes the stream's gRPC operations the way the Write service would:
+ * every write goes through, the handshake is answered, and then each batch is
+ * acknowledged with a single write result, never before it was written.
+ */
+class FakeWriteBackend {
+ public:
+  FakeWriteBackend() {
+    Message<google_firestore_v1_WriteResponse> handshake;
+    handshake->stream_id = nanopb::MakeBytesArray("stream");
+    handshake->stream_token = nanopb::MakeBytesArray("token");
+    handshake_response_ = MakeByteBuffer(handshake);
+
+    Message<google_firestore_v1_WriteResponse> write;
+    write->stream_token = nanopb::MakeBytesArray("token");
+    write->commit_time.seconds = 1;
+    write->write_results_count = 1;
+    write->write_results =
+        nanopb::MakeArray<google_firestore_v1_WriteResult>(1);
+    write_response_ = MakeByteBuffer(write);
+  }
+
+  /**
+   * Completes `completion` or holds it until it can be answered. Returns true
+   * once all `kBatchCount` batches have been acknowledged.
+   */
+  bool Handle(GrpcCompletion* completion) {
+    switch (completion->type()) {
+      case Type::Write:
+        ++writes_;
+        completion->Complete(true);
+        break;
+
+      case Type::Read:
+        HARD_ASSERT(pending_read_ == nullptr, "Two reads in progress");
+        pending_read_ = completion;
+        break;
+
+      default:
+        HARD_FAIL("Unexpected completion type %s", completion->type());
+    }
+
+    MaybeRespond();
+    return acknowledged_ == kBatchCount;
+  }
+
+ private:
+  void MaybeRespond() {
+    if (pending_read_ == nullptr) {
+      return;
+    }
+
+    // The first write is the handshake; every later one is a batch.
+    if (!handshake_complete_) {
+      if (writes_ == 0) {
+        return;
+      }
+      *pending_read_->message() = handshake_response_;
+      handshake_complete_ = true;
+    } else {
+      if (acknowledged_ >= writes_ - 1) {
+        return;
+      }
+      *pending_read_->message() = write_response_;
+      ++acknowledged_;
+    }
+
+    pending_read_->Complete(true);
+    pending_read_ = nullptr;
+  }
+
+  grpc::ByteBuffer handshake_response_;
+  grpc::ByteBuffer write_response_;
+
+  GrpcCompletion* pending_read_ = nullptr;
+  bool handshake_complete_ = false;
+  int writes_ = 0;
+  int acknowledged_ = 0;
+};
+
+/**
+ * Sends `kBatchCount` batches through a real `WriteStream` over faked gRPC
+ * completions, with the maximum pipeline depth, round trip and service time in
+ * microseconds given by the benchmark's arguments. A maximum depth of 10 is
+ * the fixed depth the pipeline used to have.
+ *
+ * The measured time is spent in the stream, its serializer and the gRPC
+ * plumbing. The simulated counters show how the depth policy fares against
+ * `FakeWriteService`; `RemoteStore` itself does not take part.
+ */
+void BM_WritePipelineDepth(benchmark::State& state) {
+  std::shared_ptr<AsyncQueue> worker_queue = testutil::AsyncQueueForTesting();
+  std::unique_ptr<ConnectivityMonitor> connectivity_monitor =
+      CreateNoOpConnectivityMonitor();
+  Micros simulated_time{0};
+
+  for (auto _ : state) {
+    GrpcStreamTester tester{worker_queue, connectivity_monitor.get()};
+    PipelinedWriter writer{
+        static_cast<int>(state.range(0)),
+        FakeWriteService{Micros(state.range(1)), Micros(state.range(2))}};
+    auto stream =
+        std::make_shared<BenchmarkWriteStream>(worker_queue, &tester, &writer);
+    writer.set_stream(stream.get());
+
+    worker_queue->EnqueueBlocking([&] { stream->Start(); });
+    worker_queue->EnqueueBlocking([] {});
+
+    FakeWriteBackend backend;
+    tester.ForceFinish(stream->context(), [&](GrpcCompletion* completion) {
+      return backend.Handle(completion);
+    });
+
+    worker_queue->EnqueueBlocking([&] {
+      tester.KeepPollingGrpcQueue();
+      stream->Stop();
+    });
+    tester.Shutdown();
+
+    simulated_time = writer.simulated_time();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+  state.counters["simulated_ms"] =
+      benchmark::Counter(static_cast<double>(simulated_time.count()) / 1000);
+  state.counters["simulated_writes_per_second"] = benchmark::Counter(
+      kBatchCount * 1e6 / static_cast<double>(simulated_time.count()));
+}
+
+void PipelineArguments(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"max_depth", "round_trip_us", "service_us"});
+  for (int max_depth : {10, 100, 1000}) {
+    for (int round_trip : {20000, 200000}) {
+      for (int service_time : {500, 5000}) {
+        benchmark->Args({max_depth, round_trip, service_time});
+      }
+    }
+  }
+}
+BENCHMARK(BM_WritePipelineDepth)->Apply(PipelineArguments);
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
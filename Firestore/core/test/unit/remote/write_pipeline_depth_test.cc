@@ -0,0 +1,94 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/write_pipeline_depth.h"
+
+#include <chrono>  // NOLINT(build/c++11)
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using Millis = std::chrono::milliseconds;
+
+constexpr int kInitialDepth = WritePipelineDepth::kInitialDepth;
+
+/** Acknowledges `count` writes, each with the given round trip. */
+void Acknowledge(WritePipelineDepth* depth, int count, Millis round_trip) {
+  for (int i = 0; i < count; ++i) {
+    depth->OnWriteAcknowledged(round_trip);
+  }
+}
+
+TEST(WritePipelineDepthTest, StartsAtInitialDepth) {
+  EXPECT_EQ(WritePipelineDepth(100).depth(), kInitialDepth);
+  EXPECT_EQ(WritePipelineDepth(5).depth(), 5);
+}
+
+TEST(WritePipelineDepthTest, GrowsOncePerPipelineAcknowledgedInTime) {
+  WritePipelineDepth depth(100);
+
+  Acknowledge(&depth, kInitialDepth - 1, Millis(50));
+  EXPECT_EQ(depth.depth(), kInitialDepth);
+
+  Acknowledge(&depth, 1, Millis(80));
+  EXPECT_EQ(depth.depth(), kInitialDepth + 1);
+
+  Acknowledge(&depth, kInitialDepth + 1, Millis(100));
+  EXPECT_EQ(depth.depth(), kInitialDepth + 2);
+}
+
+TEST(WritePipelineDepthTest, StopsGrowingAtMaximum) {
+  WritePipelineDepth depth(12);
+
+  Acknowledge(&depth, 1000, Millis(50));
+  EXPECT_EQ(depth.depth(), 12);
+}
+
+TEST(WritePipelineDepthTest, ShrinksWhenRoundTripsSlowDown) {
+  WritePipelineDepth depth(100);
+  Acknowledge(&depth, 1000, Millis(50));
+  int grown = depth.depth();
+  ASSERT_GT(grown, kInitialDepth);
+
+  Acknowledge(&depth, 3, Millis(101));
+  EXPECT_EQ(depth.depth(), grown - 3);
+
+  Acknowledge(&depth, 1000, Millis(500));
+  EXPECT_EQ(depth.depth(), kInitialDepth);
+}
+
+TEST(WritePipelineDepthTest, HalvesWhenStreamIsInterrupted) {
+  WritePipelineDepth depth(100);
+  Acknowledge(&depth, 10000, Millis(50));
+  ASSERT_EQ(depth.depth(), 100);
+
+  depth.OnStreamInterrupted();
+  EXPECT_EQ(depth.depth(), 50);
+
+  for (int i = 0; i < 3; ++i) {
+    depth.OnStreamInterrupted();
+  }
+  EXPECT_EQ(depth.depth(), kInitialDepth);
+}
+
+}  // namespace
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
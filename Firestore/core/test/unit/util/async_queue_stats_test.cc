@@ -0,0 +1,144 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/async_queue_stats.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+using Micros = LatencyHistogram::Duration;
+
+TEST(LatencyHistogramTest, RecordsIntoExponentialBuckets) {
+  LatencyHistogram histogram;
+  histogram.Record(Micros(0));
+  histogram.Record(Micros(1));
+  histogram.Record(Micros(3));
+  histogram.Record(Micros(1000));
+
+  LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.buckets[0], 1u);
+  EXPECT_EQ(snapshot.buckets[1], 1u);
+  EXPECT_EQ(snapshot.buckets[2], 1u);
+  EXPECT_EQ(snapshot.buckets[10], 1u);
+  EXPECT_EQ(snapshot.count, 4u);
+  EXPECT_EQ(snapshot.total, Micros(1004));
+  EXPECT_EQ(snapshot.max, Micros(1000));
+  EXPECT_EQ(snapshot.Mean(), Micros(251));
+}
+
+TEST(LatencyHistogramTest, PercentilesAreBoundedByBucketsAndMax) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 99; ++i) {
+    histogram.Record(Micros(100));
+  }
+  histogram.Record(Micros(5000));
+
+  LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.Percentile(50), Micros(128));
+  EXPECT_EQ(snapshot.Percentile(99), Micros(128));
+  EXPECT_EQ(snapshot.Percentile(100), Micros(5000));
+
+  EXPECT_EQ(LatencyHistogram().GetSnapshot().Percentile(50), Micros(0));
+}
+
+TEST(LatencyHistogramTest, LongDurationsGoInTheLastBucket) {
+  LatencyHistogram histogram;
+  histogram.Record(std::chrono::hours(2));
+
+  LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.buckets[LatencyHistogram::kBucketCount - 1], 1u);
+  EXPECT_EQ(snapshot.Percentile(50), std::chrono::hours(2));
+}
+
+TEST(AsyncQueueStatsTest, GroupsOperationsByLabel) {
+  AsyncQueueStats stats;
+  stats.RecordOperation("Fast", Micros(10), Micros(1));
+  stats.RecordOperation("Slow", Micros(20), Micros(500));
+  stats.RecordOperation("Slow", Micros(30), Micros(700));
+  stats.RecordOperation(nullptr, Micros(0), Micros(2));
+
+  AsyncQueueStats::Snapshot snapshot = stats.GetSnapshot();
+  ASSERT_EQ(snapshot.operations.size(), 3u);
+
+  // Sorted by total run time.
+  EXPECT_EQ(snapshot.operations[0].label, "Slow");
+  EXPECT_EQ(snapshot.operations[0].run.count, 2u);
+  EXPECT_EQ(snapshot.operations[0].run.total, Micros(1200));
+  EXPECT_EQ(snapshot.operations[0].wait.max, Micros(30));
+  EXPECT_EQ(snapshot.operations[1].label, AsyncQueueStats::kUnlabeled);
+  EXPECT_EQ(snapshot.operations[2].label, "Fast");
+}
+
+TEST(AsyncQueueStatsTest, MergesLabelsWithTheSameText) {
+  // Distinct arrays, so the labels are guaranteed to have different addresses.
+  char first[] = "Label";
+  char second[] = "Label";
+
+  AsyncQueueStats stats;
+  stats.RecordOperation(first, Micros(0), Micros(1));
+  stats.RecordOperation(second, Micros(0), Micros(2));
+
+  AsyncQueueStats::Snapshot snapshot = stats.GetSnapshot();
+  ASSERT_EQ(snapshot.operations.size(), 1u);
+  EXPECT_EQ(snapshot.operations[0].run.count, 2u);
+}
+
+TEST(AsyncQueueStatsTest, RecordsUnderOverflowLabelOnceFull) {
+  std::vector<std::string> labels;
+  for (size_t i = 0; i <= AsyncQueueStats::kMaxLabels; ++i) {
+    labels.push_back("Label" + std::to_string(i));
+  }
+
+  AsyncQueueStats stats;
+  for (const std::string& label : labels) {
+    stats.RecordOperation(label.c_str(), Micros(0), Micros(1));
+  }
+
+  AsyncQueueStats::Snapshot snapshot = stats.GetSnapshot();
+  ASSERT_EQ(snapshot.operations.size(), AsyncQueueStats::kMaxLabels + 1);
+  int overflow_count = 0;
+  for (const auto& operation : snapshot.operations) {
+    if (operation.label == AsyncQueueStats::kOverflowLabel) {
+      ++overflow_count;
+      EXPECT_EQ(operation.run.count, 1u);
+    }
+  }
+  EXPECT_EQ(overflow_count, 1);
+}
+
+TEST(AsyncQueueStatsTest, TracksDepth) {
+  AsyncQueueStats stats;
+  stats.RecordEnqueued();
+  stats.RecordEnqueued();
+  stats.RecordDequeued();
+  stats.RecordEnqueued();
+  stats.RecordDequeued();
+
+  AsyncQueueStats::Snapshot snapshot = stats.GetSnapshot();
+  EXPECT_EQ(snapshot.depth, 1);
+  EXPECT_EQ(snapshot.max_depth, 2);
+  EXPECT_NE(snapshot.ToString().find("depth: 1 (max 2)"), std::string::npos);
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -16,9 +16,11 @@
 
 #include "Firestore/core/test/unit/util/async_queue_test.h"
 
+#include <algorithm>
 #include <chrono>  // NOLINT(build/c++11)
 #include <future>  // NOLINT(build/c++11)
 #include <string>
+#include <vector>
 
 #include "Firestore/core/src/util/executor.h"
 #include "absl/memory/memory.h"
@@ -242,6 +244,68 @@ TEST_P(AsyncQueueTest, DisposePreventsAllEnqueues) {
   ASSERT_FALSE(queue->EnqueueEvenWhileRestricted([&] {}));
 }
 
+TEST_P(AsyncQueueTest, InstrumentationRecordsLabeledOperations) {
+  queue->EnqueueBlocking([] {});
+  EXPECT_TRUE(queue->GetStatsSnapshot().operations.empty());
+
+  queue->EnableInstrumentation();
+
+  Expectation ran;
+  queue->Enqueue("Test::Immediate", [] {});
+  queue->EnqueueBlocking([&] {
+    queue->EnqueueAfterDelay(AsyncQueue::Milliseconds(1), kTimerId1,
+                             "Test::Delayed", ran.AsCallback());
+  });
+  Await(ran);
+
+  // Operations are recorded once they finish, so wait for the delayed one to
+  // finish by running another one after it.
+  queue->EnqueueBlocking([] {});
+
+  AsyncQueueStats::Snapshot snapshot = queue->GetStatsSnapshot();
+  std::vector<std::string> labels;
+  for (const auto& operation : snapshot.operations) {
+    labels.push_back(operation.label);
+  }
+  std::sort(labels.begin(), labels.end());
+  EXPECT_EQ(labels, (std::vector<std::string>{
+                        AsyncQueueStats::kUnlabeled, "Test::Delayed",
+                        "Test::Immediate"}));
+  EXPECT_EQ(snapshot.depth, 0);
+  EXPECT_GE(snapshot.max_depth, 1);
+}
+
+TEST_P(AsyncQueueTest, InstrumentationForgetsOperationsDiscardedByDispose) {
+  queue->EnableInstrumentation();
+
+  // Block the queue, such that the operations after it are still waiting when
+  // the queue is disposed.
+  Expectation blocking_started;
+  Expectation blocking_complete;
+  queue->Enqueue([&] {
+    blocking_started.Fulfill();
+    Await(blocking_complete);
+  });
+  Await(blocking_started);
+  queue->Enqueue("Test::Discarded", [] {});
+  queue->Enqueue("Test::Discarded", [] {});
+  EXPECT_EQ(queue->GetStatsSnapshot().depth, 2);
+
+  Expectation dispose_started;
+  Expectation dispose_complete;
+  Async([&] {
+    dispose_started.Fulfill();
+    queue->Dispose();
+    dispose_complete.Fulfill();
+  });
+
+  Await(dispose_started);
+  blocking_complete.Fulfill();
+  Await(dispose_complete);
+
+  EXPECT_EQ(queue->GetStatsSnapshot().depth, 0);
+}
+
 TEST_P(AsyncQueueTest, DisposeDoesNotBlockEnqueueWhileWaiting) {
   // Start a task that will block the queue. AsyncQueue::Dispose will block
   // until this completes.
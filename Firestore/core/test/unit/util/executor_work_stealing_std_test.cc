@@ -0,0 +1,40 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/executor_work_stealing.h"
+
+#include "Firestore/core/test/unit/util/executor_test.h"
+#include "absl/memory/memory.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+std::unique_ptr<Executor> ExecutorFactory(int threads) {
+  return absl::make_unique<ExecutorWorkStealing>(threads);
+}
+
+}  // namespace
+
+INSTANTIATE_TEST_SUITE_P(ExecutorTestWorkStealing,
+                         ExecutorTest,
+                         ::testing::Values(ExecutorFactory));
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
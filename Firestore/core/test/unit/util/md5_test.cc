@@ -0,0 +1,65 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/md5.h"
+
+#include <string>
+
+#include "absl/strings/escaping.h"
+#include "gtest/gtest.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+std::string HexDigest(absl::string_view data) {
+  Md5Digest digest = CalculateMd5Digest(data);
+  return absl::BytesToHexString(absl::string_view(
+      reinterpret_cast<const char*>(digest.data()), digest.size()));
+}
+
+}  // namespace
+
+TEST(Md5Test, MatchesTestSuite) {
+  // The test suite from RFC 1321.
+  EXPECT_EQ(HexDigest(""), "d41d8cd98f00b204e9800998ecf8427e");
+  EXPECT_EQ(HexDigest("a"), "0cc175b9c0f1b6a831c399e269772661");
+  EXPECT_EQ(HexDigest("abc"), "900150983cd24fb0d6963f7d28e17f72");
+  EXPECT_EQ(HexDigest("message digest"), "f96b697d7cb7938d525a2f31aaf161d0");
+  EXPECT_EQ(HexDigest("abcdefghijklmnopqrstuvwxyz"),
+            "c3fcd3d76192e4007dfb496cca67e13b");
+  EXPECT_EQ(HexDigest("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz"
+                      "0123456789"),
+            "d174ab98d277d9f5a5611c2c9f419d9f");
+  EXPECT_EQ(HexDigest("1234567890123456789012345678901234567890"
+                      "1234567890123456789012345678901234567890"),
+            "57edf4a22be3c955ac49da2e2107b67a");
+}
+
+TEST(Md5Test, PadsAroundBlockBoundaries) {
+  // The length no longer fits in the first padding block from 56 bytes on.
+  EXPECT_EQ(HexDigest(std::string(55, 'a')),
+            "ef1772b6dff9a122358552954ad0df65");
+  EXPECT_EQ(HexDigest(std::string(56, 'a')),
+            "3b0c8ac703f828b04c6c197006d17218");
+  EXPECT_EQ(HexDigest(std::string(64, 'a')),
+            "014842d480b571495a4a0363793f7367");
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <vector>
+
+#include "Firestore/core/src/util/schedule.h"
+#include "Firestore/core/src/util/secure_random.h"
+#include "Firestore/core/src/util/task.h"
+#include "benchmark/benchmark.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+// Models the timers of an `AsyncQueue` with many concurrent transactions and
+// streams: `state.range(0)` delayed operations are pending at any time, and
+// each iteration cancels a random one of them and schedules a replacement.
+void ScheduleAndCancel(benchmark::State& state, bool by_id) {
+  const auto pending = static_cast<size_t>(state.range(0));
+  const auto now = std::chrono::time_point_cast<Executor::Milliseconds>(
+      Executor::Clock::now());
+
+  SecureRandom rnd;
+  auto next_target_time = [&] {
+    // Delays range from milliseconds to minutes, like idle and backoff timers.
+    return now + Executor::Milliseconds(1 + rnd.Uniform(60 * 60 * 1000));
+  };
+
+  Schedule schedule;
+  Executor::Id next_id = 0;
+  std::vector<Executor::Id> ids;
+  for (size_t i = 0; i < pending; ++i) {
+    ids.push_back(next_id);
+    schedule.Push(
+        Task::Create(nullptr, next_target_time(), 1, next_id++, [] {}));
+  }
+
+  for (auto _ : state) {
+    size_t index = rnd.Uniform(static_cast<uint32_t>(pending));
+    Executor::Id id = ids[index];
+
+    Task* removed = nullptr;
+    if (by_id) {
+      removed = schedule.RemoveById(id);
+    } else {
+      removed = schedule.RemoveIf([id](const Task& t) { return t.id() == id; });
+    }
+    removed->Release();
+
+    ids[index] = next_id;
+    schedule.Push(
+        Task::Create(nullptr, next_target_time(), 1, next_id++, [] {}));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_ScheduleCancelById(benchmark::State& state) {
+  ScheduleAndCancel(state, /*by_id=*/true);
+}
+BENCHMARK(BM_ScheduleCancelById)->Range(8, 8 << 10);
+
+// The linear scan that cancellation used before `RemoveById`, for comparison.
+void BM_ScheduleCancelByPredicate(benchmark::State& state) {
+  ScheduleAndCancel(state, /*by_id=*/false);
+}
+BENCHMARK(BM_ScheduleCancelByPredicate)->Range(8, 8 << 10);
+
+// Measures the immediate operations that `ExecutorStd` pushes through the
+// schedule, which must not get slower.
+void BM_ScheduleImmediate(benchmark::State& state) {
+  Schedule schedule;
+  Executor::Id next_id = 0;
+  for (auto _ : state) {
+    schedule.Push(Task::Create(nullptr, Executor::TimePoint{},
+                               Executor::kNoTag, next_id++, [] {}));
+    schedule.PopIfDue()->Release();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScheduleImmediate);
+
+}  // namespace
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -19,6 +19,7 @@
 #include <chrono>  // NOLINT(build/c++11)
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 #include "Firestore/core/src/util/task.h"
 #include "Firestore/core/test/unit/testutil/async_testing.h"
@@ -47,6 +48,26 @@ class ScheduleTest : public ::testing::Test, public testutil::AsyncTest {
     schedule.Push(task);
   }
 
+  void Push(int value, Executor::Id id, Schedule::TimePoint target_time) {
+    auto task = Task::Create(nullptr, target_time, value, id, [] {});
+    schedule.Push(task);
+  }
+
+  // Pushes an immediate entry, identified by its id since immediate entries
+  // don't have a tag.
+  void PushImmediate(Executor::Id id) {
+    auto task = Task::Create(nullptr, Schedule::TimePoint{}, Executor::kNoTag,
+                             id, [] {});
+    schedule.Push(task);
+  }
+
+  int PopIdBlocking() {
+    Task* task = schedule.PopBlocking();
+    int result = static_cast<int>(task->id());
+    task->Release();
+    return result;
+  }
+
   int PopIfDue() {
     return Value(schedule.PopIfDue());
   }
@@ -128,6 +149,53 @@ TEST_F(ScheduleTest, RemoveIf) {
   EXPECT_TRUE(schedule.empty());
 }
 
+TEST_F(ScheduleTest, RemoveById) {
+  Push(1, 10, start_time);
+  Push(2, 20, Now() + chr::minutes(1));
+  Push(3, 30, Now() + chr::minutes(2));
+
+  EXPECT_TRUE(schedule.ContainsId(20));
+  EXPECT_EQ(Value(schedule.RemoveById(20)), 2);
+  EXPECT_FALSE(schedule.ContainsId(20));
+
+  // Non-existent id.
+  EXPECT_EQ(schedule.RemoveById(20), nullptr);
+
+  EXPECT_EQ(Value(schedule.RemoveById(30)), 3);
+  EXPECT_EQ(PopIfDue(), 1);
+  EXPECT_FALSE(schedule.ContainsId(10));
+  EXPECT_TRUE(schedule.empty());
+}
+
+TEST_F(ScheduleTest, RemoveByIdPrefersMostDueEntryWithDuplicateIds) {
+  Push(2, 10, start_time + chr::milliseconds(2));
+  Push(1, 10, start_time + chr::milliseconds(1));
+  Push(3, 10, start_time + chr::milliseconds(2));
+
+  EXPECT_EQ(Value(schedule.RemoveById(10)), 1);
+  EXPECT_EQ(Value(schedule.RemoveById(10)), 2);
+  EXPECT_EQ(Value(schedule.RemoveById(10)), 3);
+  EXPECT_TRUE(schedule.empty());
+}
+
+TEST_F(ScheduleTest, ImmediateEntriesAreOrderedWithDelayedEntries) {
+  PushImmediate(1);
+  Push(3, 3, start_time);
+  PushImmediate(2);
+  Push(4, 4, start_time + chr::milliseconds(1));
+
+  // Immediate entries can't be looked up by id.
+  EXPECT_FALSE(schedule.ContainsId(1));
+  EXPECT_EQ(schedule.RemoveById(1), nullptr);
+
+  std::vector<int> ids;
+  while (!schedule.empty()) {
+    ids.push_back(PopIdBlocking());
+  }
+  const std::vector<int> expected = {1, 2, 3, 4};
+  EXPECT_EQ(ids, expected);
+}
+
 TEST_F(ScheduleTest, Ordering) {
   Push(11, start_time + chr::milliseconds(5));
   Push(1, start_time);